@@ -0,0 +1,56 @@
+#################################################################################
+#
+# Inviwo - Interactive Visualization Workshop
+#
+# Copyright (c) 2013-2018 Inviwo Foundation
+# All rights reserved.
+# 
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met: 
+# 
+# 1. Redistributions of source code must retain the above copyright notice, this
+# list of conditions and the following disclaimer. 
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+# this list of conditions and the following disclaimer in the documentation
+# and/or other materials provided with the distribution. 
+# 
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+# ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+# ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+# 
+#################################################################################
+
+ ### Helpers for benchmark targets. ###
+
+#--------------------------------------------------------------------
+# Output directory for benchmark results
+set(IVW_BENCHMARK_OUTPUT_DIR "${CMAKE_BINARY_DIR}/benchmarks" CACHE PATH
+    "Directory where the run-benchmarks target writes the JSON results")
+
+#--------------------------------------------------------------------
+# Add a "<target>-json" target that runs the benchmark executable and writes the results as
+# JSON to IVW_BENCHMARK_OUTPUT_DIR/<target>.json, and add it to the "run-benchmarks" target.
+# Usage: ivw_add_benchmark_json_target(base-benchmark)
+function(ivw_add_benchmark_json_target target)
+    if(NOT TARGET run-benchmarks)
+        add_custom_target(run-benchmarks)
+        set_target_properties(run-benchmarks PROPERTIES FOLDER benchmarks)
+    endif()
+    add_custom_target(${target}-json
+        COMMAND ${CMAKE_COMMAND} -E make_directory ${IVW_BENCHMARK_OUTPUT_DIR}
+        COMMAND ${target} --benchmark_out=${IVW_BENCHMARK_OUTPUT_DIR}/${target}.json
+                          --benchmark_out_format=json
+        DEPENDS ${target}
+        COMMENT "Running benchmarks: ${target}"
+        VERBATIM
+    )
+    set_target_properties(${target}-json PROPERTIES FOLDER benchmarks)
+    add_dependencies(run-benchmarks ${target}-json)
+endfunction()
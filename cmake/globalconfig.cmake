@@ -181,6 +181,10 @@ option(IVW_PROFILING "Enable profiling" OFF)
 # Build unittest for all modules
 include(${CMAKE_CURRENT_LIST_DIR}/unittests.cmake)
 
+#--------------------------------------------------------------------
+# Helpers for benchmarks
+include(${CMAKE_CURRENT_LIST_DIR}/benchmarks.cmake)
+
 #--------------------------------------------------------------------
 # Use Visual Studio memory leak test
 include(${CMAKE_CURRENT_LIST_DIR}/memleak.cmake)
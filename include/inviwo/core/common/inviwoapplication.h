@@ -226,11 +226,24 @@ public:
 
     virtual void processFront();
 
+    /**
+     * Wait for a task dispatched to the pool to finish. When called from within a pool task the
+     * worker will process other queued tasks while waiting, hence pool tasks can safely wait for
+     * subtasks they have dispatched.
+     */
+    template <typename Future>
+    void waitForTask(const Future& future);
+
     /**
      * Get the current number of worker threads in the thread pool
      */
     size_t getPoolSize() const;
 
+    /**
+     * Get the number of tasks dispatched to the thread pool that are queued or running
+     */
+    size_t getNumberOfPoolTasks() const;
+
     /**
      * Set the number of worker threads in the thread pool. This will block for working threads to
      * finish
@@ -353,6 +366,7 @@ protected:
     WorkspaceManager::ClearHandle presetsClearHandle_;
     WorkspaceManager::SerializationHandle presetsSerializationHandle_;
     WorkspaceManager::DeserializationHandle presetsDeserializationHandle_;
+    std::shared_ptr<std::function<void()>> representationMemoryHandle_;
     std::unique_ptr<TimerThread> timerThread_;
 private:
     friend Singleton<InviwoApplication>;
@@ -371,6 +385,11 @@ auto dispatchPool(F&& f, Args&&... args) -> std::future<typename std::result_of<
                                                      std::forward<Args>(args)...);
 }
 
+template <typename Future>
+void waitForTask(const Future& future) {
+    InviwoApplication::getPtr()->waitForTask(future);
+}
+
 namespace util {
 
 /**
@@ -417,6 +436,11 @@ auto InviwoApplication::dispatchPool(F&& f, Args&&... args)
     return pool_.enqueue(std::forward<F>(f), std::forward<Args>(args)...);
 }
 
+template <typename Future>
+void InviwoApplication::waitForTask(const Future& future) {
+    pool_.wait(future);
+}
+
 template <class F, class... Args>
 auto InviwoApplication::dispatchFront(F&& f, Args&&... args)
     -> std::future<typename std::result_of<F(Args...)>::type> {
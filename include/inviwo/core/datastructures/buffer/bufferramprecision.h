@@ -55,6 +55,7 @@ public:
 
     virtual void setSize(size_t size) override;
     virtual size_t getSize() const override;
+    virtual size_t getNumberOfBytes() const override;
 
     virtual void* getData() override;
     virtual const void* getData() const override;
@@ -146,6 +147,11 @@ size_t BufferRAMPrecision<T, Target>::getSize() const {
     return data_.size();
 }
 
+template <typename T, BufferTarget Target>
+size_t BufferRAMPrecision<T, Target>::getNumberOfBytes() const {
+    return data_.size() * sizeof(T);
+}
+
 template <typename T, BufferTarget Target>
 void* BufferRAMPrecision<T, Target>::getData() {
     return (data_.empty() ? nullptr : data_.data());
@@ -34,7 +34,11 @@
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/common/inviwoapplication.h>
 #include <inviwo/core/datastructures/representationconverterfactory.h>
+#include <inviwo/core/datastructures/representationmemorymanager.h>
+#include <inviwo/core/util/trace.h>
+#include <future>
 #include <typeindex>
+#include <unordered_set>
 
 namespace inviwo {
 /**
@@ -78,19 +82,23 @@ namespace inviwo {
  *
  *
  *
+ * Representations reporting their size are registered with the RepresentationMemoryManager, which
+ * might remove them when the memory budget is exceeded if they can be rebuilt from another valid
+ * representation.
+ *
  * @note Do not use the same representation in different Data objects.
  * This can cause inconsistencies since the Data objects cannot know if
  * another one has edited the representation.
  * @see Representation and RepresentationConverter
  */
 template <typename Self, typename Repr>
-class Data {
+class Data : public RepresentationMemoryManager::Owner {
 public:
     using self = Self;
     using repr = Repr;
 
     virtual Data<Self, Repr>* clone() const = 0;
-    virtual ~Data() = default;
+    virtual ~Data();
 
     /**
      * Get a representation of type T. If there already is a valid representation of type T, just
@@ -98,18 +106,44 @@ public:
      * valid. It there is no representation of type T, create it from the last valid representation.
      * If there are no representations create a default representation and from that create a
      * representation of type T.
+     * The conversion runs without holding the lock of this object, hence requests for valid
+     * representations are not blocked by it. Concurrent requests for the same type of
+     * representation share a single conversion. If the representations are changed while
+     * converting, the conversion is redone from the new data.
      */
     template <typename T>
     const T* getRepresentation() const;
 
     /**
      * Get an editable representation. This will invalidate all other representations.
-     * They will now have to be updated from this one before use.
+     * They will now have to be updated from this one before use. If the representation shares
+     * its data with a copy of this object, the data is copied first.
      * @see getRepresentation and invalidateAllOther
      */
     template <typename T>
     T* getEditableRepresentation();
 
+    /**
+     * Same as getRepresentation and getEditableRepresentation, but the returned pointer shares
+     * ownership of the representation. This keeps the representation alive even if it is removed
+     * from, or replaced in, this object later on.
+     */
+    template <typename T>
+    std::shared_ptr<const T> getRepresentationShared() const;
+    template <typename T>
+    std::shared_ptr<T> getEditableRepresentationShared();
+
+    /**
+     * Get a representation of type T without blocking the calling thread. If the representation
+     * is valid the returned future is ready, otherwise the conversion is dispatched to the
+     * thread pool. Useful for prefetching, for example loading a volume from disk into RAM while
+     * other processors are running.
+     * @note The data object has to be kept alive until the future is ready. Representations that
+     * require an OpenGL context should not be requested asynchronously.
+     */
+    template <typename T>
+    std::future<std::shared_ptr<const T>> getRepresentationAsync() const;
+
     /**
      * Check if a specific representation type exists.
      * Example:
@@ -175,8 +209,14 @@ protected:
     Data<Self, Repr>& operator=(const Data<Self, Repr>& rhs);
 
     virtual std::shared_ptr<Repr> createDefaultRepresentation() const = 0;
-    template <typename T>
-    const T* getValidRepresentation() const;
+    std::shared_ptr<Repr> getValidRepresentation(std::type_index type) const;
+    std::shared_ptr<Repr> convertRepresentation(std::shared_ptr<Repr> source, std::type_index type,
+                                                size_t generation) const;
+    void cancelConversions();
+    void trackRepresentation(const Repr* repr) const;
+    void touchRepresentation(const Repr* repr) const;
+    void untrackRepresentation(const Repr* repr) const;
+    virtual bool evictRepresentation(const void* repr) override;
     void copyRepresentationsTo(Data<Self, Repr>* targetData) const;
 
     std::shared_ptr<Repr> addRepresentationInternal(std::shared_ptr<Repr> representation) const;
@@ -185,6 +225,17 @@ protected:
     mutable std::unordered_map<std::type_index, std::shared_ptr<Repr>> representations_;
     // A pointer to the the most recently updated representation. Makes updates and creation faster.
     mutable std::shared_ptr<Repr> lastValidRepresentation_;
+    // Conversions in flight, shared by all threads requesting the same type of representation.
+    mutable std::unordered_map<std::type_index, std::shared_future<std::shared_ptr<Repr>>>
+        conversions_;
+    // Representations being updated by a conversion. An outdated conversion may still be
+    // updating one after its request was cancelled, later conversions then create a new one.
+    mutable std::unordered_set<const Repr*> updating_;
+    // Incremented whenever the representations change, conversions started before are stale.
+    size_t generation_ = 0;
+    // Usage of the representations registered with the RepresentationMemoryManager
+    mutable std::unordered_map<const Repr*, std::shared_ptr<RepresentationMemoryManager::Usage>>
+        usage_;
     const DataFormatBase* dataFormatBase_;
 };
 
@@ -198,6 +249,12 @@ Data<Self, Repr>::Data(const Data<Self, Repr>& rhs)
     rhs.copyRepresentationsTo(this);
 }
 
+template <typename Self, typename Repr>
+Data<Self, Repr>::~Data() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (auto& elem : representations_) untrackRepresentation(elem.second.get());
+}
+
 template <typename Self, typename Repr>
 Data<Self, Repr>& Data<Self, Repr>::operator=(const Data<Self, Repr>& that) {
     if (this != &that) {
@@ -210,57 +267,220 @@ Data<Self, Repr>& Data<Self, Repr>::operator=(const Data<Self, Repr>& that) {
 template <typename Self, typename Repr>
 template <typename T>
 const T* Data<Self, Repr>::getRepresentation() const {
+    return dynamic_cast<const T*>(getValidRepresentation(std::type_index(typeid(T))).get());
+}
+
+template <typename Self, typename Repr>
+std::shared_ptr<Repr> Data<Self, Repr>::getValidRepresentation(std::type_index type) const {
     std::unique_lock<std::mutex> lock(mutex_);
     if (representations_.empty()) {
         lock.unlock();
         auto repr = createDefaultRepresentation();
-        lock.lock();
         if (!repr) throw Exception("Failed to create default representation", IvwContext);
-        lastValidRepresentation_ = addRepresentationInternal(repr);
+        lock.lock();
+        if (representations_.empty()) lastValidRepresentation_ = addRepresentationInternal(repr);
     }
 
-    auto it = representations_.find(std::type_index(typeid(T)));
+    auto it = representations_.find(type);
     if (it != representations_.end() && it->second->isValid()) {
         lastValidRepresentation_ = it->second;
-        return dynamic_cast<const T*>(lastValidRepresentation_.get());
-    } else {
-        return getValidRepresentation<T>();
+        touchRepresentation(it->second.get());
+        return it->second;
+    }
+
+    auto cit = conversions_.find(type);
+    if (cit != conversions_.end()) {
+        auto conversion = cit->second;
+        lock.unlock();
+        return conversion.get();
+    }
+
+    std::promise<std::shared_ptr<Repr>> promise;
+    conversions_[type] = promise.get_future().share();
+    const auto generation = generation_;
+    auto source = lastValidRepresentation_;
+    lock.unlock();
+
+    try {
+        auto result = convertRepresentation(source, type, generation);
+        promise.set_value(result);
+        return result;
+    } catch (...) {
+        lock.lock();
+        if (generation == generation_) conversions_.erase(type);
+        lock.unlock();
+        promise.set_exception(std::current_exception());
+        throw;
     }
 }
 
 template <typename Self, typename Repr>
-template <typename T>
-const T* Data<Self, Repr>::getValidRepresentation() const {
+std::shared_ptr<Repr> Data<Self, Repr>::convertRepresentation(std::shared_ptr<Repr> source,
+                                                              std::type_index type,
+                                                              size_t generation) const {
+    if (!source) throw ConverterException("Found no valid representation", IvwContext);
     auto factory = InviwoApplication::getPtr()->getRepresentationConverterFactory<Repr>();
-    auto package = factory->getRepresentationConverter(lastValidRepresentation_->getTypeIndex(),
-                                                       std::type_index(typeid(T)));
-
-    if (package) {
-        for (auto converter : package->getConverters()) {
-            auto dest = converter->getConverterID().second;
-            auto it = representations_.find(dest);
-            if (it != representations_.end()) {  // Next repr. already exist, just update it
-                converter->update(lastValidRepresentation_, it->second);
-                lastValidRepresentation_ = it->second;
-                lastValidRepresentation_->setValid(true);
-            } else {  // No representation found, create it
-                auto result = converter->createFrom(lastValidRepresentation_);
-                if (!result) throw ConverterException("Converter failed to create", IvwContext);
-                lastValidRepresentation_ = addRepresentationInternal(result);
-            }
+    auto package = factory->getRepresentationConverter(source->getTypeIndex(), type);
+    if (!package) throw ConverterException("Found no converters", IvwContext);
+
+    // Intermediate representations are requested separately, that way they are shared with
+    // concurrent conversions to other types going through the same intermediate representation.
+    const auto& converters = package->getConverters();
+    auto converter = converters.back();
+    if (converters.size() > 1) {
+        source = getValidRepresentation(converter->getConverterID().first);
+    }
+
+    IVW_TRACE_SCOPE("representation", parseTypeIdName(converter->getConverterID().first.name()) +
+                                          " -> " + parseTypeIdName(type.name()));
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = representations_.find(type);
+    auto dest = it != representations_.end() && !util::has_key(updating_, it->second.get())
+                    ? it->second
+                    : nullptr;
+    if (dest) updating_.insert(dest.get());
+    lock.unlock();
+
+    if (dest) {  // Representation already exist, just update it
+        try {
+            converter->update(source, dest);
+        } catch (...) {
+            lock.lock();
+            updating_.erase(dest.get());
+            throw;
         }
-        return dynamic_cast<const T*>(lastValidRepresentation_.get());
+        lock.lock();
+        updating_.erase(dest.get());
+    } else {  // No representation found, or it is still updated by an outdated conversion
+        dest = converter->createFrom(source);
+        if (!dest) throw ConverterException("Converter failed to create", IvwContext);
+        lock.lock();
+    }
+
+    if (generation == generation_) {
+        lastValidRepresentation_ = addRepresentationInternal(dest);
+        conversions_.erase(type);
+        return dest;
+    }
+
+    // The data was changed during the conversion and the result is outdated. Keep it, invalid,
+    // to be updated by the next request, unless another representation of this type was added
+    // meanwhile. Then redo the request such that the caller gets a representation owned by this
+    // object reflecting the current data.
+    if (!util::has_key(representations_, type)) addRepresentationInternal(dest)->setValid(false);
+    lock.unlock();
+    return getValidRepresentation(type);
+}
+
+template <typename Self, typename Repr>
+void Data<Self, Repr>::cancelConversions() {
+    ++generation_;
+    conversions_.clear();
+}
+
+template <typename Self, typename Repr>
+void Data<Self, Repr>::trackRepresentation(const Repr* repr) const {
+    if (!RepresentationMemoryManager::isInitialized()) return;
+    if (const auto bytes = repr->getNumberOfBytes()) {
+        usage_[repr] = RepresentationMemoryManager::getPtr()->use(
+            const_cast<Data<Self, Repr>*>(this), repr, bytes);
+    }
+}
+
+template <typename Self, typename Repr>
+void Data<Self, Repr>::touchRepresentation(const Repr* repr) const {
+    // Called for every retrieved representation, avoid locking the manager
+    if (!RepresentationMemoryManager::isInitialized()) return;
+    auto it = usage_.find(repr);
+    if (it != usage_.end()) {
+        RepresentationMemoryManager::getPtr()->touch(*it->second, repr->getNumberOfBytes());
     } else {
-        throw ConverterException("Found no converters", IvwContext);
+        trackRepresentation(repr);
     }
 }
 
+template <typename Self, typename Repr>
+void Data<Self, Repr>::untrackRepresentation(const Repr* repr) const {
+    if (usage_.erase(repr) == 0) return;
+    if (!RepresentationMemoryManager::isInitialized()) return;
+    RepresentationMemoryManager::getPtr()->remove(repr);
+}
+
+template <typename Self, typename Repr>
+bool Data<Self, Repr>::evictRepresentation(const void* repr) {
+    // Called by the memory manager, skip if the data object is busy to not wait while holding
+    // the manager lock.
+    std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+    if (!lock) return false;
+
+    auto it = std::find_if(representations_.begin(), representations_.end(),
+                           [&](const auto& elem) { return elem.second.get() == repr; });
+    if (it == representations_.end()) return false;
+    const auto candidate = it->second;
+
+    // Keep representations referenced from elsewhere, or being converted to or from.
+    const long references = 2 + (lastValidRepresentation_ == candidate ? 1 : 0);
+    if (candidate.use_count() > references || util::has_key(conversions_, it->first)) {
+        return false;
+    }
+
+    if (candidate->isValid()) {
+        // Only evict if the representation can be rebuilt from another valid one.
+        auto factory = InviwoApplication::getPtr()->getRepresentationConverterFactory<Repr>();
+        auto sit = std::find_if(representations_.begin(), representations_.end(),
+                                [&](const auto& elem) {
+                                    return elem.second != candidate && elem.second->isValid() &&
+                                           factory->getRepresentationConverter(
+                                               elem.first, candidate->getTypeIndex());
+                                });
+        if (sit == representations_.end()) return false;
+        if (lastValidRepresentation_ == candidate) lastValidRepresentation_ = sit->second;
+    }
+
+    usage_.erase(candidate.get());
+    representations_.erase(it);
+    return true;
+}
+
 template <typename Self, typename Repr>
 template <typename T>
 T* Data<Self, Repr>::getEditableRepresentation() {
-    auto repr = getRepresentation<T>();
+    auto repr = const_cast<T*>(getRepresentation<T>());
+    repr->makeUnique();
     invalidateAllOther(repr);
-    return const_cast<T*>(repr);
+    return repr;
+}
+
+template <typename Self, typename Repr>
+template <typename T>
+std::shared_ptr<const T> Data<Self, Repr>::getRepresentationShared() const {
+    return std::dynamic_pointer_cast<const T>(
+        getValidRepresentation(std::type_index(typeid(T))));
+}
+
+template <typename Self, typename Repr>
+template <typename T>
+std::shared_ptr<T> Data<Self, Repr>::getEditableRepresentationShared() {
+    auto repr = std::const_pointer_cast<T>(getRepresentationShared<T>());
+    repr->makeUnique();
+    invalidateAllOther(repr.get());
+    return repr;
+}
+
+template <typename Self, typename Repr>
+template <typename T>
+std::future<std::shared_ptr<const T>> Data<Self, Repr>::getRepresentationAsync() const {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto it = representations_.find(std::type_index(typeid(T)));
+        if (it != representations_.end() && it->second->isValid()) {
+            std::promise<std::shared_ptr<const T>> promise;
+            promise.set_value(std::dynamic_pointer_cast<const T>(it->second));
+            return promise.get_future();
+        }
+    }
+    return dispatchPool([this]() { return getRepresentationShared<T>(); });
 }
 
 template <typename Self, typename Repr>
@@ -274,6 +494,7 @@ template <typename Self, typename Repr>
 void Data<Self, Repr>::invalidateAllOther(const Repr* repr) {
     bool found = false;
     std::unique_lock<std::mutex> lock(mutex_);
+    cancelConversions();
     for (auto& elem : representations_) {
         if (elem.second.get() != repr) {
             elem.second->setValid(false);
@@ -289,6 +510,8 @@ void Data<Self, Repr>::invalidateAllOther(const Repr* repr) {
 template <typename Self, typename Repr>
 void Data<Self, Repr>::clearRepresentations() {
     std::unique_lock<std::mutex> lock(mutex_);
+    cancelConversions();
+    for (auto& elem : representations_) untrackRepresentation(elem.second.get());
     representations_.clear();
 }
 
@@ -307,22 +530,28 @@ std::shared_ptr<Repr> Data<Self, Repr>::addRepresentationInternal(
     std::shared_ptr<Repr> repr) const {
     repr->setValid(true);
     repr->setOwner(static_cast<Self*>(const_cast<Data<Self, Repr>*>(this)));
-    representations_[repr->getTypeIndex()] = repr;
+    auto& elem = representations_[repr->getTypeIndex()];
+    if (elem && elem != repr) untrackRepresentation(elem.get());
+    elem = repr;
+    trackRepresentation(repr.get());
     return repr;
 }
 
 template <typename Self, typename Repr>
 void Data<Self, Repr>::addRepresentation(std::shared_ptr<Repr> representation) {
     std::unique_lock<std::mutex> lock(mutex_);
+    cancelConversions();
     lastValidRepresentation_ = addRepresentationInternal(representation);
 }
 
 template <typename Self, typename Repr>
 void Data<Self, Repr>::removeRepresentation(const Repr* representation) {
     std::unique_lock<std::mutex> lock(mutex_);
+    cancelConversions();
 
     for (auto& elem : representations_) {
         if (elem.second.get() == representation) {
+            untrackRepresentation(representation);
             representations_.erase(elem.first);
             break;
         }
@@ -342,8 +571,12 @@ void Data<Self, Repr>::removeRepresentation(const Repr* representation) {
 template <typename Self, typename Repr>
 void Data<Self, Repr>::removeOtherRepresentations(const Repr* representation) {
     std::unique_lock<std::mutex> lock(mutex_);
+    cancelConversions();
 
     std::unordered_map<std::type_index, std::shared_ptr<Repr>> repr;
+    for (auto& elem : representations_) {
+        if (elem.second.get() != representation) untrackRepresentation(elem.second.get());
+    }
     for (auto& elem : representations_) {
         if (elem.second.get() == representation) {
             repr.insert(elem);
@@ -59,6 +59,20 @@ public:
     bool isValid() const;
     void setValid(bool valid);
 
+    /**
+     * The number of bytes of memory held by this representation. Representations reporting a
+     * size are tracked by the RepresentationMemoryManager, and might be evicted if they can be
+     * rebuilt from another representation.
+     */
+    virtual size_t getNumberOfBytes() const { return 0; }
+
+    /**
+     * Make sure the data of this representation is not shared with any other representation,
+     * copying it if needed. Called by Data::getEditableRepresentation before handing out the
+     * representation for editing.
+     */
+    virtual void makeUnique() {}
+
 protected:
     DataRepresentation() = default;
     DataRepresentation(const DataFormatBase* format);
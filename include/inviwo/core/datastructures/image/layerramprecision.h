@@ -31,11 +31,13 @@
 #define IVW_LAYERRAMPRECISION_H
 
 #include <inviwo/core/datastructures/image/layerram.h>
+#include <inviwo/core/datastructures/sharedstorage.h>
 
 namespace inviwo {
 
 /**
  * \ingroup datastructures	
+ * Copies and clones share the pixel data until one of them is modified, see VolumeRAMPrecision.
  */
 template <typename T>
 class LayerRAMPrecision : public LayerRAM {
@@ -47,10 +49,18 @@ public:
     LayerRAMPrecision(T* data, size2_t dimensions = size2_t(8, 8),
                       LayerType type = LayerType::Color,
                       const SwizzleMask& swizzleMask = swizzlemasks::rgba);
+    /**
+     * Use external memory without copying it. The representation will not delete the data,
+     * instead the owner is kept alive until the data is replaced or the representation is
+     * destroyed.
+     */
+    LayerRAMPrecision(T* data, size2_t dimensions, std::shared_ptr<void> owner,
+                      LayerType type = LayerType::Color,
+                      const SwizzleMask& swizzleMask = swizzlemasks::rgba);
     LayerRAMPrecision(const LayerRAMPrecision<T>& rhs);
     LayerRAMPrecision<T>& operator=(const LayerRAMPrecision<T>& that);
     virtual LayerRAMPrecision<T>* clone() const override;
-    virtual ~LayerRAMPrecision() = default;
+    virtual ~LayerRAMPrecision();
 
     T* getDataTyped();
     const T* getDataTyped() const;
@@ -58,6 +68,7 @@ public:
     virtual void* getData() override;
     virtual const void* getData() const override;
     virtual void setData(void* data, size2_t dimensions) override;
+    virtual void makeUnique() override;
 
     /**
      * Resize the representation to dimension. This is destructive, the data will not be
@@ -74,6 +85,8 @@ public:
     virtual void setSwizzleMask(const SwizzleMask &mask) override;
     virtual SwizzleMask getSwizzleMask() const override;
 
+    virtual size_t getNumberOfBytes() const override;
+
     virtual double getAsDouble(const size2_t& pos) const override;
     virtual dvec2 getAsDVec2(const size2_t& pos) const override;
     virtual dvec3 getAsDVec3(const size2_t& pos) const override;
@@ -95,7 +108,7 @@ public:
     virtual void setFromNormalizedDVec4(const size2_t& pos, dvec4 val) override;
 
 private:
-    std::unique_ptr<T[]> data_;
+    SharedStorage<T> data_;
     SwizzleMask swizzleMask_;
 };
 
@@ -116,32 +129,35 @@ template <typename T>
 LayerRAMPrecision<T>::LayerRAMPrecision(size2_t dimensions, LayerType type,
                                         const SwizzleMask& swizzleMask)
     : LayerRAM(dimensions, type, DataFormat<T>::get())
-    , data_(new T[dimensions_.x * dimensions_.y]())
+    , data_(dimensions_.x * dimensions_.y)
     , swizzleMask_(swizzleMask) {}
 
 template <typename T>
 LayerRAMPrecision<T>::LayerRAMPrecision(T* data, size2_t dimensions, LayerType type,
                                         const SwizzleMask& swizzleMask)
     : LayerRAM(dimensions, type, DataFormat<T>::get())
-    , data_(data ? data : new T[dimensions_.x * dimensions_.y]())
+    , data_(data, dimensions_.x * dimensions_.y)
     , swizzleMask_(swizzleMask) {}
 
+template <typename T>
+LayerRAMPrecision<T>::LayerRAMPrecision(T* data, size2_t dimensions, std::shared_ptr<void> owner,
+                                        LayerType type, const SwizzleMask& swizzleMask)
+    : LayerRAM(dimensions, type, DataFormat<T>::get())
+    , data_(data, dimensions_.x * dimensions_.y, std::move(owner))
+    , swizzleMask_(swizzleMask) {}
+
+template <typename T>
+LayerRAMPrecision<T>::~LayerRAMPrecision() = default;
+
 template <typename T>
 LayerRAMPrecision<T>::LayerRAMPrecision(const LayerRAMPrecision<T>& rhs)
-    : LayerRAM(rhs), data_(new T[dimensions_.x * dimensions_.y]), swizzleMask_(rhs.swizzleMask_) {
-    std::memcpy(data_.get(), rhs.data_.get(), dimensions_.x * dimensions_.y * sizeof(T));
-}
+    : LayerRAM(rhs), data_(rhs.data_), swizzleMask_(rhs.swizzleMask_) {}
 
 template <typename T>
 LayerRAMPrecision<T>& LayerRAMPrecision<T>::operator=(const LayerRAMPrecision<T>& that) {
     if (this != &that) {
         LayerRAM::operator=(that);
-
-        const auto dim = that.dimensions_;
-        auto data = util::make_unique<T[]>(dim.x * dim.y);
-        std::memcpy(data.get(), that.data_.get(), dim.x * dim.y * sizeof(T));
-        data_.swap(data);
-        
+        data_ = that.data_;
         dimensions_ = that.dimensions_;
         swizzleMask_ = that.swizzleMask_;
     }
@@ -155,37 +171,41 @@ LayerRAMPrecision<T>* LayerRAMPrecision<T>::clone() const {
 
 template <typename T>
 T* inviwo::LayerRAMPrecision<T>::getDataTyped() {
-    return data_.get();
+    data_.makeUnique();
+    return data_.data();
 }
 
 
 template <typename T>
 const T* inviwo::LayerRAMPrecision<T>::getDataTyped() const {
-    return data_.get();
+    return data_.data();
 }
 
 template <typename T>
 void* LayerRAMPrecision<T>::getData() {
-    return data_.get();
+    return getDataTyped();
 }
 template <typename T>
 const void* LayerRAMPrecision<T>::getData() const {
-    return const_cast<const T*>(data_.get());
+    return data_.data();
 }
 
 template <typename T>
 void inviwo::LayerRAMPrecision<T>::setData(void* d, size2_t dimensions) {
-    std::unique_ptr<T[]> data(static_cast<T*>(d));
-    data_.swap(data);
-    std::swap(dimensions_, dimensions);
+    data_ = SharedStorage<T>(static_cast<T*>(d), dimensions.x * dimensions.y);
+    dimensions_ = dimensions;
+}
+
+template <typename T>
+void LayerRAMPrecision<T>::makeUnique() {
+    data_.makeUnique();
 }
 
 template <typename T>
 void LayerRAMPrecision<T>::setDimensions(size2_t dimensions) {
     if (dimensions != dimensions_) {
-        auto data = util::make_unique<T[]>(dimensions.x * dimensions.y);
-        data_.swap(data);
-        std::swap(dimensions, dimensions_);
+        data_ = SharedStorage<T>(dimensions.x * dimensions.y);
+        dimensions_ = dimensions;
     }
     updateBaseMetaFromRepresentation();
 }
@@ -201,6 +221,11 @@ SwizzleMask LayerRAMPrecision<T>::getSwizzleMask() const {
     return swizzleMask_;
 }
 
+template <typename T>
+size_t LayerRAMPrecision<T>::getNumberOfBytes() const {
+    return dimensions_.x * dimensions_.y * sizeof(T);
+}
+
 template <typename T>
 double LayerRAMPrecision<T>::getAsDouble(const size2_t& pos) const {
     return util::glm_convert<double>(data_[posToIndex(pos, dimensions_)]);
@@ -223,22 +248,22 @@ dvec4 LayerRAMPrecision<T>::getAsDVec4(const size2_t& pos) const {
 
 template <typename T>
 void LayerRAMPrecision<T>::setFromDouble(const size2_t& pos, double val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
+    getDataTyped()[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
 }
 
 template <typename T>
 void LayerRAMPrecision<T>::setFromDVec2(const size2_t& pos, dvec2 val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
+    getDataTyped()[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
 }
 
 template <typename T>
 void LayerRAMPrecision<T>::setFromDVec3(const size2_t& pos, dvec3 val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
+    getDataTyped()[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
 }
 
 template <typename T>
 void LayerRAMPrecision<T>::setFromDVec4(const size2_t& pos, dvec4 val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
+    getDataTyped()[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
 }
 
 template <typename T>
@@ -263,22 +288,22 @@ dvec4 LayerRAMPrecision<T>::getAsNormalizedDVec4(const size2_t& pos) const {
 
 template <typename T>
 void LayerRAMPrecision<T>::setFromNormalizedDouble(const size2_t& pos, double val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
+    getDataTyped()[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
 }
 
 template <typename T>
 void LayerRAMPrecision<T>::setFromNormalizedDVec2(const size2_t& pos, dvec2 val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
+    getDataTyped()[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
 }
 
 template <typename T>
 void LayerRAMPrecision<T>::setFromNormalizedDVec3(const size2_t& pos, dvec3 val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
+    getDataTyped()[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
 }
 
 template <typename T>
 void LayerRAMPrecision<T>::setFromNormalizedDVec4(const size2_t& pos, dvec4 val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
+    getDataTyped()[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
 }
 
 }  // namespace
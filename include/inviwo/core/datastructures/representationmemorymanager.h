@@ -0,0 +1,170 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_REPRESENTATIONMEMORYMANAGER_H
+#define IVW_REPRESENTATIONMEMORYMANAGER_H
+
+#include <inviwo/core/common/inviwocoredefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/util/singleton.h>
+#include <inviwo/core/util/dispatcher.h>
+#include <inviwo/core/network/processornetworkevaluationobserver.h>
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace inviwo {
+
+/**
+ * \ingroup datastructures
+ * \class RepresentationMemoryManager
+ * \brief Keeps track of the memory held by representations and evicts the least recently used
+ * ones when a memory budget is exceeded.
+ * Data objects register their representations that report a size, see
+ * DataRepresentation::getNumberOfBytes, and mark them as used whenever they are retrieved. When
+ * the total size exceeds the budget, the least recently used representations that can be rebuilt
+ * from another valid representation of the same data object are removed, for example a VolumeRAM
+ * of a volume that is still available as a VolumeDisk.
+ *
+ * Eviction only happens after the network has been evaluated or when the budget is changed, and
+ * never while tasks are queued or running on the thread pool, since those might hold raw
+ * pointers to representations. Representations retrieved during the current or the last network
+ * evaluation are pinned, as are representations retrieved with getRepresentationShared, or
+ * otherwise referenced. Hence, code that keeps a representation for longer than that has to keep
+ * it by shared pointer.
+ */
+class IVW_CORE_API RepresentationMemoryManager : public Singleton<RepresentationMemoryManager>,
+                                                 public ProcessorNetworkEvaluationObserver {
+public:
+    /**
+     * Implemented by the data objects owning the representations.
+     */
+    class IVW_CORE_API Owner {
+    public:
+        virtual ~Owner() = default;
+        /**
+         * Remove the representation if it is not in use and can be rebuilt from another valid
+         * representation. Called while the manager is locked, must not call back into the manager.
+         * @return true if the representation was removed.
+         */
+        virtual bool evictRepresentation(const void* repr) = 0;
+    };
+
+    /**
+     * The use of a registered representation, updated by its owner without locking the manager.
+     */
+    struct Usage {
+        std::atomic<size_t> epoch{0};  //< the epoch in which the representation was last used
+        std::atomic<size_t> bytes{0};
+    };
+
+    RepresentationMemoryManager(size_t budget = size_t{8} * 1024 * 1024 * 1024);
+    RepresentationMemoryManager(RepresentationMemoryManager const&) = delete;
+    RepresentationMemoryManager& operator=(RepresentationMemoryManager const&) = delete;
+    virtual ~RepresentationMemoryManager() = default;
+
+    /**
+     * Register a representation, or update its size if already registered, and mark it as the
+     * most recently used. The returned usage can be passed to touch for later uses.
+     */
+    std::shared_ptr<Usage> use(Owner* owner, const void* repr, size_t bytes);
+    /**
+     * Mark a registered representation as used, and pin it until the network evaluation after the
+     * current one has ended. Does not lock the manager, called each time a representation is
+     * retrieved.
+     */
+    void touch(Usage& usage, size_t bytes) const {
+        usage.epoch.store(epoch_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        usage.bytes.store(bytes, std::memory_order_relaxed);
+    }
+    /**
+     * Unregister a representation, called by the owner when the representation is removed.
+     */
+    void remove(const void* repr);
+
+    /**
+     * Evict least recently used representations that are not pinned until the total size is
+     * within the budget. Does nothing while there are tasks on the thread pool. Has to be called
+     * from the main thread.
+     */
+    void evict();
+
+    /**
+     * Set the memory budget in bytes, will evict representations if needed.
+     */
+    void setBudget(size_t bytes);
+    size_t getBudget() const;
+    /**
+     * The number of bytes held by all registered representations.
+     */
+    size_t getSize() const;
+    size_t getNumberOfRepresentations() const;
+    /**
+     * The total number of bytes and representations evicted so far.
+     */
+    size_t getEvictedBytes() const;
+    size_t getNumberOfEvictions() const;
+
+    /**
+     * Register a callback that is called on the main thread after each eviction pass.
+     */
+    std::shared_ptr<std::function<void()>> onEvict(std::function<void()> callback);
+
+    /**
+     * Releases the pins of the representations last used in the evaluation before the one that
+     * ended, and evicts.
+     */
+    virtual void onProcessorNetworkEvaluationEnd() override;
+
+private:
+    struct Entry {
+        Owner* owner;
+        const void* repr;
+        std::shared_ptr<Usage> usage;
+    };
+    size_t computeSize() const;
+
+    mutable std::mutex mutex_;
+    std::list<Entry> lru_;  //< most recently registered or used first
+    std::unordered_map<const void*, std::list<Entry>::iterator> entries_;
+    std::atomic<size_t> epoch_;
+    size_t budget_;
+    size_t evictedBytes_;
+    size_t evictions_;
+    Dispatcher<void()> onEvict_;
+
+    friend Singleton<RepresentationMemoryManager>;
+    static RepresentationMemoryManager* instance_;
+};
+
+}  // namespace inviwo
+
+#endif  // IVW_REPRESENTATIONMEMORYMANAGER_H
@@ -0,0 +1,235 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_SHAREDSTORAGE_H
+#define IVW_SHAREDSTORAGE_H
+
+#include <inviwo/core/common/inviwocoredefine.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace inviwo {
+
+namespace util {
+
+/**
+ * Memory held by all SharedStorage objects. The logical size counts the elements of every storage
+ * object, i.e. memory shared between copies is counted once per copy. The physical size counts
+ * each distinct block of memory once.
+ */
+struct IVW_CORE_API SharedStorageMemory {
+    size_t logicalBytes;
+    size_t physicalBytes;
+};
+
+IVW_CORE_API SharedStorageMemory getSharedStorageMemory();
+
+}  // namespace util
+
+namespace detail {
+
+IVW_CORE_API void trackSharedStorageLogical(std::ptrdiff_t bytes);
+IVW_CORE_API void trackSharedStoragePhysical(std::ptrdiff_t bytes);
+
+}  // namespace detail
+
+/**
+ * \ingroup datastructures
+ * \brief Reference counted element storage with copy-on-write semantics.
+ *
+ * Copies of a SharedStorage refer to the same memory. Before writing to the elements, call
+ * makeUnique, which copies the elements if the memory is shared with another storage object.
+ * The RAM representations keep their data in a SharedStorage, so cloning a representation, and
+ * hence copying a Volume or Layer, does not copy the data until one of the copies is edited.
+ *
+ * @note A pointer obtained from data() before the storage was copied will write to the memory of
+ * both copies. Call makeUnique and get a new pointer after the storage might have been copied.
+ *
+ * @note Once makeUnique has found or made the memory unique, the result is cached until the
+ * storage is copied, such that calling makeUnique before every element write is cheap. The cache
+ * is cleared by copying, and the reference count is only a hint while another thread copies or
+ * destroys a storage sharing the memory. Hence, as for any other write, makeUnique must not run
+ * concurrently with copying the same storage object.
+ */
+template <typename T>
+class SharedStorage {
+public:
+    SharedStorage() = default;
+    /**
+     * Allocate size value-initialized elements.
+     */
+    explicit SharedStorage(size_t size);
+    /**
+     * Take ownership of data, which has to be allocated with new T[size], or be nullptr in which
+     * case size value-initialized elements are allocated.
+     */
+    SharedStorage(T* data, size_t size);
+    /**
+     * Use external memory without taking ownership. The owner, if given, is kept alive as long as
+     * any copy of the storage uses the memory.
+     */
+    SharedStorage(T* data, size_t size, std::shared_ptr<void> owner);
+
+    SharedStorage(const SharedStorage& rhs);
+    SharedStorage(SharedStorage&& rhs) noexcept;
+    SharedStorage& operator=(const SharedStorage& that);
+    SharedStorage& operator=(SharedStorage&& that) noexcept;
+    ~SharedStorage();
+
+    T* data() { return data_.get(); }
+    const T* data() const { return data_.get(); }
+    T& operator[](size_t i) { return data_.get()[i]; }
+    const T& operator[](size_t i) const { return data_.get()[i]; }
+    size_t size() const { return size_; }
+    size_t sizeInBytes() const { return data_ ? size_ * sizeof(T) : 0; }
+
+    /**
+     * True if the memory is shared with another storage object
+     */
+    bool isShared() const { return data_.use_count() > 1; }
+
+    /**
+     * Copy the elements into newly allocated memory if they are shared with another storage
+     * object. The copy is owned by this storage. Only checks the reference count for the first
+     * call after the storage was copied.
+     */
+    void makeUnique();
+
+    /**
+     * Do not delete the memory when the last storage object referring to it is destroyed.
+     * Affects all copies sharing the memory.
+     */
+    void releaseOwnership();
+
+private:
+    struct Deleter {
+        size_t bytes;
+        bool owns;
+        std::shared_ptr<void> owner;
+        void operator()(T* ptr) const {
+            detail::trackSharedStoragePhysical(-static_cast<std::ptrdiff_t>(bytes));
+            if (owns) delete[] ptr;
+        }
+    };
+
+    static std::shared_ptr<T> makePayload(T* data, size_t size, bool owns,
+                                          std::shared_ptr<void> owner);
+
+    std::shared_ptr<T> data_;
+    size_t size_ = 0;
+    // Set by makeUnique, cleared on both sides when copying. Copying only reads the source, hence
+    // several threads may copy the same storage and clear the flag concurrently.
+    mutable std::atomic<bool> unique_{false};
+};
+
+template <typename T>
+std::shared_ptr<T> SharedStorage<T>::makePayload(T* data, size_t size, bool owns,
+                                                 std::shared_ptr<void> owner) {
+    const auto bytes = size * sizeof(T);
+    detail::trackSharedStoragePhysical(static_cast<std::ptrdiff_t>(bytes));
+    detail::trackSharedStorageLogical(static_cast<std::ptrdiff_t>(bytes));
+    return std::shared_ptr<T>(data, Deleter{bytes, owns, std::move(owner)});
+}
+
+template <typename T>
+SharedStorage<T>::SharedStorage(size_t size)
+    : data_{makePayload(new T[size](), size, true, nullptr)}, size_{size} {}
+
+template <typename T>
+SharedStorage<T>::SharedStorage(T* data, size_t size)
+    : data_{makePayload(data ? data : new T[size](), size, true, nullptr)}, size_{size} {}
+
+template <typename T>
+SharedStorage<T>::SharedStorage(T* data, size_t size, std::shared_ptr<void> owner)
+    : data_{makePayload(data, size, false, std::move(owner))}, size_{size} {}
+
+template <typename T>
+SharedStorage<T>::SharedStorage(const SharedStorage& rhs) : data_{rhs.data_}, size_{rhs.size_} {
+    rhs.unique_.store(false, std::memory_order_relaxed);
+    detail::trackSharedStorageLogical(static_cast<std::ptrdiff_t>(sizeInBytes()));
+}
+
+template <typename T>
+SharedStorage<T>::SharedStorage(SharedStorage&& rhs) noexcept
+    : data_{std::move(rhs.data_)}
+    , size_{rhs.size_}
+    , unique_{rhs.unique_.load(std::memory_order_relaxed)} {
+    rhs.size_ = 0;
+    rhs.unique_.store(false, std::memory_order_relaxed);
+}
+
+template <typename T>
+SharedStorage<T>& SharedStorage<T>::operator=(const SharedStorage& that) {
+    if (this != &that) {
+        SharedStorage copy{that};
+        std::swap(data_, copy.data_);
+        std::swap(size_, copy.size_);
+        unique_.store(false, std::memory_order_relaxed);
+    }
+    return *this;
+}
+
+template <typename T>
+SharedStorage<T>& SharedStorage<T>::operator=(SharedStorage&& that) noexcept {
+    if (this != &that) {
+        SharedStorage tmp{std::move(that)};
+        std::swap(data_, tmp.data_);
+        std::swap(size_, tmp.size_);
+        unique_.store(tmp.unique_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    return *this;
+}
+
+template <typename T>
+SharedStorage<T>::~SharedStorage() {
+    detail::trackSharedStorageLogical(-static_cast<std::ptrdiff_t>(sizeInBytes()));
+}
+
+template <typename T>
+void SharedStorage<T>::makeUnique() {
+    if (unique_.load(std::memory_order_relaxed)) return;
+    if (isShared()) {
+        auto copy = new T[size_];
+        std::copy_n(data_.get(), size_, copy);
+        *this = SharedStorage{copy, size_};
+    }
+    unique_.store(true, std::memory_order_relaxed);
+}
+
+template <typename T>
+void SharedStorage<T>::releaseOwnership() {
+    if (auto deleter = std::get_deleter<Deleter>(data_)) deleter->owns = false;
+}
+
+}  // namespace inviwo
+
+#endif  // IVW_SHAREDSTORAGE_H
@@ -0,0 +1,126 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *********************************************************************************/
+
+#ifndef IVW_VOLUMEBRICKCACHE_H
+#define IVW_VOLUMEBRICKCACHE_H
+
+#include <inviwo/core/common/inviwocoredefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/util/singleton.h>
+
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <unordered_map>
+
+namespace inviwo {
+
+class VolumeRAM;
+
+/**
+ * \ingroup datastructures
+ * \class VolumeBrickCache
+ * \brief A process wide least recently used cache of volume bricks with a memory budget.
+ * Bricks are identified by the id of the VolumeBricked they belong to and the linear index of
+ * the brick. When the total size of all cached bricks exceeds the budget, the least recently used
+ * bricks are dropped from the cache. Bricks still referenced elsewhere stay alive until released.
+ * @see VolumeBricked
+ */
+class IVW_CORE_API VolumeBrickCache : public Singleton<VolumeBrickCache> {
+public:
+    using Loader = std::function<std::shared_ptr<const VolumeRAM>()>;
+
+    VolumeBrickCache(size_t budget = 1024 * 1024 * 1024);
+    VolumeBrickCache(VolumeBrickCache const&) = delete;
+    VolumeBrickCache& operator=(VolumeBrickCache const&) = delete;
+    virtual ~VolumeBrickCache() = default;
+
+    /**
+     * Return the brick from the cache, or use loader to load it and add it to the cache.
+     */
+    std::shared_ptr<const VolumeRAM> get(size_t volumeId, size_t brick, const Loader& loader);
+
+    /**
+     * Remove all bricks of the given volume from the cache.
+     */
+    void clear(size_t volumeId);
+    void clear();
+
+    /**
+     * Set the memory budget in bytes, will evict bricks if needed.
+     */
+    void setBudget(size_t bytes);
+    size_t getBudget() const;
+    /**
+     * The number of bytes currently held by the cache.
+     */
+    size_t getSize() const;
+
+    /**
+     * Get a new unique id for a bricked volume.
+     */
+    static size_t newVolumeId();
+
+private:
+    struct Key {
+        size_t volume;
+        size_t brick;
+        bool operator==(const Key& rhs) const {
+            return volume == rhs.volume && brick == rhs.brick;
+        }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return std::hash<size_t>{}(key.volume) ^ (std::hash<size_t>{}(key.brick) << 1);
+        }
+    };
+    struct Entry {
+        Key key;
+        std::shared_ptr<const VolumeRAM> brick;
+        size_t bytes;
+    };
+
+    void evict();  // mutex_ has to be locked.
+
+    mutable std::mutex mutex_;
+    std::list<Entry> lru_;  //< most recently used first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> entries_;
+    size_t budget_;
+    size_t size_;
+
+    static std::atomic<size_t> volumeIdCounter_;
+
+    friend Singleton<VolumeBrickCache>;
+    static VolumeBrickCache* instance_;
+};
+
+}  // namespace inviwo
+
+#endif  // IVW_VOLUMEBRICKCACHE_H
@@ -0,0 +1,162 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *********************************************************************************/
+
+#ifndef IVW_VOLUMEBRICKED_H
+#define IVW_VOLUMEBRICKED_H
+
+#include <inviwo/core/common/inviwocoredefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/volume/volumerepresentation.h>
+#include <inviwo/core/datastructures/diskrepresentation.h>
+
+namespace inviwo {
+
+class Volume;
+class VolumeRAM;
+class VolumeRegionLoader;
+
+/**
+ * \ingroup datastructures
+ * \class VolumeBricked
+ * \brief An out-of-core volume representation that loads the volume in bricks on demand.
+ * The volume is divided into bricks of getBrickSize() voxels, and each brick is read from disk
+ * using a VolumeRegionLoader the first time it is accessed. Loaded bricks are kept in the
+ * VolumeBrickCache, which drops the least recently used bricks when its memory budget is
+ * exceeded. Each brick is padded with getGhostBorder() voxels from its neighbors, clamped to the
+ * volume, such that filters and interpolation close to the brick borders can be evaluated within
+ * a single brick.
+ *
+ * Use util::getBrickedRepresentation to get a VolumeBricked for a Volume when one is available.
+ * @see VolumeBrickCache, VolumeRegionLoader
+ */
+class IVW_CORE_API VolumeBricked : public VolumeRepresentation {
+public:
+    /**
+     * @param loader A loader that also implements VolumeRegionLoader, will be cloned.
+     * @param dimensions of the volume.
+     * @param format of the volume.
+     * @param brickSize number of voxels in each brick, not counting the ghost border.
+     * @param ghostBorder number of extra voxels to add on each side of every brick. Sampling
+     * with interpolation across brick borders needs at least 1, volumes with a ghost border of 0
+     * are sampled from their RAM representation instead.
+     */
+    VolumeBricked(const DiskRepresentationLoader<VolumeRepresentation>& loader,
+                  size3_t dimensions, const DataFormatBase* format,
+                  size3_t brickSize = size3_t(64), size_t ghostBorder = 1);
+    VolumeBricked(const VolumeBricked& rhs) = default;
+    VolumeBricked& operator=(const VolumeBricked& that) = default;
+    virtual VolumeBricked* clone() const override;
+    virtual ~VolumeBricked() = default;
+
+    virtual std::type_index getTypeIndex() const override final;
+
+    virtual void setDimensions(size3_t dimensions) override;
+    virtual const size3_t& getDimensions() const override;
+
+    const size3_t& getBrickSize() const;
+    size_t getGhostBorder() const;
+    /**
+     * The number of bricks along each axis.
+     */
+    size3_t getBrickCount() const;
+    /**
+     * The index of the brick containing the voxel at pos.
+     */
+    size3_t getBrickIndex(const size3_t& pos) const;
+
+    /**
+     * Get the data of a brick, including the ghost border. Loads the brick if it is not in the
+     * cache.
+     * @param brick index of the brick, less than getBrickCount().
+     */
+    std::shared_ptr<const VolumeRAM> getBrick(const size3_t& brick) const;
+    /**
+     * The position in the volume of the first voxel of the data returned by getBrick.
+     */
+    size3_t getBrickDataOffset(const size3_t& brick) const;
+    /**
+     * The dimensions of the data returned by getBrick.
+     */
+    size3_t getBrickDataDimensions(const size3_t& brick) const;
+
+    /**
+     * Copy the voxels in [offset, offset + dimensions) into a new VolumeRAM, only the bricks
+     * intersecting the region are loaded.
+     */
+    std::shared_ptr<VolumeRAM> getRegion(const size3_t& offset, const size3_t& dimensions) const;
+    /**
+     * Copy the voxels in [offset, offset + dimensions) into dest, tightly packed in x, y, z order.
+     */
+    void readRegion(const size3_t& offset, const size3_t& dimensions, void* dest) const;
+
+    const DiskRepresentationLoader<VolumeRepresentation>& getLoader() const;
+
+    /**
+     * Identifies the bricks of this volume in the VolumeBrickCache, shared by all copies.
+     * Identifiers are never reused.
+     */
+    size_t getCacheId() const;
+
+private:
+    // Bricks in the cache are removed when the last copy of this volume is destroyed
+    struct CacheHandle {
+        CacheHandle();
+        ~CacheHandle();
+        const size_t id;
+    };
+
+    std::shared_ptr<const DiskRepresentationLoader<VolumeRepresentation>> loader_;
+    const VolumeRegionLoader* regionLoader_;
+    size3_t dimensions_;
+    size3_t brickSize_;
+    size_t ghostBorder_;
+    std::shared_ptr<const CacheHandle> cache_;
+};
+
+namespace util {
+
+/**
+ * Get a bricked representation of volume if it can be loaded in bricks, i.e. if it is backed by
+ * a disk representation with a VolumeRegionLoader and has no RAM representation. Returns nullptr
+ * otherwise, in which case getRepresentation<VolumeRAM>() should be used.
+ */
+IVW_CORE_API const VolumeBricked* getBrickedRepresentation(const Volume& volume);
+
+/**
+ * Get a bricked representation of volume as getBrickedRepresentation, but only if the volume does
+ * not fit in the representation memory budget. Volumes that fit are read to RAM once instead of
+ * brick by brick. Returns nullptr otherwise.
+ */
+IVW_CORE_API const VolumeBricked* getBrickedRepresentationOverBudget(const Volume& volume);
+
+}  // namespace util
+
+}  // namespace inviwo
+
+#endif  // IVW_VOLUMEBRICKED_H
@@ -37,6 +37,23 @@
 
 namespace inviwo {
 
+/**
+ * \ingroup datastructures
+ * Interface for volume DiskRepresentationLoaders that can read a sub region of the volume without
+ * loading all of it.
+ * @see VolumeBricked
+ */
+class IVW_CORE_API VolumeRegionLoader {
+public:
+    virtual ~VolumeRegionLoader() = default;
+    /**
+     * Read the voxels in [offset, offset + dimensions) into dest. The voxels are tightly packed in
+     * dest, in x, y, z order, using the data format of the volume.
+     */
+    virtual void readRegion(const size3_t& offset, const size3_t& dimensions,
+                            void* dest) const = 0;
+};
+
 /**
  * \ingroup datastructures	
  */
@@ -71,7 +71,14 @@ public:
 
     virtual const HistogramContainer* getHistograms(size_t bins = 2048u,
                                                     size3_t sampleRate = size3_t(1)) const = 0;
-    virtual void calculateHistograms(size_t bins, size3_t sampleRate, const bool& stop) const = 0;
+    /**
+     * Calculate the histograms of the volume, aborting if stop is set to true. An aborted
+     * calculation does not store any histograms. If progress is given, it is called with a coarse
+     * approximation of the histograms before the final ones are calculated.
+     */
+    virtual void calculateHistograms(
+        size_t bins, size3_t sampleRate, const bool& stop,
+        std::function<void(const HistogramContainer&)> progress = nullptr) const = 0;
 
     // uniform getters and setters
     virtual double getAsDouble(const size3_t& pos) const = 0;
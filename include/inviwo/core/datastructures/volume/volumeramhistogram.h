@@ -31,22 +31,150 @@
 #define IVW_VOLUMERAMHISTOGRAM_H
 
 #include <inviwo/core/datastructures/histogram.h>
-#include <inviwo/core/util/indexmapper.h>
+#include <inviwo/core/util/glm.h>
+#include <inviwo/core/util/foreach.h>
+
+#include <cmath>
+#include <vector>
+#include <functional>
+#include <algorithm>
+
 namespace inviwo {
 
 namespace util {
 
+namespace detail {
+
+/**
+ * Statistics and bin counts of a part of a volume. Each thread fills its own chunk, and the
+ * chunks are merged when all threads are done.
+ */
+template <typename D>
+struct HistogramChunk {
+    HistogramChunk(size_t extent, size_t bins)
+        : min(std::numeric_limits<double>::max())
+        , max(std::numeric_limits<double>::lowest())
+        , sum(0)
+        , sum2(0)
+        , count(0)
+        , counts(extent * bins, 0) {}
+
+    void merge(const HistogramChunk& rhs) {
+        min = glm::min(min, rhs.min);
+        max = glm::max(max, rhs.max);
+        sum += rhs.sum;
+        sum2 += rhs.sum2;
+        count += rhs.count;
+        std::transform(counts.begin(), counts.end(), rhs.counts.begin(), counts.begin(),
+                       std::plus<size_t>());
+    }
+
+    D min;
+    D max;
+    D sum;
+    D sum2;
+    size_t count;
+    std::vector<size_t> counts;  //< the bins of component i starts at i * bins
+};
+
+/**
+ * Add n values, stride elements apart, to the min, max, sum and sum of squares of chunk.
+ * Uses independent accumulators such that the compiler can vectorize the loop.
+ */
+template <typename T, typename D>
+void accumulateStats(const T* data, size_t n, size_t stride, HistogramChunk<D>& chunk) {
+    constexpr size_t lanes = 4;
+    D mins[lanes], maxs[lanes], sums[lanes], sums2[lanes];
+    for (size_t l = 0; l < lanes; ++l) {
+        mins[l] = chunk.min;
+        maxs[l] = chunk.max;
+        sums[l] = D(0);
+        sums2[l] = D(0);
+    }
+
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        for (size_t l = 0; l < lanes; ++l) {
+            const D val = static_cast<D>(data[(i + l) * stride]);
+            mins[l] = glm::min(mins[l], val);
+            maxs[l] = glm::max(maxs[l], val);
+            sums[l] += val;
+            sums2[l] += val * val;
+        }
+    }
+    for (; i < n; ++i) {
+        const D val = static_cast<D>(data[i * stride]);
+        mins[0] = glm::min(mins[0], val);
+        maxs[0] = glm::max(maxs[0], val);
+        sums[0] += val;
+        sums2[0] += val * val;
+    }
+
+    for (size_t l = 0; l < lanes; ++l) {
+        chunk.min = glm::min(chunk.min, mins[l]);
+        chunk.max = glm::max(chunk.max, maxs[l]);
+        chunk.sum += sums[l];
+        chunk.sum2 += sums2[l];
+    }
+    chunk.count += n;
+}
+
+/**
+ * Add n values, stride elements apart, to the bin counts of chunk.
+ */
+template <typename T, typename D>
+void accumulateBins(const T* data, size_t n, size_t stride, const D& rangeMin,
+                    const D& rangeScaleFactor, size_t bins, HistogramChunk<D>& chunk) {
+    const size_t extent = util::rank<T>::value > 0 ? util::extent<T>::value : 1;
+    const double maxBin = static_cast<double>(bins);
+
+    for (size_t i = 0; i < n; ++i) {
+        const D pos = (static_cast<D>(data[i * stride]) - rangeMin) * rangeScaleFactor;
+        for (size_t c = 0; c < extent; ++c) {
+            // values in (-1, 0) are truncated into the first bin
+            const double bin = util::glmcomp(pos, c);
+            if (bin > -1.0 && bin < maxBin) {
+                ++chunk.counts[c * bins + static_cast<size_t>(bin)];
+            }
+        }
+    }
+}
+
+}  // namespace detail
+
+/**
+ * Calculate a histogram for each component of the volume data, using only every sampleRate voxel.
+ * The volume is split into chunks of rows that are processed in parallel in the thread pool, each
+ * into its own bins, which are merged at the end. If stop is set to true during the calculation,
+ * the calculation is aborted and an empty HistogramContainer is returned.
+ *
+ * If a progress callback is given, a coarse histogram using about 64^3 samples is calculated and
+ * passed to the callback before the full calculation is started. This lets a user interface show
+ * an approximate histogram while waiting for the final result.
+ */
 template <typename T>
-HistogramContainer calculateVolumeHistogram(const T* data, size3_t dimensions, dvec2 dataRange,
-                                            const bool& stop = false, size_t bins = 2048,
-                                            size3_t sampleRate = size3_t(1)) {
+HistogramContainer calculateVolumeHistogram(
+    const T* data, size3_t dimensions, dvec2 dataRange, const bool& stop = false,
+    size_t bins = 2048, size3_t sampleRate = size3_t(1),
+    const std::function<void(const HistogramContainer&)>& progress = nullptr) {
     // a double type with the same extent as T
     typedef typename util::same_extent<T, double>::type D;
-    // a size_t type with same extent as T
-    typedef typename util::same_extent<T, size_t>::type I;
-    
+
     const size_t extent = util::rank<T>::value > 0 ? util::extent<T>::value : 1;
-    
+    sampleRate = glm::max(sampleRate, size3_t(1));
+
+    if (progress) {
+        const size3_t samples = (dimensions + sampleRate - size3_t(1)) / sampleRate;
+        const double total = static_cast<double>(samples.x * samples.y * samples.z);
+        const auto coarse = static_cast<size_t>(std::ceil(std::cbrt(total / (64.0 * 64.0 * 64.0))));
+        if (coarse > 1) {
+            auto coarseHistograms = calculateVolumeHistogram(data, dimensions, dataRange, stop,
+                                                             bins, sampleRate * coarse);
+            if (stop) return HistogramContainer{};
+            progress(coarseHistograms);
+        }
+    }
+
     // check whether number of bins exceeds the data range only if it is an integral type
     if (!util::is_floating_point<T>::value) {
         bins = std::min(bins, static_cast<std::size_t>(dataRange.y - dataRange.x + 1));
@@ -57,56 +185,52 @@ HistogramContainer calculateVolumeHistogram(const T* data, size3_t dimensions, d
         histograms.add(new NormalizedHistogram(bins));
     }
 
-    D min(std::numeric_limits<double>::max());
-    D max(std::numeric_limits<double>::lowest());
-    D sum(0);
-    D sum2(0);
-    double count(0);
-
-    D val;
-    I ind;
-    size_t v;
-
     const D rangeMin(dataRange.x);
     const D rangeScaleFactor(static_cast<double>(bins - 1) / (dataRange.y - dataRange.x));
 
-    util::IndexMapper3D mapper(dimensions);
-
-    size3_t pos(0);
-    // Column major data, so x is the fastest index.
-    for (pos.z = 0; pos.z < dimensions.z; pos.z += sampleRate.z) {
-        for (pos.y = 0; pos.y < dimensions.y; pos.y += sampleRate.y) {
-            for (pos.x = 0; pos.x < dimensions.x; pos.x += sampleRate.x) {
-                if (stop) return histograms;
-
-                val = static_cast<D>(data[mapper(pos)]);
-
-                min = glm::min(min, val);
-                max = glm::max(max, val);
-                sum += val;
-                sum2 += val * val;
-                count++;
-
-                ind = static_cast<I>((val - rangeMin) * rangeScaleFactor);
-
-                for (size_t i = 0; i < extent; ++i) {
-                    v = util::glmcomp(ind, i);
-                    if (v < bins) {
-                        histograms[i][v]++;
-                    } 
-                }
-            }
+    // Column major data, so x is the fastest index. Each sampled row along x is one unit of work.
+    const size_t rowLength = (dimensions.x + sampleRate.x - 1) / sampleRate.x;
+    const size_t rowsY = (dimensions.y + sampleRate.y - 1) / sampleRate.y;
+    const size_t rows = rowsY * ((dimensions.z + sampleRate.z - 1) / sampleRate.z);
+
+    const auto process = [&](size_t begin, size_t end) {
+        detail::HistogramChunk<D> chunk(extent, bins);
+        for (size_t row = begin; row < end && !stop; ++row) {
+            const size_t y = (row % rowsY) * sampleRate.y;
+            const size_t z = (row / rowsY) * sampleRate.z;
+            const T* rowData = data + (z * dimensions.y + y) * dimensions.x;
+            detail::accumulateStats(rowData, rowLength, sampleRate.x, chunk);
+            detail::accumulateBins(rowData, rowLength, sampleRate.x, rangeMin, rangeScaleFactor,
+                                   bins, chunk);
         }
-    }
-
+        return chunk;
+    };
+
+    // Avoid ranges with very few voxels, each range gets its own partial histogram
+    const size_t minRows = std::max(size_t{1}, (64 * 1024) / std::max(size_t{1}, rowLength));
+    const size_t ranges = util::parallelRangeCount(rows, minRows);
+    std::vector<detail::HistogramChunk<D>> chunks(ranges, detail::HistogramChunk<D>(extent, bins));
+    util::forEachRangeParallelN(rows, ranges, [&](size_t begin, size_t end, size_t range) {
+        chunks[range] = process(begin, end);
+    });
+    if (stop) return HistogramContainer{};
+
+    detail::HistogramChunk<D> result(extent, bins);
+    for (const auto& chunk : chunks) result.merge(chunk);
+
+    const double count = static_cast<double>(result.count);
     for (size_t i = 0; i < extent; ++i) {
+        for (size_t bin = 0; bin < bins; ++bin) {
+            histograms[i][bin] = static_cast<double>(result.counts[i * bins + bin]);
+        }
         histograms[i].dataRange_ = dataRange;
-        histograms[i].stats_.min = util::glmcomp(min, i);
-        histograms[i].stats_.max = util::glmcomp(max, i);
-        histograms[i].stats_.mean = util::glmcomp(sum, i) / count;
-        histograms[i].stats_.standardDeviation = std::sqrt(
-            (count * util::glmcomp(sum2, i) - util::glmcomp(sum, i) * util::glmcomp(sum, i)) /
-            (count * (count - 1)));
+        histograms[i].stats_.min = util::glmcomp(result.min, i);
+        histograms[i].stats_.max = util::glmcomp(result.max, i);
+        histograms[i].stats_.mean = util::glmcomp(result.sum, i) / count;
+        histograms[i].stats_.standardDeviation =
+            std::sqrt((count * util::glmcomp(result.sum2, i) -
+                       util::glmcomp(result.sum, i) * util::glmcomp(result.sum, i)) /
+                      (count * (count - 1)));
 
         histograms[i].calculatePercentiles();
         histograms[i].performNormalization();
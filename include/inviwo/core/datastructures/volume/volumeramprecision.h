@@ -32,6 +32,7 @@
 
 #include <inviwo/core/datastructures/volume/volumeram.h>
 #include <inviwo/core/datastructures/volume/volumeramhistogram.h>
+#include <inviwo/core/datastructures/sharedstorage.h>
 #include <inviwo/core/util/glm.h>
 #include <inviwo/core/util/stdextensions.h>
 #include <inviwo/core/datastructures/volume/volume.h>
@@ -40,6 +41,11 @@ namespace inviwo {
 
 /**
  * \ingroup datastructures
+ * Copies and clones share the voxel data until one of them is modified. All non-const data
+ * accessors first make the data unique to the representation, hence use the const accessors
+ * when only reading. Uniqueness is only resolved once after each copy, so the per voxel setters
+ * do not check the reference count for every voxel. As for any write, the setters must not be
+ * called while another thread clones the same representation.
  */
 template <typename T>
 class VolumeRAMPrecision : public VolumeRAM {
@@ -48,6 +54,12 @@ public:
 
     VolumeRAMPrecision(size3_t dimensions = size3_t(128, 128, 128));
     VolumeRAMPrecision(T* data, size3_t dimensions = size3_t(128, 128, 128));
+    /**
+     * Use external memory without copying it. The representation will not delete the data,
+     * instead the owner is kept alive until the data is replaced or the representation is
+     * destroyed.
+     */
+    VolumeRAMPrecision(T* data, size3_t dimensions, std::shared_ptr<void> owner);
     VolumeRAMPrecision(const VolumeRAMPrecision<T>& rhs);
     VolumeRAMPrecision<T>& operator=(const VolumeRAMPrecision<T>& that);
     virtual VolumeRAMPrecision<T>* clone() const override;
@@ -65,6 +77,7 @@ public:
     virtual void setData(void* data, size3_t dimensions) override;
 
     virtual void removeDataOwnership() override;
+    virtual void makeUnique() override;
 
     virtual const size3_t& getDimensions() const override;
     virtual void setDimensions(size3_t dimensions) override;
@@ -74,8 +87,9 @@ public:
                                               size3_t sampleRate = size3_t(1)) override;
     virtual const HistogramContainer* getHistograms(size_t bins = 2048u,
                                                     size3_t sampleRate = size3_t(1)) const override;
-    virtual void calculateHistograms(size_t bins, size3_t sampleRate,
-                                     const bool& stop) const override;
+    virtual void calculateHistograms(
+        size_t bins, size3_t sampleRate, const bool& stop,
+        std::function<void(const HistogramContainer&)> progress = nullptr) const override;
 
     virtual double getAsDouble(const size3_t& pos) const override;
     virtual dvec2 getAsDVec2(const size3_t& pos) const override;
@@ -104,8 +118,7 @@ public:
 
 private:
     size3_t dimensions_;
-    bool ownsDataPtr_;
-    std::unique_ptr<T[]> data_;
+    SharedStorage<T> data_;
     mutable HistogramContainer histCont_;
 };
 
@@ -126,44 +139,37 @@ template <typename T>
 VolumeRAMPrecision<T>::VolumeRAMPrecision(size3_t dimensions)
     : VolumeRAM(DataFormat<T>::get())
     , dimensions_(dimensions)
-    , ownsDataPtr_(true)
-    , data_(new T[dimensions_.x * dimensions_.y * dimensions_.z]()) {}
+    , data_(dimensions_.x * dimensions_.y * dimensions_.z) {}
 
 template <typename T>
 VolumeRAMPrecision<T>::VolumeRAMPrecision(T* data, size3_t dimensions)
     : VolumeRAM(DataFormat<T>::get())
     , dimensions_(dimensions)
-    , ownsDataPtr_(true)
-    , data_(data ? data : new T[dimensions_.x * dimensions_.y * dimensions_.z]()) {}
+    , data_(data, dimensions_.x * dimensions_.y * dimensions_.z) {}
+
+template <typename T>
+VolumeRAMPrecision<T>::VolumeRAMPrecision(T* data, size3_t dimensions,
+                                          std::shared_ptr<void> owner)
+    : VolumeRAM(DataFormat<T>::get())
+    , dimensions_(dimensions)
+    , data_(data, dimensions_.x * dimensions_.y * dimensions_.z, std::move(owner)) {}
 
 template <typename T>
 VolumeRAMPrecision<T>::VolumeRAMPrecision(const VolumeRAMPrecision<T>& rhs)
-    : VolumeRAM(rhs)
-    , dimensions_(rhs.dimensions_)
-    , ownsDataPtr_(true)
-    , data_(new T[dimensions_.x * dimensions_.y * dimensions_.z]) {
-    std::memcpy(data_.get(), rhs.data_.get(),
-                dimensions_.x * dimensions_.y * dimensions_.z * sizeof(T));
-}
+    : VolumeRAM(rhs), dimensions_(rhs.dimensions_), data_(rhs.data_) {}
 
 template <typename T>
 VolumeRAMPrecision<T>& VolumeRAMPrecision<T>::operator=(const VolumeRAMPrecision<T>& that) {
     if (this != &that) {
         VolumeRAM::operator=(that);
-        auto dim = that.dimensions_;
-        auto data = util::make_unique<T[]>(dim.x * dim.y * dim.z);
-        std::memcpy(data.get(), that.data_.get(), dim.x * dim.y * dim.z * sizeof(T));
-        data_.swap(data);
-        std::swap(dim, dimensions_);
-        ownsDataPtr_ = true;
+        data_ = that.data_;
+        dimensions_ = that.dimensions_;
     }
     return *this;
 }
 
 template <typename T>
-VolumeRAMPrecision<T>::~VolumeRAMPrecision() {
-    if (!ownsDataPtr_) data_.release();
-}
+VolumeRAMPrecision<T>::~VolumeRAMPrecision() = default;
 
 template <typename T>
 VolumeRAMPrecision<T>* VolumeRAMPrecision<T>::clone() const {
@@ -172,46 +178,48 @@ VolumeRAMPrecision<T>* VolumeRAMPrecision<T>::clone() const {
 
 template <typename T>
 const T* inviwo::VolumeRAMPrecision<T>::getDataTyped() const {
-    return data_.get();
+    return data_.data();
 }
 
 template <typename T>
 T* inviwo::VolumeRAMPrecision<T>::getDataTyped() {
-    return data_.get();
+    data_.makeUnique();
+    return data_.data();
 }
 
 template <typename T>
 void* VolumeRAMPrecision<T>::getData() {
-    return data_.get();
+    return getDataTyped();
 }
 template <typename T>
 const void* VolumeRAMPrecision<T>::getData() const {
-    return const_cast<const T*>(data_.get());
+    return data_.data();
 }
 
 template <typename T>
 void* VolumeRAMPrecision<T>::getData(size_t pos) {
-    return data_.get() + pos;
+    return getDataTyped() + pos;
 }
 
 template <typename T>
 const void* VolumeRAMPrecision<T>::getData(size_t pos) const {
-    return const_cast<const T*>(data_.get()) + pos;
+    return data_.data() + pos;
 }
 
 template <typename T>
 void VolumeRAMPrecision<T>::setData(void* d, size3_t dimensions) {
-    std::unique_ptr<T[]> data(static_cast<T*>(d));
-    data_.swap(data);
-    std::swap(dimensions_, dimensions);
-
-    if (!ownsDataPtr_) data.release();
-    ownsDataPtr_ = true;
+    data_ = SharedStorage<T>(static_cast<T*>(d), dimensions.x * dimensions.y * dimensions.z);
+    dimensions_ = dimensions;
 }
 
 template <typename T>
 void VolumeRAMPrecision<T>::removeDataOwnership() {
-    ownsDataPtr_ = false;
+    data_.releaseOwnership();
+}
+
+template <typename T>
+void VolumeRAMPrecision<T>::makeUnique() {
+    data_.makeUnique();
 }
 
 template <typename T>
@@ -226,11 +234,8 @@ size_t VolumeRAMPrecision<T>::getNumberOfBytes() const {
 
 template <typename T>
 void VolumeRAMPrecision<T>::setDimensions(size3_t dimensions) {
-    auto data = util::make_unique<T[]>(dimensions.x * dimensions.y * dimensions.z);
-    data_.swap(data);
+    data_ = SharedStorage<T>(dimensions.x * dimensions.y * dimensions.z);
     dimensions_ = dimensions;
-    if (!ownsDataPtr_) data.release();
-    ownsDataPtr_ = true;
 }
 
 template <typename T>
@@ -255,22 +260,22 @@ dvec4 VolumeRAMPrecision<T>::getAsDVec4(const size3_t& pos) const {
 
 template <typename T>
 void VolumeRAMPrecision<T>::setFromDouble(const size3_t& pos, double val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
+    getDataTyped()[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
 }
 
 template <typename T>
 void VolumeRAMPrecision<T>::setFromDVec2(const size3_t& pos, dvec2 val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
+    getDataTyped()[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
 }
 
 template <typename T>
 void VolumeRAMPrecision<T>::setFromDVec3(const size3_t& pos, dvec3 val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
+    getDataTyped()[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
 }
 
 template <typename T>
 void VolumeRAMPrecision<T>::setFromDVec4(const size3_t& pos, dvec4 val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
+    getDataTyped()[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
 }
 
 template <typename T>
@@ -295,28 +300,29 @@ dvec4 VolumeRAMPrecision<T>::getAsNormalizedDVec4(const size3_t& pos) const {
 
 template <typename T>
 void VolumeRAMPrecision<T>::setFromNormalizedDouble(const size3_t& pos, double val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
+    getDataTyped()[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
 }
 
 template <typename T>
 void VolumeRAMPrecision<T>::setFromNormalizedDVec2(const size3_t& pos, dvec2 val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
+    getDataTyped()[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
 }
 
 template <typename T>
 void VolumeRAMPrecision<T>::setFromNormalizedDVec3(const size3_t& pos, dvec3 val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
+    getDataTyped()[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
 }
 
 template <typename T>
 void VolumeRAMPrecision<T>::setFromNormalizedDVec4(const size3_t& pos, dvec4 val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
+    getDataTyped()[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
 }
 
 template <typename T>
 void VolumeRAMPrecision<T>::setValuesFromVolume(const VolumeRAM* src, const size3_t& dstOffset,
                                                 const size3_t& subSize, const size3_t& subOffset) {
     const T* srcData = reinterpret_cast<const T*>(src->getData());
+    T* dstData = getDataTyped();
 
     size_t initialStartPos = (dstOffset.z * (dimensions_.x * dimensions_.y)) +
                              (dstOffset.y * dimensions_.x) + dstOffset.x;
@@ -334,7 +340,7 @@ void VolumeRAMPrecision<T>::setValuesFromVolume(const VolumeRAM* src, const size
         volumePos = (y * dimensions_.x) + (z * dimensions_.x * dimensions_.y);
         subVolumePos = ((y + subOffset.y) * srcDims.x) +
                        ((z + subOffset.z) * srcDims.x * srcDims.y) + subOffset.x;
-        std::memcpy((data_.get() + volumePos + initialStartPos), (srcData + subVolumePos),
+        std::memcpy((dstData + volumePos + initialStartPos), (srcData + subVolumePos),
                     dataSize);
     }
 }
@@ -361,12 +367,15 @@ HistogramContainer* VolumeRAMPrecision<T>::getHistograms(size_t bins, size3_t sa
 }
 
 template <typename T>
-void VolumeRAMPrecision<T>::calculateHistograms(size_t bins, size3_t sampleRate,
-                                                const bool& stop) const {
+void VolumeRAMPrecision<T>::calculateHistograms(
+    size_t bins, size3_t sampleRate, const bool& stop,
+    std::function<void(const HistogramContainer&)> progress) const {
     if (const auto volume = getOwner()) {
         dvec2 dataRange = volume->dataMap_.dataRange;
-        histCont_ = util::calculateVolumeHistogram(data_.get(), dimensions_, dataRange, stop, bins,
-                                                   sampleRate);
+        auto histograms = util::calculateVolumeHistogram(data_.data(), dimensions_, dataRange,
+                                                         stop, bins, sampleRate, progress);
+        // An aborted calculation returns no histograms, keep the previous ones
+        if (!histograms.empty()) histCont_ = std::move(histograms);
     }
 }
 
@@ -37,8 +37,19 @@ namespace inviwo {
 
 namespace util {
 
+/**
+ * Read bytes from file, starting at offset, into dest. If the data is not little endian each
+ * component of elementSize bytes will be byte swapped.
+ * @note elementSize should be the size of a single component, i.e. 4 for a vec3 of floats.
+ */
 void IVW_CORE_API readBytesIntoBuffer(const std::string& file, size_t offset, size_t bytes,
                                       bool littleEndian, size_t elementSize, void* dest);
+
+/**
+ * Reverse the byte order of each element of elementSize bytes in data.
+ */
+void IVW_CORE_API swapBytes(void* data, size_t bytes, size_t elementSize);
+
 }  // namespace
 
 }  // namespace
@@ -0,0 +1,88 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *********************************************************************************/
+
+#ifndef IVW_MEMORYMAPPEDFILE_H
+#define IVW_MEMORYMAPPEDFILE_H
+
+#include <inviwo/core/common/inviwocoredefine.h>
+#include <inviwo/core/common/inviwo.h>
+
+#include <string>
+
+namespace inviwo {
+
+namespace util {
+
+/**
+ * \class MemoryMappedFile
+ * \brief RAII interface for a private, copy-on-write, memory mapping of a part of a file.
+ * The pages of the file are read on demand by the operating system when first accessed, and
+ * are shared with all other mappings of the same file until written to. Writes are never
+ * propagated back to the file.
+ */
+class IVW_CORE_API MemoryMappedFile {
+public:
+    /**
+     * Map bytes number of bytes starting at offset of the file.
+     * @throws FileException if the file could not be opened or mapped.
+     */
+    MemoryMappedFile(const std::string& filename, size_t offset, size_t bytes);
+
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+    MemoryMappedFile(MemoryMappedFile&& rhs);
+    MemoryMappedFile& operator=(MemoryMappedFile&& rhs);
+
+    ~MemoryMappedFile();
+
+    /**
+     * Pointer to the first mapped byte, i.e. the byte at offset in the file.
+     */
+    void* getData();
+    const void* getData() const;
+    size_t getSize() const;
+
+    const std::string& getFileName() const;
+
+private:
+    void cleanup();
+
+    std::string filename_;
+    void* mapping_;      //< start of the mapping, aligned to the allocation granularity
+    size_t mappingSize_;
+    size_t offset_;      //< offset of the requested data into the mapping
+    size_t size_;
+};
+
+}  // namespace util
+
+}  // namespace inviwo
+
+#endif  // IVW_MEMORYMAPPEDFILE_H
@@ -33,25 +33,51 @@
 #include <inviwo/core/common/inviwocoredefine.h>
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/io/bytereaderutil.h>
+#include <inviwo/core/io/memorymappedfile.h>
 #include <inviwo/core/io/datareaderexception.h>
 #include <inviwo/core/datastructures/diskrepresentation.h>
 #include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
 
 namespace inviwo {
 
+namespace detail {
+
+/**
+ * A VolumeRAMPrecision using a private memory mapping of a raw file as its data. Voxels are read
+ * on demand by the operating system, and unmodified pages are shared with all other mappings of
+ * the same file. Editing the volume will not modify the file. Clones share the mapping, which is
+ * kept alive as long as any of them uses it.
+ */
+template <typename T>
+class MappedVolumeRAMPrecision : public VolumeRAMPrecision<T> {
+public:
+    MappedVolumeRAMPrecision(std::shared_ptr<util::MemoryMappedFile> file, size3_t dimensions)
+        : VolumeRAMPrecision<T>(static_cast<T*>(file->getData()), dimensions, file) {}
+    virtual ~MappedVolumeRAMPrecision() = default;
+};
+
+}  // namespace detail
+
 /**
  * \class RawVolumeRAMLoader
  * \brief A loader of raw files. Used to create VolumeRAM representations.
  * This class us used by the DatVolumeSequenceReader, IvfVolumeReader and RawVolumeReader.
+ * Data stored in native byte order is memory mapped instead of read, hence only the parts of the
+ * volume that are accessed are loaded from disk. Other data is read and byte swapped.
+ * Sub regions of the volume can be read using readRegion, which is used by VolumeBricked.
  */
 
-class IVW_CORE_API RawVolumeRAMLoader : public DiskRepresentationLoader<VolumeRepresentation> {
+class IVW_CORE_API RawVolumeRAMLoader : public DiskRepresentationLoader<VolumeRepresentation>,
+                                        public VolumeRegionLoader {
 public:
     RawVolumeRAMLoader(const std::string& rawFile, size_t offset, size3_t dimensions,
                        bool littleEndian, const DataFormatBase* format);
     virtual RawVolumeRAMLoader* clone() const override;
     virtual std::shared_ptr<VolumeRepresentation> createRepresentation() const override;
     virtual void updateRepresentation(std::shared_ptr<VolumeRepresentation> dest) const override;
+    virtual void readRegion(const size3_t& offset, const size3_t& dimensions,
+                            void* dest) const override;
 
     using type = std::shared_ptr<VolumeRAM>;
 
@@ -60,6 +86,19 @@ public:
         typedef typename T::type F;
 
         std::size_t size = dimensions_.x * dimensions_.y * dimensions_.z;
+        const size_t componentSize = format_->getSize() / format_->getComponents();
+
+        if ((littleEndian_ || componentSize == 1) && offset_ % alignof(F) == 0) {
+            try {
+                auto file = std::make_shared<util::MemoryMappedFile>(rawFile_, offset_,
+                                                                     size * sizeof(F));
+                return std::make_shared<detail::MappedVolumeRAMPrecision<F>>(std::move(file),
+                                                                             dimensions_);
+            } catch (const FileException&) {
+                // Fall back to reading the file
+            }
+        }
+
         auto data = util::make_unique<F[]>(size);
 
         if (!data) {
@@ -68,7 +107,7 @@ public:
         }
 
         util::readBytesIntoBuffer(rawFile_, offset_, size * format_->getSize(), littleEndian_,
-                                  format_->getSize(), data.get());
+                                  componentSize, data.get());
 
         auto repr = std::make_shared<VolumeRAMPrecision<F>>(data.get(), dimensions_);
         data.release();
@@ -36,6 +36,8 @@
 #include <inviwo/core/links/propertylink.h>
 
 #include <unordered_map>
+#include <unordered_set>
+#include <memory>
 
 namespace inviwo {
 
@@ -78,43 +80,64 @@ private:
         Property* dst_;
         const PropertyConverter* converter_;
     };
+    using Links = std::vector<Link>;
+
+    // The secondary cache entry of a property. Links are shared with any evaluation in progress
+    // such that the entry can be invalidated during evaluation.
+    struct TriggeredLinks {
+        std::shared_ptr<const Links> links;
+        // All properties whose direct links were followed when building the links.
+        std::vector<Property*> dependencies;
+    };
 
     // Cache helpers
-    std::vector<Link>& addToSecondaryCache(Property* property);
-    void secondaryCacheHelper(std::vector<Link>& links, Property* src, Property* dst);
-    std::vector<Link>& getTriggerdLinksForProperty(Property* property);
+    TriggeredLinks& addToSecondaryCache(Property* property);
+    void secondaryCacheHelper(Links& links, std::unordered_set<Property*>& linked,
+                              std::unordered_set<Property*>& dependencies, const Link& link);
+    const std::shared_ptr<const Links>& getTriggerdLinksForProperty(Property* property);
+    void invalidateSecondaryCache(Property* property);
 
     ProcessorNetwork* network_;
 
-    // The primary link cache is a map with all source properties and a vector of properties that
-    // they link directly to
-    std::unordered_map<Property*, std::vector<Property*>> propertyLinkPrimaryCache_;
+    // The primary link cache is a map with all source properties and the links to the properties
+    // they link directly to, with the converters already resolved.
+    std::unordered_map<Property*, Links> propertyLinkPrimaryCache_;
     // The secondary link cache is a map with all source properties and a vector of ALL the
-    // properties that they link to. Directly or indirectly.
-    std::unordered_map<Property*, std::vector<Link>> propertyLinkSecondaryCache_;
+    // links that are triggered by them. Directly or indirectly.
+    std::unordered_map<Property*, TriggeredLinks> propertyLinkSecondaryCache_;
+    // For each property the secondary cache entries that followed its direct links. Used to only
+    // invalidate the affected entries when a link is added or removed.
+    std::unordered_map<Property*, std::vector<Property*>> secondaryCacheDependents_;
     // A cache of all links between two processors.
     ProcessorLinkMap processorLinksCache_;
 
-    // Used to make sure we don't end up in circular links
-    std::vector<Property*> visited_;
+    // Used to make sure we don't end up in circular links, counts the number of evaluations in
+    // progress that involves each property.
+    std::unordered_map<Property*, size_t> visited_;
     struct VisitedHelper {
-        VisitedHelper(std::vector<Property*>& visited, std::vector<Link>& toVisit)
-            : visited_(visited), toVisit_(toVisit) {
-            for (auto& link : toVisit_) {
-                util::push_back_unique(visited_, link.src_);
-                util::push_back_unique(visited_, link.dst_);
+        VisitedHelper(std::unordered_map<Property*, size_t>& visited,
+                      std::shared_ptr<const Links> toVisit)
+            : visited_(visited), toVisit_(std::move(toVisit)) {
+            for (auto& link : *toVisit_) {
+                ++visited_[link.src_];
+                ++visited_[link.dst_];
             }
         }
         ~VisitedHelper() {
-            for (auto& link : toVisit_) {
-                util::erase_remove(visited_, link.src_);
-                util::erase_remove(visited_, link.dst_);
+            for (auto& link : *toVisit_) {
+                leave(link.src_);
+                leave(link.dst_);
             }
         }
+        const Links& links() const { return *toVisit_; }
 
     private:
-        std::vector<Property*>& visited_;
-        std::vector<Link>& toVisit_;
+        void leave(Property* property) {
+            auto it = visited_.find(property);
+            if (--(it->second) == 0) visited_.erase(it);
+        }
+        std::unordered_map<Property*, size_t>& visited_;
+        std::shared_ptr<const Links> toVisit_;
     };
 };
 
@@ -52,6 +52,19 @@ public:
     virtual ~ProcessorNetworkEvaluator() = default;
     void setExceptionHandler(EvaluationErrorHandler handler);
 
+    /**
+     * Enable or disable concurrent evaluation. When enabled, processors tagged with
+     * Tags::Concurrent are processed on the thread pool as soon as all their predecessors are
+     * done, while all other processors are still processed on the calling (main) thread.
+     * Independent branches of the network can hence be evaluated simultaneously.
+     * To leave room for tasks dispatched from within Processor::process at most
+     * getPoolSize() - 1 processors are running on the pool at the same time, i.e. a pool size
+     * less than two will evaluate serially.
+     * @see Tags::Concurrent
+     */
+    void setConcurrentEvaluation(bool enable);
+    bool getConcurrentEvaluation() const;
+
 private:
     // ProcessorNetworkObserver overrides
     virtual void onProcessorNetworkEvaluateRequest() override;
@@ -66,11 +79,21 @@ private:
 
     void requestEvaluate();
     void evaluate();
+    void evaluateSerial();
+    void evaluateConcurrent(size_t maxConcurrent);
+
+    /**
+     * Initialize resources and call onChange for changed inports.
+     * Returns false if an exception was handled and the processor should not be processed.
+     */
+    bool prepareProcess(Processor* processor);
+    void finishProcess(Processor* processor);
 
     ProcessorNetwork* processorNetwork_;
     // the sorted list of processors obtained through topological sorting
     std::vector<Processor*> processorsSorted_;
     bool evaulationQueued_;
+    bool concurrentEvaluation_;
     EvaluationErrorHandler exceptionHandler_;
 };
 
@@ -44,6 +44,12 @@
 
 namespace inviwo {
 
+class BufferBase;
+class Image;
+class Layer;
+class Mesh;
+class Volume;
+
 /**
  * \ingroup ports
  * DataInport represents a general inport providing data as a std:shared_ptr<const T>
@@ -73,6 +79,8 @@ public:
     virtual std::vector<std::shared_ptr<const T>> getVectorData() const;
     virtual std::vector<std::pair<Outport*, std::shared_ptr<const T>>> getSourceVectorData() const;
 
+    virtual void prefetchRAMRepresentations() const override;
+
     bool hasData() const;
 };
 
@@ -83,6 +91,15 @@ template <typename T>
 using FlatMultiDataInport = DataInport<T, 0, true>;
 
 namespace detail {
+// Create the RAM representations of the data types that have one, see
+// Inport::prefetchRAMRepresentations. Other data types are ignored.
+IVW_CORE_API void prefetchRAM(const BufferBase* data);
+IVW_CORE_API void prefetchRAM(const Layer* data);
+IVW_CORE_API void prefetchRAM(const Image* data);
+IVW_CORE_API void prefetchRAM(const Mesh* data);
+IVW_CORE_API void prefetchRAM(const Volume* data);
+inline void prefetchRAM(const void*) {}
+
 template <size_t N>
 size_t getMaxNumberOfConnections() {
     return N;
@@ -261,6 +278,13 @@ DataInport<T, N, Flat>::getSourceVectorData() const {
     return res;
 }
 
+template <typename T, size_t N, bool Flat>
+void DataInport<T, N, Flat>::prefetchRAMRepresentations() const {
+    for (const auto& data : getVectorData()) {
+        if (data) detail::prefetchRAM(data.get());
+    }
+}
+
 template <typename T, size_t N, bool Flat>
 Document DataInport<T, N, Flat>::getInfo() const {
     auto name = []() {
@@ -94,6 +94,14 @@ public:
     virtual size_t getNumberOfConnections() const;
     virtual std::vector<const Outport*> getChangedOutports() const;
 
+    /**
+     * Make the data of the connected outports available in RAM. Called by the
+     * ProcessorNetworkEvaluator on the main thread before a processor tagged with Tags::Concurrent
+     * is processed on the thread pool, such that reading the inports in process() does not
+     * trigger conversions that need an OpenGL context.
+     */
+    virtual void prefetchRAMRepresentations() const;
+
     /**
      * Propagate event upwards towards connected outports, if targets is nullptr, propagate the
      * even to all connected outport, otherwise only to target.
@@ -0,0 +1,314 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_BACKGROUNDJOB_H
+#define IVW_BACKGROUNDJOB_H
+
+#include <inviwo/core/common/inviwocoredefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/processors/activityindicator.h>
+#include <inviwo/core/processors/progressbar.h>
+#include <inviwo/core/util/exception.h>
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+
+namespace inviwo {
+
+/**
+ * Thrown by StopToken::throwIfStopRequested to abort a background job whose result is no longer
+ * wanted. BackgroundJob catches it and silently drops the job.
+ */
+class IVW_CORE_API JobCancelledException : public Exception {
+public:
+    JobCancelledException(const std::string& message = "Job cancelled",
+                          ExceptionContext context = ExceptionContext());
+    virtual ~JobCancelledException() throw() {}
+};
+
+/**
+ * \class StopToken
+ * Handed to a background job to let it know when its result is no longer wanted. Copies share the
+ * same state, so a stop requested through one copy is seen by all of them. The token is checked
+ * cooperatively, the job should poll it at convenient points, for example between slices or in
+ * its progress callback, and return early or call throwIfStopRequested.
+ */
+class IVW_CORE_API StopToken {
+public:
+    StopToken();
+    bool isStopRequested() const;
+    void requestStop();
+    /**
+     * Throws a JobCancelledException if a stop has been requested. Only call this where unwinding
+     * is safe, i.e. not while tasks that reference local state are still running on the pool.
+     */
+    void throwIfStopRequested() const;
+
+private:
+    std::shared_ptr<std::atomic<bool>> stop_;
+};
+
+namespace detail {
+
+/**
+ * Front thread bookkeeping shared by all BackgroundJob instantiations. Progress from the worker
+ * is coalesced such that at most one progress update is queued on the front thread at a time.
+ */
+class IVW_CORE_API BackgroundJobIndicator
+    : public std::enable_shared_from_this<BackgroundJobIndicator> {
+public:
+    BackgroundJobIndicator(ActivityIndicator* indicator);
+    void started();
+    void finished();
+    void detach();
+    /**
+     * Returns a callback, callable from any thread, that forwards progress in [0,1] to the
+     * progress bar, if any, until a stop is requested through token.
+     */
+    std::function<void(float)> progressCallback(const StopToken& token);
+
+private:
+    ActivityIndicator* indicator_;
+    ProgressBar* progressBar_;
+    std::atomic<float> progress_;
+    std::atomic<bool> progressQueued_;
+};
+
+}  // namespace detail
+
+/**
+ * \class BackgroundJob
+ * Runs a computation for a processor on the thread pool with latest-wins semantics. Calling
+ * submit while a job is already running requests that job to stop and queues the new one. Only
+ * one job runs at a time and only the most recently submitted job is kept in the queue, hence
+ * rapid property changes, like dragging a slider, result in at most one obsolete computation
+ * instead of one per change.
+ *
+ * When a job finishes and no newer job is queued, its result is stored and the owning processor
+ * is invalidated with InvalidationLevel::InvalidOutput. The processor then picks up the result in
+ * process() through hasResult() / takeResult(). Processors that hold back output invalidation
+ * while computing can use hasResult() in their invalidate override.
+ *
+ * The job is called as `Result job(const StopToken& token, const std::function<void(float)>&
+ * progress)`. If the owner is given a ProgressBar as indicator, the progress is shown there,
+ * otherwise the indicator is active while a job is running.
+ *
+ * All member functions must be called from the front (main) thread. The destructor requests the
+ * running job to stop and waits for it to finish, jobs may hence reference members of the owner
+ * that are declared before the BackgroundJob.
+ *
+ * Example:
+ * \code{.cpp}
+ * void MyProcessor::process() {
+ *     if (job_.hasResult()) {
+ *         outport_.setData(job_.takeResult());
+ *     } else if (inport_.isChanged() || threshold_.isModified()) {
+ *         job_.submit([volume = inport_.getData(), t = threshold_.get()](
+ *                         const StopToken& token, const std::function<void(float)>& progress) {
+ *             return compute(volume, t, token, progress);
+ *         });
+ *     }
+ * }
+ * \endcode
+ */
+template <typename Result>
+class BackgroundJob {
+public:
+    using Progress = std::function<void(float)>;
+    using Job = std::function<Result(const StopToken&, const Progress&)>;
+
+    /**
+     * @param owner the processor to invalidate when a new result is available
+     * @param indicator optional activity indicator or progress bar of the owner
+     */
+    BackgroundJob(Processor& owner, ActivityIndicator* indicator = nullptr);
+    BackgroundJob(const BackgroundJob&) = delete;
+    BackgroundJob& operator=(const BackgroundJob&) = delete;
+    ~BackgroundJob();
+
+    /**
+     * Start job on the pool, or queue it if another job is running. A running job is asked to
+     * stop and a previously queued job is discarded.
+     */
+    void submit(Job job);
+
+    /**
+     * Ask the running job to stop, discard any queued job and any result not yet taken.
+     */
+    void cancel();
+
+    /**
+     * True while a job is running or queued.
+     */
+    bool isRunning() const;
+
+    /**
+     * True if a job has finished and its result has not been taken yet.
+     */
+    bool hasResult() const;
+
+    /**
+     * Take the result of the last finished job. Rethrows any exception thrown by the job.
+     */
+    Result takeResult();
+
+private:
+    struct State {
+        State(Processor& owner, ActivityIndicator* indicator)
+            : owner{&owner}
+            , indicator{std::make_shared<detail::BackgroundJobIndicator>(indicator)} {}
+
+        Processor* owner;
+        std::shared_ptr<detail::BackgroundJobIndicator> indicator;
+        StopToken token;
+        std::future<void> running;
+        Job pending;
+        bool hasResult = false;
+        Result result{};
+        std::exception_ptr error;
+    };
+
+    static void start(std::shared_ptr<State> state, Job job);
+    static void finished(const std::shared_ptr<State>& state, Result&& result,
+                         std::exception_ptr error);
+
+    std::shared_ptr<State> state_;
+};
+
+template <typename Result>
+BackgroundJob<Result>::BackgroundJob(Processor& owner, ActivityIndicator* indicator)
+    : state_{std::make_shared<State>(owner, indicator)} {}
+
+template <typename Result>
+BackgroundJob<Result>::~BackgroundJob() {
+    state_->owner = nullptr;
+    state_->pending = nullptr;
+    state_->token.requestStop();
+    state_->indicator->detach();
+    if (state_->running.valid()) {
+        waitForTask(state_->running);
+    }
+}
+
+template <typename Result>
+void BackgroundJob<Result>::submit(Job job) {
+    state_->hasResult = false;
+    state_->result = Result{};
+    state_->error = nullptr;
+    if (state_->running.valid()) {
+        state_->token.requestStop();
+        state_->pending = std::move(job);
+    } else {
+        start(state_, std::move(job));
+    }
+}
+
+template <typename Result>
+void BackgroundJob<Result>::cancel() {
+    state_->pending = nullptr;
+    state_->token.requestStop();
+    state_->hasResult = false;
+    state_->result = Result{};
+    state_->error = nullptr;
+}
+
+template <typename Result>
+bool BackgroundJob<Result>::isRunning() const {
+    return state_->running.valid();
+}
+
+template <typename Result>
+bool BackgroundJob<Result>::hasResult() const {
+    return state_->hasResult;
+}
+
+template <typename Result>
+Result BackgroundJob<Result>::takeResult() {
+    state_->hasResult = false;
+    auto result = std::move(state_->result);
+    state_->result = Result{};
+    if (auto error = state_->error) {
+        state_->error = nullptr;
+        std::rethrow_exception(error);
+    }
+    return result;
+}
+
+template <typename Result>
+void BackgroundJob<Result>::start(std::shared_ptr<State> state, Job job) {
+    state->token = StopToken{};
+    state->indicator->started();
+    state->running = dispatchPool([
+        state, job = std::move(job), token = state->token,
+        progress = state->indicator->progressCallback(state->token)
+    ]() {
+        Result result{};
+        std::exception_ptr error;
+        try {
+            result = job(token, progress);
+        } catch (const JobCancelledException&) {
+        } catch (...) {
+            error = std::current_exception();
+        }
+        auto res = std::make_shared<Result>(std::move(result));
+        dispatchFront([state, res, error]() { finished(state, std::move(*res), error); });
+    });
+}
+
+template <typename Result>
+void BackgroundJob<Result>::finished(const std::shared_ptr<State>& state, Result&& result,
+                                     std::exception_ptr error) {
+    state->running = {};
+    if (!state->owner) return;
+
+    if (state->pending) {
+        auto job = std::move(state->pending);
+        state->pending = nullptr;
+        start(state, std::move(job));
+        return;
+    }
+    state->indicator->finished();
+    // The token is still the one of the finished job. Checked here on the front thread, since a
+    // cancel might have been called after the job returned but before this was dispatched.
+    if (state->token.isStopRequested()) return;
+
+    state->hasResult = true;
+    state->result = std::move(result);
+    state->error = error;
+    state->owner->invalidate(InvalidationLevel::InvalidOutput);
+}
+
+}  // namespace inviwo
+
+#endif  // IVW_BACKGROUNDJOB_H
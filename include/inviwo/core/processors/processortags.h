@@ -97,8 +97,23 @@ public:
     static const Tags GL;
     static const Tags CL;
     static const Tags CPU;
+
+    /*
+     * Marks a processor whose process() only reads its inports and writes its outports and does
+     * not use any OpenGL/OpenCL state. Such processors may be processed on the thread pool
+     * by the ProcessorNetworkEvaluator when concurrent evaluation is enabled. The RAM
+     * representations of the inport data are created on the main thread before process() is
+     * called, see Inport::prefetchRAMRepresentations, other representations must not be
+     * requested. process() must not wait for work dispatched to the main thread.
+     */
+    static const Tags Concurrent;
 };
 
+/*
+ * Returns the union of the two tag sets, i.e. Tags::CPU | Tags::Concurrent
+ */
+IVW_CORE_API Tags operator|(const Tags& lhs, const Tags& rhs);
+
 inline bool operator==(const Tags& lhs, const Tags& rhs) { return lhs.tags_ == rhs.tags_; }
 inline bool operator<(const Tags& lhs, const Tags& rhs) { return lhs.tags_ < rhs.tags_; }
 inline bool operator!=(const Tags& lhs, const Tags& rhs) { return !operator==(lhs, rhs); }
@@ -102,6 +102,7 @@ public:
     const std::string getOutputPath() const;
     const std::string getWorkspacePath() const;
     const std::string getLogToFileFileName() const;
+    const std::string getTraceFileName() const;
     bool getQuitApplicationAfterStartup() const;
     bool getLoadWorkspaceFromArg() const;
     bool getShowSplashScreen() const;
@@ -125,6 +126,7 @@ private:
     TCLAP::ValueArg<std::string> workspace_;
     TCLAP::ValueArg<std::string> outputPath_;
     TCLAP::ValueArg<std::string> logfile_;
+    TCLAP::ValueArg<std::string> trace_;
     TCLAP::SwitchArg logConsole_;
     TCLAP::SwitchArg noSplashScreen_;
     TCLAP::SwitchArg quitAfterStartup_;
@@ -35,7 +35,11 @@
 #include <inviwo/core/util/stdextensions.h>
 #include <inviwo/core/common/inviwoapplication.h>
 #include <inviwo/core/util/settings/systemsettings.h>
+#include <algorithm>
+#include <exception>
+#include <future>
 #include <string>
+#include <vector>
 
 namespace inviwo {
 
@@ -51,6 +55,18 @@ namespace util {
             std::for_each(a, b, [&](auto v) { callback(v, start++); });
         }
 
+        template <typename Callback>
+        void range_helper(std::false_type, Callback& callback, size_t begin, size_t end,
+                          size_t) {
+            callback(begin, end);
+        }
+
+        template <typename Callback>
+        void range_helper(std::true_type, Callback& callback, size_t begin, size_t end,
+                          size_t range) {
+            callback(begin, end, range);
+        }
+
     }
 
 
@@ -115,8 +131,96 @@ void forEachParallel(const Iterable& iterable, Callback callback, size_t jobs =
     auto futures = forEachParallelAsync<Iterable,Callback,T>(iterable, callback, jobs);
 
     for (const auto& e : futures) {
-        e.wait();
+        waitForTask(e);
+    }
+}
+
+/**
+ * The number of ranges forEachRangeParallel splits [0, size) into. That is 4 times the pool size
+ * for load balancing, but no range shorter than minRangeSize, and 1 if there is no application or
+ * the pool is empty.
+ */
+inline size_t parallelRangeCount(size_t size, size_t minRangeSize = 1) {
+    size_t ranges = 1;
+    if (InviwoApplication::isInitialized()) {
+        ranges = 4 * InviwoApplication::getPtr()->getPoolSize();
+    }
+    return std::max(size_t{1}, std::min(ranges, size / std::max(size_t{1}, minRangeSize)));
+}
+
+/**
+ * Split [0, size) into the given number of consecutive ranges and process them as tasks in the
+ * thread pool. With a single range the callback is called directly in the calling thread.
+ * Use this together with parallelRangeCount when storage per range is allocated up front, such
+ * that the storage and the split use the same number of ranges even if the pool is resized.
+ * The function will return once all ranges have been processed, even if some of them throw, since
+ * the callbacks usually refer to state of the caller. The first exception is then rethrown.
+ *
+ * @param size the number of elements to process
+ * @param ranges the number of ranges, at least 1
+ * @param callback called for each range, can be either `[](size_t begin, size_t end){}` or
+ * `[](size_t begin, size_t end, size_t range){}` where `range` is the index of the range, i.e. for
+ * storing a result per range
+ * @param done called as `done(range)` in the calling thread when a range has been processed, in
+ * order of the ranges, i.e. for reporting progress
+ */
+template <typename Callback, typename Done>
+void forEachRangeParallelN(size_t size, size_t ranges, Callback callback, Done done) {
+    ranges = std::max(size_t{1}, ranges);
+    auto includeIndex =
+        typename std::conditional<util::is_callable_with<size_t, size_t, size_t>(callback),
+                                  std::true_type, std::false_type>::type();
+    const auto process = [&](size_t range) {
+        detail::range_helper(includeIndex, callback, range * size / ranges,
+                             (range + 1) * size / ranges, range);
+    };
+
+    if (ranges == 1) {
+        process(0);
+        done(size_t{0});
+        return;
+    }
+
+    std::vector<std::future<void>> futures;
+    for (size_t range = 0; range < ranges; ++range) {
+        futures.push_back(dispatchPool(process, range));
     }
+    std::exception_ptr error;
+    for (size_t range = 0; range < ranges; ++range) {
+        waitForTask(futures[range]);
+        try {
+            futures[range].get();
+            if (!error) done(range);
+        } catch (...) {
+            if (!error) error = std::current_exception();
+        }
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+template <typename Callback>
+void forEachRangeParallelN(size_t size, size_t ranges, Callback callback) {
+    forEachRangeParallelN(size, ranges, callback, [](size_t) {});
+}
+
+/**
+ * Split [0, size) into parallelRangeCount(size, minRangeSize) consecutive ranges and process them
+ * with forEachRangeParallelN. If the callback stores a result per range, allocate the storage with
+ * one call to parallelRangeCount and use forEachRangeParallelN instead.
+ *
+ * @param size the number of elements to process
+ * @param minRangeSize the minimal number of elements in a range
+ * @param callback see forEachRangeParallelN
+ * @param done see forEachRangeParallelN
+ */
+template <typename Callback, typename Done>
+void forEachRangeParallel(size_t size, size_t minRangeSize, Callback callback, Done done) {
+    forEachRangeParallelN(size, parallelRangeCount(size, minRangeSize), callback, done);
+}
+
+template <typename Callback>
+void forEachRangeParallel(size_t size, size_t minRangeSize, Callback callback) {
+    forEachRangeParallel(size, minRangeSize, callback, [](size_t) {});
 }
 
 }  // namespace util
@@ -83,7 +83,7 @@ void forEachPixelParallel(const LayerRAM &layer, C callback, size_t jobs = 0) {
     }
 
     for (const auto &e : futures) {
-        e.wait();
+        waitForTask(e);
     }
 }
 
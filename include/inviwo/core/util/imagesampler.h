@@ -64,21 +64,29 @@ public:
      * available for the lifetime of the ImageSpatialSampler
      */
     ImageSpatialSampler(const LayerRAM *ram)
+        : ImageSpatialSampler(std::shared_ptr<const LayerRAM>(ram, [](const LayerRAM *) {})) {}
+
+    /**
+     * Creates a ImageSpatialSampler for the given LayerRAM, and keeps it for the lifetime of the
+     * ImageSpatialSampler.
+     */
+    ImageSpatialSampler(std::shared_ptr<const LayerRAM> ram)
         : SpatialSampler<2, DataDims, T>(*ram->getOwner())
-        , layer_(ram)
+        , layer_(std::move(ram))
         , dims_(layer_->getDimensions())
         , sharedImage_(nullptr) {}
 
     /**
-     * Creates a ImageSpatialSampler for the given Layer, does not take ownership of ram.
-     * Use ImageSpatialSampler(std::shared_ptr<const Image>) to ensure that the Layer is available
-     * for the lifetime of the ImageSpatialSampler
+     * Creates a ImageSpatialSampler for the given Layer, does not take ownership of layer.
+     * The LayerRAM is kept for the lifetime of the ImageSpatialSampler, use
+     * ImageSpatialSampler(std::shared_ptr<const Image>) to ensure that the Layer is available
+     * as well
      */
     ImageSpatialSampler(const Layer *layer)
-        : ImageSpatialSampler(layer->getRepresentation<LayerRAM>()) {}
+        : ImageSpatialSampler(layer->getRepresentationShared<LayerRAM>()) {}
 
     /**
-     * Creates a ImageSpatialSampler for the given Image, does not take ownership of ram.
+     * Creates a ImageSpatialSampler for the given Image, does not take ownership of img.
      * Use ImageSpatialSampler(std::shared_ptr<const Image>) to ensure that the Image is available
      * for the lifetime of the ImageSpatialSampler
      */
@@ -86,8 +94,9 @@ public:
 
     /**
      * Creates a ImageSpatialSampler for the given Image.
-     * The shared_ptr will ensure that the Image is available for the lifetime of the
-     * ImageSpatialSampler
+     * The shared_ptr will ensure that the Image and its LayerRAM are available for the lifetime
+     * of the ImageSpatialSampler, even across network evaluations where the memory manager might
+     * evict unused representations.
      */
     ImageSpatialSampler(std::shared_ptr<const Image> sharedImage)
         : ImageSpatialSampler(sharedImage->getColorLayer()) {
@@ -142,7 +151,8 @@ private:
         auto p = glm::clamp(pos, size2_t(0), dims_ - size2_t(1));
         return layer_->getAsDVec4(p);
     }
-    const LayerRAM *layer_;
+
+    std::shared_ptr<const LayerRAM> layer_;
     size2_t dims_;
 
     std::shared_ptr<const Image> sharedImage_;
@@ -166,6 +176,7 @@ template <typename T, typename P>
 class TemplateImageSampler {
 public:
     TemplateImageSampler(const LayerRAM *ram);
+    TemplateImageSampler(std::shared_ptr<const LayerRAM> ram);
     TemplateImageSampler(const Layer *layer);
 
     TemplateImageSampler(const Image *img);
@@ -187,6 +198,7 @@ public:
 
 private:
     T getPixel(const size2_t &pos);
+    std::shared_ptr<const LayerRAM> ram_;
     const T *data_;
     size2_t dims_;
     util::IndexMapper2D ic_;
@@ -196,14 +208,19 @@ private:
 
 template <typename T, typename P>
 TemplateImageSampler<T, P>::TemplateImageSampler(const LayerRAM *ram)
-    : data_(static_cast<const T *>(ram->getData()))
-    , dims_(ram->getDimensions())
+    : TemplateImageSampler(std::shared_ptr<const LayerRAM>(ram, [](const LayerRAM *) {})) {}
+
+template <typename T, typename P>
+TemplateImageSampler<T, P>::TemplateImageSampler(std::shared_ptr<const LayerRAM> ram)
+    : ram_(std::move(ram))
+    , data_(static_cast<const T *>(ram_->getData()))
+    , dims_(ram_->getDimensions())
     , ic_(dims_)
     , sharedImage_(nullptr) {
-    if (ram->getDataFormat() != DataFormat<T>::get()) {
+    if (ram_->getDataFormat() != DataFormat<T>::get()) {
         std::ostringstream oss;
         oss << "Type mismatch when trying to initialize TemplateImageSampler. Image is "
-            << ram->getDataFormat()->getString() << " but expected "
+            << ram_->getDataFormat()->getString() << " but expected "
             << DataFormat<T>::get()->getString();
         throw Exception(oss.str(), IvwContext);
     }
@@ -211,7 +228,7 @@ TemplateImageSampler<T, P>::TemplateImageSampler(const LayerRAM *ram)
 
 template <typename T, typename P>
 TemplateImageSampler<T, P>::TemplateImageSampler(const Layer *layer)
-    : TemplateImageSampler(layer->getRepresentation<LayerRAM>()) {}
+    : TemplateImageSampler(layer->getRepresentationShared<LayerRAM>()) {}
 
 template <typename T, typename P>
 TemplateImageSampler<T, P>::TemplateImageSampler(const Image *img)
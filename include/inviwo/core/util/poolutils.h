@@ -0,0 +1,73 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_POOLUTILS_H
+#define IVW_POOLUTILS_H
+
+#include <inviwo/core/common/inviwocoredefine.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/util/raiiutils.h>
+
+#include <utility>
+
+namespace inviwo {
+
+namespace util {
+
+/**
+ * Call func with the thread pool of the application resized to poolSize, the pool size is
+ * restored afterwards. Returns the result of func.
+ */
+template <typename Func>
+auto withPoolSize(size_t poolSize, Func&& func) -> decltype(func()) {
+    auto app = InviwoApplication::getPtr();
+    const auto oldPoolSize = app->getPoolSize();
+    util::OnScopeExit restorePool([&]() { app->resizePool(oldPoolSize); });
+    app->resizePool(poolSize);
+    return func();
+}
+
+/**
+ * Call func once without a thread pool, i.e. everything is processed in the calling thread, and
+ * once with a pool of poolSize threads. Returns both results, i.e. for testing that a parallel
+ * algorithm gives the same result as the serial one.
+ */
+template <typename Func>
+auto serialAndParallel(Func&& func, size_t poolSize = 2)
+    -> std::pair<decltype(func()), decltype(func())> {
+    auto serial = withPoolSize(0, func);
+    auto parallel = withPoolSize(poolSize, func);
+    return {std::move(serial), std::move(parallel)};
+}
+
+}  // namespace util
+
+}  // namespace inviwo
+
+#endif  // IVW_POOLUTILS_H
@@ -34,6 +34,7 @@
 #include <inviwo/core/properties/optionproperty.h>
 #include <inviwo/core/properties/boolproperty.h>
 #include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/properties/stringproperty.h>
 
 namespace inviwo {
 
@@ -48,6 +49,7 @@ public:
     SystemSettings(InviwoApplication* app);
     TemplateOptionProperty<UsageMode> applicationUsageMode_;
     IntSizeTProperty poolSize_;
+    BoolProperty concurrentEvaluation_;
     BoolProperty enablePortInspectors_;
     IntProperty portInspectorSize_;
     BoolProperty enableTouchProperty_;
@@ -57,6 +59,9 @@ public:
     BoolProperty followObjectDuringRotation_;
     BoolProperty runtimeModuleReloading_;
     BoolProperty enableResourceManager_;
+    IntSizeTProperty brickCacheSize_;  //< Memory budget of the VolumeBrickCache in MB
+    IntSizeTProperty representationMemoryBudget_;  //< RepresentationMemoryManager budget in MB
+    StringProperty representationMemoryUsage_;
 
     static size_t defaultPoolSize();
 };
@@ -75,6 +75,7 @@ private:
     Vector<DataDims, T> getVoxel(const size3_t &pos) const;
     virtual bool withinBoundsDataSpace(const dvec3 &pos) const override;
 
+    std::shared_ptr<const VolumeRAM> ram_;
     const DataType *data_;
     size3_t dims_;
     util::IndexMapper3D ic_;
@@ -92,8 +93,9 @@ template <typename DataType, typename P, typename T, unsigned int DataDims>
 TemplateVolumeSampler<DataType, P, T, DataDims>::TemplateVolumeSampler(const Volume &volume,
                                                                        CoordinateSpace space)
     : SpatialSampler<3, DataDims, T>(volume, space)
-    , data_(static_cast<const DataType *>(volume.getRepresentation<VolumeRAM>()->getData()))
-    , dims_(volume.getRepresentation<VolumeRAM>()->getDimensions())
+    , ram_(volume.getRepresentationShared<VolumeRAM>())
+    , data_(static_cast<const DataType *>(ram_->getData()))
+    , dims_(ram_->getDimensions())
     , ic_(dims_) {}
 
 template <typename DataType, typename P, typename T, unsigned int DataDims>
@@ -62,7 +62,8 @@
 #include <warn/push>
 #include <warn/ignore/all>
 #include <vector>
-#include <queue>
+#include <deque>
+#include <array>
 #include <memory>
 #include <thread>
 #include <mutex>
@@ -71,20 +72,97 @@
 #include <functional>
 #include <stdexcept>
 #include <atomic>
+#include <chrono>
+#include <type_traits>
+#include <cstddef>
 #include <warn/pop>
 
 namespace inviwo {
 
+/**
+ * A work stealing thread pool. Each worker has its own task queues. Tasks enqueued from a worker
+ * thread are put in that worker's queues, and run newest first by that worker. Tasks enqueued from
+ * other threads are put in a shared queue. Idle workers take tasks from their own queues, then from
+ * the shared queue, and finally steal the oldest tasks of other workers.
+ * Tasks with higher priority are preferred in each of the queues.
+ * A task can wait on subtasks it has enqueued using ThreadPool::wait, which will run other queued
+ * tasks while waiting instead of blocking the worker.
+ */
 class IVW_CORE_API ThreadPool {
 public:
+    enum class Priority { High = 0, Normal = 1, Low = 2 };
+
+    /**
+     * A move only type erased callable. Callables small enough are stored inline without any heap
+     * allocation.
+     */
+    class Task {
+    public:
+        Task() = default;
+        template <typename F, typename = typename std::enable_if<
+                                  !std::is_same<typename std::decay<F>::type, Task>::value>::type>
+        Task(F&& f);
+        Task(const Task&) = delete;
+        Task(Task&& rhs) noexcept;
+        Task& operator=(const Task&) = delete;
+        Task& operator=(Task&& rhs) noexcept;
+        ~Task();
+
+        void operator()();
+        explicit operator bool() const { return ops_ != nullptr; }
+
+    private:
+        static constexpr size_t bufferSize = 64;
+        using Buffer = std::aligned_storage<bufferSize, alignof(std::max_align_t)>::type;
+
+        struct Ops {
+            void (*call)(Buffer&);
+            void (*move)(Buffer& from, Buffer& to);
+            void (*destroy)(Buffer&);
+        };
+        template <typename F>
+        struct InlineOps;
+        template <typename F>
+        struct HeapOps;
+
+        void reset();
+
+        Buffer buffer_;
+        const Ops* ops_ = nullptr;
+    };
+
     ThreadPool(size_t threads, std::function<void()> onThreadStart = []() {},
                std::function<void()> onThreadStop = []() {});
     ~ThreadPool();
 
     template <class F, class... Args>
     auto enqueue(F&& f, Args&&... args) -> std::future<typename std::result_of<F(Args...)>::type>;
+
+    template <class F, class... Args>
+    auto enqueue(Priority priority, F&& f, Args&&... args)
+        -> std::future<typename std::result_of<F(Args...)>::type>;
+
+    /**
+     * Wait for the future to become ready. If called from one of the pool's worker threads the
+     * worker will keep processing queued tasks while waiting. Hence a task can wait for subtasks
+     * that it has enqueued without dead locking the pool. When there is nothing to run, the worker
+     * sleeps until a task finishes or is enqueued. Futures completed outside of the pool, e.g. by
+     * InviwoApplication::dispatchFront, are checked again every few milliseconds.
+     */
+    template <typename Future>
+    void wait(const Future& future);
+
     size_t trySetSize(size_t size);
     size_t getSize() const;
+    /**
+     * The number of tasks that are queued or running.
+     */
+    size_t getNumberOfTasks() const;
+
+    /**
+     * Returns true if the calling thread is one of the pool's worker threads.
+     */
+    bool isWorkerThread() const;
 
 private:
     enum class State {
@@ -95,6 +173,17 @@ private:
         Done      //< Worker is waiting to be joined.
     };
 
+    class Queue {
+    public:
+        void push(Task&& task, Priority priority);
+        bool popNewest(Task& task, Priority priority);
+        bool popOldest(Task& task, Priority priority);
+
+    private:
+        std::mutex mutex_;
+        std::array<std::deque<Task>, 3> tasks_;
+    };
+
     struct Worker {
         Worker(ThreadPool& pool);
         Worker(const Worker&) = delete;
@@ -104,44 +193,198 @@ private:
         ~Worker();
 
         std::atomic<State> state; //< State of the worker
+        Queue queue;
         std::thread thread;
     };
-    // need to keep track of threads so we can join them
+
+    /**
+     * The task run by the workers for enqueue, keeps the callable and its promise in the Task
+     * itself instead of in a separately allocated std::packaged_task.
+     */
+    template <typename R, typename F>
+    struct PromisedTask;
+
+    void push(Task&& task, Priority priority);
+    bool pop(Worker* self, Task& task);
+    /**
+     * Wake the threads waiting in wait(), called when a task finishes or is queued.
+     */
+    void notifyWaiters();
+    /**
+     * Run one queued task if called from a worker thread and there is a task available.
+     */
+    bool runPendingTask();
+
+    // need to keep track of threads so we can join them, and find workers to steal from
     std::vector<std::unique_ptr<Worker>> workers;
+    std::mutex workersMutex_;
+    std::atomic<size_t> size_;
 
-    // the task queue
-    std::queue<std::function<void()>> tasks;
+    // the shared task queue, used for tasks enqueued from outside of the pool.
+    Queue queue_;
+    std::atomic<size_t> pending_;  //< number of tasks in all queues
+    std::atomic<size_t> tasks_;    //< number of tasks queued or running
+    std::atomic<size_t> sleeping_; //< number of workers waiting on condition
+    std::atomic<size_t> waiting_;  //< number of workers sleeping in wait()
 
     // synchronization
     std::mutex queue_mutex;
     std::condition_variable condition;
+    std::mutex waitMutex_;
+    std::condition_variable waitCondition_;
 
     // Thread start end exit actions
     std::function<void()> onThreadStart_;
     std::function<void()> onThreadStop_;
 };
 
+template <typename R, typename F>
+struct ThreadPool::PromisedTask {
+    void operator()() {
+        try {
+            run(promise, func);
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+        }
+    }
+    template <typename T>
+    static void run(std::promise<T>& p, F& f) {
+        p.set_value(f());
+    }
+    static void run(std::promise<void>& p, F& f) {
+        f();
+        p.set_value();
+    }
+
+    std::promise<R> promise;
+    F func;
+};
+
+template <typename F>
+struct ThreadPool::Task::InlineOps {
+    static void call(Buffer& b) { (*reinterpret_cast<F*>(&b))(); }
+    static void move(Buffer& from, Buffer& to) {
+        new (&to) F(std::move(*reinterpret_cast<F*>(&from)));
+        reinterpret_cast<F*>(&from)->~F();
+    }
+    static void destroy(Buffer& b) { reinterpret_cast<F*>(&b)->~F(); }
+    static const Ops* get() {
+        static constexpr Ops ops{&call, &move, &destroy};
+        return &ops;
+    }
+    template <typename G>
+    static const Ops* construct(Buffer& b, G&& g) {
+        new (&b) F(std::forward<G>(g));
+        return get();
+    }
+};
+
+template <typename F>
+struct ThreadPool::Task::HeapOps {
+    static void call(Buffer& b) { (**reinterpret_cast<F**>(&b))(); }
+    static void move(Buffer& from, Buffer& to) { new (&to) F*(*reinterpret_cast<F**>(&from)); }
+    static void destroy(Buffer& b) { delete *reinterpret_cast<F**>(&b); }
+    static const Ops* get() {
+        static constexpr Ops ops{&call, &move, &destroy};
+        return &ops;
+    }
+    template <typename G>
+    static const Ops* construct(Buffer& b, G&& g) {
+        new (&b) F*(new F(std::forward<G>(g)));
+        return get();
+    }
+};
+
+template <typename F, typename>
+ThreadPool::Task::Task(F&& f) {
+    using Func = typename std::decay<F>::type;
+    using Storage = typename std::conditional<sizeof(Func) <= bufferSize &&
+                                                  alignof(Func) <= alignof(Buffer) &&
+                                                  std::is_nothrow_move_constructible<Func>::value,
+                                              InlineOps<Func>, HeapOps<Func>>::type;
+    ops_ = Storage::construct(buffer_, std::forward<F>(f));
+}
+
+inline ThreadPool::Task::Task(Task&& rhs) noexcept : ops_{rhs.ops_} {
+    if (ops_) {
+        ops_->move(rhs.buffer_, buffer_);
+        rhs.ops_ = nullptr;
+    }
+}
+
+inline ThreadPool::Task& ThreadPool::Task::operator=(Task&& rhs) noexcept {
+    if (this != &rhs) {
+        reset();
+        if (rhs.ops_) {
+            rhs.ops_->move(rhs.buffer_, buffer_);
+            ops_ = rhs.ops_;
+            rhs.ops_ = nullptr;
+        }
+    }
+    return *this;
+}
+
+inline ThreadPool::Task::~Task() { reset(); }
+
+inline void ThreadPool::Task::operator()() { ops_->call(buffer_); }
+
+inline void ThreadPool::Task::reset() {
+    if (ops_) {
+        ops_->destroy(buffer_);
+        ops_ = nullptr;
+    }
+}
+
 // add new work item to the pool
 template <class F, class... Args>
 auto ThreadPool::enqueue(F&& f, Args&&... args)
     -> std::future<typename std::result_of<F(Args...)>::type> {
-    using return_type = typename std::result_of<F(Args...)>::type;
+    return enqueue(Priority::Normal, std::forward<F>(f), std::forward<Args>(args)...);
+}
 
-    auto task = std::make_shared<std::packaged_task<return_type()>>(
-        std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+template <class F, class... Args>
+auto ThreadPool::enqueue(Priority priority, F&& f, Args&&... args)
+    -> std::future<typename std::result_of<F(Args...)>::type> {
+    using return_type = typename std::result_of<F(Args...)>::type;
+    using Func = decltype(std::bind(std::forward<F>(f), std::forward<Args>(args)...));
 
-    std::future<return_type> res = task->get_future();
+    // Only the shared state of the future is allocated, the task is stored inline in the Task
+    // when it is small enough
+    PromisedTask<return_type, Func> task{std::promise<return_type>{},
+                                         std::bind(std::forward<F>(f), std::forward<Args>(args)...)};
+    std::future<return_type> res = task.promise.get_future();
 
-    if (workers.empty()) {
-        (*task)();  // No worker threads, just run the task.
+    if (size_ == 0) {
+        task();  // No worker threads, just run the task.
     } else {
-        std::unique_lock<std::mutex> lock(queue_mutex);
-        tasks.emplace([task]() { (*task)(); });
+        push(Task{std::move(task)}, priority);
     }
-    condition.notify_one();
     return res;
 }
 
+template <typename Future>
+void ThreadPool::wait(const Future& future) {
+    if (!isWorkerThread()) {
+        future.wait();
+        return;
+    }
+    const auto ready = [&future]() {
+        return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    };
+    while (!ready()) {
+        if (runPendingTask()) continue;
+
+        // Nothing to do, the subtasks are running on other workers. Sleep until a task finishes
+        // or is queued, notifyWaiters pairs with this fence such that no wake up is lost.
+        std::unique_lock<std::mutex> lock(waitMutex_);
+        ++waiting_;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        waitCondition_.wait_for(lock, std::chrono::milliseconds(10),
+                                [&]() { return pending_ > 0 || ready(); });
+        --waiting_;
+    }
+}
+
 }  // namespace
 
 #endif  // IVW_THREADPOOL_H
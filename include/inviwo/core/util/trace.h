@@ -0,0 +1,172 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_TRACE_H
+#define IVW_TRACE_H
+
+#include <inviwo/core/common/inviwocoredefine.h>
+#include <inviwo/core/util/clock.h>
+
+#include <atomic>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace inviwo {
+
+namespace trace {
+
+using clock = std::chrono::steady_clock;
+
+/**
+ * A recorded span. Names are truncated to fit in the event to avoid any allocations when
+ * recording.
+ */
+struct IVW_CORE_API Event {
+    static constexpr size_t maxNameLength = 95;
+
+    const char* category;                     //< Has to point to a string literal
+    std::array<char, maxNameLength + 1> name;  //< Null terminated
+    std::int64_t begin;                       //< Nanoseconds since the tracer was started
+    std::int64_t duration;                    //< Nanoseconds
+    std::uint32_t thread;                     //< Sequential id of the recording thread
+};
+
+/**
+ * \class Tracer
+ * \brief Records timed spans into per thread ring buffers and exports them as Chrome trace JSON.
+ *
+ * The tracer is always compiled in. When disabled, recording a span costs a single relaxed atomic
+ * load. When enabled, each thread writes into its own ring buffer without any locking, when a
+ * buffer is full the oldest events are overwritten. The result can be viewed in chrome://tracing
+ * or https://ui.perfetto.dev
+ *
+ * Tracing is started from the command line with `--trace <file>`, the trace is then written to
+ * the file when the application exits.
+ *
+ * @see IVW_TRACE_SCOPE
+ */
+class IVW_CORE_API Tracer {
+public:
+    Tracer() = delete;
+
+    static bool isEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * Start recording, clears any previously recorded events.
+     * @param eventsPerThread size of the ring buffer of each thread.
+     */
+    static void start(size_t eventsPerThread = 1 << 15);
+    static void stop();
+    /**
+     * Remove all recorded events. Events recorded concurrently with this call are dropped.
+     */
+    static void clear();
+
+    static void record(const char* category, const char* name, clock::time_point begin,
+                       clock::time_point end);
+    static void record(const char* category, const std::string& name, clock::time_point begin,
+                       clock::time_point end);
+
+    /**
+     * Name the calling thread in the exported trace.
+     */
+    static void setThreadName(const std::string& name);
+
+    /**
+     * Returns the recorded events ordered by start time. Events recorded concurrently with this
+     * call are dropped, call stop() first to get all events.
+     */
+    static std::vector<Event> getEvents();
+
+    /**
+     * Write all recorded events in the Chrome trace event format.
+     */
+    static void writeChromeTrace(std::ostream& os);
+    /**
+     * @throw FileException if the file can not be opened
+     */
+    static void writeChromeTrace(const std::string& filename);
+
+private:
+    static std::atomic<bool> enabled_;
+};
+
+/**
+ * \class Scope
+ * Records a span from construction to destruction, if tracing was enabled at construction.
+ * The name is only evaluated when tracing is enabled.
+ */
+class Scope {
+public:
+    Scope(const char* category, const char* name) : category_{category} {
+        if (Tracer::isEnabled()) {
+            name_ = name;
+            begin_ = clock::now();
+        }
+    }
+    template <typename NameFunc>
+    Scope(const char* category, NameFunc&& nameFunc) : category_{category} {
+        if (Tracer::isEnabled()) {
+            nameStr_ = nameFunc();
+            name_ = nameStr_.c_str();
+            begin_ = clock::now();
+        }
+    }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+    ~Scope() {
+        if (name_) Tracer::record(category_, name_, begin_, clock::now());
+    }
+
+private:
+    const char* category_;
+    const char* name_ = nullptr;
+    std::string nameStr_;
+    clock::time_point begin_;
+};
+
+}  // namespace trace
+
+}  // namespace inviwo
+
+/**
+ * Trace the enclosing scope. The category has to be a string literal, the name can be any
+ * expression convertible to std::string and is only evaluated when tracing is enabled.
+ * \code{.cpp}
+ * IVW_TRACE_SCOPE("network", processor->getIdentifier());
+ * \endcode
+ */
+#define IVW_TRACE_SCOPE(category, name) \
+    ::inviwo::trace::Scope IVW_ADDLINE(ivwTraceScope)(category, [&]() { return std::string(name); })
+
+#endif  // IVW_TRACE_H
@@ -85,7 +85,7 @@ void forEachVoxelParallel(const VolumeRAM &v, C callback, size_t jobs = 0) {
     }
 
     for (const auto &e : futures) {
-        e.wait();
+        waitForTask(e);
     }
 }
 
@@ -37,13 +37,135 @@
 #include <inviwo/core/util/interpolation.h>
 #include <inviwo/core/datastructures/volume/volume.h>
 #include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/datastructures/volume/volumebricked.h>
 
 #include <inviwo/core/util/spatialsampler.h>
 
 namespace inviwo {
 
+/**
+ * \class VolumeRAMSampler
+ * Samples the data of a VolumeRAMPrecision<T> in data space using trilinear interpolation with
+ * precision P (double or float). All calls are non-virtual and the voxels are converted directly
+ * from T, which makes it suitable for inner loops. Positions outside of [0,1] return zero.
+ * Use VolumeRAM::dispatch to pick T once for a given volume.
+ */
+template <typename T, unsigned int DataDims, typename P = double>
+class VolumeRAMSampler {
+public:
+    using Result = Vector<DataDims, P>;
+    using Position = Vector<3, P>;
+
+    VolumeRAMSampler(const VolumeRAMPrecision<T> &ram)
+        : data_(ram.getDataTyped()), dims_(ram.getDimensions()) {}
+
+    bool withinBounds(const Position &pos) const {
+        return !(glm::any(glm::lessThan(pos, Position(0))) ||
+                 glm::any(glm::greaterThan(pos, Position(1))));
+    }
+
+    Result sample(const Position &pos) const {
+        if (!withinBounds(pos)) return Result(0);
+
+        const Position samplePos = pos * Position(dims_ - size3_t(1));
+        const size3_t lower = glm::min(size3_t(samplePos), dims_ - size3_t(1));
+        const size3_t upper = glm::min(lower + size3_t(1), dims_ - size3_t(1));
+        const Position interpolants = samplePos - Position(lower);
+
+        const size_t x0 = lower.x;
+        const size_t x1 = upper.x;
+        const size_t y0 = lower.y * dims_.x;
+        const size_t y1 = upper.y * dims_.x;
+        const size_t z0 = lower.z * dims_.x * dims_.y;
+        const size_t z1 = upper.z * dims_.x * dims_.y;
+
+        const Result samples[8] = {voxel(x0 + y0 + z0), voxel(x1 + y0 + z0), voxel(x0 + y1 + z0),
+                                   voxel(x1 + y1 + z0), voxel(x0 + y0 + z1), voxel(x1 + y0 + z1),
+                                   voxel(x0 + y1 + z1), voxel(x1 + y1 + z1)};
+        return Interpolation<Result, P>::trilinear(samples, interpolants);
+    }
+
+    /**
+     * Sample all positions in [begin, end) and write the results to out.
+     */
+    template <typename InputIt, typename OutputIt>
+    OutputIt sample(InputIt begin, InputIt end, OutputIt out) const {
+        for (; begin != end; ++begin, ++out) *out = sample(Position(*begin));
+        return out;
+    }
+
+    const size3_t &getDimensions() const { return dims_; }
+
+private:
+    Result voxel(size_t index) const { return util::glm_convert<Result>(data_[index]); }
+
+    const T *data_;
+    size3_t dims_;
+};
+
+namespace detail {
+
+/**
+ * Type erased sampler used by VolumeDoubleSampler, one virtual call per sample or batch.
+ */
+template <unsigned int DataDims>
+class VolumeSamplerKernel {
+public:
+    virtual ~VolumeSamplerKernel() = default;
+    virtual Vector<DataDims, double> sample(const dvec3 &pos) const = 0;
+    virtual void sample(const dvec3 *pos, size_t count, Vector<DataDims, double> *result) const = 0;
+};
+
+template <typename T, unsigned int DataDims>
+class TypedVolumeSamplerKernel : public VolumeSamplerKernel<DataDims> {
+public:
+    TypedVolumeSamplerKernel(const VolumeRAMPrecision<T> &ram) : sampler_(ram) {}
+    virtual Vector<DataDims, double> sample(const dvec3 &pos) const override {
+        return sampler_.sample(pos);
+    }
+    virtual void sample(const dvec3 *pos, size_t count,
+                        Vector<DataDims, double> *result) const override {
+        sampler_.sample(pos, pos + count, result);
+    }
+
+private:
+    VolumeRAMSampler<T, DataDims, double> sampler_;
+};
+
+/**
+ * Create a kernel for the format of ram, defined in volumesampler.cpp to avoid instantiating all
+ * the formats in every translation unit. The kernel reads the data of ram, which has to be kept
+ * alive.
+ */
+template <unsigned int DataDims>
+IVW_CORE_API std::shared_ptr<const VolumeSamplerKernel<DataDims>> createVolumeSamplerKernel(
+    const VolumeRAM &ram);
+
+/**
+ * Create a kernel sampling the bricks of bricked, loading only the bricks that are sampled. The
+ * bricks need a ghost border of at least one voxel. The kernel keeps a copy of bricked, which
+ * shares the loader and the cached bricks.
+ */
+template <unsigned int DataDims>
+IVW_CORE_API std::shared_ptr<const VolumeSamplerKernel<DataDims>> createVolumeSamplerKernel(
+    const VolumeBricked &bricked);
+
+/**
+ * The bricked representation to sample vol through, or nullptr if vol should be sampled in RAM.
+ * Bricks are only used for volumes without a RAM representation that do not fit in the
+ * representation memory budget, and that have a ghost border of at least one voxel.
+ */
+IVW_CORE_API const VolumeBricked *getSamplingBricks(const Volume &vol);
+
+}  // namespace detail
+
 /**
  * \class VolumeDoubleSampler
+ * Samples a volume using trilinear interpolation, through a kernel picked once for the data format
+ * of the volume. Volumes that can be loaded in bricks, are not already in RAM, and do not fit in
+ * the representation memory budget, are sampled through their VolumeBricked representation,
+ * loading only the bricks that are sampled. Other volumes are sampled through a VolumeRAMSampler.
  */
 template <unsigned int DataDims>
 class VolumeDoubleSampler : public SpatialSampler<3, DataDims, double> {
@@ -55,29 +177,23 @@ public:
 
     VolumeDoubleSampler &operator=(const VolumeDoubleSampler &) = default;
 
+    using SpatialSampler<3, DataDims, double>::sample;
+
+    /**
+     * Sample all positions, given in the space of the sampler, at once.
+     */
+    std::vector<Vector<DataDims, double>> sample(const std::vector<dvec3> &positions) const;
+
     virtual Vector<DataDims, double> sampleDataSpace(const dvec3 &pos) const override;
     virtual bool withinBoundsDataSpace(const dvec3 &pos) const override;
 
 protected:
-    Vector<DataDims, double> getVoxel(const size3_t &pos) const;
-
     std::shared_ptr<const Volume> volume_;
-    const VolumeRAM *ram_;
+    std::shared_ptr<const VolumeRAM> ram_;
+    std::shared_ptr<const detail::VolumeSamplerKernel<DataDims>> kernel_;
     size3_t dims_;
 };
 
-template <>
-IVW_CORE_API Vector<1, double> VolumeDoubleSampler<1>::getVoxel(const size3_t &pos) const;
-
-template <>
-IVW_CORE_API Vector<2, double> VolumeDoubleSampler<2>::getVoxel(const size3_t &pos) const;
-
-template <>
-IVW_CORE_API Vector<3, double> VolumeDoubleSampler<3>::getVoxel(const size3_t &pos) const;
-
-template <>
-IVW_CORE_API Vector<4, double> VolumeDoubleSampler<4>::getVoxel(const size3_t &pos) const;
-
 using VolumeSampler = VolumeDoubleSampler<4>;
 
 template <unsigned int DataDims>
@@ -90,30 +206,37 @@ VolumeDoubleSampler<DataDims>::VolumeDoubleSampler(std::shared_ptr<const Volume>
 template <unsigned int DataDims>
 VolumeDoubleSampler<DataDims>::VolumeDoubleSampler(const Volume &vol, CoordinateSpace space)
     : SpatialSampler<3, DataDims, double>(vol, space)
-    , ram_(vol.getRepresentation<VolumeRAM>())
-    , dims_(vol.getDimensions()) {}
+    , ram_(nullptr)
+    , dims_(vol.getDimensions()) {
+    if (const auto bricked = detail::getSamplingBricks(vol)) {
+        kernel_ = detail::createVolumeSamplerKernel<DataDims>(*bricked);
+    } else {
+        ram_ = vol.getRepresentationShared<VolumeRAM>();
+        kernel_ = detail::createVolumeSamplerKernel<DataDims>(*ram_);
+    }
+}
 
 template <unsigned int DataDims>
-Vector<DataDims, double> VolumeDoubleSampler<DataDims>::sampleDataSpace(const dvec3 &pos) const {
-    if (!withinBoundsDataSpace(pos)) {
-        return Vector<DataDims, double>(0.0);
+std::vector<Vector<DataDims, double>> VolumeDoubleSampler<DataDims>::sample(
+    const std::vector<dvec3> &positions) const {
+    std::vector<Vector<DataDims, double>> result(positions.size());
+    if (this->space_ != CoordinateSpace::Data) {
+        std::vector<dvec3> dataPositions(positions.size());
+        std::transform(positions.begin(), positions.end(), dataPositions.begin(),
+                       [&](const dvec3 &pos) {
+                           const auto p = this->transform_ * dvec4(pos, 1.0);
+                           return dvec3(p) / p.w;
+                       });
+        kernel_->sample(dataPositions.data(), dataPositions.size(), result.data());
+    } else {
+        kernel_->sample(positions.data(), positions.size(), result.data());
     }
-    const dvec3 samplePos = pos * dvec3(dims_ - size3_t(1));
-    const size3_t indexPos = size3_t(samplePos);
-    const dvec3 interpolants = samplePos - dvec3(indexPos);
-
-    Vector<DataDims, double> samples[8];
-    samples[0] = getVoxel(indexPos);
-    samples[1] = getVoxel(indexPos + size3_t(1, 0, 0));
-    samples[2] = getVoxel(indexPos + size3_t(0, 1, 0));
-    samples[3] = getVoxel(indexPos + size3_t(1, 1, 0));
-
-    samples[4] = getVoxel(indexPos + size3_t(0, 0, 1));
-    samples[5] = getVoxel(indexPos + size3_t(1, 0, 1));
-    samples[6] = getVoxel(indexPos + size3_t(0, 1, 1));
-    samples[7] = getVoxel(indexPos + size3_t(1, 1, 1));
-
-    return Interpolation<Vector<DataDims, double>>::trilinear(samples, interpolants);
+    return result;
+}
+
+template <unsigned int DataDims>
+Vector<DataDims, double> VolumeDoubleSampler<DataDims>::sampleDataSpace(const dvec3 &pos) const {
+    return kernel_->sample(pos);
 }
 
 template <unsigned int DataDims>
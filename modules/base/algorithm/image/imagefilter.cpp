@@ -0,0 +1,377 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *********************************************************************************/
+
+
+#include <modules/base/algorithm/image/imagefilter.h>
+
+#include <inviwo/core/datastructures/image/layer.h>
+#include <inviwo/core/datastructures/image/layerram.h>
+#include <inviwo/core/datastructures/image/layerramprecision.h>
+#include <inviwo/core/datastructures/transferfunction.h>
+#include <inviwo/core/util/formatdispatching.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace inviwo {
+
+namespace util {
+
+namespace {
+
+// Scalar conversions matching how OpenGL normalizes integer textures
+template <typename T, typename std::enable_if<util::is_floating_point<T>::value, int>::type = 0>
+float toNormalized(T v) {
+    return static_cast<float>(v);
+}
+template <typename T, typename std::enable_if<!util::is_floating_point<T>::value &&
+                                                  std::is_unsigned<T>::value,
+                                              int>::type = 0>
+float toNormalized(T v) {
+    return static_cast<float>(v) / static_cast<float>(std::numeric_limits<T>::max());
+}
+template <typename T, typename std::enable_if<!util::is_floating_point<T>::value &&
+                                                  std::is_signed<T>::value,
+                                              int>::type = 0>
+float toNormalized(T v) {
+    return std::max(static_cast<float>(v) / static_cast<float>(std::numeric_limits<T>::max()),
+                    -1.0f);
+}
+
+template <typename T, typename std::enable_if<util::is_floating_point<T>::value, int>::type = 0>
+T fromNormalized(float v) {
+    return static_cast<T>(v);
+}
+template <typename T, typename std::enable_if<!util::is_floating_point<T>::value &&
+                                                  std::is_unsigned<T>::value,
+                                              int>::type = 0>
+T fromNormalized(float v) {
+    return static_cast<T>(
+        std::round(glm::clamp(v, 0.0f, 1.0f) * static_cast<float>(std::numeric_limits<T>::max())));
+}
+template <typename T, typename std::enable_if<!util::is_floating_point<T>::value &&
+                                                  std::is_signed<T>::value,
+                                              int>::type = 0>
+T fromNormalized(float v) {
+    return static_cast<T>(std::round(glm::clamp(v, -1.0f, 1.0f) *
+                                     static_cast<float>(std::numeric_limits<T>::max())));
+}
+
+template <typename T>
+vec4 toPixel(const T& value) {
+    using V = typename util::value_type<T>::type;
+    const size_t components = DataFormat<T>::components();
+    vec4 res(0.0f, 0.0f, 0.0f, 1.0f);
+    for (size_t c = 0; c < components; ++c) {
+        res[static_cast<glm::length_t>(c)] = toNormalized<V>(util::glmcomp(value, c));
+    }
+    return res;
+}
+
+template <typename T>
+T fromPixel(const vec4& pixel) {
+    using V = typename util::value_type<T>::type;
+    const size_t components = DataFormat<T>::components();
+    T res{0};
+    for (size_t c = 0; c < components; ++c) {
+        util::glmcomp(res, c) = fromNormalized<V>(pixel[static_cast<glm::length_t>(c)]);
+    }
+    return res;
+}
+
+struct LayerFromPixels {
+    template <typename Result, typename Format>
+    Result operator()(const FilterImage& image, const SwizzleMask& swizzleMask) {
+        using T = typename Format::type;
+        auto ram =
+            std::make_shared<LayerRAMPrecision<T>>(image.dims, LayerType::Color, swizzleMask);
+        auto dst = ram->getDataTyped();
+        forEachRangeParallel(image.dims.y, 1, [&](size_t y0, size_t y1) {
+            for (size_t i = y0 * image.dims.x; i < y1 * image.dims.x; ++i) {
+                dst[i] = fromPixel<T>(image.pixels[i]);
+            }
+        });
+        return std::make_shared<Layer>(ram);
+    }
+};
+
+// Integer taps with weights for a kernel with taps one pixel apart centered on the pixel.
+// For an even number of taps the positions fall halfway between pixels and each weight is
+// split between the two neighbors, as linear texture filtering does.
+std::vector<std::pair<int, float>> integerTaps(const std::vector<float>& kernel) {
+    const int size = static_cast<int>(kernel.size());
+    std::vector<std::pair<int, float>> taps;
+    if (size % 2 == 1) {
+        for (int i = 0; i < size; ++i) taps.emplace_back(i - (size - 1) / 2, kernel[i]);
+    } else {
+        for (int i = 0; i <= size; ++i) taps.emplace_back(i - size / 2, 0.0f);
+        for (int i = 0; i < size; ++i) {
+            taps[i].second += 0.5f * kernel[i];
+            taps[i + 1].second += 0.5f * kernel[i];
+        }
+    }
+    return taps;
+}
+
+size_t clampIndex(std::ptrdiff_t i, size_t size) {
+    return static_cast<size_t>(
+        glm::clamp(i, std::ptrdiff_t{0}, static_cast<std::ptrdiff_t>(size) - 1));
+}
+
+// Bilinear lookup at a position in pixel coordinates with clamp to edge, as a texture lookup
+// at (pos + 0.5) / dims
+vec4 sampleBilinear(const FilterImage& image, const vec2& pos) {
+    const vec2 base = glm::floor(pos);
+    const vec2 t = pos - base;
+    const auto x0 = static_cast<std::ptrdiff_t>(base.x);
+    const auto y0 = static_cast<std::ptrdiff_t>(base.y);
+    const size_t xa = clampIndex(x0, image.dims.x);
+    const size_t xb = clampIndex(x0 + 1, image.dims.x);
+    const size_t ya = clampIndex(y0, image.dims.y);
+    const size_t yb = clampIndex(y0 + 1, image.dims.y);
+    return glm::mix(glm::mix(image(xa, ya), image(xb, ya), t.x),
+                    glm::mix(image(xa, yb), image(xb, yb), t.x), t.y);
+}
+
+// Cubic B-spline weights for the four pixels around a position with fraction t
+vec4 cubicWeights(float t) {
+    const vec4 n = vec4(1.0f, 2.0f, 3.0f, 4.0f) - t;
+    const vec4 s = n * n * n;
+    const float x = s.x;
+    const float y = s.y - 4.0f * s.x;
+    const float z = s.z - 4.0f * s.y + 6.0f * s.x;
+    const float w = 6.0f - x - y - z;
+    return vec4(x, y, z, w) / 6.0f;
+}
+
+vec4 sampleBicubic(const FilterImage& image, const vec2& pos) {
+    const vec2 base = glm::floor(pos);
+    const vec4 wx = cubicWeights(pos.x - base.x);
+    const vec4 wy = cubicWeights(pos.y - base.y);
+    const auto x0 = static_cast<std::ptrdiff_t>(base.x) - 1;
+    const auto y0 = static_cast<std::ptrdiff_t>(base.y) - 1;
+    vec4 res(0.0f);
+    for (glm::length_t j = 0; j < 4; ++j) {
+        const size_t y = clampIndex(y0 + j, image.dims.y);
+        vec4 row(0.0f);
+        for (glm::length_t i = 0; i < 4; ++i) {
+            row += wx[i] * image(clampIndex(x0 + i, image.dims.x), y);
+        }
+        res += wy[j] * row;
+    }
+    return res;
+}
+
+}  // namespace
+
+FilterImage::FilterImage(const size2_t& dims) : dims(dims), pixels(dims.x * dims.y) {}
+
+FilterImage::FilterImage(const LayerRAM& layer)
+    : dims(layer.getDimensions()), pixels(dims.x * dims.y) {
+    layer.dispatch<void>([&](const auto lrprecision) {
+        const auto src = lrprecision->getDataTyped();
+        forEachRangeParallel(dims.y, 1, [&](size_t y0, size_t y1) {
+            for (size_t i = y0 * dims.x; i < y1 * dims.x; ++i) pixels[i] = toPixel(src[i]);
+        });
+    });
+}
+
+std::shared_ptr<Layer> FilterImage::toLayer(const DataFormatBase* format,
+                                            const SwizzleMask& swizzleMask) const {
+    return dispatching::dispatch<std::shared_ptr<Layer>, dispatching::filter::All>(
+        format->getId(), LayerFromPixels{}, *this, swizzleMask);
+}
+
+FilterImage convolveSeparable(const FilterImage& image, const std::vector<float>& kernel,
+                              float kernelScale) {
+    if (kernel.size() <= 1) return image;
+
+    const auto taps = integerTaps(kernel);
+    const int radius = -taps.front().first;
+    const size2_t dims = image.dims;
+    const float scale = 1.0f / kernelScale;
+
+    // Horizontal pass, each row is padded with its border pixels
+    FilterImage hori(dims);
+    forEachRangeParallel(dims.y, 1, [&](size_t y0, size_t y1) {
+        std::vector<vec3> row(dims.x + 2 * radius);
+        for (size_t y = y0; y < y1; ++y) {
+            const vec4* src = &image.pixels[y * dims.x];
+            for (size_t i = 0; i < row.size(); ++i) {
+                row[i] = vec3(src[clampIndex(static_cast<std::ptrdiff_t>(i) - radius, dims.x)]);
+            }
+            vec4* dst = &hori.pixels[y * dims.x];
+            for (size_t x = 0; x < dims.x; ++x) {
+                vec3 sum(0.0f);
+                for (const auto& tap : taps) sum += tap.second * row[x + radius + tap.first];
+                dst[x] = vec4(sum * scale, src[x].a);
+            }
+        }
+    });
+
+    // Vertical pass, whole rows are accumulated to keep the inner loop contiguous
+    FilterImage res(dims);
+    forEachRangeParallel(dims.y, 1, [&](size_t y0, size_t y1) {
+        std::vector<vec3> sum(dims.x);
+        for (size_t y = y0; y < y1; ++y) {
+            std::fill(sum.begin(), sum.end(), vec3(0.0f));
+            for (const auto& tap : taps) {
+                const size_t sy = clampIndex(static_cast<std::ptrdiff_t>(y) + tap.first, dims.y);
+                const vec4* src = &hori.pixels[sy * dims.x];
+                for (size_t x = 0; x < dims.x; ++x) sum[x] += tap.second * vec3(src[x]);
+            }
+            const vec4* center = &image.pixels[y * dims.x];
+            vec4* dst = &res.pixels[y * dims.x];
+            for (size_t x = 0; x < dims.x; ++x) dst[x] = vec4(sum[x] * scale, center[x].a);
+        }
+    });
+    return res;
+}
+
+FilterImage gaussianLowpass(const FilterImage& image, float sigma) {
+    // 99% of samples are within +- 2.576 standard deviations
+    const int kernelSize = static_cast<int>(sigma * 2 * 2.576);
+    const float sigmaSq2 = 2.0f * sigma * sigma;
+    const float a = 1.0f / (sigmaSq2 * glm::pi<float>());
+
+    std::vector<float> kernel(std::max(kernelSize, 0));
+    const float kernelCenter = (kernelSize - 1) / 2.0f;
+    float totWeight = 0.0f;
+    for (int i = 0; i < kernelSize; ++i) {
+        const float p = i - kernelCenter;
+        kernel[i] = a * std::exp(-(p * p) / sigmaSq2);
+        totWeight += kernel[i];
+    }
+    return convolveSeparable(image, kernel, totWeight);
+}
+
+FilterImage lowpass(const FilterImage& image, int kernelSize) {
+    return convolveSeparable(image, std::vector<float>(std::max(kernelSize, 0), 1.0f),
+                             static_cast<float>(kernelSize));
+}
+
+FilterImage highpass(const FilterImage& image, int kernelSize, bool sharpen) {
+    const size2_t dims = image.dims;
+    const auto k2 = static_cast<std::ptrdiff_t>(kernelSize / 2);
+    const auto count = static_cast<float>((2 * k2 + 1) * (2 * k2 + 1) - 1);
+    if (k2 == 0) {
+        return transformPixels(image, [sharpen](const vec4& p) {
+            return sharpen ? p : vec4(vec3(0.5f), p.a);
+        });
+    }
+
+    // The window sums use column sums over the rows of the window
+    FilterImage res(dims);
+    forEachRangeParallel(dims.y, 1, [&](size_t y0, size_t y1) {
+        std::vector<vec3> columns(dims.x);
+        for (size_t y = y0; y < y1; ++y) {
+            std::fill(columns.begin(), columns.end(), vec3(0.0f));
+            for (auto dy = -k2; dy <= k2; ++dy) {
+                const size_t sy = clampIndex(static_cast<std::ptrdiff_t>(y) + dy, dims.y);
+                const vec4* src = &image.pixels[sy * dims.x];
+                for (size_t x = 0; x < dims.x; ++x) columns[x] += vec3(src[x]);
+            }
+            const vec4* src = &image.pixels[y * dims.x];
+            vec4* dst = &res.pixels[y * dims.x];
+            for (size_t x = 0; x < dims.x; ++x) {
+                vec3 sum(-vec3(src[x]));
+                for (auto dx = -k2; dx <= k2; ++dx) {
+                    sum += columns[clampIndex(static_cast<std::ptrdiff_t>(x) + dx, dims.x)];
+                }
+                const vec3 p(src[x]);
+                const vec3 mean = sum / count;
+                dst[x] = vec4(sharpen ? 2.0f * p - mean : (p - mean + 1.0f) * 0.5f, src[x].a);
+            }
+        }
+    });
+    return res;
+}
+
+FilterImage gradient(const FilterImage& image, size_t channel, bool renormalize) {
+    const size2_t dims = image.dims;
+    const auto c = static_cast<glm::length_t>(glm::clamp(channel, size_t{0}, size_t{3}));
+    const float scale = renormalize ? 0.5f * static_cast<float>(dims.x) : 0.5f;
+
+    FilterImage res(dims);
+    forEachRangeParallel(dims.y, 1, [&](size_t y0, size_t y1) {
+        for (size_t y = y0; y < y1; ++y) {
+            const size_t yp = std::min(y + 1, dims.y - 1);
+            const size_t ym = y > 0 ? y - 1 : 0;
+            for (size_t x = 0; x < dims.x; ++x) {
+                const size_t xp = std::min(x + 1, dims.x - 1);
+                const size_t xm = x > 0 ? x - 1 : 0;
+                const float gx = (image(xp, y)[c] - image(xm, y)[c]) * scale;
+                const float gy = (image(x, yp)[c] - image(x, ym)[c]) * scale;
+                res(x, y) = vec4(gx, gy, 0.0f, 1.0f);
+            }
+        }
+    });
+    return res;
+}
+
+FilterImage mapValues(const FilterImage& image, const TransferFunction& tf) {
+    const auto tfRam = tf.getData()->getRepresentation<LayerRAM>();
+    const size_t n = tfRam->getDimensions().x;
+    std::vector<vec4> lut(n);
+    for (size_t i = 0; i < n; ++i) lut[i] = vec4(tfRam->getAsNormalizedDVec4(size2_t(i, 0)));
+
+    // Linear lookup matching a clamped and linearly filtered texture, see applyTF in
+    // classification.glsl
+    return transformPixels(image, [&lut, n](const vec4& p) {
+        const float pos =
+            glm::clamp(p.r * static_cast<float>(n) - 0.5f, 0.0f, static_cast<float>(n - 1));
+        const size_t i0 = static_cast<size_t>(pos);
+        const size_t i1 = std::min(i0 + 1, n - 1);
+        return glm::mix(lut[i0], lut[i1], pos - static_cast<float>(i0));
+    });
+}
+
+FilterImage resample(const FilterImage& image, const size2_t& dims,
+                     ImageInterpolation interpolation) {
+    FilterImage res(dims);
+    if (image.pixels.empty()) return res;
+    const vec2 scale = vec2(image.dims) / vec2(dims);
+
+    forEachRangeParallel(dims.y, 1, [&](size_t y0, size_t y1) {
+        for (size_t y = y0; y < y1; ++y) {
+            for (size_t x = 0; x < dims.x; ++x) {
+                const vec2 pos = (vec2(x, y) + 0.5f) * scale - 0.5f;
+                res(x, y) = interpolation == ImageInterpolation::Bicubic
+                                ? sampleBicubic(image, pos)
+                                : sampleBilinear(image, pos);
+            }
+        }
+    });
+    return res;
+}
+
+}  // namespace util
+
+}  // namespace inviwo
@@ -0,0 +1,142 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *********************************************************************************/
+
+#ifndef IVW_IMAGEFILTER_H
+#define IVW_IMAGEFILTER_H
+
+#include <modules/base/basemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/image/imagetypes.h>
+#include <inviwo/core/util/foreach.h>
+
+#include <memory>
+#include <vector>
+
+namespace inviwo {
+
+class Layer;
+class LayerRAM;
+class DataFormatBase;
+class TransferFunction;
+
+namespace util {
+
+/**
+ * Image data for the CPU image filters. Each pixel holds the normalized RGBA values an OpenGL
+ * shader reads from the texture of a layer, i.e. integer data is normalized, missing
+ * components are zero and a missing alpha is one. The filters then give the same results as
+ * the corresponding shaders in the basegl module. Rows are stored bottom up, as in LayerRAM.
+ */
+struct IVW_MODULE_BASE_API FilterImage {
+    FilterImage() = default;
+    explicit FilterImage(const size2_t& dims);
+    /// Convert the data of a LayerRAMPrecision<T> of any format
+    explicit FilterImage(const LayerRAM& layer);
+
+    /**
+     * Create a layer of the given format from the pixels. Values are clamped to the normalized
+     * range of integer formats, components beyond those of the format are dropped.
+     */
+    std::shared_ptr<Layer> toLayer(const DataFormatBase* format,
+                                   const SwizzleMask& swizzleMask = swizzlemasks::rgba) const;
+
+    vec4& operator()(size_t x, size_t y) { return pixels[y * dims.x + x]; }
+    const vec4& operator()(size_t x, size_t y) const { return pixels[y * dims.x + x]; }
+
+    size2_t dims{0};
+    std::vector<vec4> pixels;
+};
+
+/**
+ * Apply a point operation, func maps the value of a pixel to the new value of the pixel.
+ */
+template <typename Func>
+FilterImage transformPixels(const FilterImage& image, Func func) {
+    FilterImage res(image.dims);
+    forEachRangeParallel(image.dims.y, 1, [&](size_t y0, size_t y1) {
+        const vec4* src = image.pixels.data();
+        vec4* dst = res.pixels.data();
+        for (size_t i = y0 * image.dims.x; i < y1 * image.dims.x; ++i) dst[i] = func(src[i]);
+    });
+    return res;
+}
+
+/**
+ * Convolve the RGB channels with kernel along x and then along y, the alpha channel is kept.
+ * The taps are one pixel apart and centered on the pixel. For an even number of taps they fall
+ * between pixels and the image is linearly interpolated, as when sampling a texture. Pixels
+ * outside the image are clamped to the border. The result is divided by kernelScale.
+ */
+IVW_MODULE_BASE_API FilterImage convolveSeparable(const FilterImage& image,
+                                                  const std::vector<float>& kernel,
+                                                  float kernelScale);
+
+/**
+ * Gaussian low pass filter, the kernel covers +-2.576 sigma as in ImageConvolution.
+ */
+IVW_MODULE_BASE_API FilterImage gaussianLowpass(const FilterImage& image, float sigma);
+
+/**
+ * Low pass filter with constant weights.
+ */
+IVW_MODULE_BASE_API FilterImage lowpass(const FilterImage& image, int kernelSize);
+
+/**
+ * High pass filter based on the mean of the kernelSize x kernelSize neighborhood excluding the
+ * pixel itself. The RGB channels are mapped to (p - mean + 1) / 2, or to 2p - mean if sharpen is
+ * set. The alpha channel is kept.
+ */
+IVW_MODULE_BASE_API FilterImage highpass(const FilterImage& image, int kernelSize, bool sharpen);
+
+/**
+ * Central difference gradient of one channel, stored in the first two components. The gradient
+ * is per pixel, or scaled by the image width if renormalize is set.
+ */
+IVW_MODULE_BASE_API FilterImage gradient(const FilterImage& image, size_t channel,
+                                         bool renormalize);
+
+/**
+ * Map the first channel to RGBA with the transfer function.
+ */
+IVW_MODULE_BASE_API FilterImage mapValues(const FilterImage& image, const TransferFunction& tf);
+
+enum class ImageInterpolation { Bilinear, Bicubic };
+
+/**
+ * Resample the image to the given dimensions. Bicubic interpolation uses cubic B-spline weights,
+ * as img_resample.frag.
+ */
+IVW_MODULE_BASE_API FilterImage resample(const FilterImage& image, const size2_t& dims,
+                                         ImageInterpolation interpolation);
+
+}  // namespace util
+
+}  // namespace inviwo
+
+#endif  // IVW_IMAGEFILTER_H
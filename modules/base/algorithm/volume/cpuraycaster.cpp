@@ -0,0 +1,433 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/base/algorithm/volume/cpuraycaster.h>
+
+#include <inviwo/core/datastructures/image/image.h>
+#include <inviwo/core/datastructures/image/layerramprecision.h>
+#include <inviwo/core/datastructures/transferfunction.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/exception.h>
+#include <inviwo/core/util/foreach.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace inviwo {
+
+namespace {
+
+// Same constants as the OpenGL raycaster, see compositing.glsl and raycasting.frag
+constexpr float refSamplingInterval = 150.0f;
+constexpr float earlyRayTermination = 0.99f;
+constexpr size_t tileSize = 16;
+
+// Values are normalized by the data range as getNormalizedVoxel in sampler3d.glsl, i.e.
+// (value - offset) * scale
+float rangeOffset(const dvec2& range) { return static_cast<float>(range.x); }
+float rangeScale(const dvec2& range) {
+    return static_cast<float>(range.y > range.x ? 1.0 / (range.y - range.x) : 1.0);
+}
+
+void checkChannel(const VolumeRAM& ram, size_t channel) {
+    if (channel >= ram.getDataFormat()->getComponents()) {
+        throw Exception("Channel " + toString(channel) + " out of range",
+                        IvwContextCustom("CPURaycaster"));
+    }
+}
+
+// Linear lookup in a transfer function table, matching a clamped and linearly filtered texture
+vec4 applyTF(const std::vector<vec4>& lut, float value) {
+    const size_t n = lut.size();
+    const float pos = glm::clamp(value * static_cast<float>(n) - 0.5f, 0.0f,
+                                 static_cast<float>(n - 1));
+    const size_t i0 = static_cast<size_t>(pos);
+    const size_t i1 = std::min(i0 + 1, n - 1);
+    return glm::mix(lut[i0], lut[i1], pos - static_cast<float>(i0));
+}
+
+// The functions below mirror the ones in shading.glsl
+vec3 shadeDiffuse(const CPURaycastingLight& light, const vec3& color, const vec3& normal,
+                  const vec3& toLightDir) {
+    return color * light.diffuseColor * std::max(glm::dot(normal, toLightDir), 0.0f);
+}
+
+vec3 shadeSpecularBlinnPhong(const CPURaycastingLight& light, const vec3& normal,
+                             const vec3& toLightDir, const vec3& toCameraDir) {
+    const vec3 halfway = toCameraDir + toLightDir;
+    if (glm::dot(halfway, halfway) < 1.0e-6f) return vec3(0.0f);
+    const float cosAngle = std::max(glm::dot(normal, glm::normalize(halfway)), 0.0f);
+    return light.specularColor * std::pow(cosAngle, light.specularExponent);
+}
+
+vec3 shadeSpecularPhong(const CPURaycastingLight& light, const vec3& normal,
+                        const vec3& toLightDir, const vec3& toCameraDir) {
+    if (glm::dot(toLightDir, normal) < 0.0f) return vec3(0.0f);
+    const float cosAngle = std::max(glm::dot(glm::reflect(-toLightDir, normal), toCameraDir), 0.0f);
+    return light.specularColor * std::pow(cosAngle, light.specularExponent * 0.25f);
+}
+
+// The material ambient and diffuse colors are the sample color, the specular color is white
+vec3 shade(const CPURaycastingLight& light, const vec3& color, const vec3& position,
+           const vec3& normal, const vec3& toCameraDir) {
+    const vec3 toLightDir = glm::normalize(light.position - position);
+    switch (light.shadingMode) {
+        case ShadingMode::Ambient:
+            return color * light.ambientColor;
+        case ShadingMode::Diffuse:
+            return shadeDiffuse(light, color, normal, toLightDir);
+        case ShadingMode::Specular:
+            return shadeSpecularPhong(light, normal, toLightDir, toCameraDir);
+        case ShadingMode::BlinnPhong:
+            return color * light.ambientColor + shadeDiffuse(light, color, normal, toLightDir) +
+                   shadeSpecularBlinnPhong(light, normal, toLightDir, toCameraDir);
+        case ShadingMode::Phong:
+            return color * light.ambientColor + shadeDiffuse(light, color, normal, toLightDir) +
+                   shadeSpecularPhong(light, normal, toLightDir, toCameraDir);
+        case ShadingMode::None:
+        default:
+            return color;
+    }
+}
+
+}  // namespace
+
+MacroCellGrid::MacroCellGrid(const std::vector<float>& values, const size3_t& dims,
+                             size_t cellSize)
+    : dims_{1}, cellSize_{std::max(size_t{1}, cellSize)} {
+
+    if (values.size() != glm::compMul(dims)) {
+        throw Exception("Expected one value per voxel", IvwContextCustom("MacroCellGrid"));
+    }
+    build([&](size_t i) { return values[i]; }, dims);
+}
+
+MacroCellGrid::MacroCellGrid(const VolumeRAM& ram, size_t channel, const dvec2& dataRange,
+                             size_t cellSize)
+    : dims_{1}, cellSize_{std::max(size_t{1}, cellSize)} {
+
+    checkChannel(ram, channel);
+    const float offset = rangeOffset(dataRange);
+    const float scale = rangeScale(dataRange);
+    ram.dispatch<void>([&](auto vrprecision) {
+        const auto data = vrprecision->getDataTyped();
+        build(
+            [&](size_t i) {
+                return (static_cast<float>(util::glmcomp(data[i], channel)) - offset) * scale;
+            },
+            ram.getDimensions());
+    });
+}
+
+template <typename Value>
+void MacroCellGrid::build(Value value, const size3_t& dims) {
+    const size3_t last = glm::max(dims, size3_t(1)) - size3_t(1);
+    dims_ = glm::max((last + cellSize_ - size_t{1}) / cellSize_, size3_t(1));
+    ranges_.resize(glm::compMul(dims_));
+
+    const size_t sliceSize = dims.x * dims.y;
+    util::forEachRangeParallel(dims_.z, 1, [&](size_t cz0, size_t cz1) {
+        for (size_t cz = cz0; cz < cz1; ++cz) {
+            const size_t z0 = cz * cellSize_, z1 = std::min((cz + 1) * cellSize_, last.z);
+            for (size_t cy = 0; cy < dims_.y; ++cy) {
+                const size_t y0 = cy * cellSize_, y1 = std::min((cy + 1) * cellSize_, last.y);
+                for (size_t cx = 0; cx < dims_.x; ++cx) {
+                    const size_t x0 = cx * cellSize_, x1 = std::min((cx + 1) * cellSize_, last.x);
+                    vec2 range{std::numeric_limits<float>::max(),
+                               std::numeric_limits<float>::lowest()};
+                    for (size_t z = z0; z <= z1; ++z) {
+                        for (size_t y = y0; y <= y1; ++y) {
+                            const size_t row = z * sliceSize + y * dims.x;
+                            for (size_t x = x0; x <= x1; ++x) {
+                                const float v = value(row + x);
+                                range.x = std::min(range.x, v);
+                                range.y = std::max(range.y, v);
+                            }
+                        }
+                    }
+                    ranges_[cx + dims_.x * (cy + dims_.y * cz)] = range;
+                }
+            }
+        }
+    });
+}
+
+size3_t MacroCellGrid::getDimensions() const { return dims_; }
+
+size_t MacroCellGrid::getCellSize() const { return cellSize_; }
+
+vec2 MacroCellGrid::getRange(const size3_t& cell) const {
+    return ranges_[cell.x + dims_.x * (cell.y + dims_.y * cell.z)];
+}
+
+std::vector<unsigned char> MacroCellGrid::classify(const std::vector<vec4>& lut) const {
+    std::vector<unsigned char> visible(ranges_.size(), 0);
+    if (lut.empty()) return visible;
+
+    // Number of entries with nonzero opacity before each entry, the lookup is linearly
+    // interpolated so a value range covers the entries surrounding its ends
+    const size_t n = lut.size();
+    std::vector<size_t> opaque(n + 1, 0);
+    for (size_t i = 0; i < n; ++i) opaque[i + 1] = opaque[i] + (lut[i].a > 0.0f ? 1 : 0);
+    if (opaque[n] == 0) return visible;
+
+    const auto texel = [&](float v) {
+        return glm::clamp(v * static_cast<float>(n) - 0.5f, 0.0f, static_cast<float>(n - 1));
+    };
+    for (size_t i = 0; i < ranges_.size(); ++i) {
+        const size_t lo = static_cast<size_t>(std::floor(texel(ranges_[i].x)));
+        const size_t hi = static_cast<size_t>(std::ceil(texel(ranges_[i].y)));
+        visible[i] = opaque[hi + 1] > opaque[lo] ? 1 : 0;
+    }
+    return visible;
+}
+
+CPURaycastingLight::CPURaycastingLight(const SimpleLightingProperty& lighting)
+    : shadingMode{static_cast<ShadingMode::Modes>(lighting.shadingMode_.get())}
+    , position{lighting.getTransformedPosition()}
+    , ambientColor{lighting.ambientColor_.get()}
+    , diffuseColor{lighting.diffuseColor_.get()}
+    , specularColor{lighting.specularColor_.get()}
+    , specularExponent{lighting.specularExponent_.get()} {}
+
+/**
+ * A ray segment clipped to the volume. Positions and directions are in data space except where
+ * noted, samples are taken at (i + 0.5) * tIncr for i in [0, samples).
+ */
+struct CPURaycaster::Ray {
+    vec3 entry;
+    vec3 direction;
+    float tEnd;
+    float tIncr;
+    size_t samples;
+    vec3 worldEntry;
+    vec3 worldDirection;
+    vec3 toCameraDir;  ///< World space
+};
+
+CPURaycaster::CPURaycaster(const Volume& volume, size_t channel)
+    : ram_{volume.getRepresentationShared<VolumeRAM>()}
+    , channel_{channel}
+    , offset_{rangeOffset(volume.dataMap_.dataRange)}
+    , scale_{rangeScale(volume.dataMap_.dataRange)}
+    , dims_{volume.getDimensions()}
+    , cells_{*ram_, channel_, volume.dataMap_.dataRange}
+    , worldToData_{volume.getCoordinateTransformer().getWorldToDataMatrix()}
+    , dataToWorld_{volume.getCoordinateTransformer().getDataToWorldMatrix()}
+    , indexGradientToWorld_{glm::transpose(mat3(glm::diagonal3x3(vec3(dims_ - size3_t(1)))) *
+                                           mat3(worldToData_))} {}
+
+const MacroCellGrid& CPURaycaster::getMacroCells() const { return cells_; }
+
+std::shared_ptr<Image> CPURaycaster::render(const size2_t& dims, const mat4& viewProjection,
+                                            const TransferFunction& tf,
+                                            const CPURaycastingLight& light,
+                                            float samplingRate) const {
+    const auto tfRAM = tf.getData()->getRepresentation<LayerRAM>();
+    const auto tfData = static_cast<const vec4*>(tfRAM->getData());
+    const std::vector<vec4> lut(tfData, tfData + tfRAM->getDimensions().x);
+    const auto visible = cells_.classify(lut);
+
+    auto colorRAM = std::make_shared<LayerRAMPrecision<glm::u8vec4>>(dims);
+    auto image = std::make_shared<Image>(std::make_shared<Layer>(colorRAM));
+    auto out = colorRAM->getDataTyped();
+
+    const mat4 clipToWorld = glm::inverse(viewProjection);
+    const mat3 dataToWorldDir{dataToWorld_};
+    const vec3 voxels{dims_};
+    const bool empty =
+        std::none_of(visible.begin(), visible.end(), [](unsigned char v) { return v != 0; });
+
+    // Set up the ray through the pixel center between the near and the far plane, clipped to
+    // the unit cube in data space. Returns false if the ray misses the volume.
+    const auto setupRay = [&](const size2_t& pixel, Ray& ray) {
+        const vec2 ndc = (vec2(pixel) + 0.5f) / vec2(dims) * 2.0f - 1.0f;
+        vec4 nearWorld = clipToWorld * vec4(ndc, -1.0f, 1.0f);
+        vec4 farWorld = clipToWorld * vec4(ndc, 1.0f, 1.0f);
+        nearWorld /= nearWorld.w;
+        farWorld /= farWorld.w;
+
+        const vec3 a{worldToData_ * nearWorld};
+        const vec3 d = vec3(worldToData_ * farWorld) - a;
+        float s0 = 0.0f, s1 = 1.0f;
+        for (int k = 0; k < 3; ++k) {
+            if (d[k] == 0.0f) {
+                if (a[k] < 0.0f || a[k] > 1.0f) return false;
+            } else {
+                float t0 = -a[k] / d[k];
+                float t1 = (1.0f - a[k]) / d[k];
+                if (t0 > t1) std::swap(t0, t1);
+                s0 = std::max(s0, t0);
+                s1 = std::min(s1, t1);
+            }
+        }
+        if (s0 >= s1) return false;
+
+        const vec3 segment = (s1 - s0) * d;
+        ray.tEnd = glm::length(segment);
+        if (ray.tEnd <= 0.0f) return false;
+        ray.entry = a + s0 * d;
+        ray.direction = segment / ray.tEnd;
+        ray.samples = std::max(
+            size_t{1},
+            static_cast<size_t>(std::ceil(samplingRate * glm::length(segment * voxels))));
+        ray.tIncr = ray.tEnd / static_cast<float>(ray.samples);
+        ray.worldEntry = vec3(dataToWorld_ * vec4(ray.entry, 1.0f));
+        ray.worldDirection = dataToWorldDir * ray.direction;
+        ray.toCameraDir = glm::normalize(vec3(nearWorld) - vec3(farWorld));
+        return true;
+    };
+
+    // Tiles are handed out dynamically since the cost per tile varies a lot with the content, the
+    // ranges only decide the number of tasks taking tiles from the shared counter
+    const size2_t tiles = (dims + tileSize - size_t{1}) / tileSize;
+    const size_t tileCount = tiles.x * tiles.y;
+    std::atomic<size_t> nextTile{0};
+    ram_->dispatch<void>([&](auto vrprecision) {
+        const auto data = vrprecision->getDataTyped();
+        util::forEachRangeParallel(tileCount, 1, [&](size_t, size_t) {
+            Ray ray;
+            for (size_t tile = nextTile++; tile < tileCount; tile = nextTile++) {
+                const size2_t start = size2_t(tile % tiles.x, tile / tiles.x) * tileSize;
+                const size2_t stop = glm::min(start + tileSize, dims);
+                size2_t pixel;
+                for (pixel.y = start.y; pixel.y < stop.y; ++pixel.y) {
+                    for (pixel.x = start.x; pixel.x < stop.x; ++pixel.x) {
+                        vec4 color{0.0f};
+                        if (!empty && setupRay(pixel, ray)) {
+                            color = castRay(data, ray, lut, visible, light);
+                        }
+                        out[pixel.y * dims.x + pixel.x] =
+                            glm::u8vec4(glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f);
+                    }
+                }
+            }
+        });
+    });
+
+    return image;
+}
+
+template <typename T>
+vec4 CPURaycaster::castRay(const T* data, const Ray& ray, const std::vector<vec4>& lut,
+                           const std::vector<unsigned char>& visible,
+                           const CPURaycastingLight& light) const {
+    // The ray in index space, index = origin + t * dir
+    const vec3 steps{dims_ - size3_t(1)};
+    const vec3 origin = ray.entry * steps;
+    const vec3 dir = ray.direction * steps;
+    const size3_t cellDims = cells_.getDimensions();
+    const size3_t lastCell = cellDims - size3_t(1);
+    const float cellSize = static_cast<float>(cells_.getCellSize());
+
+    vec4 result{0.0f};
+    size_t i = 0;
+    while (i < ray.samples) {
+        const float t = (static_cast<float>(i) + 0.5f) * ray.tIncr;
+        const vec3 index = glm::clamp(origin + t * dir, vec3(0.0f), steps);
+        const size3_t cell = glm::min(size3_t(index / cellSize), lastCell);
+
+        if (!visible[cell.x + cellDims.x * (cell.y + cellDims.y * cell.z)]) {
+            // Continue with the first sample at or beyond the exit of the cell
+            float tExit = ray.tEnd;
+            for (int k = 0; k < 3; ++k) {
+                if (dir[k] > 0.0f) {
+                    tExit = std::min(tExit, ((cell[k] + 1) * cellSize - origin[k]) / dir[k]);
+                } else if (dir[k] < 0.0f) {
+                    tExit = std::min(tExit, (cell[k] * cellSize - origin[k]) / dir[k]);
+                }
+            }
+            const float next = std::ceil(tExit / ray.tIncr - 0.5f);
+            i = std::max(i + 1, next > 0.0f ? static_cast<size_t>(next) : size_t{0});
+            continue;
+        }
+
+        const vec4 color = applyTF(lut, sample(data, index));
+        if (color.a > 0.0f) {
+            vec3 rgb{color};
+            if (light.shadingMode != ShadingMode::None) {
+                // The normal points towards lower values, i.e. against the gradient
+                const vec3 g = gradient(data, index);
+                const float length = glm::length(g);
+                const vec3 normal = length > 0.0f ? -g / length : vec3(0.0f);
+                rgb = shade(light, rgb, ray.worldEntry + t * ray.worldDirection, normal,
+                            ray.toCameraDir);
+            }
+            const float alpha = 1.0f - std::pow(1.0f - color.a, ray.tIncr * refSamplingInterval);
+            result += (1.0f - result.a) * vec4(alpha * rgb, alpha);
+            if (result.a > earlyRayTermination) break;
+        }
+        ++i;
+    }
+    return result;
+}
+
+template <typename T>
+float CPURaycaster::sample(const T* data, const vec3& index) const {
+    const size3_t last = dims_ - size3_t(1);
+    const vec3 pos = glm::clamp(index, vec3(0.0f), vec3(last));
+    const size3_t lower = glm::min(size3_t(pos), last);
+    const size3_t upper = glm::min(lower + size3_t(1), last);
+    const vec3 f = pos - vec3(lower);
+
+    const size_t x0 = lower.x, x1 = upper.x;
+    const size_t y0 = lower.y * dims_.x, y1 = upper.y * dims_.x;
+    const size_t z0 = lower.z * dims_.x * dims_.y, z1 = upper.z * dims_.x * dims_.y;
+    // Interpolate the raw values, the normalization is linear and applied to the result
+    const auto v = [&](size_t i) { return static_cast<float>(util::glmcomp(data[i], channel_)); };
+
+    const auto lerp = [&](size_t i0, size_t i1) {
+        const float a = v(i0);
+        return a + f.x * (v(i1) - a);
+    };
+    const float c00 = lerp(x0 + y0 + z0, x1 + y0 + z0);
+    const float c10 = lerp(x0 + y1 + z0, x1 + y1 + z0);
+    const float c01 = lerp(x0 + y0 + z1, x1 + y0 + z1);
+    const float c11 = lerp(x0 + y1 + z1, x1 + y1 + z1);
+    const float c0 = c00 + f.y * (c10 - c00);
+    const float c1 = c01 + f.y * (c11 - c01);
+    return (c0 + f.z * (c1 - c0) - offset_) * scale_;
+}
+
+template <typename T>
+vec3 CPURaycaster::gradient(const T* data, const vec3& index) const {
+    // Central differences with a one voxel step, as gradientCentralDiff in gradients.glsl
+    vec3 g;
+    for (int k = 0; k < 3; ++k) {
+        vec3 h{0.0f};
+        h[k] = 1.0f;
+        g[k] = 0.5f * (sample(data, index + h) - sample(data, index - h));
+    }
+    return indexGradientToWorld_ * g;
+}
+
+}  // namespace inviwo
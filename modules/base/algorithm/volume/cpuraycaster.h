@@ -0,0 +1,164 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_CPURAYCASTER_H
+#define IVW_CPURAYCASTER_H
+
+#include <modules/base/basemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/properties/simplelightingproperty.h>
+
+#include <memory>
+#include <vector>
+
+namespace inviwo {
+
+class Volume;
+class VolumeRAM;
+class Image;
+class TransferFunction;
+
+/**
+ * Minimum and maximum value of cubic blocks of voxels. Cell (i,j,k) covers the voxels with index
+ * [i * cellSize, (i + 1) * cellSize] along x, and correspondingly along y and z, i.e. neighboring
+ * cells share one layer of voxels such that every trilinearly interpolated value inside a cell is
+ * within the range of the cell.
+ */
+class IVW_MODULE_BASE_API MacroCellGrid {
+public:
+    /**
+     * @param values one value per voxel, x fastest
+     * @param dims the number of voxels along each axis
+     * @param cellSize the number of voxel steps along each side of a cell
+     */
+    MacroCellGrid(const std::vector<float>& values, const size3_t& dims, size_t cellSize = 8);
+    /**
+     * Build the grid from one channel of ram, with the values normalized by dataRange.
+     */
+    MacroCellGrid(const VolumeRAM& ram, size_t channel, const dvec2& dataRange,
+                  size_t cellSize = 8);
+
+    /// The number of cells along each axis
+    size3_t getDimensions() const;
+    size_t getCellSize() const;
+    /// The minimum and maximum value of the voxels covered by the cell
+    vec2 getRange(const size3_t& cell) const;
+
+    /**
+     * Classify the cells using a transfer function lookup table covering the values [0,1]. A cell
+     * is visible if any table entry within its value range has a nonzero opacity.
+     * @return one entry per cell, x fastest, nonzero for visible cells
+     */
+    std::vector<unsigned char> classify(const std::vector<vec4>& lut) const;
+
+private:
+    template <typename Value>
+    void build(Value value, const size3_t& dims);
+
+    size3_t dims_;
+    size_t cellSize_;
+    std::vector<vec2> ranges_;
+};
+
+/**
+ * Light parameters used by CPURaycaster, matching the properties of SimpleLightingProperty. The
+ * position is given in world space.
+ */
+struct IVW_MODULE_BASE_API CPURaycastingLight {
+    CPURaycastingLight() = default;
+    CPURaycastingLight(const SimpleLightingProperty& lighting);
+
+    ShadingMode::Modes shadingMode = ShadingMode::None;
+    vec3 position{0.0f};
+    vec3 ambientColor{0.0f};
+    vec3 diffuseColor{1.0f};
+    vec3 specularColor{0.0f};
+    float specularExponent = 60.0f;
+};
+
+/**
+ * Direct volume rendering of one channel of a volume on the CPU. Compositing, opacity correction,
+ * shading and early ray termination follow the OpenGL raycaster such that the results are
+ * comparable. The image is split into tiles that are rendered in parallel in the thread pool, and
+ * empty space is skipped using a MacroCellGrid classified by the transfer function.
+ *
+ * The rays sample the VolumeRAM of the volume directly in its own data format, the raycaster
+ * keeps the representation alive. The macro cells are built on construction, keep the raycaster
+ * around as long as the volume and channel are unchanged.
+ *
+ * Rays are traced one at a time rather than in SIMD packets. Each sample is dominated by eight
+ * loads at data dependent addresses, 56 with shading, and a transfer function lookup. Without
+ * gather instructions, which the build does not enable, those stay scalar in a packet. Only the
+ * interpolation weights would be vectorized, while the rays of a packet leave the macro cells
+ * and terminate at different samples and leave lanes idle. The 16x16 tiles keep neighboring rays
+ * on the same thread, such that they share the cached voxels.
+ */
+class IVW_MODULE_BASE_API CPURaycaster {
+public:
+    CPURaycaster(const Volume& volume, size_t channel);
+
+    /**
+     * Render the volume into a new RGBA image with a single color layer.
+     * @param dims the image dimensions
+     * @param viewProjection the camera projection matrix times the view matrix
+     * @param tf transfer function applied to the channel values normalized by the data range
+     * @param light the light used for shading
+     * @param samplingRate number of samples per voxel along the ray
+     */
+    std::shared_ptr<Image> render(const size2_t& dims, const mat4& viewProjection,
+                                  const TransferFunction& tf, const CPURaycastingLight& light,
+                                  float samplingRate) const;
+
+    const MacroCellGrid& getMacroCells() const;
+
+private:
+    struct Ray;
+    template <typename T>
+    vec4 castRay(const T* data, const Ray& ray, const std::vector<vec4>& lut,
+                 const std::vector<unsigned char>& visible, const CPURaycastingLight& light) const;
+    /// The normalized value of the channel at index, interpolated trilinearly
+    template <typename T>
+    float sample(const T* data, const vec3& index) const;
+    template <typename T>
+    vec3 gradient(const T* data, const vec3& index) const;
+
+    std::shared_ptr<const VolumeRAM> ram_;
+    size_t channel_;
+    float offset_;  ///< Start of the data range
+    float scale_;   ///< One over the extent of the data range
+    size3_t dims_;
+    MacroCellGrid cells_;
+    mat4 worldToData_;
+    mat4 dataToWorld_;
+    mat3 indexGradientToWorld_;
+};
+
+}  // namespace inviwo
+
+#endif  // IVW_CPURAYCASTER_H
@@ -31,6 +31,7 @@
 #include <modules/base/algorithm/volume/surfaceextraction.h>
 #include <inviwo/core/util/indexmapper.h>
 
+#include <inviwo/core/util/foreach.h>
 #include <modules/base/datastructures/disjointsets.h>
 #include <glm/gtx/normal.hpp>
 
@@ -244,7 +245,7 @@ class VCache {
 public:
     enum CacheName { xCacheCurr, xCacheNext, yCacheCurr, yCacheNext, zCacheCurr, zCacheNext };
     enum CachePosName { xCurr0, xCurr1, xNext0, xNext1, yCurr, yNext, zCurr, zNext };
-    VCache(const size2_t &dim) : cIm{dim} {
+    VCache(const size2_t &dim, size_t z0 = 0) : cIm{dim}, z0_{z0} {
         cache[xCacheCurr].resize(dim.x * dim.y);
         cache[xCacheNext].resize(dim.x * dim.y);
         cache[yCacheCurr].resize(dim.x * dim.y);
@@ -256,28 +257,28 @@ public:
     std::pair<size_t, bool> find(const size3_t &ind, int edge, const size_t &val) {
         switch (edge) {
             case 0:
-                if (ind.z == 0 && ind.y == 0) {
+                if (ind.z == z0_ && ind.y == 0) {
                     cache[xCacheCurr][cIm(pos[xCurr0], ind.y)] = val;
                     return {val, true};
                 } else {
                     return {cache[xCacheCurr][cIm(pos[xCurr0], ind.y)], false};
                 }
             case 1:
-                if (ind.z == 0) {
+                if (ind.z == z0_) {
                     cache[yCacheCurr][cIm(pos[yCurr] + 1, ind.y)] = val;
                     return {val, true};
                 } else {
                     return {cache[yCacheCurr][cIm(pos[yCurr] + 1, ind.y)], false};
                 }
             case 2:
-                if (ind.z == 0) {
+                if (ind.z == z0_) {
                     cache[xCacheCurr][cIm(pos[xCurr1], ind.y + 1)] = val;
                     return {val, true};
                 } else {
                     return {cache[xCacheCurr][cIm(pos[xCurr1], ind.y + 1)], false};
                 }
             case 3:
-                if (ind.z == 0 && ind.x == 0) {
+                if (ind.z == z0_ && ind.x == 0) {
                     cache[yCacheCurr][cIm(pos[yCurr], ind.y)] = val;
                     return {val, true};
                 } else {
@@ -355,6 +356,7 @@ public:
 
 private:
     util::IndexMapper2D cIm;
+    size_t z0_;  // the first z index, vertices on the bottom plane are added there
     std::array<std::vector<size_t>, 6> cache;
     std::array<size_t, 8> pos;
 };
@@ -429,6 +431,217 @@ template <typename T, typename IsoTest>
 const std::array<OffsetIndexMasks, 4> Index<T, IsoTest>::oim_ = {
     {{0, 1, {0, 0, 0}}, {3, 2, {0, 1, 0}}, {4, 5, {0, 0, 1}}, {7, 6, {0, 1, 1}}}};
 
+/**
+ * The part of the surface extracted from the cells with z index in [z0, z1). The vertices created
+ * on the bottom (z0) and top (z1) planes of the slab are listed as (edge key, vertex) such that
+ * neighboring slabs can be welded together.
+ */
+struct Slab {
+    size_t z0;
+    size_t z1;
+    std::vector<vec3> positions;
+    std::vector<vec3> normals;
+    std::vector<std::uint32_t> indices;
+    std::vector<std::pair<size_t, std::uint32_t>> bottom;
+    std::vector<std::pair<size_t, std::uint32_t>> top;
+};
+
+/**
+ * Key of an edge in a z-plane, given the index of a cell and one of its edges in the bottom
+ * (0-3) or top (8-11) face.
+ */
+size_t planeEdgeKey(const size3_t &dim, const size3_t &ind, int edge) {
+    static const std::array<size2_t, 4> offsets = {{{0, 0}, {1, 0}, {0, 1}, {0, 0}}};
+    const auto e = edge % 4;
+    return 2 * (ind.x + offsets[e].x + (ind.y + offsets[e].y) * dim.x) + e % 2;
+}
+
+template <typename T, typename IsoTest, typename MapValue>
+void extractSlab(const VolumeRAMPrecision<T> *ram, IsoTest isoTest, MapValue mapValue, Slab &slab,
+                 const std::function<void(float)> &progressCallback,
+                 const std::function<bool(const size3_t &)> &maskingCallback) {
+    static const marching::Config cube{};
+
+    auto &positions = slab.positions;
+    auto &normals = slab.normals;
+    auto &indices = slab.indices;
+
+    const T *src = ram->getDataTyped();
+    const size3_t dim{ram->getDimensions()};
+    const size3_t dim1 = dim - size3_t{1, 1, 1};
+    const util::IndexMapper3D im(dim);
+
+    const auto dr = dvec3(1.0) / dvec3{glm::max(size3_t{1}, (dim - size3_t{1}))};
+    const auto doffs = [&]() {
+        std::array<dvec3, 8> tmp;
+        std::transform(cube.vertices.begin(), cube.vertices.end(), tmp.begin(),
+                       [dr](auto &v) { return dr * dvec3{v}; });
+        return tmp;
+    }();
+
+    const auto interpolate = [src, im, &mapValue, &doffs](const size3_t &ind, const dvec3 &pos,
+                                                          marching::Config::EdgeId e) {
+        const auto a = cube.edges[e][0];
+        const auto b = cube.edges[e][1];
+        const auto tv0 = src[im(ind + cube.vertices[a])];
+        const auto v0 = mapValue(tv0);
+        const auto tv1 = src[im(ind + cube.vertices[b])];
+        const auto v1 = mapValue(tv1);
+
+        const auto t = v0 / (v0 - v1);
+        const auto r0 = pos + doffs[a];
+        const auto r1 = pos + doffs[b];
+        return r0 + t * (r1 - r0);
+    };
+
+    VCache vcache(size2_t{dim.x, dim.y}, slab.z0);
+    Index<T, decltype(isoTest)> index(src, im, isoTest);
+    size3_t ind;
+    dvec3 pos;
+
+    const float err =
+        static_cast<float>(4.0 * glm::epsilon<double>() * glm::epsilon<double>() * dr.x * dr.y);
+
+    const bool weldBottom = slab.z0 > 0;
+    const bool weldTop = slab.z1 < dim1.z;
+
+    for (ind.z = slab.z0; ind.z < slab.z1; ++ind.z) {
+        // Not accumulated, such that a slice gets the same position in any slab split
+        pos.z = dr.z * static_cast<double>(ind.z);
+        vcache.incZ();
+        const bool bottom = weldBottom && ind.z == slab.z0;
+        const bool top = weldTop && ind.z + 1 == slab.z1;
+        for (ind.y = 0, pos.y = 0.0; ind.y < dim1.y; ++ind.y, pos.y += dr.y) {
+            ind.x = 0;
+            const auto cInd = im(ind);
+            vcache.incY();
+            index.init(cInd);
+            for (pos.x = 0.0; ind.x < dim1.x; ++ind.x, pos.x += dr.x) {
+                index.update(cInd + ind.x);
+                if (index == 0 || index == 255) continue;
+                if (maskingCallback && !maskingCallback(ind)) continue;
+
+                std::array<size_t, 12> inds;
+                for (const auto edge : cube.caseEdges[index]) {
+                    const auto c = vcache.find(ind, edge, positions.size());
+                    inds[edge] = c.first;
+                    if (c.second) {
+                        const auto vertex = interpolate(ind, pos, edge);
+                        if (bottom && edge < 4) {
+                            slab.bottom.emplace_back(planeEdgeKey(dim, ind, edge),
+                                                     static_cast<std::uint32_t>(c.first));
+                        } else if (top && edge >= 8) {
+                            slab.top.emplace_back(planeEdgeKey(dim, ind, edge),
+                                                  static_cast<std::uint32_t>(c.first));
+                        }
+                        positions.emplace_back(vertex);
+                        normals.emplace_back(0.0f, 0.0f, 0.0f);
+                    }
+                }
+                for (const auto &tri : cube.caseTriangles[index]) {
+                    const auto side0 = positions[inds[tri[1]]] - positions[inds[tri[0]]];
+                    const auto side1 = positions[inds[tri[2]]] - positions[inds[tri[0]]];
+                    auto n = glm::cross(side0, side1);
+                    if (glm::length2(n) < err) {
+                        continue;  // triangle is so small area is 0.
+                    }
+                    n = glm::normalize(n);
+                    for (int v = 0; v < 3; ++v) {
+                        indices.push_back(static_cast<uint32_t>(inds[tri[v]]));
+                        normals[inds[tri[v]]] += n;
+                    }
+                }
+                vcache.incX(cube.caseIncrements[index]);
+            }
+        }
+        if (progressCallback) {
+            progressCallback(static_cast<float>(ind.z + 1) / static_cast<float>(dim.z - 1));
+        }
+    }
+}
+
+/**
+ * Concatenate the slabs into the output vectors. The vertices on the bottom plane of each slab are
+ * welded to the same vertices on the top plane of the slab below, i.e. the duplicate is dropped
+ * and its normal is added to the kept vertex. The vertices and indices of each slab are copied in
+ * parallel directly to their final place.
+ */
+void mergeSlabs(std::vector<Slab> &slabs, std::vector<vec3> &positions, std::vector<vec3> &normals,
+                std::vector<std::uint32_t> &indices) {
+    if (slabs.size() == 1) {
+        positions.swap(slabs[0].positions);
+        normals.swap(slabs[0].normals);
+        indices.swap(slabs[0].indices);
+        return;
+    }
+
+    // (vertex in slab, vertex in the slab below) for each welded vertex, sorted on the first
+    using Weld = std::pair<std::uint32_t, std::uint32_t>;
+    std::vector<std::vector<Weld>> welds(slabs.size());
+    for (size_t k = 1; k < slabs.size(); ++k) {
+        auto &bottom = slabs[k].bottom;
+        auto &top = slabs[k - 1].top;
+        std::sort(bottom.begin(), bottom.end());
+        std::sort(top.begin(), top.end());
+        auto t = top.begin();
+        for (const auto &b : bottom) {
+            while (t != top.end() && t->first < b.first) ++t;
+            if (t != top.end() && t->first == b.first) welds[k].emplace_back(b.second, t->second);
+        }
+        std::sort(welds[k].begin(), welds[k].end());
+    }
+
+    std::vector<size_t> vertexOffsets(slabs.size() + 1, 0);
+    std::vector<size_t> indexOffsets(slabs.size() + 1, 0);
+    for (size_t k = 0; k < slabs.size(); ++k) {
+        vertexOffsets[k + 1] = vertexOffsets[k] + slabs[k].positions.size() - welds[k].size();
+        indexOffsets[k + 1] = indexOffsets[k] + slabs[k].indices.size();
+    }
+    positions.resize(vertexOffsets.back());
+    normals.resize(vertexOffsets.back());
+    indices.resize(indexOffsets.back());
+
+    // Copy the kept vertices and map the local vertex indices to the merged ones
+    std::vector<std::vector<std::uint32_t>> remap(slabs.size());
+    util::forEachRangeParallel(slabs.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k) {
+            auto &slab = slabs[k];
+            auto &map = remap[k];
+            map.resize(slab.positions.size());
+            auto weld = welds[k].begin();
+            auto dst = static_cast<std::uint32_t>(vertexOffsets[k]);
+            for (std::uint32_t i = 0; i < static_cast<std::uint32_t>(map.size()); ++i) {
+                if (weld != welds[k].end() && weld->first == i) {
+                    ++weld;
+                    continue;
+                }
+                positions[dst] = slab.positions[i];
+                normals[dst] = slab.normals[i];
+                map[i] = dst++;
+            }
+            std::vector<vec3>().swap(slab.positions);
+        }
+    });
+
+    // Welded vertices refer to a kept vertex in the slab below, which is never welded itself
+    for (size_t k = 1; k < slabs.size(); ++k) {
+        for (const auto &weld : welds[k]) {
+            const auto kept = remap[k - 1][weld.second];
+            remap[k][weld.first] = kept;
+            normals[kept] += slabs[k].normals[weld.first];
+        }
+    }
+
+    util::forEachRangeParallel(slabs.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k) {
+            const auto &map = remap[k];
+            auto dst = indices.begin() + indexOffsets[k];
+            for (const auto &i : slabs[k].indices) *dst++ = map[i];
+            std::vector<std::uint32_t>().swap(slabs[k].indices);
+        }
+    });
+}
+
 }  // namespace
 
 namespace util {
@@ -452,110 +665,52 @@ std::shared_ptr<Mesh> marchingCubesOpt(std::shared_ptr<const Volume> volume, dou
 
     if (progressCallback) progressCallback(0.0f);
 
-    const auto mc = [&](auto ram, auto isoTest, auto mapValue) {
-        using T = util::PrecsionValueType<decltype(ram)>;
-        static const marching::Config cube{};
-
-        const T *src = ram->getDataTyped();
-        const size3_t dim{volume->getDimensions()};
-        const size3_t dim1 = dim - size3_t{1, 1, 1};
-        const util::IndexMapper3D im(dim);
-
-        const auto dr = dvec3(1.0) / dvec3{glm::max(size3_t{1}, (dim - size3_t{1}))};
-        const auto doffs = [&]() {
-            std::array<dvec3, 8> tmp;
-            std::transform(cube.vertices.begin(), cube.vertices.end(), tmp.begin(),
-                           [dr](auto &v) { return dr * dvec3{v}; });
-            return tmp;
-        }();
-
-        const auto interpolate = [src, im, &mapValue, &doffs](const size3_t &ind, const dvec3 &pos,
-                                                              marching::Config::EdgeId e) {
-            const auto a = cube.edges[e][0];
-            const auto b = cube.edges[e][1];
-            const auto tv0 = src[im(ind + cube.vertices[a])];
-            const auto v0 = mapValue(tv0);
-            const auto tv1 = src[im(ind + cube.vertices[b])];
-            const auto v1 = mapValue(tv1);
-
-            const auto t = v0 / (v0 - v1);
-            const auto r0 = pos + doffs[a];
-            const auto r1 = pos + doffs[b];
-            return r0 + t * (r1 - r0);
-        };
-
-        VCache vcache(size2_t{dim.x, dim.y});
-        Index<T, decltype(isoTest)> index(src, im, isoTest);
-        size3_t ind;
-        dvec3 pos;
-
-        const float err =
-            static_cast<float>(4.0 * glm::epsilon<double>() * glm::epsilon<double>() * dr.x * dr.y);
-
-        for (ind.z = 0, pos.z = 0.0; ind.z < dim1.z; ++ind.z, pos.z += dr.z) {
-            vcache.incZ();
-            for (ind.y = 0, pos.y = 0.0; ind.y < dim1.y; ++ind.y, pos.y += dr.y) {
-                ind.x = 0;
-                const auto cInd = im(ind);
-                vcache.incY();
-                index.init(cInd);
-                for (pos.x = 0.0; ind.x < dim1.x; ++ind.x, pos.x += dr.x) {
-                    index.update(cInd + ind.x);
-                    if (index == 0 || index == 255) continue;
-                    if (maskingCallback && !maskingCallback(ind)) continue;
-
-                    std::array<size_t, 12> inds;
-                    for (const auto edge : cube.caseEdges[index]) {
-                        const auto c = vcache.find(ind, edge, positions.size());
-                        inds[edge] = c.first;
-                        if (c.second) {
-                            const auto vertex = interpolate(ind, pos, edge);
-                            positions.emplace_back(vertex);
-                            normals.emplace_back(0.0f, 0.0f, 0.0f);
-                        }
-                    }
-                    for (const auto &tri : cube.caseTriangles[index]) {
-                        const auto side0 = positions[inds[tri[1]]] - positions[inds[tri[0]]];
-                        const auto side1 = positions[inds[tri[2]]] - positions[inds[tri[0]]];
-                        auto n = glm::cross(side0, side1);
-                        if (glm::length2(n) < err) {
-                            continue;  // triangle is so small area is 0.
-                        }
-                        n = glm::normalize(n);
-                        for (int v = 0; v < 3; ++v) {
-                            indices.push_back(static_cast<uint32_t>(inds[tri[v]]));
-                            normals[inds[tri[v]]] += n;
-                        }
-                    }
-                    vcache.incX(cube.caseIncrements[index]);
-                }
-            }
-            if (progressCallback) {
-                progressCallback(static_cast<float>(ind.z + 1) / static_cast<float>(dim.z - 1));
+    const auto ram = volume->getRepresentation<VolumeRAM>();
+    const size3_t dim{volume->getDimensions()};
+    const size_t cellsZ = dim.z - 1;
+
+    // Split the cells into z-slabs that are extracted in parallel in the thread pool
+    const size_t minSlabThickness = 8;
+    std::vector<Slab> slabs(util::parallelRangeCount(cellsZ, minSlabThickness));
+
+    const auto extract = [&](Slab &slab, const std::function<void(float)> &progress) {
+        ram->dispatch<void, dispatching::filter::Scalars>([&](auto vrprecision) {
+            using ValueType = util::PrecsionValueType<decltype(vrprecision)>;
+            const auto tiso = util::glm_convert<ValueType>(iso);
+            if (invert) {
+                extractSlab(vrprecision, [tiso](auto &&val) { return val > tiso; },
+                            [iso](auto &&val) { return util::glm_convert<double>(val) - iso; },
+                            slab, progress, maskingCallback);
+            } else {
+                extractSlab(vrprecision, [tiso](auto &&val) { return val < tiso; },
+                            [iso](auto &&val) { return -(util::glm_convert<double>(val) - iso); },
+                            slab, progress, maskingCallback);
             }
-        }
-
-        if (enclose) {
-            marching::encloseSurfce(src, dim, indexRAM, positions, normals, iso, invert, dr.x, dr.y,
-                                    dr.z);
-        }
+        });
     };
-    if (invert) {
-        volume->getRepresentation<VolumeRAM>()->dispatch<void, dispatching::filter::Scalars>(
-            [&](auto ram) {
-                using ValueType = util::PrecsionValueType<decltype(ram)>;
-                mc(ram,
-                   [tiso = util::glm_convert<ValueType>(iso)](auto &&val) { return val > tiso; },
-                   [iso](auto &&val) { return util::glm_convert<double>(val) - iso; });
-            });
-    } else {
-        volume->getRepresentation<VolumeRAM>()->dispatch<void, dispatching::filter::Scalars>(
-            [&](auto ram) {
-                using ValueType = util::PrecsionValueType<decltype(ram)>;
-                mc(ram,
-                   [tiso = util::glm_convert<ValueType>(iso)](auto &&val) { return val < tiso; },
-                   [iso](auto &&val) { return -(util::glm_convert<double>(val) - iso); });
-            });
+
+    // A single slab reports progress per z-slice, several slabs when each one is done
+    const bool single = slabs.size() == 1;
+    util::forEachRangeParallelN(cellsZ, slabs.size(),
+                                [&](size_t z0, size_t z1, size_t k) {
+                                    slabs[k].z0 = z0;
+                                    slabs[k].z1 = z1;
+                                    extract(slabs[k], single ? progressCallback : nullptr);
+                                },
+                                [&](size_t k) {
+                                    if (progressCallback && !single) {
+                                        progressCallback(static_cast<float>(slabs[k].z1) /
+                                                         static_cast<float>(cellsZ));
+                                    }
+                                });
+    mergeSlabs(slabs, positions, normals, indices);
+
+    if (enclose) {
+        ram->dispatch<void, dispatching::filter::Scalars>([&](auto vrprecision) {
+            const auto dr = dvec3(1.0) / dvec3{glm::max(size3_t{1}, (dim - size3_t{1}))};
+            marching::encloseSurfce(vrprecision->getDataTyped(), dim, indexRAM, positions,
+                                    normals, iso, invert, dr.x, dr.y, dr.z);
+        });
     }
 
     ivwAssert(positions.size() == normals.size(), "positions and normals must be equal size");
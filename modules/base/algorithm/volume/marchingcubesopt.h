@@ -48,7 +48,9 @@ namespace util {
  * Extracts an iso surface from a volume using the Marching Cubes algorithm
  *
  * Note: Shares interface with util::marchingcbes and util::marchingtetrahedron
- * This is an optimized version of util::marchingcubes
+ * This is an optimized version of util::marchingcubes. When the InviwoApplication is initialized
+ * the volume is split into slabs along z that are extracted in parallel in the thread pool and
+ * then merged into one mesh, welding the vertices shared between neighboring slabs.
  *
  * @param volume the scalar volume
  * @param iso iso-value for the extracted surface
@@ -59,7 +61,8 @@ namespace util {
  * @param progressCallback if set, will be called will executing with the current progress in the
  * interval [0,1], useful for progress bars
  * @param maskingCallback optional callback to test whether current cell should be evaluated or not
- * (return true to include current cell)
+ * (return true to include current cell). The slabs are extracted concurrently, hence the callback
+ * is called from several threads at the same time and has to be thread safe.
  */
 
 IVW_MODULE_BASE_API std::shared_ptr<Mesh> marchingCubesOpt(
@@ -0,0 +1,389 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/base/algorithm/volume/volumederivatives.h>
+
+#include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/exception.h>
+#include <inviwo/core/util/foreach.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <mutex>
+
+namespace inviwo {
+
+namespace util {
+
+namespace {
+
+// Index space derivative along x of a row, one sided at the ends
+void diffX(const float* row, size_t n, float* out) {
+    if (n < 2) {
+        std::fill_n(out, n, 0.0f);
+        return;
+    }
+    out[0] = row[1] - row[0];
+    for (size_t x = 1; x + 1 < n; ++x) out[x] = 0.5f * (row[x + 1] - row[x - 1]);
+    out[n - 1] = row[n - 1] - row[n - 2];
+}
+
+// Index space derivative along y or z given the neighboring rows, scale is one over their distance
+void diffRows(const float* minus, const float* plus, float scale, size_t n, float* out) {
+    for (size_t x = 0; x < n; ++x) out[x] = scale * (plus[x] - minus[x]);
+}
+
+// 7-point Laplacian of a row, with the boundary voxels repeated
+void laplacianRow(const float* row, const float* ym, const float* yp, const float* zm,
+                  const float* zp, size_t n, const vec3& invH2, float* out) {
+    for (size_t x = 0; x < n; ++x) {
+        const float c2 = 2.0f * row[x];
+        out[x] = invH2.y * (yp[x] - c2 + ym[x]) + invH2.z * (zp[x] - c2 + zm[x]);
+    }
+    if (n < 2) return;
+    out[0] += invH2.x * (row[1] - row[0]);
+    for (size_t x = 1; x + 1 < n; ++x) {
+        out[x] += invH2.x * (row[x + 1] - 2.0f * row[x] + row[x - 1]);
+    }
+    out[n - 1] += invH2.x * (row[n - 2] - row[n - 1]);
+}
+
+// Adds scale times the mixed derivative along x and the axis of the rows minus and plus, with the
+// boundary voxels repeated as in laplacianRow
+void addMixedX(const float* minus, const float* plus, size_t n, float scale, float* out) {
+    if (n < 2) return;
+    const float s = 0.25f * scale;
+    out[0] += s * ((plus[1] - plus[0]) - (minus[1] - minus[0]));
+    for (size_t x = 1; x + 1 < n; ++x) {
+        out[x] += s * ((plus[x + 1] - plus[x - 1]) - (minus[x + 1] - minus[x - 1]));
+    }
+    out[n - 1] += s * ((plus[n - 1] - plus[n - 2]) - (minus[n - 1] - minus[n - 2]));
+}
+
+// Adds scale times the mixed derivative along y and z given the diagonal neighbor rows, named by
+// their z and y side, m for minus and p for plus
+void addMixedYZ(const float* mm, const float* mp, const float* pm, const float* pp, size_t n,
+                float scale, float* out) {
+    const float s = 0.25f * scale;
+    for (size_t x = 0; x < n; ++x) out[x] += s * (pp[x] - pm[x] - mp[x] + mm[x]);
+}
+
+/**
+ * The slices z - 1, z and z + 1 of the needed components converted to float. Slices are converted
+ * when first needed and kept in slot z % 3, such that stepping through a slab converts each slice
+ * once.
+ */
+class SliceWindow {
+public:
+    using Loader = std::function<void(size_t z, size_t c, float* dst)>;
+
+    SliceWindow(const Loader& loader, const std::array<bool, 4>& read, size_t sliceSize)
+        : loader_{loader}, read_{read} {
+        for (size_t c = 0; c < 4; ++c) {
+            if (!read_[c]) continue;
+            for (auto& slot : slots_[c]) slot.resize(sliceSize);
+        }
+        loaded_.fill(std::numeric_limits<size_t>::max());
+    }
+
+    // Pointer to the first voxel of slice z of component c, slice z has to be loaded
+    const float* slice(size_t c, size_t z) const { return slots_[c][z % 3].data(); }
+
+    void load(size_t z) {
+        const size_t slot = z % 3;
+        if (loaded_[slot] == z) return;
+        for (size_t c = 0; c < 4; ++c) {
+            if (read_[c]) loader_(z, c, slots_[c][slot].data());
+        }
+        loaded_[slot] = z;
+    }
+
+private:
+    const Loader& loader_;
+    std::array<bool, 4> read_;
+    std::array<std::array<std::vector<float>, 3>, 4> slots_;
+    std::array<size_t, 3> loaded_;
+};
+
+struct Range {
+    float min = std::numeric_limits<float>::max();
+    float max = std::numeric_limits<float>::lowest();
+
+    void add(float v) {
+        min = std::min(min, v);
+        max = std::max(max, v);
+    }
+    void add(const Range& r) {
+        min = std::min(min, r.min);
+        max = std::max(max, r.max);
+    }
+    dvec2 symmetric() const {
+        const double range = std::max(std::abs(min), std::abs(max));
+        return dvec2(-range, range);
+    }
+};
+
+std::unique_ptr<Volume> derivedVolume(const Volume& volume, const DataFormatBase* format) {
+    auto res = util::make_unique<Volume>(volume.getDimensions(), format);
+    res->setModelMatrix(volume.getModelMatrix());
+    res->setWorldMatrix(volume.getWorldMatrix());
+    return res;
+}
+
+}  // namespace
+
+VolumeDerivatives volumeDerivatives(const Volume& volume, const VolumeDerivativeFields& fields) {
+    const auto ram = volume.getRepresentation<VolumeRAM>();
+    const size3_t dims = volume.getDimensions();
+    const size_t comps = volume.getDataFormat()->getComponents();
+    const size_t sliceSize = dims.x * dims.y;
+
+    if ((fields.divergence || fields.curl) && comps != 3) {
+        throw Exception("Divergence and curl require a volume with three components",
+                        IvwContextCustom("util::volumeDerivatives"));
+    }
+    if (fields.gradient &&
+        (fields.gradientChannel < 0 || static_cast<size_t>(fields.gradientChannel) >= comps)) {
+        throw Exception("Gradient channel " + toString(fields.gradientChannel) + " out of range",
+                        IvwContextCustom("util::volumeDerivatives"));
+    }
+
+    // The components that need first order derivatives, and the components that need to be read
+    std::array<bool, 4> derive{{false, false, false, false}};
+    if (fields.gradient) derive[fields.gradientChannel] = true;
+    if (fields.divergence || fields.curl) derive[0] = derive[1] = derive[2] = true;
+    std::array<bool, 4> read = derive;
+    if (fields.laplacian) std::fill_n(read.begin(), comps, true);
+
+    // The stencils run on float rows independent of the data format. Each slab converts the
+    // slices it needs one at a time into a window of three slices, instead of converting the
+    // whole volume up front.
+    const SliceWindow::Loader loader = ram->dispatch<SliceWindow::Loader>([&](auto vrprecision) {
+        const auto src = vrprecision->getDataTyped();
+        return [src, sliceSize](size_t z, size_t c, float* dst) {
+            const auto slice = src + z * sliceSize;
+            for (size_t i = 0; i < sliceSize; ++i) {
+                dst[i] = static_cast<float>(util::glmcomp(slice[i], c));
+            }
+        };
+    });
+
+    // Index to world space transformation of a one voxel step, and its inverse that maps index
+    // space derivatives to world space derivatives
+    const dvec3 steps{glm::max(dims, size3_t(2)) - size3_t(1)};
+    const dmat3 indexToWorld =
+        dmat3(volume.getCoordinateTransformer().getDataToWorldMatrix()) *
+        dmat3(glm::diagonal3x3(dvec3(1.0) / steps));
+    const dmat3 inverse = glm::inverse(indexToWorld);
+    const mat3 worldToIndex{inverse};
+
+    // The Laplacian in index space is sum_ij metric_ij d2F/di dj, where metric is the inverse
+    // metric tensor of the index space. The mixed terms vanish for orthogonal axes and are then
+    // skipped.
+    const dmat3 metric = inverse * glm::transpose(inverse);
+    vec3 invH2{0.0f};
+    for (int i = 0; i < 3; ++i) {
+        if (dims[i] > 1) invH2[i] = static_cast<float>(metric[i][i]);
+    }
+    // Twice the off-diagonal metric, for the axis pairs xy, xz and yz
+    vec3 mixed{0.0f};
+    const std::array<std::array<int, 2>, 3> pairs{{{{0, 1}}, {{0, 2}}, {{1, 2}}}};
+    for (int p = 0; p < 3; ++p) {
+        const int i = pairs[p][0];
+        const int j = pairs[p][1];
+        const double m = metric[i][j];
+        if (dims[i] > 1 && dims[j] > 1 &&
+            std::abs(m) > 1e-6 * std::sqrt(metric[i][i] * metric[j][j])) {
+            mixed[p] = static_cast<float>(2.0 * m);
+        }
+    }
+
+    VolumeDerivatives res;
+    vec3* gradient = nullptr;
+    float* divergence = nullptr;
+    vec3* curl = nullptr;
+    float* laplacian = nullptr;
+    if (fields.gradient) {
+        res.gradient = derivedVolume(volume, DataVec3Float32::get());
+        gradient = static_cast<vec3*>(res.gradient->getEditableRepresentation<VolumeRAM>()->getData());
+    }
+    if (fields.divergence) {
+        res.divergence = derivedVolume(volume, DataFloat32::get());
+        divergence =
+            static_cast<float*>(res.divergence->getEditableRepresentation<VolumeRAM>()->getData());
+    }
+    if (fields.curl) {
+        res.curl = derivedVolume(volume, DataVec3Float32::get());
+        curl = static_cast<vec3*>(res.curl->getEditableRepresentation<VolumeRAM>()->getData());
+    }
+    if (fields.laplacian) {
+        res.laplacian = derivedVolume(volume, DataFormatBase::get(NumericType::Float, comps, 32));
+        laplacian =
+            static_cast<float*>(res.laplacian->getEditableRepresentation<VolumeRAM>()->getData());
+    }
+
+    std::mutex mutex;
+    Range divergenceRange, curlRange, laplacianRange;
+
+    // Each slab converts the slices on both sides of it as well, keep that overhead small
+    const size_t minSlabThickness = 8;
+    forEachRangeParallel(dims.z, minSlabThickness, [&](size_t z0, size_t z1) {
+        const size_t n = dims.x;
+        SliceWindow window(loader, read, sliceSize);
+        // Index space derivative rows and world space derivative rows, world[c][k] = dF_c/dw_k
+        std::array<std::array<std::vector<float>, 3>, 4> index;
+        std::array<std::array<std::vector<float>, 3>, 4> world;
+        for (size_t c = 0; c < comps; ++c) {
+            if (!derive[c]) continue;
+            for (int k = 0; k < 3; ++k) {
+                index[c][k].resize(n);
+                world[c][k].resize(n);
+            }
+        }
+        std::vector<float> lap(fields.laplacian ? n : 0);
+        Range divergenceLocal, curlLocal, laplacianLocal;
+
+        for (size_t z = z0; z < z1; ++z) {
+            const size_t zm = z > 0 ? z - 1 : z;
+            const size_t zp = z + 1 < dims.z ? z + 1 : z;
+            const float zScale = zp > zm ? 1.0f / static_cast<float>(zp - zm) : 0.0f;
+            window.load(zm);
+            window.load(z);
+            window.load(zp);
+            for (size_t y = 0; y < dims.y; ++y) {
+                const size_t ym = y > 0 ? y - 1 : y;
+                const size_t yp = y + 1 < dims.y ? y + 1 : y;
+                const float yScale = yp > ym ? 1.0f / static_cast<float>(yp - ym) : 0.0f;
+
+                // Offset of the row in the output, and of the neighboring rows within a slice
+                const size_t row = y * n + z * sliceSize;
+                const size_t rowY = y * n;
+                const size_t rowYm = ym * n;
+                const size_t rowYp = yp * n;
+
+                for (size_t c = 0; c < comps; ++c) {
+                    if (!derive[c]) continue;
+                    const float* p = window.slice(c, z);
+                    diffX(p + rowY, n, index[c][0].data());
+                    diffRows(p + rowYm, p + rowYp, yScale, n, index[c][1].data());
+                    diffRows(window.slice(c, zm) + rowY, window.slice(c, zp) + rowY, zScale, n,
+                             index[c][2].data());
+                    for (int k = 0; k < 3; ++k) {
+                        // worldToIndex[k][i] is the derivative of index i along world axis k
+                        const float a0 = worldToIndex[k][0];
+                        const float a1 = worldToIndex[k][1];
+                        const float a2 = worldToIndex[k][2];
+                        const float* d0 = index[c][0].data();
+                        const float* d1 = index[c][1].data();
+                        const float* d2 = index[c][2].data();
+                        float* w = world[c][k].data();
+                        for (size_t x = 0; x < n; ++x) w[x] = a0 * d0[x] + a1 * d1[x] + a2 * d2[x];
+                    }
+                }
+
+                if (gradient) {
+                    const auto& w = world[fields.gradientChannel];
+                    vec3* out = gradient + row;
+                    for (size_t x = 0; x < n; ++x) out[x] = vec3(w[0][x], w[1][x], w[2][x]);
+                }
+                if (divergence) {
+                    float* out = divergence + row;
+                    for (size_t x = 0; x < n; ++x) {
+                        out[x] = world[0][0][x] + world[1][1][x] + world[2][2][x];
+                        divergenceLocal.add(out[x]);
+                    }
+                }
+                if (curl) {
+                    vec3* out = curl + row;
+                    for (size_t x = 0; x < n; ++x) {
+                        out[x] = vec3(world[2][1][x] - world[1][2][x],
+                                      world[0][2][x] - world[2][0][x],
+                                      world[1][0][x] - world[0][1][x]);
+                        curlLocal.add(glm::compMin(out[x]));
+                        curlLocal.add(glm::compMax(out[x]));
+                    }
+                }
+                if (laplacian) {
+                    for (size_t c = 0; c < comps; ++c) {
+                        const float* p = window.slice(c, z);
+                        const float* pzm = window.slice(c, zm);
+                        const float* pzp = window.slice(c, zp);
+                        laplacianRow(p + rowY, p + rowYm, p + rowYp, pzm + rowY, pzp + rowY, n,
+                                     invH2, lap.data());
+                        if (mixed.x != 0.0f) {
+                            addMixedX(p + rowYm, p + rowYp, n, mixed.x, lap.data());
+                        }
+                        if (mixed.y != 0.0f) {
+                            addMixedX(pzm + rowY, pzp + rowY, n, mixed.y, lap.data());
+                        }
+                        if (mixed.z != 0.0f) {
+                            addMixedYZ(pzm + rowYm, pzm + rowYp, pzp + rowYm, pzp + rowYp, n,
+                                       mixed.z, lap.data());
+                        }
+                        float* out = laplacian + row * comps + c;
+                        for (size_t x = 0; x < n; ++x) {
+                            out[x * comps] = lap[x];
+                            laplacianLocal.add(lap[x]);
+                        }
+                    }
+                }
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        divergenceRange.add(divergenceLocal);
+        curlRange.add(curlLocal);
+        laplacianRange.add(laplacianLocal);
+    });
+
+    if (res.divergence) {
+        res.divergence->dataMap_ = volume.dataMap_;
+        res.divergence->dataMap_.dataRange = divergenceRange.symmetric();
+        res.divergence->dataMap_.valueRange = dvec2(divergenceRange.min, divergenceRange.max);
+    }
+    if (res.curl) {
+        res.curl->dataMap_ = volume.dataMap_;
+        res.curl->dataMap_.dataRange = curlRange.symmetric();
+        res.curl->dataMap_.valueRange = dvec2(curlRange.min, curlRange.max);
+    }
+    if (res.laplacian) {
+        res.laplacian->dataMap_.dataRange = laplacianRange.symmetric();
+        res.laplacian->dataMap_.valueRange = laplacianRange.symmetric();
+    }
+
+    return res;
+}
+
+}  // namespace util
+
+}  // namespace inviwo
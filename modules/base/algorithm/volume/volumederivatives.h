@@ -0,0 +1,86 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_VOLUMEDERIVATIVES_H
+#define IVW_VOLUMEDERIVATIVES_H
+
+#include <modules/base/basemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+
+#include <memory>
+
+namespace inviwo {
+
+namespace util {
+
+/**
+ * Selects the fields computed by util::volumeDerivatives.
+ */
+struct IVW_MODULE_BASE_API VolumeDerivativeFields {
+    bool gradient = false;    ///< gradient of gradientChannel, vec3
+    bool divergence = false;  ///< divergence of a three component volume, float
+    bool curl = false;        ///< curl of a three component volume, vec3
+    bool laplacian = false;   ///< Laplacian of each component, float with the same extent
+    int gradientChannel = 0;
+};
+
+/**
+ * The fields computed by util::volumeDerivatives, fields that were not requested are null.
+ */
+struct IVW_MODULE_BASE_API VolumeDerivatives {
+    std::unique_ptr<Volume> gradient;
+    std::unique_ptr<Volume> divergence;
+    std::unique_ptr<Volume> curl;
+    std::unique_ptr<Volume> laplacian;
+};
+
+/**
+ * Computes derived fields of a volume in world space using finite difference stencils directly on
+ * the voxel grid. Central differences are used in the interior and one sided differences at the
+ * volume boundaries. The Laplacian uses the standard 7-point stencil with the boundary voxels
+ * repeated. For volumes with non-orthogonal axes the mixed derivatives of the metric tensor are
+ * added from the diagonal neighbors, giving a 19-point stencil. All requested fields are
+ * computed in a single pass over the volume, parallelized over z-slabs in the thread pool.
+ *
+ * Divergence and curl have their data and value ranges set to the range of the result, the
+ * divergence and curl ranges are symmetric around zero.
+ *
+ * @param volume the input volume
+ * @param fields the fields to compute
+ * @throws Exception if divergence or curl is requested for a volume without three components
+ */
+IVW_MODULE_BASE_API VolumeDerivatives volumeDerivatives(const Volume& volume,
+                                                        const VolumeDerivativeFields& fields);
+
+}  // namespace util
+
+}  // namespace inviwo
+
+#endif  // IVW_VOLUMEDERIVATIVES_H
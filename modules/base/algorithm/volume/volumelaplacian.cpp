@@ -28,15 +28,56 @@
  *********************************************************************************/
 
 #include <modules/base/algorithm/volume/volumelaplacian.h>
+#include <modules/base/algorithm/volume/volumederivatives.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+
+#include <algorithm>
 
 namespace inviwo {
 
 std::shared_ptr<Volume> util::volumeLaplacian(std::shared_ptr<const Volume> volume,
                                               VolumeLaplacianPostProcessing postProcessing,
                                               double scale) {
-    util::detail::VolumeLaplacianDispatcher disp;
-    return volume->getDataFormat()->dispatch(disp, volume, postProcessing, scale);
-}
+    VolumeDerivativeFields fields;
+    fields.laplacian = true;
+    std::shared_ptr<Volume> newVolume = std::move(volumeDerivatives(*volume, fields).laplacian);
+
+    auto ram = newVolume->getEditableRepresentation<VolumeRAM>();
+    auto begin = static_cast<float*>(ram->getData());
+    auto end =
+        begin + glm::compMul(ram->getDimensions()) * ram->getDataFormat()->getComponents();
+
+    // The Laplacian range is symmetric
+    const auto rangemax = static_cast<float>(newVolume->dataMap_.dataRange.y);
 
-} // namespace
+    switch (postProcessing) {
+        case VolumeLaplacianPostProcessing::Normalized:
+            std::transform(begin, end, begin,
+                           [&](float v) { return (v + rangemax) / (2.0f * rangemax); });
+            newVolume->dataMap_.dataRange = dvec2(0.0, 1.0);
+            newVolume->dataMap_.valueRange = dvec2(0.0, 1.0);
+            break;
+        case VolumeLaplacianPostProcessing::SignNormalized:
+            std::transform(begin, end, begin,
+                           [&](float v) { return (v + rangemax) / rangemax - 1.0f; });
+            newVolume->dataMap_.dataRange = dvec2(-1.0, 1.0);
+            newVolume->dataMap_.valueRange = dvec2(-1.0, 1.0);
+            break;
+        case VolumeLaplacianPostProcessing::Scaled: {
+            const auto s = static_cast<float>(scale);
+            std::transform(begin, end, begin, [&](float v) { return v * s; });
+            newVolume->dataMap_.dataRange = dvec2(-rangemax * scale, rangemax * scale);
+            newVolume->dataMap_.valueRange = dvec2(-rangemax * scale, rangemax * scale);
+            break;
+        }
+        case VolumeLaplacianPostProcessing::None:
+        default:
+            break;
+    }
+
+    newVolume->dataMap_.valueUnit = "Laplacian";
+
+    return newVolume;
+}
 
+}  // namespace inviwo
@@ -28,6 +28,7 @@
  *********************************************************************************/
 
 #include "volumeramsubset.h"
+#include <inviwo/core/datastructures/volume/volumebricked.h>
 
 namespace inviwo {
 
@@ -35,6 +36,15 @@ std::shared_ptr<VolumeRAM> VolumeRAMSubSet::apply(const VolumeRepresentation* in
                                                   size3_t offset,
                                                   const VolumeBorders& border /*= VolumeBorders()*/,
                                                   bool clampBorderOutsideVolume /*= true*/) {
+    if (auto bricked = dynamic_cast<const VolumeBricked*>(in)) {
+        // Only load the bricks covering the subset and its border, not the whole volume
+        const size3_t dataDims{bricked->getDimensions()};
+        const size3_t lo{glm::min(glm::max(offset, border.llf) - border.llf, dataDims)};
+        const size3_t hi{glm::max(glm::min(offset + dim + border.urb, dataDims), lo)};
+        auto region = bricked->getRegion(lo, hi - lo);
+        return apply(region.get(), dim, offset - lo, border, clampBorderOutsideVolume);
+    }
+
     detail::VolumeRAMSubSetDispatcher disp;
     return in->getDataFormat()->dispatch(disp, in, dim, offset, border, clampBorderOutsideVolume);
 }
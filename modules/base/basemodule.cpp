@@ -79,6 +79,7 @@
 #include <modules/base/processors/volumedivergencecpuprocessor.h>
 #include <modules/base/processors/volumegradientcpuprocessor.h>
 #include <modules/base/processors/volumelaplacianprocessor.h>
+#include <modules/base/processors/volumeraycastercpu.h>
 #include <modules/base/processors/volumesequencetospatial4dsampler.h>
 #include <modules/base/processors/worldtransform.h>
 #include <modules/base/processors/camerafrustum.h>
@@ -162,6 +163,7 @@ BaseModule::BaseModule(InviwoApplication* app) : InviwoModule(app, "Base") {
     registerProcessor<VolumeCurlCPUProcessor>();
     registerProcessor<VolumeDivergenceCPUProcessor>();
     registerProcessor<VolumeLaplacianProcessor>();
+    registerProcessor<VolumeRaycasterCPU>();
     registerProcessor<MeshExport>();
     registerProcessor<RandomMeshGenerator>();
     registerProcessor<RandomSphereGenerator>();
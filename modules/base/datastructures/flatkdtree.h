@@ -0,0 +1,424 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *********************************************************************************/
+
+#ifndef IVW_FLATKDTREE_H
+#define IVW_FLATKDTREE_H
+
+#include <modules/base/basemoduledefine.h>
+#include <inviwo/core/util/foreach.h>
+#include <inviwo/core/util/glm.h>
+#include <inviwo/core/util/assertion.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace inviwo {
+
+/**
+ * \class FlatKDTree
+ * \brief Implicit, array-backed KD-tree for static point sets.
+ *
+ * In contrast to KDTree, all points are given up front and the tree is built in O(n log n) by
+ * median partitioning. The nodes are stored in a single array where the node of the range
+ * [begin, end) is located at its middle, the left subtree in [begin, middle), and the right
+ * subtree in [middle + 1, end). Each node splits along the dimension of largest extent of its
+ * range. Nodes are referred to by their index in the array, see getPosition() and getData().
+ *
+ * Building and the batched queries are run on the thread pool, if available. Single queries are
+ * thread safe as long as the tree is not rebuilt.
+ */
+template <unsigned char N, typename T = char, typename P = double>
+class FlatKDTree {
+public:
+    using Point = Vector<N, P>;
+    /**
+     * Index returned for queries without result, i.e. for an empty tree or when less than k
+     * points are available in findNNearest.
+     */
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    FlatKDTree() = default;
+    /**
+     * Build a tree from the given points, @see build
+     */
+    FlatKDTree(std::vector<Point> points, std::vector<T> data = {});
+
+    /**
+     * Replace the content of the tree with the given points and associated data. If data is
+     * empty, all nodes get a default constructed T, otherwise it has to match the number of
+     * points.
+     */
+    void build(std::vector<Point> points, std::vector<T> data = {});
+    void clear();
+
+    bool empty() const { return positions_.empty(); }
+    size_t size() const { return positions_.size(); }
+    /**
+     * Returns the number of levels of the tree, i.e. ceil(log2(size() + 1))
+     */
+    size_t depth() const;
+
+    const Point& getPosition(size_t node) const { return positions_[node]; }
+    const T& getData(size_t node) const { return data_[node]; }
+    T& getData(size_t node) { return data_[node]; }
+    const std::vector<Point>& getPositions() const { return positions_; }
+
+    /**
+     * Returns the node closest to pos or npos if the tree is empty.
+     */
+    size_t findNearest(const Point& pos) const;
+
+    /**
+     * Find the k nodes closest to pos. The nodes are written to indices, sorted by increasing
+     * distance, and their squared distances to sqDists, unless it is null. Both have to hold at
+     * least k elements. Entries without a matching node are set to npos and the largest P.
+     * @return the number of nodes found, i.e. min(k, size())
+     */
+    size_t findNNearest(const Point& pos, size_t k, size_t* indices, P* sqDists = nullptr) const;
+
+    /**
+     * Append all nodes within distance of pos to result.
+     */
+    void findCloseTo(const Point& pos, P distance, std::vector<size_t>& result) const;
+
+    /**
+     * Batched version of findNNearest for numQueries points. The result of query i is written
+     * to indices[i * k, (i + 1) * k), and the squared distances to the same range of sqDists,
+     * unless it is null.
+     */
+    void findNNearest(const Point* queries, size_t numQueries, size_t k, size_t* indices,
+                      P* sqDists = nullptr) const;
+
+    /**
+     * Batched version of findCloseTo for numQueries points. On return, the nodes within distance
+     * of query i are stored in result[offsets[i], offsets[i + 1]). offsets will hold
+     * numQueries + 1 elements.
+     */
+    void findCloseTo(const Point* queries, size_t numQueries, P distance,
+                     std::vector<size_t>& offsets, std::vector<size_t>& result) const;
+
+private:
+    struct Range {
+        size_t begin;
+        size_t end;
+        P bound;  // lower bound of the squared distance between the query and the range
+    };
+    // The depth of a balanced tree is bounded by the number of bits of size_t, and at most one
+    // range per level plus the current one are kept on the traversal stack
+    static constexpr size_t maxStackSize = 2 * 8 * sizeof(size_t);
+
+    static size_t middle(size_t begin, size_t end) { return begin + (end - begin) / 2; }
+    static P sqDist(const Point& a, const Point& b);
+
+    void partition(std::vector<std::pair<Point, size_t>>& items, size_t begin, size_t end);
+    void buildSubtree(std::vector<std::pair<Point, size_t>>& items, size_t begin, size_t end);
+
+    std::vector<Point> positions_;
+    std::vector<T> data_;
+    std::vector<unsigned char> splitDims_;
+};
+
+template <unsigned char N, typename T, typename P>
+constexpr size_t FlatKDTree<N, T, P>::npos;
+
+template <unsigned char N, typename T, typename P>
+constexpr size_t FlatKDTree<N, T, P>::maxStackSize;
+
+template <unsigned char N, typename T, typename P>
+FlatKDTree<N, T, P>::FlatKDTree(std::vector<Point> points, std::vector<T> data) {
+    build(std::move(points), std::move(data));
+}
+
+template <unsigned char N, typename T, typename P>
+void FlatKDTree<N, T, P>::clear() {
+    positions_.clear();
+    data_.clear();
+    splitDims_.clear();
+}
+
+template <unsigned char N, typename T, typename P>
+size_t FlatKDTree<N, T, P>::depth() const {
+    size_t depth = 0;
+    for (size_t n = size(); n > 0; n /= 2) ++depth;
+    return depth;
+}
+
+template <unsigned char N, typename T, typename P>
+P FlatKDTree<N, T, P>::sqDist(const Point& a, const Point& b) {
+    P dist = 0;
+    for (size_t i = 0; i < N; ++i) {
+        const P d = a[i] - b[i];
+        dist += d * d;
+    }
+    return dist;
+}
+
+template <unsigned char N, typename T, typename P>
+void FlatKDTree<N, T, P>::build(std::vector<Point> points, std::vector<T> data) {
+    IVW_ASSERT(data.empty() || data.size() == points.size(),
+               "FlatKDTree: number of data elements does not match number of points");
+    const size_t count = points.size();
+
+    // keep the position next to the original index while partitioning for better locality
+    std::vector<std::pair<Point, size_t>> items(count);
+    util::forEachRangeParallel(count, 1 << 16, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) items[i] = {points[i], i};
+    });
+    splitDims_.assign(count, 0);
+
+    // Partition the top levels breadth first with the ranges of each level processed in
+    // parallel, until there are enough independent subtrees to keep the pool busy.
+    const size_t subtrees = util::parallelRangeCount(count);
+    std::vector<std::pair<size_t, size_t>> ranges{{0, count}};
+    while (ranges.size() < subtrees && count / ranges.size() > (1 << 14)) {
+        util::forEachRangeParallel(ranges.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                partition(items, ranges[i].first, ranges[i].second);
+            }
+        });
+        std::vector<std::pair<size_t, size_t>> next;
+        for (const auto& range : ranges) {
+            const auto mid = middle(range.first, range.second);
+            if (mid > range.first) next.emplace_back(range.first, mid);
+            if (mid + 1 < range.second) next.emplace_back(mid + 1, range.second);
+        }
+        ranges = std::move(next);
+    }
+    util::forEachRangeParallel(ranges.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            buildSubtree(items, ranges[i].first, ranges[i].second);
+        }
+    });
+
+    positions_.resize(count);
+    data_.resize(count);
+    util::forEachRangeParallel(count, 1 << 16, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            positions_[i] = items[i].first;
+            data_[i] = data.empty() ? T{} : std::move(data[items[i].second]);
+        }
+    });
+}
+
+template <unsigned char N, typename T, typename P>
+void FlatKDTree<N, T, P>::partition(std::vector<std::pair<Point, size_t>>& items, size_t begin,
+                                    size_t end) {
+    Point minPos = items[begin].first;
+    Point maxPos = items[begin].first;
+    for (size_t i = begin + 1; i < end; ++i) {
+        minPos = glm::min(minPos, items[i].first);
+        maxPos = glm::max(maxPos, items[i].first);
+    }
+    unsigned char dim = 0;
+    for (unsigned char i = 1; i < N; ++i) {
+        if (maxPos[i] - minPos[i] > maxPos[dim] - minPos[dim]) dim = i;
+    }
+
+    const auto mid = middle(begin, end);
+    std::nth_element(items.begin() + begin, items.begin() + mid, items.begin() + end,
+                     [dim](const std::pair<Point, size_t>& a, const std::pair<Point, size_t>& b) {
+                         return a.first[dim] < b.first[dim];
+                     });
+    splitDims_[mid] = dim;
+}
+
+template <unsigned char N, typename T, typename P>
+void FlatKDTree<N, T, P>::buildSubtree(std::vector<std::pair<Point, size_t>>& items, size_t begin,
+                                       size_t end) {
+    if (end - begin < 2) return;
+    partition(items, begin, end);
+    const auto mid = middle(begin, end);
+    buildSubtree(items, begin, mid);
+    buildSubtree(items, mid + 1, end);
+}
+
+template <unsigned char N, typename T, typename P>
+size_t FlatKDTree<N, T, P>::findNearest(const Point& pos) const {
+    size_t index = npos;
+    findNNearest(pos, 1, &index);
+    return index;
+}
+
+template <unsigned char N, typename T, typename P>
+size_t FlatKDTree<N, T, P>::findNNearest(const Point& pos, size_t k, size_t* indices,
+                                         P* sqDists) const {
+    std::vector<P> distBuffer;
+    if (!sqDists) {
+        distBuffer.resize(k);
+        sqDists = distBuffer.data();
+    }
+    std::fill(indices, indices + k, npos);
+    std::fill(sqDists, sqDists + k, std::numeric_limits<P>::max());
+    if (k == 0 || empty()) return 0;
+
+    // indices/sqDists are used as a max heap on the distance while searching
+    size_t found = 0;
+    auto siftDown = [&](size_t i, size_t count) {
+        while (2 * i + 1 < count) {
+            size_t child = 2 * i + 1;
+            if (child + 1 < count && sqDists[child + 1] > sqDists[child]) ++child;
+            if (sqDists[i] >= sqDists[child]) break;
+            std::swap(sqDists[i], sqDists[child]);
+            std::swap(indices[i], indices[child]);
+            i = child;
+        }
+    };
+    auto insert = [&](size_t node, P dist) {
+        if (found < k) {
+            size_t i = found++;
+            sqDists[i] = dist;
+            indices[i] = node;
+            while (i > 0 && sqDists[(i - 1) / 2] < sqDists[i]) {
+                std::swap(sqDists[i], sqDists[(i - 1) / 2]);
+                std::swap(indices[i], indices[(i - 1) / 2]);
+                i = (i - 1) / 2;
+            }
+        } else if (dist < sqDists[0]) {
+            sqDists[0] = dist;
+            indices[0] = node;
+            siftDown(0, k);
+        }
+    };
+
+    Range stack[maxStackSize];
+    size_t top = 0;
+    stack[top++] = {0, size(), P{0}};
+    while (top > 0) {
+        const Range range = stack[--top];
+        if (range.begin >= range.end) continue;
+        if (found == k && range.bound >= sqDists[0]) continue;
+
+        const auto mid = middle(range.begin, range.end);
+        insert(mid, sqDist(pos, positions_[mid]));
+
+        const auto dim = splitDims_[mid];
+        const P diff = pos[dim] - positions_[mid][dim];
+        const Range left{range.begin, mid, range.bound};
+        const Range right{mid + 1, range.end, range.bound};
+        // search the side containing pos first, i.e. push it last
+        if (diff < 0) {
+            stack[top++] = {right.begin, right.end, std::max(range.bound, diff * diff)};
+            stack[top++] = left;
+        } else {
+            stack[top++] = {left.begin, left.end, std::max(range.bound, diff * diff)};
+            stack[top++] = right;
+        }
+    }
+
+    // turn the heap into a list sorted by increasing distance
+    for (size_t count = found; count > 1; --count) {
+        std::swap(sqDists[0], sqDists[count - 1]);
+        std::swap(indices[0], indices[count - 1]);
+        siftDown(0, count - 1);
+    }
+    return found;
+}
+
+template <unsigned char N, typename T, typename P>
+void FlatKDTree<N, T, P>::findCloseTo(const Point& pos, P distance,
+                                      std::vector<size_t>& result) const {
+    const P maxSqDist = distance * distance;
+
+    Range stack[maxStackSize];
+    size_t top = 0;
+    stack[top++] = {0, size(), P{0}};
+    while (top > 0) {
+        const Range range = stack[--top];
+        if (range.begin >= range.end || range.bound >= maxSqDist) continue;
+
+        const auto mid = middle(range.begin, range.end);
+        if (sqDist(pos, positions_[mid]) < maxSqDist) result.push_back(mid);
+
+        const auto dim = splitDims_[mid];
+        const P diff = pos[dim] - positions_[mid][dim];
+        const P farBound = std::max(range.bound, diff * diff);
+        stack[top++] = {range.begin, mid, diff < 0 ? range.bound : farBound};
+        stack[top++] = {mid + 1, range.end, diff < 0 ? farBound : range.bound};
+    }
+}
+
+template <unsigned char N, typename T, typename P>
+void FlatKDTree<N, T, P>::findNNearest(const Point* queries, size_t numQueries, size_t k,
+                                       size_t* indices, P* sqDists) const {
+    util::forEachRangeParallel(numQueries, 1024, [&](size_t begin, size_t end) {
+        std::vector<P> distBuffer(sqDists ? 0 : k);
+        for (size_t i = begin; i < end; ++i) {
+            findNNearest(queries[i], k, indices + i * k,
+                         sqDists ? sqDists + i * k : distBuffer.data());
+        }
+    });
+}
+
+template <unsigned char N, typename T, typename P>
+void FlatKDTree<N, T, P>::findCloseTo(const Point* queries, size_t numQueries, P distance,
+                                      std::vector<size_t>& offsets,
+                                      std::vector<size_t>& result) const {
+    offsets.assign(numQueries + 1, 0);
+    result.clear();
+
+    // each job collects the results of its consecutive range of queries, which are concatenated
+    // in order afterwards
+    std::mutex mutex;
+    std::vector<std::pair<size_t, std::vector<size_t>>> partial;
+    util::forEachRangeParallel(numQueries, 1024, [&](size_t begin, size_t end) {
+        std::vector<size_t> nodes;
+        for (size_t i = begin; i < end; ++i) {
+            const auto prevSize = nodes.size();
+            findCloseTo(queries[i], distance, nodes);
+            offsets[i + 1] = nodes.size() - prevSize;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        partial.emplace_back(begin, std::move(nodes));
+    });
+    std::sort(partial.begin(), partial.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    for (size_t i = 0; i < numQueries; ++i) {
+        offsets[i + 1] += offsets[i];
+    }
+    result.reserve(offsets.back());
+    for (const auto& nodes : partial) {
+        result.insert(result.end(), nodes.second.begin(), nodes.second.end());
+    }
+}
+
+template <typename T = char, typename P = double>
+using Flat2DTree = FlatKDTree<2, T, P>;
+template <typename T = char, typename P = double>
+using Flat3DTree = FlatKDTree<3, T, P>;
+template <typename T = char, typename P = double>
+using Flat4DTree = FlatKDTree<4, T, P>;
+
+}  // namespace inviwo
+
+#endif  // IVW_FLATKDTREE_H
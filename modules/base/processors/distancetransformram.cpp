@@ -66,7 +66,7 @@ DistanceTransformRAM::DistanceTransformRAM()
                        InvalidationLevel::InvalidOutput, PropertySemantics::Text)
     , btnForceUpdate_("forceUpdate", "Update Distance Map")
     , distTransformDirty_(true)
-    , hasNewData_(false) {
+    , job_(*this, &progressBar_) {
 
     addPort(volumePort_);
     addPort(outport_);
@@ -112,67 +112,56 @@ DistanceTransformRAM::~DistanceTransformRAM() = default;
 void DistanceTransformRAM::invalidate(InvalidationLevel invalidationLevel, Property* source) {
     notifyObserversInvalidationBegin(this);
     PropertyOwner::invalidate(invalidationLevel, source);
-    if (!isValid() && hasNewData_) {
+    if (!isValid() && job_.hasResult()) {
         for (auto& port : getOutports()) port->invalidate(InvalidationLevel::InvalidOutput);
     }
     notifyObserversInvalidationEnd(this);
 }
 
 void DistanceTransformRAM::process() {
-    if (util::is_future_ready(newVolume_)) {
+    if (volumePort_.isChanged() || distTransformDirty_) {
+        updateOutport();
+    } else if (job_.hasResult()) {
+        std::shared_ptr<const Volume> vol;
         try {
-            auto vol = newVolume_.get();
-            dataRangeOutput_.set(vol->dataMap_.dataRange);
-            outport_.setData(vol);
-            hasNewData_ = false;
-            btnForceUpdate_.setDisplayName("Update Distance Map");
-        } catch (Exception&) {
-            // Need to reset the future, VS bug:
-            // http://stackoverflow.com/questions/33899615/stdfuture-still-valid-after-calling-get-which-throws-an-exception
-            newVolume_ = {};
+            vol = job_.takeResult();
+        } catch (...) {
+            // Do not leave the previous result on the outport when the job failed
             outport_.setData(nullptr);
-            hasNewData_ = false;
             throw;
         }
-    } else if (!newVolume_.valid()) {  // We are not waiting for a calculation
+        dataRangeOutput_.set(vol->dataMap_.dataRange);
+        outport_.setData(vol);
+        btnForceUpdate_.setDisplayName("Update Distance Map");
+    } else if (!job_.isRunning()) {
         btnForceUpdate_.setDisplayName("Update Distance Map (dirty)");
-        if (volumePort_.isChanged() || distTransformDirty_) {
-            updateOutport();
-        }
     }
 }
 
 void DistanceTransformRAM::updateOutport() {
-    auto done = [this]() {
-        dispatchFront([this]() {
-            distTransformDirty_ = false;
-            hasNewData_ = true;
-            invalidate(InvalidationLevel::InvalidOutput);
-        });
-    };
-
-    auto calc =
-        [
-            pb = &progressBar_,
-            upsample = uniformUpsampling_.get() ? size3_t(upsampleFactorUniform_.get())
-                                                : upsampleFactorVec3_.get(),
-            threshold = threshold_.get(), normalize = normalize_.get(), flip = flip_.get(),
-            square = resultSquaredDist_.get(), scale = resultDistScale_.get(),
-            dataRangeMode = dataRangeMode_.get(), customDataRange = customDataRange_.get(), done
-        ](std::shared_ptr<const Volume> volume)
-            ->std::shared_ptr<const Volume> {
+    distTransformDirty_ = false;
+
+    job_.submit([
+        volume = volumePort_.getData(),
+        upsample = uniformUpsampling_.get() ? size3_t(upsampleFactorUniform_.get())
+                                            : upsampleFactorVec3_.get(),
+        threshold = threshold_.get(), normalize = normalize_.get(), flip = flip_.get(),
+        square = resultSquaredDist_.get(), scale = resultDistScale_.get(),
+        dataRangeMode = dataRangeMode_.get(), customDataRange = customDataRange_.get()
+    ](const StopToken& token, const std::function<void(float)>& progress)
+                    ->std::shared_ptr<const Volume> {
 
         auto volDim = glm::max(volume->getDimensions(), size3_t(1u));
         auto dstRepr = std::make_shared<VolumeRAMPrecision<float>>(upsample * volDim);
 
-        const auto progress = [pb](double f) {
-            dispatchFront([f, pb]() {
-                f < 1.0 ? pb->show() : pb->hide();
-                pb->updateProgress(static_cast<float>(f));
-            });
+        // The progress callback is only called in between the passes of the transform, it is
+        // hence safe to abort the computation from there.
+        const auto callback = [&](double f) {
+            token.throwIfStopRequested();
+            progress(static_cast<float>(f));
         };
         util::volumeDistanceTransform(volume.get(), dstRepr.get(), upsample, threshold, normalize,
-                                      flip, square, scale, progress);
+                                      flip, square, scale, callback);
 
         auto dstVol = std::make_shared<Volume>(dstRepr);
         // pass meta data on
@@ -190,6 +179,7 @@ void DistanceTransformRAM::updateOutport() {
                 break;
             }
             case DistanceTransformRAM::DataRangeMode::MinMax: {
+                token.throwIfStopRequested();
                 auto minmax = util::dataMinMax(dstRepr->getDataTyped(),
                                                glm::compMul(dstRepr->getDimensions()));
 
@@ -206,11 +196,8 @@ void DistanceTransformRAM::updateOutport() {
                 break;
         }
 
-        done();
         return dstVol;
-    };
-
-    newVolume_ = dispatchPool(calc, volumePort_.getData());
+    });
 }
 
 }  // namespace inviwo
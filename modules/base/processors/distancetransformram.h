@@ -45,6 +45,7 @@
 #include <inviwo/core/properties/optionproperty.h>
 #include <inviwo/core/properties/stringproperty.h>
 #include <inviwo/core/processors/progressbarowner.h>
+#include <inviwo/core/processors/backgroundjob.h>
 #include <inviwo/core/datastructures/volume/volume.h>
 
 namespace inviwo {
@@ -77,7 +78,8 @@ namespace inviwo {
 *   * __Data Range__ The data range of the output volume. (ReadOnly)
 *   * __Custom Data Range__ Specify a custom output range.
 *   * __Update Distance Map__ Triggers a computation of the distance transform. Since the 
-*     computation is time consuming one has to manually trigger it.
+*     computation is time consuming one has to manually trigger it. The computation runs in the
+*     background, triggering it again while running aborts the stale computation.
 *
 */
 
@@ -104,8 +106,6 @@ private:
     VolumeInport volumePort_;
     VolumeOutport outport_;
 
-    std::future<std::shared_ptr<const Volume>> newVolume_;
-
     DoubleProperty threshold_;
     BoolProperty flip_;
     BoolProperty normalize_;
@@ -122,7 +122,7 @@ private:
     ButtonProperty btnForceUpdate_;
 
     bool distTransformDirty_;
-    bool hasNewData_;
+    BackgroundJob<std::shared_ptr<const Volume>> job_;
 };
 
 template <class Elem, class Traits>
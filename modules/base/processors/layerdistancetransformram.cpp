@@ -59,7 +59,7 @@ LayerDistanceTransformRAM::LayerDistanceTransformRAM()
                           size2_t(10))
     , btnForceUpdate_("forceUpdate", "Update Distance Map")
     , distTransformDirty_(true)
-    , hasNewData_(false) {
+    , job_(*this, &progressBar_) {
 
     addPort(imagePort_);
     addPort(outport_);
@@ -93,54 +93,41 @@ LayerDistanceTransformRAM::~LayerDistanceTransformRAM() = default;
 void LayerDistanceTransformRAM::invalidate(InvalidationLevel invalidationLevel, Property* source) {
     notifyObserversInvalidationBegin(this);
     PropertyOwner::invalidate(invalidationLevel, source);
-    if (!isValid() && hasNewData_) {
+    if (!isValid() && job_.hasResult()) {
         for (auto& port : getOutports()) port->invalidate(InvalidationLevel::InvalidOutput);
     }
     notifyObserversInvalidationEnd(this);
 }
 
 void LayerDistanceTransformRAM::process() {
-    if (util::is_future_ready(newImage_)) {
+    if (imagePort_.isChanged() || distTransformDirty_) {
+        updateOutport();
+    } else if (job_.hasResult()) {
+        std::shared_ptr<Image> image;
         try {
-            auto image = newImage_.get();
-            outport_.setData(image);
-            hasNewData_ = false;
-            btnForceUpdate_.setDisplayName("Update Distance Map");
+            image = job_.takeResult();
         } catch (Exception&) {
-            // Need to reset the future, VS bug:
-            // http://stackoverflow.com/questions/33899615/stdfuture-still-valid-after-calling-get-which-throws-an-exception
-            newImage_ = {};
             outport_.setData(static_cast<Image*>(nullptr));
-            hasNewData_ = false;
             throw;
         }
-    } else if (!newImage_.valid()) {  // We are not waiting for a calculation
+        outport_.setData(image);
+        btnForceUpdate_.setDisplayName("Update Distance Map");
+    } else if (!job_.isRunning()) {
         btnForceUpdate_.setDisplayName("Update Distance Map (dirty)");
-        if (imagePort_.isChanged() || distTransformDirty_) {
-            updateOutport();
-        }
     }
 }
 
 void LayerDistanceTransformRAM::updateOutport() {
-    auto done = [this]() {
-        dispatchFront([this]() {
-            distTransformDirty_ = false;
-            hasNewData_ = true;
-            invalidate(InvalidationLevel::InvalidOutput);
-        });
-    };
+    distTransformDirty_ = false;
 
-    auto calc =
-        [
-            pb = &progressBar_,
-            upsample = uniformUpsampling_.get() ? size3_t(upsampleFactorUniform_.get())
-                                                : upsampleFactorVec2_.get(),
-            threshold = threshold_.get(), normalize = normalize_.get(), flip = flip_.get(),
-            square = resultSquaredDist_.get(), scale = resultDistScale_.get(), done,
-            &cache = imageCache_
-        ](std::shared_ptr<const Image> image)
-            ->std::shared_ptr<Image> {
+    job_.submit([
+        image = imagePort_.getData(),
+        upsample = uniformUpsampling_.get() ? size3_t(upsampleFactorUniform_.get())
+                                            : upsampleFactorVec2_.get(),
+        threshold = threshold_.get(), normalize = normalize_.get(), flip = flip_.get(),
+        square = resultSquaredDist_.get(), scale = resultDistScale_.get(), &cache = imageCache_
+    ](const StopToken& token, const std::function<void(float)>& progress)
+                    ->std::shared_ptr<Image> {
 
         auto imgDim = glm::max(image->getDimensions(), size2_t(1u));
 
@@ -153,21 +140,18 @@ void LayerDistanceTransformRAM::updateOutport() {
         dstImage->getColorLayer()->setWorldMatrix(image->getColorLayer()->getWorldMatrix());
         dstImage->copyMetaDataFrom(*image);
 
-        const auto progress = [pb](double f) {
-            dispatchFront([f, pb]() {
-                f < 1.0 ? pb->show() : pb->hide();
-                pb->updateProgress(static_cast<float>(f));
-            });
+        // The progress callback is only called in between the passes of the transform, it is
+        // hence safe to abort the computation from there.
+        const auto callback = [&](double f) {
+            token.throwIfStopRequested();
+            progress(static_cast<float>(f));
         };
         util::layerDistanceTransform(image->getColorLayer(), dstRepr, upsample, threshold,
-                                     normalize, flip, square, scale, progress);
+                                     normalize, flip, square, scale, callback);
 
-        done();
         cache.add(dstImage);
         return dstImage;
-    };
-
-    newImage_ = dispatchPool(calc, imagePort_.getData());
+    });
 }
 
 }  // namespace inviwo
@@ -45,6 +45,7 @@
 #include <inviwo/core/properties/optionproperty.h>
 #include <inviwo/core/properties/stringproperty.h>
 #include <inviwo/core/processors/progressbarowner.h>
+#include <inviwo/core/processors/backgroundjob.h>
 #include <inviwo/core/datastructures/image/layerramprecision.h>
 
 #include <modules/base/datastructures/imagereusecache.h>
@@ -80,7 +81,8 @@ namespace inviwo {
 *   * __Data Range__ The data range of the output volume. (ReadOnly)
 *   * __Custom Data Range__ Specify a custom output range.
 *   * __Update Distance Map__ Triggers a computation of the distance transform. Since the 
-*     computation is time consuming one has to manually trigger it.
+*     computation is time consuming one has to manually trigger it. The computation runs in the
+*     background, triggering it again while running aborts the stale computation.
 *
 */
 class IVW_MODULE_BASE_API LayerDistanceTransformRAM : public Processor, public ProgressBarOwner {
@@ -105,7 +107,6 @@ private:
     ImageInport imagePort_;
     ImageOutport outport_;
 
-    std::future<std::shared_ptr<Image>> newImage_;   
     ImageReuseCache imageCache_;
 
     DoubleProperty threshold_;
@@ -120,7 +121,7 @@ private:
     ButtonProperty btnForceUpdate_;
 
     bool distTransformDirty_;
-    bool hasNewData_;
+    BackgroundJob<std::shared_ptr<Image>> job_;
 };
 
 template <class Elem, class Traits>
@@ -30,10 +30,16 @@
 #include "meshclipping.h"
 #include <inviwo/core/datastructures/geometry/basicmesh.h>
 #include <inviwo/core/datastructures/geometry/edge.h>
-#include <inviwo/core/datastructures/geometry/polygon.h>
 #include <inviwo/core/datastructures/geometry/simplemeshcreator.h>
 #include <inviwo/core/datastructures/buffer/bufferramprecision.h>
+#include <inviwo/core/util/stdextensions.h>
+#include <inviwo/core/util/foreach.h>
+
 #include <vector>
+#include <array>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace inviwo {
 
@@ -48,6 +54,41 @@ const ProcessorInfo MeshClipping::getProcessorInfo() const { return processorInf
 
 const float MeshClipping::EPSILON = 0.00001f;
 
+namespace {
+
+/**
+ * The part of the clipped mesh produced from a range of triangles.
+ */
+struct ClipChunk {
+    void clear() {
+        positions.clear();
+        colors.clear();
+        edges.clear();
+        intersections.clear();
+    }
+
+    std::vector<vec3> positions;
+    std::vector<vec4> colors;
+    // Intersection edges on the clipping plane, one per clipped triangle
+    std::vector<Edge3D> edges;
+    // Position, texture coordinate and color of each intersection with the clipping plane
+    std::vector<std::tuple<vec3, vec3, vec4>> intersections;
+};
+
+}  // namespace
+
+struct MeshClipping::ClipBuffers {
+    std::vector<ClipChunk> chunks;
+
+    // Signed distance of each vertex to the plane through the origin with the given normal.
+    // Only the plane offset changes while the plane is moved along its normal, and the distances
+    // can be reused.
+    std::vector<float> distances;
+    const vec3* vertices = nullptr;
+    size_t vertexCount = 0;
+    vec3 normal{0.0f};
+};
+
 MeshClipping::MeshClipping()
     : Processor()
     , inport_("inputMesh")
@@ -67,7 +108,8 @@ MeshClipping::MeshClipping()
                                       "Align Plane Normal To Camera Normal",
                                       InvalidationLevel::Valid)
     , camera_("camera", "Camera", vec3(0.0f, 0.0f, -2.0f), vec3(0.0f, 0.0f, 0.0f),
-              vec3(0.0f, 1.0f, 0.0f), nullptr, InvalidationLevel::Valid) {
+              vec3(0.0f, 1.0f, 0.0f), nullptr, InvalidationLevel::Valid)
+    , buffers_(util::make_unique<ClipBuffers>()) {
     addPort(inport_);
     addPort(outport_);
     addPort(clippingPlane_);
@@ -94,6 +136,9 @@ MeshClipping::MeshClipping()
 
     movePointAlongNormal_.onChange(onMovePointAlongNormalToggled);
     onMovePointAlongNormalToggled();
+
+    // The vertices might have changed even if the vertex buffer is at the same address
+    inport_.onChange([this]() { buffers_->distances.clear(); });
 }
 
 MeshClipping::~MeshClipping() = default;
@@ -205,12 +250,6 @@ void MeshClipping::onAlignPlaneNormalToCameraNormalPressed() {
     }
 }
 
-// Check point equality with threshold
-inline bool equal(vec3 v1, vec3 v2, float eps) {
-    return (std::fabs(v1.x - v2.x) < eps && std::fabs(v1.y - v2.y) < eps &&
-            std::fabs(v1.z - v2.z) < eps);
-}
-
 // Compute barycentric coordinates/weights for
 // point p (which is inside the polygon) with respect to polygons of vertices (v)
 // Based on Mean Value Coordinates by Hormann/Floater
@@ -275,6 +314,179 @@ inline vec3 barycentricTriangle(vec3 p, vec3 a, vec3 b, vec3 c) {
     return bary;
 }
 
+namespace {
+
+struct Vec3Hash {
+    size_t operator()(const vec3& v) const {
+        size_t h = 0;
+        util::hash_combine(h, v.x);
+        util::hash_combine(h, v.y);
+        util::hash_combine(h, v.z);
+        return h;
+    }
+};
+
+// Edges are equal regardless of direction, hence a symmetric hash
+struct EdgeHash {
+    size_t operator()(const Edge3D& e) const { return Vec3Hash{}(e.v1) ^ Vec3Hash{}(e.v2); }
+};
+
+struct ClipInput {
+    const std::vector<vec3>& vertices;
+    const std::vector<vec3>& texCoords;
+    const std::vector<vec4>& colors;
+    const std::vector<float>& distances;
+    float offset;
+};
+
+/**
+ * Clip the triangles [begin, end) against the plane, where triangle(t) returns the vertex indices
+ * of triangle t. Triangles entirely in front of the plane are copied, triangles behind the plane
+ * are dropped and only the triangles straddling the plane are clipped.
+ */
+template <typename Triangle>
+void clipTriangles(size_t begin, size_t end, Triangle triangle, const ClipInput& in,
+                   ClipChunk& out) {
+    const auto& d = in.distances;
+    const auto inside = [&](std::uint32_t i) { return d[i] >= in.offset; };
+
+    std::array<vec3, 4> newVertices;
+    std::array<vec4, 4> newColors;
+
+    for (size_t t = begin; t < end; ++t) {
+        const std::array<std::uint32_t, 3> idx = triangle(t);
+        const std::array<bool, 3> in3{{inside(idx[0]), inside(idx[1]), inside(idx[2])}};
+
+        if (in3[0] && in3[1] && in3[2]) {
+            for (size_t i = 0; i < 3; ++i) {
+                const auto j = idx[i == 2 ? 0 : i + 1];
+                out.positions.push_back(in.vertices[j]);
+                out.colors.push_back(in.colors[j]);
+            }
+            continue;
+        } else if (!in3[0] && !in3[1] && !in3[2]) {
+            continue;
+        }
+
+        /* Sutherland-Hodgman Clipping
+           1) Traverse each edge by edge, such as successive vertex pairs make up edges
+           2) For each edge with vertices [v1, v2]
+              Case 1: If v1 and v2 is inside, add v2
+              Case 2: If v1 inside and v2 outside, add intersection
+              Case 3: If v1 outside and v2 inside, add intersection and then add v2
+              Case 4: If v1 and v2 is outside, add nothing
+           Observation: A clipped triangle can either contain
+              3 points (if only case 1 and 4 occurred) or
+              4 points (if case 2 and 3 occurred) or
+              0 points (if only case 4 occurred, thus no points)
+           3) If 4 points, make two triangles, 0 1 2 and 0 3 2, total 6 points.
+        */
+        size_t count = 0;
+        bool intersectionAdded = false;
+        const auto add = [&](const vec3& pos, const vec4& col) {
+            newVertices[count] = pos;
+            newColors[count] = col;
+            ++count;
+        };
+        const auto intersect = [&](std::uint32_t a, std::uint32_t b) {
+            // Always interpolate from the lower position such that triangles sharing the edge
+            // get exactly the same intersection point, even if they have their own copies of the
+            // vertices as in unwelded meshes
+            const auto& va = in.vertices[a];
+            const auto& vb = in.vertices[b];
+            if (std::tie(vb.x, vb.y, vb.z) < std::tie(va.x, va.y, va.z)) std::swap(a, b);
+            const float t = (in.offset - d[a]) / (d[b] - d[a]);
+            // Use the vertex itself when it is on the plane, the interpolation might be off by
+            // rounding, which would leave a gap between the edges meeting at the vertex
+            const vec3 intersection =
+                t <= 0.0f ? in.vertices[a]
+                          : t >= 1.0f ? in.vertices[b]
+                                      : in.vertices[a] + t * (in.vertices[b] - in.vertices[a]);
+
+            const vec3 interBC =
+                barycentricTriangle(intersection, in.vertices[idx[0]], in.vertices[idx[1]],
+                                    in.vertices[idx[2]]);
+            const vec3 interTex = (in.texCoords[idx[0]] * interBC.x) +
+                                  (in.texCoords[idx[1]] * interBC.y) +
+                                  (in.texCoords[idx[2]] * interBC.z);
+            const vec4 interCol = (in.colors[idx[0]] * interBC.x) +
+                                  (in.colors[idx[1]] * interBC.y) +
+                                  (in.colors[idx[2]] * interBC.z);
+            add(intersection, interCol);
+            out.intersections.emplace_back(intersection, interTex, interCol);
+            return intersection;
+        };
+
+        for (size_t i = 0; i < 3; ++i) {
+            size_t j = (i == 2 ? 0 : i + 1);
+
+            if (in3[i]) {
+                if (in3[j]) {  // Case 1
+                    add(in.vertices[idx[j]], in.colors[idx[j]]);
+                } else {  // Case 2
+                    const auto intersection = intersect(idx[i], idx[j]);
+                    // We save the intersection as part of edge on the clipping plane
+                    if (intersectionAdded) {
+                        out.edges.back().v1 = intersection;
+                    } else {
+                        out.edges.push_back(Edge3D(intersection));
+                        intersectionAdded = true;
+                    }
+                }
+            } else if (in3[j]) {  // Case 3
+                const auto intersection = intersect(idx[i], idx[j]);
+                // We save the intersection as part of edge on the clipping plane
+                if (intersectionAdded) {
+                    out.edges.back().v2 = intersection;
+                } else {
+                    out.edges.push_back(Edge3D(intersection));
+                    intersectionAdded = true;
+                }
+                add(in.vertices[idx[j]], in.colors[idx[j]]);
+            }
+            // Case 4
+        }
+
+        // Handle more then 3 vertices
+        for (size_t i : {0, 1, 2}) {
+            out.positions.push_back(newVertices[i]);
+            out.colors.push_back(newColors[i]);
+        }
+        if (count > 3) {
+            for (size_t i : {0, 2, 3}) {
+                out.positions.push_back(newVertices[i]);
+                out.colors.push_back(newColors[i]);
+            }
+        }
+    }
+}
+
+}  // namespace
+
+void MeshClipping::updateVertexDistances(const std::vector<vec3>& vertices, const vec3& normal) {
+    auto& buffers = *buffers_;
+    if (buffers.vertices == vertices.data() && buffers.vertexCount == vertices.size() &&
+        buffers.normal == normal && buffers.distances.size() == vertices.size()) {
+        return;
+    }
+
+    buffers.distances.resize(vertices.size());
+    // Plain loops over arrays of floats, such that the compiler can vectorize them
+    const auto x = normal.x, y = normal.y, z = normal.z;
+    const auto src = glm::value_ptr(vertices.front());
+    const auto dst = buffers.distances.data();
+    const auto size = vertices.size();
+    util::forEachRangeParallel(size, 1 << 16, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            dst[i] = x * src[3 * i] + y * src[3 * i + 1] + z * src[3 * i + 2];
+        }
+    });
+
+    buffers.vertices = vertices.data();
+    buffers.vertexCount = vertices.size();
+    buffers.normal = normal;
+}
+
 std::shared_ptr<Mesh> MeshClipping::clipGeometryAgainstPlane(const Mesh* in,
                                                              const Plane& worldSpacePlane) {
     // Perform clipping in data space
@@ -285,7 +497,7 @@ std::shared_ptr<Mesh> MeshClipping::clipGeometryAgainstPlane(const Mesh* in,
         glm::normalize(vec3(worldToDataNormal * vec4(worldSpacePlane.getNormal(), 0.0)));
     Plane plane(dataSpacePos, dataSpaceNormal);
 
-    ConnectivityType indexAttrInfo;
+    Mesh::MeshInfo indexAttrInfo;
     const std::vector<vec3>* vertexList;
     const std::vector<vec3>* texcoordlist;
     const std::vector<vec4>* colorList;
@@ -296,7 +508,7 @@ std::shared_ptr<Mesh> MeshClipping::clipGeometryAgainstPlane(const Mesh* in,
         texcoordlist = &simple->getTexCoordList()->getRAMRepresentation()->getDataContainer();
         colorList = &simple->getColorList()->getRAMRepresentation()->getDataContainer();
         triangleList = &simple->getIndexList()->getRAMRepresentation()->getDataContainer();
-        indexAttrInfo = simple->getIndexMeshInfo(0).ct;
+        indexAttrInfo = simple->getIndexMeshInfo(0);
     } else if (auto basic = dynamic_cast<const BasicMesh*>(in)) {
         // TODO do clipping in all the index list now we only consider the first one
         vertexList = &basic->getVertices()->getRAMRepresentation()->getDataContainer();
@@ -304,412 +516,236 @@ std::shared_ptr<Mesh> MeshClipping::clipGeometryAgainstPlane(const Mesh* in,
         colorList = &basic->getColors()->getRAMRepresentation()->getDataContainer();
         triangleList =
             &basic->getIndexBuffers()[0].second->getRAMRepresentation()->getDataContainer();
-        indexAttrInfo = basic->getIndexBuffers()[0].first.ct;
+        indexAttrInfo = basic->getIndexBuffers()[0].first;
     } else {
         throw Exception("Unsupported mesh type, only simple and basic meshes are supported");
     }
 
     auto outputMesh = std::make_shared<SimpleMesh>(DrawType::Triangles);
 
-    // Check if we are using indices
-    if (triangleList->size() > 0) {
-        // Check if it is a Triangle Strip
-        if (indexAttrInfo == ConnectivityType::Strip) {
-            // Iterate over edges by edge
-            unsigned int idx[3];
-            std::vector<vec3> newVertices;
-            std::vector<vec3> newTexCoords;
-            std::vector<vec4> newColors;
-            std::vector<Edge3D> intersectionsEdges;
-            std::vector<std::pair<vec3, vec3> > intersectionTex;
-            std::vector<std::pair<vec3, vec4> > intersectionCol;
-
-            for (unsigned int t = 0; t < triangleList->size() - 2; ++t) {
-                idx[0] = triangleList->at(t);
-
-                // Clockwise
-                if (t & 1) {
-                    idx[1] = triangleList->at(t + 2);
-                    idx[2] = triangleList->at(t + 1);
-                } else {
-                    idx[1] = triangleList->at(t + 1);
-                    idx[2] = triangleList->at(t + 2);
-                }
-
-                /* Sutherland-Hodgman Clipping
-                   1) Traverse each edge by edge, such as successive vertex pairs make up edges
-                   2) For each edge with vertices [v1, v2]
-                      Case 1: If v1 and v2 is inside, add v2
-                      Case 2: If v1 inside and v2 outside, add intersection
-                      Case 3: If v1 outside and v2 inside, add intersection and then add v2
-                      Case 4: If v1 and v2 is outside, add nothing
-                   Observation: A clipped triangle can either contain
-                      3 points (if only case 1 and 4 occurred) or
-                      4 points (if case 2 and 3 occurred) or
-                      0 points (if only case 4 occurred, thus no points)
-                   3) If 4 points, make two triangles, 0 1 2 and 0 3 2, total 6 points.
-                */
-                newVertices.clear();
-                newTexCoords.clear();
-                newColors.clear();
-                bool intersectionAdded = false;
-
-                for (size_t i = 0; i < 3; ++i) {
-                    size_t j = (i == 2 ? 0 : i + 1);
-
-                    if (plane.isInside(vertexList->at(idx[i]))) {
-                        if (plane.isInside(vertexList->at(idx[j]))) {  // Case 1
-                            // Add v2
-                            newVertices.push_back(vertexList->at(idx[j]));
-                            newTexCoords.push_back(texcoordlist->at(idx[j]));
-                            newColors.push_back(colorList->at(idx[j]));
-                        } else {  // Case 2
-                            // Add Intersection
-                            vec3 intersection =
-                                plane
-                                    .getIntersection(vertexList->at(idx[i]), vertexList->at(idx[j]))
-                                    .intersection_;
-                            newVertices.push_back(intersection);
-                            vec3 interBC =
-                                barycentricTriangle(intersection, vertexList->at(idx[0]),
-                                                    vertexList->at(idx[1]), vertexList->at(idx[2]));
-                            vec3 interTex = (texcoordlist->at(idx[0]) * interBC.x) +
-                                            (texcoordlist->at(idx[1]) * interBC.y) +
-                                            (texcoordlist->at(idx[2]) * interBC.z);
-                            newTexCoords.push_back(interTex);
-                            vec4 interCol = (colorList->at(idx[0]) * interBC.x) +
-                                            (colorList->at(idx[1]) * interBC.y) +
-                                            (colorList->at(idx[2]) * interBC.z);
-                            newColors.push_back(interCol);
-                            intersectionTex.push_back(std::make_pair(intersection, interTex));
-                            intersectionCol.push_back(std::make_pair(intersection, interCol));
-
-                            // We save the intersection as part of edge on the clipping plane
-                            if (intersectionAdded)
-                                intersectionsEdges.back().v1 = intersection;
-                            else {
-                                intersectionsEdges.push_back(Edge3D(intersection));
-                                intersectionAdded = true;
-                            }
-                        }
-                    } else {
-                        if (plane.isInside(vertexList->at(idx[j]))) {  // Case 3
-                            // Add Intersection
-                            vec3 intersection =
-                                plane
-                                    .getIntersection(vertexList->at(idx[i]), vertexList->at(idx[j]))
-                                    .intersection_;
-                            newVertices.push_back(intersection);
-                            vec3 interBC =
-                                barycentricTriangle(intersection, vertexList->at(idx[0]),
-                                                    vertexList->at(idx[1]), vertexList->at(idx[2]));
-                            vec3 interTex = (texcoordlist->at(idx[0]) * interBC.x) +
-                                            (texcoordlist->at(idx[1]) * interBC.y) +
-                                            (texcoordlist->at(idx[2]) * interBC.z);
-                            newTexCoords.push_back(interTex);
-                            vec4 interCol = (colorList->at(idx[0]) * interBC.x) +
-                                            (colorList->at(idx[1]) * interBC.y) +
-                                            (colorList->at(idx[2]) * interBC.z);
-                            newColors.push_back(interCol);
-                            intersectionTex.push_back(std::make_pair(intersection, interTex));
-                            intersectionCol.push_back(std::make_pair(intersection, interCol));
-
-                            // We save the intersection as part of edge on the clipping plane
-                            if (intersectionAdded)
-                                intersectionsEdges.back().v2 = intersection;
-                            else {
-                                intersectionsEdges.push_back(Edge3D(intersection));
-                                intersectionAdded = true;
-                            }
-
-                            // Add v2
-                            newVertices.push_back(vertexList->at(idx[j]));
-                            newTexCoords.push_back(texcoordlist->at(idx[j]));
-                            newColors.push_back(colorList->at(idx[j]));
-                        }
-
-                        // Case 4
-                    }
-                }
-
-                // Handle more then 3 vertices
-                if (newVertices.size() > 3) {
-                    ivwAssert(newVertices.size() < 5,
-                              "Can't handle " << newVertices.size() << " vertices after clipping");
-                    vec3 lastVert = newVertices.at(3);
-                    vec3 lastTexc = newTexCoords.at(3);
-                    vec4 lastColor = newColors.at(3);
-                    newVertices.pop_back();
-                    newTexCoords.pop_back();
-                    newColors.pop_back();
-                    newVertices.push_back(newVertices.at(0));
-                    newTexCoords.push_back(newTexCoords.at(0));
-                    newColors.push_back(newColors.at(0));
-                    newVertices.push_back(newVertices.at(2));
-                    newTexCoords.push_back(newTexCoords.at(2));
-                    newColors.push_back(newColors.at(2));
-                    newVertices.push_back(lastVert);
-                    newTexCoords.push_back(lastTexc);
-                    newColors.push_back(lastColor);
-                }
+    // Only triangle lists and triangle strips are clipped
+    if (triangleList->size() < 3 || indexAttrInfo.dt != DrawType::Triangles ||
+        (indexAttrInfo.ct != ConnectivityType::Strip &&
+         indexAttrInfo.ct != ConnectivityType::None)) {
+        return outputMesh;
+    }
 
-                // Add vertices to mesh
-                for (size_t i = 0; i < newVertices.size(); ++i) {
-                    outputMesh->addVertex(newVertices.at(i), newVertices.at(i), newColors.at(i));
+    updateVertexDistances(*vertexList, plane.getNormal());
+    const ClipInput input{*vertexList, *texcoordlist, *colorList, buffers_->distances,
+                          glm::dot(plane.getNormal(), plane.getPoint())};
+
+    // Clip the triangles in parallel chunks
+    const auto& tl = *triangleList;
+    const bool strip = indexAttrInfo.ct == ConnectivityType::Strip;
+    const size_t numTriangles = strip ? tl.size() - 2 : tl.size() / 3;
+    auto& chunks = buffers_->chunks;
+    const size_t minChunkSize = 1 << 14;
+    chunks.resize(util::parallelRangeCount(numTriangles, minChunkSize));
+    const auto clipChunk = [&](size_t begin, size_t end, size_t c) {
+        auto& chunk = chunks[c];
+        chunk.clear();
+        if (strip) {
+            clipTriangles(begin, end,
+                          [&](size_t t) -> std::array<std::uint32_t, 3> {
+                              // Clockwise
+                              if (t & 1) return {{tl[t], tl[t + 2], tl[t + 1]}};
+                              return {{tl[t], tl[t + 1], tl[t + 2]}};
+                          },
+                          input, chunk);
+        } else {
+            clipTriangles(begin, end,
+                          [&](size_t t) -> std::array<std::uint32_t, 3> {
+                              return {{tl[3 * t], tl[3 * t + 1], tl[3 * t + 2]}};
+                          },
+                          input, chunk);
+        }
+    };
+    util::forEachRangeParallelN(numTriangles, chunks.size(), clipChunk);
+
+    // Based on intersection edges, create triangles where plane intersect mesh.
+    // One point on a clipped triangle is replaced with intersection edge,
+    // Connect all edges to form one or more polygons
+    // Then calculate centroids of these polygons
+    // Then create one triangle per edge
+    std::vector<Edge3D> uniqueEdges;
+    std::unordered_map<vec3, std::pair<vec3, vec4>, Vec3Hash> intersections;
+    {
+        std::unordered_set<Edge3D, EdgeHash> seen;
+        for (const auto& chunk : chunks) {
+            for (const auto& edge : chunk.edges) {
+                // Points are matched exactly below, so only drop edges that collapse to a point.
+                // Dropping short edges would leave their end points unconnected.
+                if (edge.v1 != edge.v2 && seen.insert(edge).second) {
+                    uniqueEdges.push_back(edge);
                 }
             }
-
-            // Based on intersection edges, create triangles where plane intersect mesh.
-            // http://en.wikipedia.org/wiki/Point_set_triangulation
-            // http://en.wikipedia.org/wiki/Delaunay_triangulation
-            // https://code.google.com/p/poly2tri/
-            // Simpler Approach? :
-            // One point on a clipped triangle is replaced with intersection edge,
-            // Connect all edges to form one or more polygons
-            // Then calculate centroids of these polygons
-            // Then create one triangle per edge
-            std::vector<Edge3D> uniqueintersectionsEdges;
-
-            for (auto& intersectionsEdge : intersectionsEdges) {
-                if (!equal(intersectionsEdge.v1, intersectionsEdge.v2, EPSILON)) {
-                    if (uniqueintersectionsEdges.empty() ||
-                        std::find(uniqueintersectionsEdges.begin(), uniqueintersectionsEdges.end(),
-                                  intersectionsEdge) == uniqueintersectionsEdges.end()) {
-                        uniqueintersectionsEdges.push_back(intersectionsEdge);
-                    }
-                }
+            for (const auto& i : chunk.intersections) {
+                intersections.emplace(std::get<0>(i),
+                                      std::make_pair(std::get<1>(i), std::get<2>(i)));
             }
+        }
+    }
 
-            // The points are not at same point, introduce threshold
-            if (!uniqueintersectionsEdges.empty()) {
-                // Create closed polygons based on edges
-                std::vector<Polygon<Edge3D> > polygons;
-                std::vector<Edge3D> connectedEdges;
-                std::vector<Edge3D> unconnectEdges = uniqueintersectionsEdges;
-
-                // Start with one edge, check which other edge it's connect to it
-                while (!unconnectEdges.empty()) {
-                    Edge3D currentEdge = unconnectEdges.front();
-                    connectedEdges.push_back(currentEdge);
-                    unconnectEdges.erase(unconnectEdges.begin());
-                    bool createdPolygon = false;
-
-                    // Search all edges for a connection
-                    for (size_t i = 0; i < uniqueintersectionsEdges.size(); ++i) {
-                        if (equal(uniqueintersectionsEdges[i].v1, currentEdge.v2, EPSILON) &&
-                            uniqueintersectionsEdges[i].v2 != currentEdge.v1) {
-                            connectedEdges.push_back(
-                                Edge3D(currentEdge.v2, uniqueintersectionsEdges[i].v2));
-                            std::vector<Edge3D>::iterator it = std::find(
-                                unconnectEdges.begin(), unconnectEdges.end(), currentEdge);
-
-                            if (it != unconnectEdges.end()) unconnectEdges.erase(it);
-
-                            currentEdge = uniqueintersectionsEdges[i];
-                            i = 0;
-                        } else if (equal(uniqueintersectionsEdges[i].v2, currentEdge.v2, EPSILON) &&
-                                   uniqueintersectionsEdges[i].v1 != currentEdge.v1) {
-                            connectedEdges.push_back(
-                                Edge3D(currentEdge.v2, uniqueintersectionsEdges[i].v1));
-                            std::vector<Edge3D>::iterator it = std::find(
-                                unconnectEdges.begin(), unconnectEdges.end(), currentEdge);
-
-                            if (it != unconnectEdges.end()) unconnectEdges.erase(it);
-
-                            currentEdge = Edge3D(uniqueintersectionsEdges[i].v2,
-                                                 uniqueintersectionsEdges[i].v1);
-                            i = 0;
-                        }
-
-                        // Last edge connect to first edge, close the loop and make a polygon
-                        if (equal(connectedEdges[0].v1, currentEdge.v2, EPSILON)) {
-                            if (currentEdge.v1 != currentEdge.v2) {
-                                connectedEdges.push_back(
-                                    Edge3D(currentEdge.v2, connectedEdges[0].v1));
-                                std::vector<Edge3D>::iterator it = std::find(
-                                    unconnectEdges.begin(), unconnectEdges.end(), currentEdge);
-
-                                if (it != unconnectEdges.end()) unconnectEdges.erase(it);
-                            }
-
-                            Polygon<Edge3D> newPoly(connectedEdges.size());
-
-                            for (size_t j = 0; j < connectedEdges.size(); ++j) {
-                                newPoly.at(j) = connectedEdges.at(j);
-                            }
-
-                            polygons.push_back(newPoly);
-                            connectedEdges.clear();
-                            createdPolygon = true;
-                            break;
-                        }
-
-                        if (i == uniqueintersectionsEdges.size() - 1) {
-                            throw Exception("Could not connect find intersecting edges",
-                                            IvwContext);
-                        }
-                    }
-
-                    if (!createdPolygon) {
-                        throw Exception("Could not connect clipped edges to manifold polygon",
-                                        IvwContext);
-                    }
+    // Create closed polygons based on edges
+    std::vector<std::vector<vec3>> polygons;
+    {
+        std::unordered_multimap<vec3, size_t, Vec3Hash> edgesAtPoint;
+        for (size_t i = 0; i < uniqueEdges.size(); ++i) {
+            edgesAtPoint.emplace(uniqueEdges[i].v1, i);
+            edgesAtPoint.emplace(uniqueEdges[i].v2, i);
+        }
+        std::vector<bool> connected(uniqueEdges.size(), false);
+        // Start with one edge, follow the connected edges until we are back at the start
+        for (size_t first = 0; first < uniqueEdges.size(); ++first) {
+            if (connected[first]) continue;
+            connected[first] = true;
+            std::vector<vec3> polygon{uniqueEdges[first].v1};
+            auto current = uniqueEdges[first].v2;
+            while (current != polygon.front()) {
+                polygon.push_back(current);
+                auto range = edgesAtPoint.equal_range(current);
+                auto next = std::find_if(range.first, range.second,
+                                         [&](const auto& item) { return !connected[item.second]; });
+                if (next == range.second) {
+                    throw Exception("Could not connect clipped edges to manifold polygon",
+                                    IvwContext);
                 }
+                connected[next->second] = true;
+                const auto& edge = uniqueEdges[next->second];
+                current = edge.v1 == current ? edge.v2 : edge.v1;
+            }
+            polygons.push_back(std::move(polygon));
+        }
+    }
 
-                // Calculate centroids per polygon
-                // First in the x-y plane and then in the x-z plane.
-                std::vector<vec3> polygonCentroids;
-                vec3 u, v;
-                vec3 n = plane.getNormal();
-
-                for (auto& polygon : polygons) {
-                    // Skip x-y plane if current plane is parallel to x-y plane
-                    // or skip x-z plane if current plane is parallel to x-z plane
-                    // or skip y-z if both skipXY and skip XZ are false
-                    vec3 p0, p1;
-                    vec3 centroid = plane.getPoint();
-                    float signedArea = 0.f;
-                    float a = 0.f;
-
-                    // X-Y Plane
-                    if (!plane.perpendicularToPlane(vec3(0.f, 0.f, 1.f))) {
-                        u = vec3(n.y, -n.z, 0.f);
-                        centroid.x = 0.f;
-                        centroid.y = 0.f;
-                        signedArea = 0.f;
-
-                        for (size_t i = 0; i < polygon.size(); ++i) {
-                            p0 = polygon.get(i).v1;
-                            p1 = polygon.get(i).v2;
-                            a = p0.x * p1.y - p1.x * p0.y;
-                            signedArea += a;
-                            centroid.x += (p0.x + p1.x) * a;
-                            centroid.y += (p0.y + p1.y) * a;
-                        }
-
-                        signedArea *= 0.5f;
-
-                        if (std::fabs(signedArea) < EPSILON) {
-                            centroid.x = 0.f;
-                            centroid.y = 0.f;
-                        } else {
-                            centroid.x /= (6.f * signedArea);
-                            centroid.y /= (6.f * signedArea);
-                        }
-                    }
-
-                    // X-Z Plane
-                    if (!plane.perpendicularToPlane(vec3(0.f, 1.f, 0.f))) {
-                        u = vec3(n.x, -n.y, 0.f);
-                        centroid.x = 0.f;
-                        centroid.z = 0.f;
-                        signedArea = 0.f;
-
-                        for (size_t i = 0; i < polygon.size(); ++i) {
-                            p0 = polygon.get(i).v1;
-                            p1 = polygon.get(i).v2;
-                            a = p0.x * p1.z - p1.x * p0.z;
-                            signedArea += a;
-                            centroid.x += (p0.x + p1.x) * a;
-                            centroid.z += (p0.z + p1.z) * a;
-                        }
-
-                        signedArea *= 0.5f;
-
-                        if (std::fabs(signedArea) < EPSILON) {
-                            centroid.x = 0.f;
-                            centroid.z = 0.f;
-                        } else {
-                            centroid.x /= (6.f * signedArea);
-                            centroid.z /= (6.f * signedArea);
-                        }
-                    }
-
-                    // Y-Z Plane
-                    if (!plane.perpendicularToPlane(vec3(1.f, 0.f, 0.f))) {
-                        u = vec3(n.y, -n.z, 0.f);
-                        centroid.y = 0.f;
-                        centroid.z = 0.f;
-                        signedArea = 0.f;
-
-                        for (size_t i = 0; i < polygon.size(); ++i) {
-                            p0 = polygon.get(i).v1;
-                            p1 = polygon.get(i).v2;
-                            a = p0.y * p1.z - p1.y * p0.z;
-                            signedArea += a;
-                            centroid.y += (p0.y + p1.y) * a;
-                            centroid.z += (p0.z + p1.z) * a;
-                        }
-
-                        signedArea *= 0.5f;
-
-                        if (std::fabs(signedArea) < EPSILON) {
-                            centroid.y = 0.f;
-                            centroid.z = 0.f;
-                        } else {
-                            centroid.y /= (6.f * signedArea);
-                            centroid.z /= (6.f * signedArea);
-                        }
-                    }
+    // Calculate centroids per polygon
+    // First in the x-y plane and then in the x-z plane.
+    const vec3 n = plane.getNormal();
+    vec3 u{n.y, -n.z, 0.f};
+    std::vector<vec3> polygonCentroids;
+    for (auto& polygon : polygons) {
+        vec3 centroid = plane.getPoint();
+        // Skip x-y plane if current plane is parallel to x-y plane
+        // or skip x-z plane if current plane is parallel to x-z plane
+        // or skip y-z if both skipXY and skip XZ are false
+        const auto planeCentroid = [&](int c0, int c1) {
+            centroid[c0] = 0.f;
+            centroid[c1] = 0.f;
+            float signedArea = 0.f;
+            for (size_t i = 0; i < polygon.size(); ++i) {
+                const vec3& p0 = polygon[i];
+                const vec3& p1 = polygon[(i + 1) % polygon.size()];
+                const float a = p0[c0] * p1[c1] - p1[c0] * p0[c1];
+                signedArea += a;
+                centroid[c0] += (p0[c0] + p1[c0]) * a;
+                centroid[c1] += (p0[c1] + p1[c1]) * a;
+            }
+            signedArea *= 0.5f;
+            if (std::fabs(signedArea) < EPSILON) {
+                centroid[c0] = 0.f;
+                centroid[c1] = 0.f;
+            } else {
+                centroid[c0] /= (6.f * signedArea);
+                centroid[c1] /= (6.f * signedArea);
+            }
+        };
 
-                    polygonCentroids.push_back(centroid);
-                }
+        // X-Y Plane
+        if (!plane.perpendicularToPlane(vec3(0.f, 0.f, 1.f))) {
+            u = vec3(n.y, -n.z, 0.f);
+            planeCentroid(0, 1);
+        }
+        // X-Z Plane
+        if (!plane.perpendicularToPlane(vec3(0.f, 1.f, 0.f))) {
+            u = vec3(n.x, -n.y, 0.f);
+            planeCentroid(0, 2);
+        }
+        // Y-Z Plane
+        if (!plane.perpendicularToPlane(vec3(1.f, 0.f, 0.f))) {
+            u = vec3(n.y, -n.z, 0.f);
+            planeCentroid(1, 2);
+        }
+        polygonCentroids.push_back(centroid);
+    }
+    const vec3 v = glm::cross(plane.getNormal(), u);
 
-                v = glm::cross(plane.getNormal(), u);
-                // Add new polygons as triangles to the mesh
-                std::vector<vec2> uv;
-                std::vector<float> baryW;
-                std::vector<vec3> tex;
-                std::vector<vec4> col;
-                vec2 uvC;
-                vec3 texC;
-                vec4 colC;
-
-                for (size_t p = 0; p < polygons.size(); ++p) {
-                    size_t pSize = polygons[p].size();
-                    uv.clear();
-                    tex.clear();
-                    col.clear();
-
-                    for (size_t i = 0; i < pSize; ++i) {
-                        // Calculate u-v plane coordinates of the vertex on the polygon
-                        uv.push_back(vec2(glm::dot(u, polygons[p].get(i).v1),
-                                          glm::dot(v, polygons[p].get(i).v1)));
-
-                        // Lookup texcoord and colors for the vertex of the polygon
-                        for (size_t t = 0; t < intersectionTex.size(); ++t) {
-                            if (intersectionTex.at(t).first == polygons[p].get(i).v1) {
-                                tex.push_back(intersectionTex.at(t).second);
-                                col.push_back(intersectionCol.at(t).second);
-                                break;
-                            }
-                        }
-                    }
+    // Size the output buffers once and copy the chunks and polygons into them in parallel
+    std::vector<size_t> offsets(chunks.size() + 1, 0);
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        offsets[c + 1] = offsets[c] + chunks[c].positions.size();
+    }
+    size_t numVertices = offsets.back();
+    for (const auto& polygon : polygons) numVertices += 3 * polygon.size();
+
+    auto& positions = static_cast<Buffer<vec3>*>(outputMesh->getBuffer(0))
+                          ->getEditableRAMRepresentation()
+                          ->getDataContainer();
+    auto& texCoords = static_cast<Buffer<vec3>*>(outputMesh->getBuffer(1))
+                          ->getEditableRAMRepresentation()
+                          ->getDataContainer();
+    auto& colors = static_cast<Buffer<vec4>*>(outputMesh->getBuffer(2))
+                       ->getEditableRAMRepresentation()
+                       ->getDataContainer();
+    positions.resize(numVertices);
+    texCoords.resize(numVertices);
+    colors.resize(numVertices);
+
+    util::forEachRangeParallel(chunks.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; ++c) {
+            const auto& chunk = chunks[c];
+            std::copy(chunk.positions.begin(), chunk.positions.end(),
+                      positions.begin() + offsets[c]);
+            std::copy(chunk.positions.begin(), chunk.positions.end(),
+                      texCoords.begin() + offsets[c]);
+            std::copy(chunk.colors.begin(), chunk.colors.end(), colors.begin() + offsets[c]);
+        }
+    });
 
-                    uv.pop_back();
-                    // Calculate barycentric coordinates (weights) for all the vertices based on
-                    // centroid.
-                    uvC = vec2(glm::dot(u, polygonCentroids[p]), glm::dot(v, polygonCentroids[p]));
-                    barycentricInsidePolygon2D(uvC, uv, baryW);
-                    texC = vec3(0.f);
-                    colC = vec4(0.f);
-
-                    for (size_t i = 0; i < pSize - 1; ++i) {
-                        texC += tex[i] * baryW[i];
-                        colC += col[i] * baryW[i];
-                    }
+    // Add new polygons as triangles to the mesh
+    size_t vertex = offsets.back();
+    std::vector<vec2> uv;
+    std::vector<float> baryW;
+    std::vector<vec3> tex;
+    std::vector<vec4> col;
+    const auto addVertex = [&](const vec3& pos, const vec3& texCoord, const vec4& color) {
+        positions[vertex] = pos;
+        texCoords[vertex] = texCoord;
+        colors[vertex] = color;
+        ++vertex;
+    };
+    for (size_t p = 0; p < polygons.size(); ++p) {
+        const auto& polygon = polygons[p];
+        const size_t pSize = polygon.size();
+        uv.clear();
+        tex.clear();
+        col.clear();
+
+        for (const auto& point : polygon) {
+            // Calculate u-v plane coordinates of the vertex on the polygon
+            uv.push_back(vec2(glm::dot(u, point), glm::dot(v, point)));
+            // Lookup texcoord and colors for the vertex of the polygon
+            const auto it = intersections.find(point);
+            tex.push_back(it != intersections.end() ? it->second.first : vec3(0.f));
+            col.push_back(it != intersections.end() ? it->second.second : vec4(0.f));
+        }
 
-                    // Add triangles to the mesh
-                    size_t ip;
+        // Calculate barycentric coordinates (weights) for all the vertices based on centroid.
+        const vec2 uvC =
+            vec2(glm::dot(u, polygonCentroids[p]), glm::dot(v, polygonCentroids[p]));
+        barycentricInsidePolygon2D(uvC, uv, baryW);
+        vec3 texC{0.f};
+        vec4 colC{0.f};
+        for (size_t i = 0; i < pSize; ++i) {
+            texC += tex[i] * baryW[i];
+            colC += col[i] * baryW[i];
+        }
 
-                    for (size_t i = 0; i < pSize; ++i) {
-                        ip = (i + 1) % pSize;
-                        outputMesh->addVertex(polygonCentroids[p], texC, colC);
-                        outputMesh->addVertex(polygons[p].get(i).v2, tex[ip], col[ip]);
-                        outputMesh->addVertex(polygons[p].get(i).v1, tex[i], col[i]);
-                    }
-                }
-            }
+        // Add triangles to the mesh
+        for (size_t i = 0; i < pSize; ++i) {
+            const size_t ip = (i + 1) % pSize;
+            addVertex(polygonCentroids[p], texC, colC);
+            addVertex(polygon[ip], tex[ip], col[ip]);
+            addVertex(polygon[i], tex[i], col[i]);
         }
     }
 
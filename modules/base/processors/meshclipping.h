@@ -51,7 +51,9 @@ namespace inviwo {
  * Link the camera property to move the camera along the plane, or to align plane with view direction.
  * Coordinates are specified in world space.
  *
- * Supports SimpleMesh and BasicMesh 
+ * Supports SimpleMesh and BasicMesh with triangle lists or triangle strips.
+ * The triangles are clipped in parallel, and the distances of the vertices to the plane are reused
+ * while the plane is only moved along its normal.
  *
  * ### Inports
  *   * __inputMesh__ Input mesh
@@ -92,7 +94,14 @@ protected:
     std::shared_ptr<Mesh> clipGeometryAgainstPlane(const Mesh*, const Plane&);
 
 private:
+    struct ClipBuffers;
+
     void onAlignPlaneNormalToCameraNormalPressed();
+    /**
+     * Compute the distance of each vertex to the plane through the origin with the given normal,
+     * unless they are already computed for the same vertices and normal.
+     */
+    void updateVertexDistances(const std::vector<vec3>& vertices, const vec3& normal);
 
     MeshInport inport_;
     MeshOutport outport_;
@@ -109,6 +118,9 @@ private:
 
     float previousPointPlaneMove_;
 
+    // Cached vertex distances and intermediate results reused between evaluations
+    std::unique_ptr<ClipBuffers> buffers_;
+
     static const float EPSILON;
 };
 }  // namespace inviwo
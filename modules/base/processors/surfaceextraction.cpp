@@ -64,7 +64,7 @@ SurfaceExtraction::SurfaceExtraction()
     , invertIso_("invert", "Invert ISO", false)
     , encloseSurface_("enclose", "Enclose Surface", true)
     , colors_("meshColors", "Mesh Colors")
-    , dirty_(false) {
+    , job_(*this, &getProgressBar()) {
 
     addPort(volume_);
     addPort(outport_);
@@ -98,84 +98,111 @@ SurfaceExtraction::SurfaceExtraction()
 SurfaceExtraction::~SurfaceExtraction() {}
 
 void SurfaceExtraction::process() {
-    if (!meshes_) {
-        meshes_ = std::make_shared<std::vector<std::shared_ptr<Mesh>>>();
+    if (job_.hasResult()) {
+        try {
+            extractions_ = job_.takeResult();
+        } catch (Exception&) {
+            extractions_.clear();
+            outport_.setData(nullptr);
+            throw;
+        }
+        auto meshes = std::make_shared<std::vector<std::shared_ptr<Mesh>>>();
+        for (const auto& e : extractions_) {
+            if (e.mesh) meshes->push_back(e.mesh);
+        }
+        if (!meshes->empty()) {
+            outport_.setData(meshes);
+        } else {
+            outport_.setData(nullptr);
+        }
     }
 
     auto data = volume_.getSourceVectorData();
     auto changed = volume_.getChangedOutports();
-    result_.resize(data.size());
-    meshes_->resize(data.size());
 
+    // Reuse the meshes of the current output where neither the volume nor the settings changed
+    std::vector<Extraction> request;
+    bool upToDate = data.size() == extractions_.size();
+    bool requested = job_.isRunning() && changed.empty() && data.size() == requested_.size();
     for (size_t i = 0; i < data.size(); ++i) {
-        auto vol = data[i].second;
-
-        if (util::is_future_ready(result_[i].result)) {
-            (*meshes_)[i] = result_[i].result.get();
-            result_[i].status = 1.0f;
-            dirty_ = false;
-            auto meshes = std::make_shared<std::vector<std::shared_ptr<Mesh>>>();
-            std::copy_if(meshes_->begin(), meshes_->end(), std::back_inserter(*meshes),
-                         [](const auto& m) { return m != nullptr; });
-            if (!meshes->empty()) {
-                outport_.setData(meshes);
-            } else {
-                outport_.setData(nullptr);
-            }
+        Extraction e{data[i].second,
+                     method_.get(),
+                     isoValue_.get(),
+                     static_cast<FloatVec4Property*>(colors_[i])->get(),
+                     invertIso_.get(),
+                     encloseSurface_.get(),
+                     nullptr};
+        if (i < extractions_.size() && !util::contains(changed, data[i].first) &&
+            e.isSame(extractions_[i])) {
+            e.mesh = extractions_[i].mesh;
+        } else {
+            upToDate = false;
         }
+        requested = requested && e.isSame(requested_[i]);
+        request.push_back(std::move(e));
+    }
 
-        Method method = method_.get();
-        float iso = isoValue_.get();
-        vec4 color = static_cast<FloatVec4Property*>(colors_[i])->get();
-        bool invert = invertIso_.get();
-        bool enclose = encloseSurface_.get();
-        if (!result_[i].result.valid() &&
-            (util::contains(changed, data[i].first) ||
-             !result_[i].isSame(method, iso, color, invert, enclose))) {
-            result_[i].set(method, iso, color, invert, enclose, 0.0f,
-                           dispatchPool([this, vol, method, iso, color, invert, enclose,
-                                         i]() -> std::shared_ptr<Mesh> {
-                               auto progressCallBack = [this, i](float s) {
-                                   this->result_[i].status = s;
-                                   float status = 0;
-                                   for (const auto& e : this->result_) status += e.status;
-                                   status /= result_.size();
-                                   dispatchFront(
-                                       [status](ProgressBar& pb) {
-                                           pb.updateProgress(status);
-                                           if (status < 1.0f)
-                                               pb.show();
-                                           else
-                                               pb.hide();
-                                       },
-                                       std::ref(this->getProgressBar()));
-                               };
+    if (upToDate) {
+        // Any extraction still running is for settings that are no longer wanted
+        job_.cancel();
+        return;
+    } else if (requested) {
+        return;  // Already extracting these
+    }
 
-                               std::shared_ptr<Mesh> m;
-                               switch (method) {
-                                   case Method::MarchingCubes:
-                                       m = util::marchingcubes(vol, iso, color, invert, enclose,
-                                                               progressCallBack);
-                                       break;
-                                   case Method::MarchingCubesOpt:
-                                       m = util::marchingCubesOpt(vol, iso, color, invert, enclose,
-                                                                  progressCallBack);
-                                       break;
-                                   case Method::MarchingTetrahedron:
-                                   default:
-                                       m = util::marchingtetrahedron(vol, iso, color, invert,
-                                                                     enclose, progressCallBack);
-                                       break;
-                               }
+    requested_ = request;
 
-                               dispatchFront([this]() {
-                                   dirty_ = true;
-                                   invalidate(InvalidationLevel::InvalidOutput);
-                               });
+    job_.submit([request](const StopToken& token, const std::function<void(float)>& progress) {
+        auto result = request;
+        std::vector<size_t> todo;
+        for (size_t i = 0; i < result.size(); ++i) {
+            if (!result[i].mesh) todo.push_back(i);
+        }
 
-                               return m;
-                           }));
+        std::vector<std::atomic<float>> status(todo.size());
+        for (auto& s : status) s = 0.0f;
+        // The extraction algorithms only report progress where it is safe to unwind
+        const auto progressCallBack = [&](size_t k) {
+            return [&, k](float s) {
+                token.throwIfStopRequested();
+                status[k] = s;
+                float total = 0.0f;
+                for (const auto& e : status) total += e;
+                progress(total / status.size());
+            };
+        };
+
+        if (todo.size() == 1) {
+            result[todo[0]].mesh = extract(result[todo[0]], progressCallBack(0));
+        } else {
+            std::vector<std::future<std::shared_ptr<Mesh>>> futures;
+            for (size_t k = 0; k < todo.size(); ++k) {
+                futures.push_back(dispatchPool(
+                    [&, k]() { return extract(result[todo[k]], progressCallBack(k)); }));
+            }
+            // Wait for all extractions before any exception is propagated
+            for (auto& f : futures) waitForTask(f);
+            for (size_t k = 0; k < todo.size(); ++k) {
+                result[todo[k]].mesh = futures[k].get();
+            }
         }
+        return result;
+    });
+}
+
+std::shared_ptr<Mesh> SurfaceExtraction::extract(const Extraction& e,
+                                                 std::function<void(float)> progressCallBack) {
+    switch (e.method) {
+        case Method::MarchingCubes:
+            return util::marchingcubes(e.volume, e.iso, e.color, e.invert, e.enclose,
+                                       progressCallBack);
+        case Method::MarchingCubesOpt:
+            return util::marchingCubesOpt(e.volume, e.iso, e.color, e.invert, e.enclose,
+                                          progressCallBack);
+        case Method::MarchingTetrahedron:
+        default:
+            return util::marchingtetrahedron(e.volume, e.iso, e.color, e.invert, e.enclose,
+                                             progressCallBack);
     }
 }
 
@@ -223,47 +250,16 @@ void SurfaceExtraction::invalidate(InvalidationLevel invalidationLevel,
     notifyObserversInvalidationBegin(this);
     PropertyOwner::invalidate(invalidationLevel, modifiedProperty);
 
-    if (dirty_ || volume_.isChanged()) outport_.invalidate(InvalidationLevel::InvalidOutput);
+    if (job_.hasResult() || volume_.isChanged()) {
+        outport_.invalidate(InvalidationLevel::InvalidOutput);
+    }
 
     notifyObserversInvalidationEnd(this);
 }
 
-SurfaceExtraction::task::task(task&& rhs)
-    : result(std::move(rhs.result))
-    , method(rhs.method)
-    , iso(rhs.iso)
-    , color(std::move(rhs.color))
-    , invert(rhs.invert)
-    , enclose(rhs.enclose)
-    , status(rhs.status) {}
-
-bool SurfaceExtraction::task::isSame(Method m, float i, vec4 c, bool inv, bool enc) const {
-    return method == m && iso == i && color == c && inv == invert && enc == enclose;
-}
-
-void SurfaceExtraction::task::set(Method m, float i, vec4 c, bool inv, bool enc, float s,
-                                  std::future<std::shared_ptr<Mesh>>&& r) {
-    method = m;
-    iso = i;
-    color = c;
-    invert = inv;
-    enclose = enc;
-    status = s;
-    result = std::move(r);
-}
-
-SurfaceExtraction::task& SurfaceExtraction::task::operator=(task&& that) {
-    if (this != &that) {
-        result = std::move(that.result);
-        method = that.method;
-        iso = that.iso;
-        invert = that.invert;
-        enclose = that.enclose;
-        color = std::move(that.color);
-        status = that.status;
-    }
-
-    return *this;
+bool SurfaceExtraction::Extraction::isSame(const Extraction& other) const {
+    return volume == other.volume && method == other.method && iso == other.iso &&
+           color == other.color && invert == other.invert && enclose == other.enclose;
 }
 
 }  // namespace inviwo
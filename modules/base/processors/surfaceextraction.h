@@ -34,6 +34,7 @@
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/processors/processor.h>
 #include <inviwo/core/processors/progressbarowner.h>
+#include <inviwo/core/processors/backgroundjob.h>
 #include <inviwo/core/ports/volumeport.h>
 #include <inviwo/core/ports/meshport.h>
 #include <inviwo/core/properties/ordinalproperty.h>
@@ -41,8 +42,6 @@
 #include <inviwo/core/properties/compositeproperty.h>
 #include <inviwo/core/properties/boolproperty.h>
 
-#include <future>
-
 namespace inviwo {
 /** \docpage{org.inviwo.SurfaceExtraction, Surface Extraction}
  * ![](org.inviwo.SurfaceExtraction.png?classIdentifier=org.inviwo.SurfaceExtraction)
@@ -59,6 +58,9 @@ namespace inviwo {
  *   * __ISO Value__ ...
  *   * __Triangle Color__ ...
  *
+ * The surfaces are extracted in the background. Only surfaces whose volume or settings have
+ * changed are extracted again, and changing the settings while extracting aborts the stale
+ * extraction.
  */
 class IVW_MODULE_BASE_API SurfaceExtraction : public Processor, public ProgressBarOwner {
 public:
@@ -84,29 +86,23 @@ protected:
     virtual void invalidate(InvalidationLevel invalidationLevel,
                             Property* modifiedProperty = nullptr) override;
 
-    struct task {
-        task() = default;
-        task(const task&) = delete;
-        task& operator=(const task&) = delete;
-        task(task&&);
-        task& operator=(task&&);
-
-        std::future<std::shared_ptr<Mesh>> result;
+    struct Extraction {
+        std::shared_ptr<const Volume> volume;
         Method method;
-        float iso = 0.0f;
-        vec4 color = vec4(0);
-        bool invert = false;
-        bool enclose = true;
-        float status = 0.0f;
-
-        bool isSame(Method m, float iso, vec4 color, bool invert, bool enclose) const;
-        void set(Method m, float iso, vec4 color, bool invert, bool enclose, float status,
-                 std::future<std::shared_ptr<Mesh>>&& result);
+        float iso;
+        vec4 color;
+        bool invert;
+        bool enclose;
+        std::shared_ptr<Mesh> mesh;
+
+        bool isSame(const Extraction& other) const;
     };
 
+    static std::shared_ptr<Mesh> extract(const Extraction& e,
+                                         std::function<void(float)> progressCallBack);
+
     DataInport<Volume, 0> volume_;
     DataOutport<std::vector<std::shared_ptr<Mesh>>> outport_;
-    std::shared_ptr<std::vector<std::shared_ptr<Mesh>>> meshes_;
 
     TemplateOptionProperty<Method> method_;
     FloatProperty isoValue_;
@@ -114,8 +110,9 @@ protected:
     BoolProperty encloseSurface_;
     CompositeProperty colors_;
 
-    std::vector<task> result_;
-    bool dirty_;
+    std::vector<Extraction> extractions_;  // The extractions of the current output
+    std::vector<Extraction> requested_;    // The extractions last submitted to the job
+    BackgroundJob<std::vector<Extraction>> job_;
 };
 
 }  // namespace
@@ -38,7 +38,7 @@ const ProcessorInfo VolumeGradientCPUProcessor::processorInfo_{
     "Volume Gradient",                // Display name
     "Volume Operation",              // Category
     CodeState::Experimental,  // Code state
-    Tags::CPU,               // Tags
+    Tags::CPU | Tags::Concurrent, // Tags
 };
 const ProcessorInfo VolumeGradientCPUProcessor::getProcessorInfo() const {
     return processorInfo_;
@@ -28,6 +28,7 @@
  *********************************************************************************/
 
 #include <modules/base/processors/volumelaplacianprocessor.h>
+#include <inviwo/core/common/inviwoapplication.h>
 
 
 namespace inviwo {
@@ -55,7 +56,8 @@ VolumeLaplacianProcessor::VolumeLaplacianProcessor()
           0)
     , scale_("scale", "Scale", 0.0, 0.0, 1000.0, 0.0001, InvalidationLevel::InvalidOutput, PropertySemantics::Text)
     , inVolume_("inputVolume", "Input Volume")
-    , outVolume_ ("outputVolume", "Output Volume") {
+    , outVolume_ ("outputVolume", "Output Volume")
+    , job_(*this, &getActivityIndicator()) {
 
     addPort(inport_);
     addPort(outport_);
@@ -73,23 +75,15 @@ void VolumeLaplacianProcessor::process() {
     auto invol = inport_.getData();
     inVolume_.updateForNewVolume(*invol.get());
 
-    auto calc = [this](std::shared_ptr<const Volume> volume,
-                       util::VolumeLaplacianPostProcessing postProcessing,
-                       double scale) -> std::shared_ptr<Volume> {
-
-        auto res = util::volumeLaplacian(volume, postProcessing, scale);
-        dispatchFront([this]() { invalidate(InvalidationLevel::InvalidOutput); });
-        return res;
-    };
-
-    if (!result_.valid()) {
-        getActivityIndicator().setActive(true);
-        result_ = dispatchPool(calc, invol, postProcessing_.get(), scale_.get());
-    } else if (util::is_future_ready(result_)) {
-        auto outvol = result_.get();
+    if (inport_.isChanged() || postProcessing_.isModified() || scale_.isModified()) {
+        job_.submit([ invol, postProcessing = postProcessing_.get(), scale = scale_.get() ](
+            const StopToken&, const std::function<void(float)>&) {
+            return util::volumeLaplacian(invol, postProcessing, scale);
+        });
+    } else if (job_.hasResult()) {
+        auto outvol = job_.takeResult();
         outport_.setData(outvol);
         outVolume_.updateForNewVolume(*outvol.get());
-        getActivityIndicator().setActive(false);
     }
 }
 
@@ -39,8 +39,7 @@
 #include <modules/base/algorithm/volume/volumelaplacian.h>
 #include <modules/base/properties/volumeinformationproperty.h>
 #include <inviwo/core/processors/activityindicator.h>
-
-#include <future>
+#include <inviwo/core/processors/backgroundjob.h>
 
 namespace inviwo {
 
@@ -80,7 +79,7 @@ private:
     VolumeInformationProperty inVolume_;
     VolumeInformationProperty outVolume_;
 
-    std::future<std::shared_ptr<Volume>> result_;
+    BackgroundJob<std::shared_ptr<Volume>> job_;
 };
 
 } // namespace
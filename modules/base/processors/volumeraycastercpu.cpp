@@ -0,0 +1,102 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *********************************************************************************/
+
+
+#include <modules/base/processors/volumeraycastercpu.h>
+#include <inviwo/core/datastructures/image/image.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+
+namespace inviwo {
+
+const ProcessorInfo VolumeRaycasterCPU::processorInfo_{
+    "org.inviwo.VolumeRaycasterCPU",  // Class identifier
+    "Volume Raycaster CPU",           // Display name
+    "Volume Rendering",               // Category
+    CodeState::Experimental,          // Code state
+    "CPU, DVR, Raycasting"            // Tags
+};
+const ProcessorInfo VolumeRaycasterCPU::getProcessorInfo() const { return processorInfo_; }
+
+VolumeRaycasterCPU::VolumeRaycasterCPU()
+    : Processor()
+    , volumePort_("volume")
+    , outport_("outport")
+    , channel_("channel", "Render Channel")
+    , transferFunction_("transferFunction", "Transfer Function", &volumePort_)
+    , samplingRate_("samplingRate", "Sampling Rate", 2.0f, 1.0f, 20.0f)
+    , camera_("camera", "Camera", vec3(0.0f, 0.0f, -2.0f), vec3(0.0f, 0.0f, 0.0f),
+              vec3(0.0f, 1.0f, 0.0f), &volumePort_)
+    , lighting_("lighting", "Lighting", &camera_, InvalidationLevel::InvalidOutput)
+    , trackball_(&camera_) {
+
+    addPort(volumePort_);
+    addPort(outport_);
+
+    channel_.addOption("Channel 1", "Channel 1", 0);
+    channel_.setSerializationMode(PropertySerializationMode::All);
+    channel_.setCurrentStateAsDefault();
+
+    volumePort_.onChange([this]() {
+        if (volumePort_.hasData()) {
+            size_t channels = volumePort_.getData()->getDataFormat()->getComponents();
+
+            if (channels == channel_.size()) return;
+
+            std::vector<OptionPropertyIntOption> channelOptions;
+            for (size_t i = 0; i < channels; i++) {
+                channelOptions.emplace_back("Channel " + toString(i + 1),
+                                            "Channel " + toString(i + 1), static_cast<int>(i));
+            }
+            channel_.replaceOptions(channelOptions);
+            channel_.setCurrentStateAsDefault();
+        }
+    });
+
+    addProperty(channel_);
+    addProperty(transferFunction_);
+    addProperty(samplingRate_);
+    addProperty(camera_);
+    addProperty(lighting_);
+    addProperty(trackball_);
+}
+
+void VolumeRaycasterCPU::process() {
+    // The macro cells are built once per volume and channel
+    if (!raycaster_ || volumePort_.isChanged() || channel_.isModified()) {
+        raycaster_ = util::make_unique<CPURaycaster>(*volumePort_.getData(),
+                                                     static_cast<size_t>(channel_.get()));
+    }
+
+    outport_.setData(raycaster_->render(outport_.getDimensions(),
+                                        camera_.projectionMatrix() * camera_.viewMatrix(),
+                                        transferFunction_.get(), CPURaycastingLight(lighting_),
+                                        samplingRate_.get()));
+}
+
+}  // namespace inviwo
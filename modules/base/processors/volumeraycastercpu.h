@@ -0,0 +1,96 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *********************************************************************************/
+
+
+#ifndef IVW_VOLUMERAYCASTERCPU_H
+#define IVW_VOLUMERAYCASTERCPU_H
+
+#include <modules/base/basemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/ports/imageport.h>
+#include <inviwo/core/ports/volumeport.h>
+#include <inviwo/core/properties/optionproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/properties/transferfunctionproperty.h>
+#include <inviwo/core/properties/cameraproperty.h>
+#include <inviwo/core/properties/simplelightingproperty.h>
+#include <inviwo/core/interaction/cameratrackball.h>
+#include <modules/base/algorithm/volume/cpuraycaster.h>
+
+namespace inviwo {
+
+/** \docpage{org.inviwo.VolumeRaycasterCPU, Volume Raycaster CPU}
+ * ![](org.inviwo.VolumeRaycasterCPU.png?classIdentifier=org.inviwo.VolumeRaycasterCPU)
+ * Direct volume rendering on the CPU, for use without OpenGL, for example on headless nodes in
+ * batch runs. The result is comparable to the DVR mode of the Volume Raycaster. Tiles of the
+ * image are rendered in parallel, empty regions of the volume are skipped and rays are
+ * terminated once they are opaque.
+ *
+ * ### Inports
+ *   * __volume__ input volume
+ *
+ * ### Outports
+ *   * __outport__ output image in RAM containing the volume rendering
+ *
+ * ### Properties
+ *   * __Render Channel__    selects which channel of the input volume is rendered
+ *   * __Transfer Function__ maps the channel values, normalized by the data range, to color
+ *                           and opacity
+ *   * __Sampling Rate__     number of samples per voxel along the rays
+ *   * __Camera__            camera of the rendering
+ *   * __Lighting__          lighting properties
+ */
+class IVW_MODULE_BASE_API VolumeRaycasterCPU : public Processor {
+public:
+    VolumeRaycasterCPU();
+    virtual ~VolumeRaycasterCPU() = default;
+
+    virtual void process() override;
+
+    virtual const ProcessorInfo getProcessorInfo() const override;
+    static const ProcessorInfo processorInfo_;
+
+private:
+    VolumeInport volumePort_;
+    ImageOutport outport_;
+
+    OptionPropertyInt channel_;
+    TransferFunctionProperty transferFunction_;
+    FloatProperty samplingRate_;
+    CameraProperty camera_;
+    SimpleLightingProperty lighting_;
+    CameraTrackball trackball_;
+
+    std::unique_ptr<CPURaycaster> raycaster_;
+};
+
+}  // namespace inviwo
+
+#endif  // IVW_VOLUMERAYCASTERCPU_H
@@ -34,6 +34,7 @@
 
 #include <inviwo/core/datastructures/volume/volume.h>
 #include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/datastructures/volume/volumebricked.h>
 #include <inviwo/core/datastructures/image/imageram.h>
 #include <inviwo/core/datastructures/image/layerramprecision.h>
 
@@ -135,12 +136,29 @@ void VolumeSlice::process() {
             break;
     }
 
+    const auto axis = static_cast<CartesianCoordinateAxis>(sliceAlongAxis_.get());
+    auto slice = static_cast<size_t>(sliceNumber_.get() - 1);
+
+    // For volumes that do not fit in the memory budget only load the bricks intersecting the
+    // slice, as a one voxel thick slab
+    std::shared_ptr<const VolumeRAM> slab;
+    const VolumeRAM* volumeRAM = nullptr;
+    if (auto bricked = util::getBrickedRepresentationOverBudget(*vol)) {
+        const auto axisIndex = static_cast<size_t>(axis);
+        size3_t offset{0};
+        size3_t size{dims};
+        offset[axisIndex] = glm::clamp(slice, size_t{0}, dims[axisIndex] - 1);
+        size[axisIndex] = 1;
+        slab = bricked->getRegion(offset, size);
+        volumeRAM = slab.get();
+        slice = 0;
+    } else {
+        volumeRAM = vol->getRepresentation<VolumeRAM>();
+    }
+
     auto image =
-        vol->getRepresentation<VolumeRAM>()
-            ->dispatch<std::shared_ptr<Image>, dispatching::filter::All>([
-                axis = static_cast<CartesianCoordinateAxis>(sliceAlongAxis_.get()),
-                slice = static_cast<size_t>(sliceNumber_.get() - 1), &cache = imageCache_
-            ](const auto vrprecision) {
+        volumeRAM->dispatch<std::shared_ptr<Image>, dispatching::filter::All>(
+            [axis, slice, &cache = imageCache_](const auto vrprecision) {
                 using T = util::PrecsionValueType<decltype(vrprecision)>;
 
                 const T* voldata = vrprecision->getDataTyped();
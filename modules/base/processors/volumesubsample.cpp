@@ -52,15 +52,13 @@ VolumeSubsample::VolumeSubsample()
     , enabled_("enabled", "Enable Operation", true)
     , waitForCompletion_("waitForCompletion", "Wait For Subsample Completion", false)
     , subSampleFactors_("subSampleFactors", "Factors", ivec3(1), ivec3(1), ivec3(8))
-    , dirty_(false) {
+    , job_(*this, &getActivityIndicator()) {
     addPort(inport_);
     addPort(outport_);
     addProperty(enabled_);
     addProperty(waitForCompletion_);
 
     addProperty(subSampleFactors_);
-
-    waitForCompletion_.onChange([this]() { dirty_ = waitForCompletion_.get(); });
 }
 
 void VolumeSubsample::process() {
@@ -70,28 +68,19 @@ void VolumeSubsample::process() {
 
     if (enabled_.get() && factors != size3_t(1, 1, 1)) {
         if (waitForCompletion_.get()) {
+            job_.cancel();
             outport_.setData(subsample(inport_.getData(), factors));
+        } else if (job_.hasResult() && !inport_.isChanged() &&
+                   !subSampleFactors_.isModified()) {
+            outport_.setData(job_.takeResult());
         } else {
-            if (!result_.valid()) {
-                getActivityIndicator().setActive(true);
-                result_ = dispatchPool(
-                    [this](std::shared_ptr<const Volume> volume,
-                           size3_t f) -> std::shared_ptr<Volume> {
-                        auto sample = subsample(volume, f);
-                        dispatchFront([this]() {
-                            dirty_ = true;
-                            invalidate(InvalidationLevel::InvalidOutput);
-                        });
-                        return sample;
-                    },
-                    inport_.getData(), factors);
-            } else if (util::is_future_ready(result_)) {
-                outport_.setData(result_.get());
-                getActivityIndicator().setActive(false);
-                dirty_ = false;
-            }
+            job_.submit([ this, volume = inport_.getData(), factors ](
+                const StopToken&, const std::function<void(float)>&) {
+                return subsample(volume, factors);
+            });
         }
     } else {
+        job_.cancel();
         outport_.setData(inport_.getData());
     }
 }
@@ -111,7 +100,7 @@ void VolumeSubsample::invalidate(InvalidationLevel invalidationLevel, Property*
     notifyObserversInvalidationBegin(this);
     PropertyOwner::invalidate(invalidationLevel, modifiedProperty);
 
-    if (dirty_ || inport_.isChanged() || !enabled_.get()) {
+    if (job_.hasResult() || waitForCompletion_.get() || inport_.isChanged() || !enabled_.get()) {
         outport_.invalidate(InvalidationLevel::InvalidOutput);
     }
 
@@ -38,8 +38,7 @@
 #include <inviwo/core/properties/ordinalproperty.h>
 #include <modules/base/algorithm/volume/volumeramsubsample.h>
 #include <inviwo/core/processors/activityindicator.h>
-
-#include <future>
+#include <inviwo/core/processors/backgroundjob.h>
 
 namespace inviwo {
 
@@ -83,8 +82,7 @@ private:
     BoolProperty waitForCompletion_;
     IntVec3Property subSampleFactors_;
 
-    std::future<std::shared_ptr<Volume>> result_;
-    bool dirty_;
+    BackgroundJob<std::shared_ptr<Volume>> job_;
 };
 }
 
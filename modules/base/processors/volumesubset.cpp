@@ -30,6 +30,7 @@
 #include "volumesubset.h"
 #include <modules/base/algorithm/volume/volumeramsubset.h>
 #include <inviwo/core/network/networklock.h>
+#include <inviwo/core/datastructures/volume/volumebricked.h>
 #include <glm/gtx/vector_angle.hpp>
 
 namespace inviwo {
@@ -90,7 +91,11 @@ VolumeSubset::~VolumeSubset() {}
 
 void VolumeSubset::process() {
     if (enabled_.get()) {
-        const VolumeRAM* vol = inport_.getData()->getRepresentation<VolumeRAM>();
+        // Use the bricked representation of volumes that do not fit in the memory budget to
+        // avoid loading the whole volume
+        const VolumeRepresentation* vol =
+            util::getBrickedRepresentationOverBudget(*inport_.getData());
+        if (!vol) vol = inport_.getData()->getRepresentation<VolumeRAM>();
         size3_t dim = size3_t(static_cast<unsigned int>(rangeX_.get().y),
                           static_cast<unsigned int>(rangeY_.get().y),
                           static_cast<unsigned int>(rangeZ_.get().y));
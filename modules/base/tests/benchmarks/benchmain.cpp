@@ -32,6 +32,10 @@
 #endif
 
 #include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/util/logcentral.h>
+#include <inviwo/core/util/consolelogger.h>
+#include <inviwo/core/common/coremodulesharedlibrary.h>
 #include <modules/base/algorithm/volume/volumegeneration.h>
 
 #include <modules/base/algorithm/volume/marchingcubes.h>
@@ -127,12 +131,56 @@ static void MiniNew(benchmark::State& state) {
     state.counters["Voxels"] = state.range(0) * state.range(0) * state.range(0);
 }
 
+/**
+ * Runs marchingCubesOpt with the thread pool resized to state.range(1) threads, 0 threads extracts
+ * the whole volume on the calling thread.
+ */
+template <typename Generator>
+static void threadSweep(benchmark::State& state, Generator generator) {
+    auto v = std::shared_ptr<Volume>(generator(size3_t{static_cast<size_t>(state.range(0))}));
+
+    auto app = InviwoApplication::getPtr();
+    const auto poolSize = app->getPoolSize();
+    app->resizePool(static_cast<size_t>(state.range(1)));
+
+    for (auto _ : state) {
+        auto mesh = util::marchingCubesOpt(v, 0.5, {0.5f, 0.0f, 0.0f, 1.0f}, false, false);
+        state.counters["Vertices"] = static_cast<double>(mesh->getBuffer(0)->getSize());
+        state.counters["Indices"] =
+            static_cast<double>(mesh->getIndexBuffers().front().second->getSize());
+        benchmark::ClobberMemory();
+    }
+    state.counters["Voxels"] = state.range(0) * state.range(0) * state.range(0);
+    state.counters["Threads"] = static_cast<double>(state.range(1));
+
+    app->resizePool(poolSize);
+}
+
+static void SphereThreads(benchmark::State& state) {
+    threadSweep(state, [](const size3_t& dim) { return util::makeSphericalVolume(dim); });
+}
+
+static void RippleThreads(benchmark::State& state) {
+    threadSweep(state, [](const size3_t& dim) { return util::makeRippleVolume(dim); });
+}
+
+static void threadArgs(benchmark::internal::Benchmark* b) {
+    for (int size : {128, 256}) {
+        for (int threads : {0, 1, 2, 4, 8, 16}) {
+            b->Args({size, threads});
+        }
+    }
+}
+
 BENCHMARK(SphereOld)->RangeMultiplier(2)->Range(8, 8 << 5);
 BENCHMARK(SphereNew)->RangeMultiplier(2)->Range(8, 8 << 6);
 
 BENCHMARK(RippleOld)->RangeMultiplier(2)->Range(8, 8 << 4);
 BENCHMARK(RippleNew)->RangeMultiplier(2)->Range(8, 8 << 5);
 
+BENCHMARK(SphereThreads)->Apply(threadArgs)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(RippleThreads)->Apply(threadArgs)->UseRealTime()->Unit(benchmark::kMillisecond);
+
 // BENCHMARK(MiniOld)->RangeMultiplier(2)->Range(8, 8 << 5);
 // BENCHMARK(MiniNew)->RangeMultiplier(2)->Range(8, 8 << 5);
 
@@ -143,6 +191,20 @@ BENCHMARK(RippleNew)->RangeMultiplier(2)->Range(8, 8 << 5);
 
 int main(int argc, char** argv) {
 
+    LogCentral::init();
+    auto logger = std::make_shared<ConsoleLogger>();
+    LogCentral::getPtr()->setLogLevel(LogLevel::Error);
+    LogCentral::getPtr()->registerLogger(logger);
+    InviwoApplication app(argc, argv, "inviwo");
+
+    {
+        std::vector<std::unique_ptr<InviwoModuleFactoryObject>> modules;
+        modules.emplace_back(createCoreModule());
+        app.registerModules(std::move(modules));
+    }
+
+    app.processFront();
+
     benchmark::Initialize(&argc, argv);
     benchmark::RunSpecifiedBenchmarks();
 
@@ -0,0 +1,142 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2013-2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/common/inviwo.h>
+#include <modules/base/datastructures/kdtree.h>
+#include <modules/base/datastructures/flatkdtree.h>
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+using namespace inviwo;
+
+namespace {
+
+std::vector<vec3> randomPoints(size_t count, unsigned int seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    std::vector<vec3> points(count);
+    for (auto& p : points) p = vec3(dist(gen), dist(gen), dist(gen));
+    return points;
+}
+
+const size_t numQueries = 10000;
+const size_t numNeighbors = 10;
+
+}  // namespace
+
+static void KDTreeBuildOld(benchmark::State& state) {
+    const auto points = randomPoints(static_cast<size_t>(state.range(0)), 0);
+
+    for (auto _ : state) {
+        K3DTree<size_t, float> tree;
+        for (size_t i = 0; i < points.size(); ++i) tree.insert(points[i], i);
+        benchmark::DoNotOptimize(tree.getRoot());
+    }
+    state.counters["Points"] = static_cast<double>(points.size());
+}
+
+static void KDTreeBuildFlat(benchmark::State& state) {
+    const auto points = randomPoints(static_cast<size_t>(state.range(0)), 0);
+
+    for (auto _ : state) {
+        FlatKDTree<3, char, float> tree(points);
+        benchmark::DoNotOptimize(tree.getPositions().data());
+    }
+    state.counters["Points"] = static_cast<double>(points.size());
+}
+
+static void KDTreeNNearestOld(benchmark::State& state) {
+    const auto points = randomPoints(static_cast<size_t>(state.range(0)), 0);
+    const auto queries = randomPoints(numQueries, 1);
+    K3DTree<size_t, float> tree;
+    for (size_t i = 0; i < points.size(); ++i) tree.insert(points[i], i);
+
+    for (auto _ : state) {
+        for (const auto& q : queries) {
+            auto nodes = tree.findNNearest(q, static_cast<int>(numNeighbors));
+            benchmark::DoNotOptimize(nodes.data());
+        }
+    }
+    state.counters["Queries"] = static_cast<double>(queries.size());
+}
+
+static void KDTreeNNearestFlat(benchmark::State& state) {
+    const auto points = randomPoints(static_cast<size_t>(state.range(0)), 0);
+    const auto queries = randomPoints(numQueries, 1);
+    FlatKDTree<3, char, float> tree(points);
+    std::vector<size_t> indices(queries.size() * numNeighbors);
+
+    for (auto _ : state) {
+        tree.findNNearest(queries.data(), queries.size(), numNeighbors, indices.data());
+        benchmark::DoNotOptimize(indices.data());
+    }
+    state.counters["Queries"] = static_cast<double>(queries.size());
+}
+
+static void KDTreeCloseToOld(benchmark::State& state) {
+    const auto points = randomPoints(static_cast<size_t>(state.range(0)), 0);
+    const auto queries = randomPoints(numQueries, 1);
+    K3DTree<size_t, float> tree;
+    for (size_t i = 0; i < points.size(); ++i) tree.insert(points[i], i);
+    const float radius = 0.05f;
+
+    for (auto _ : state) {
+        for (const auto& q : queries) {
+            auto nodes = tree.findCloseTo(q, radius);
+            benchmark::DoNotOptimize(nodes.data());
+        }
+    }
+    state.counters["Queries"] = static_cast<double>(queries.size());
+}
+
+static void KDTreeCloseToFlat(benchmark::State& state) {
+    const auto points = randomPoints(static_cast<size_t>(state.range(0)), 0);
+    const auto queries = randomPoints(numQueries, 1);
+    FlatKDTree<3, char, float> tree(points);
+    const float radius = 0.05f;
+    std::vector<size_t> offsets;
+    std::vector<size_t> result;
+
+    for (auto _ : state) {
+        tree.findCloseTo(queries.data(), queries.size(), radius, offsets, result);
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.counters["Queries"] = static_cast<double>(queries.size());
+}
+
+BENCHMARK(KDTreeBuildOld)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK(KDTreeBuildFlat)->RangeMultiplier(10)->Range(1000, 10000000);
+
+BENCHMARK(KDTreeNNearestOld)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK(KDTreeNNearestFlat)->RangeMultiplier(10)->Range(1000, 1000000);
+
+BENCHMARK(KDTreeCloseToOld)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK(KDTreeCloseToFlat)->RangeMultiplier(10)->Range(1000, 1000000);
@@ -0,0 +1,140 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2013-2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/image/layerramprecision.h>
+#include <modules/base/algorithm/volume/volumegeneration.h>
+#include <modules/base/algorithm/volume/volumeramsubsample.h>
+#include <modules/base/algorithm/volume/volumeramdistancetransform.h>
+#include <modules/base/algorithm/volume/volumederivatives.h>
+#include <modules/base/algorithm/volume/volumegradient.h>
+#include <modules/base/algorithm/image/layerramdistancetransform.h>
+
+#include <benchmark/benchmark.h>
+
+using namespace inviwo;
+
+static void VolumeSubSample(benchmark::State& state) {
+    const auto size = static_cast<size_t>(state.range(0));
+    auto volume = util::makeSphericalVolume(size3_t{size});
+    const auto ram = volume->getRepresentation<VolumeRAM>();
+
+    for (auto _ : state) {
+        auto sub = util::volumeSubSample(ram, size3_t{2});
+        benchmark::DoNotOptimize(sub->getData());
+    }
+    state.counters["Voxels"] = static_cast<double>(size * size * size);
+}
+
+static void VolumeDistanceTransform(benchmark::State& state) {
+    const auto size = static_cast<size_t>(state.range(0));
+    auto volume = util::makeSphericalVolume(size3_t{size});
+    VolumeRAMPrecision<float> distances(size3_t{size});
+
+    for (auto _ : state) {
+        util::volumeDistanceTransform(volume.get(), &distances, size3_t{1}, 0.5, true, false,
+                                      false, 1.0);
+        benchmark::ClobberMemory();
+    }
+    state.counters["Voxels"] = static_cast<double>(size * size * size);
+}
+
+static void LayerDistanceTransform(benchmark::State& state) {
+    const auto size = static_cast<size_t>(state.range(0));
+    const size2_t dims{size};
+    LayerRAMPrecision<float> layer(dims);
+    auto data = layer.getDataTyped();
+    for (size_t y = 0; y < dims.y; ++y) {
+        for (size_t x = 0; x < dims.x; ++x) {
+            const auto p = vec2(x, y) / vec2(dims) - vec2(0.5f);
+            data[x + y * dims.x] = glm::length(p) < 0.25f ? 1.0f : 0.0f;
+        }
+    }
+    LayerRAMPrecision<float> distances(dims);
+
+    for (auto _ : state) {
+        util::layerRAMDistanceTransform(&layer, &distances, mat2(1.0f), size2_t{1});
+        benchmark::ClobberMemory();
+    }
+    state.counters["Pixels"] = static_cast<double>(size * size);
+}
+
+static void VolumeGradient(benchmark::State& state) {
+    const auto size = static_cast<size_t>(state.range(0));
+    std::shared_ptr<const Volume> volume = util::makeSphericalVolume(size3_t{size});
+
+    for (auto _ : state) {
+        auto gradient = util::gradientVolume(volume, 0);
+        benchmark::DoNotOptimize(gradient.get());
+    }
+    state.counters["Voxels"] = static_cast<double>(size * size * size);
+}
+
+// All derived fields of a vector field, in one pass or in one pass per field
+static void VolumeDerivatives(benchmark::State& state) {
+    const auto size = static_cast<size_t>(state.range(0));
+    const bool onePass = state.range(1) != 0;
+    const auto field = util::gradientVolume(util::makeRippleVolume(size3_t{size}), 0);
+
+    for (auto _ : state) {
+        if (onePass) {
+            util::VolumeDerivativeFields fields;
+            fields.gradient = fields.divergence = fields.curl = fields.laplacian = true;
+            auto res = util::volumeDerivatives(*field, fields);
+            benchmark::DoNotOptimize(res.curl.get());
+        } else {
+            for (int i = 0; i < 4; ++i) {
+                util::VolumeDerivativeFields fields;
+                fields.gradient = i == 0;
+                fields.divergence = i == 1;
+                fields.curl = i == 2;
+                fields.laplacian = i == 3;
+                auto res = util::volumeDerivatives(*field, fields);
+                benchmark::DoNotOptimize(res.gradient.get());
+            }
+        }
+    }
+    state.counters["Voxels"] = static_cast<double>(size * size * size);
+}
+
+BENCHMARK(VolumeSubSample)->RangeMultiplier(2)->Range(32, 256)->Unit(benchmark::kMillisecond);
+BENCHMARK(VolumeDistanceTransform)
+    ->RangeMultiplier(2)
+    ->Range(32, 128)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(LayerDistanceTransform)
+    ->RangeMultiplier(2)
+    ->Range(256, 2048)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(VolumeGradient)->RangeMultiplier(2)->Range(32, 256)->Unit(benchmark::kMillisecond);
+BENCHMARK(VolumeDerivatives)
+    ->Args({64, 0})
+    ->Args({64, 1})
+    ->Args({256, 0})
+    ->Args({256, 1})
+    ->Unit(benchmark::kMillisecond);
@@ -32,6 +32,9 @@
 #endif
 
 #include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/util/logcentral.h>
+#include <inviwo/core/common/coremodulesharedlibrary.h>
 
 #include <warn/push>
 #include <warn/ignore/all>
@@ -41,6 +44,16 @@
 using namespace inviwo;
 
 int main(int argc, char** argv) {
+    inviwo::LogCentral::init();
+
+    // Needed for the thread pool used by the parallel algorithms
+    InviwoApplication app(argc, argv, "inviwo");
+    {
+        std::vector<std::unique_ptr<InviwoModuleFactoryObject>> modules;
+        modules.emplace_back(createCoreModule());
+        app.registerModules(std::move(modules));
+    }
+
     int ret = -1;
     {
 
@@ -0,0 +1,199 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/image/image.h>
+#include <inviwo/core/datastructures/image/layerram.h>
+#include <inviwo/core/datastructures/transferfunction.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/indexmapper.h>
+#include <modules/base/algorithm/volume/cpuraycaster.h>
+
+namespace inviwo {
+
+namespace {
+
+// A volume covering [-0.5, 0.5]^3 in world space where each voxel holds func(x, y, z)
+template <typename T = float, typename Func>
+std::shared_ptr<Volume> unitVolume(const size3_t& dims, Func func) {
+    auto ram = std::make_shared<VolumeRAMPrecision<T>>(dims);
+    auto volume = std::make_shared<Volume>(ram);
+    volume->setBasis(mat3(1.0f));
+    volume->setOffset(vec3(-0.5f));
+    volume->setWorldMatrix(mat4(1.0f));
+    volume->dataMap_.dataRange = dvec2(0.0, 1.0);
+    volume->dataMap_.valueRange = dvec2(0.0, 1.0);
+
+    const util::IndexMapper3D im(dims);
+    auto data = ram->getDataTyped();
+    for (size_t z = 0; z < dims.z; ++z) {
+        for (size_t y = 0; y < dims.y; ++y) {
+            for (size_t x = 0; x < dims.x; ++x) {
+                data[im(x, y, z)] = static_cast<T>(func(x, y, z));
+            }
+        }
+    }
+    return volume;
+}
+
+const glm::u8vec4* imageData(const std::shared_ptr<Image>& image) {
+    return static_cast<const glm::u8vec4*>(
+        image->getColorLayer()->getRepresentation<LayerRAM>()->getData());
+}
+
+}  // namespace
+
+TEST(MacroCellGrid, Ranges) {
+    const size3_t dims{10, 7, 5};
+    const util::IndexMapper3D im(dims);
+    std::vector<float> values(glm::compMul(dims));
+    for (size_t i = 0; i < values.size(); ++i) values[i] = static_cast<float>((i * 37) % 101);
+
+    const MacroCellGrid grid(values, dims, 4);
+    EXPECT_EQ(size3_t(3, 2, 1), grid.getDimensions());
+
+    // Neighboring cells share the voxels on their common faces
+    for (size_t cz = 0; cz < 1; ++cz) {
+        for (size_t cy = 0; cy < 2; ++cy) {
+            for (size_t cx = 0; cx < 3; ++cx) {
+                vec2 expected{std::numeric_limits<float>::max(),
+                              std::numeric_limits<float>::lowest()};
+                for (size_t z = cz * 4; z <= std::min(cz * 4 + 4, dims.z - 1); ++z) {
+                    for (size_t y = cy * 4; y <= std::min(cy * 4 + 4, dims.y - 1); ++y) {
+                        for (size_t x = cx * 4; x <= std::min(cx * 4 + 4, dims.x - 1); ++x) {
+                            expected.x = std::min(expected.x, values[im(x, y, z)]);
+                            expected.y = std::max(expected.y, values[im(x, y, z)]);
+                        }
+                    }
+                }
+                EXPECT_EQ(expected, grid.getRange(size3_t(cx, cy, cz)));
+            }
+        }
+    }
+}
+
+TEST(MacroCellGrid, Classify) {
+    const size3_t dims{9, 2, 2};
+    std::vector<float> values(glm::compMul(dims), 0.0f);
+    // The upper cell along x holds values up to 1
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (i % dims.x == 8) values[i] = 1.0f;
+    }
+    const MacroCellGrid grid(values, dims, 4);
+    ASSERT_EQ(size3_t(2, 1, 1), grid.getDimensions());
+
+    const std::vector<vec4> lut{vec4(0.0f), vec4(0.0f), vec4(0.0f), vec4(1.0f)};
+    const auto visible = grid.classify(lut);
+    ASSERT_EQ(2u, visible.size());
+    EXPECT_FALSE(visible[0]);
+    EXPECT_TRUE(visible[1]);
+
+    const auto none = grid.classify(std::vector<vec4>(4, vec4(1.0f, 1.0f, 1.0f, 0.0f)));
+    EXPECT_FALSE(none[0]);
+    EXPECT_FALSE(none[1]);
+}
+
+TEST(CPURaycaster, OpaqueCube) {
+    auto volume = unitVolume(size3_t{8}, [](size_t, size_t, size_t) { return 1.0f; });
+    const CPURaycaster raycaster(*volume, 0);
+    const TransferFunction tf({{0.0, vec4(0.0f)}, {1.0, vec4(1.0f)}});
+
+    // With an identity projection the rays are orthogonal and cover [-1, 1]^2
+    const size2_t dims{8, 8};
+    const auto image = raycaster.render(dims, mat4(1.0f), tf, CPURaycastingLight(), 2.0f);
+    ASSERT_EQ(dims, image->getDimensions());
+    const auto data = imageData(image);
+    for (size_t y = 0; y < dims.y; ++y) {
+        for (size_t x = 0; x < dims.x; ++x) {
+            const bool inside = x >= 2 && x < 6 && y >= 2 && y < 6;
+            EXPECT_EQ(inside ? 255 : 0, data[y * dims.x + x].a) << "pixel " << x << ", " << y;
+        }
+    }
+}
+
+TEST(CPURaycaster, EmptySpace) {
+    // Only the voxels with x = 0 are nonzero, rays through the other cells see nothing
+    auto volume =
+        unitVolume(size3_t{17}, [](size_t x, size_t, size_t) { return x == 0 ? 1.0f : 0.0f; });
+    const CPURaycaster raycaster(*volume, 0);
+    const TransferFunction tf({{0.0, vec4(0.0f)}, {0.5, vec4(0.0f)}, {1.0, vec4(1.0f)}});
+
+    const size2_t dims{16, 16};
+    const auto image = raycaster.render(dims, mat4(1.0f), tf, CPURaycastingLight(), 1.0f);
+    const auto data = imageData(image);
+    for (size_t y = 0; y < dims.y; ++y) {
+        for (size_t x = 0; x < dims.x; ++x) {
+            EXPECT_EQ(0, data[y * dims.x + x].a) << "pixel " << x << ", " << y;
+        }
+    }
+
+    // Looking along x the nonzero face covers the whole volume
+    const mat4 alongX{vec4(0.0f, 0.0f, 1.0f, 0.0f), vec4(0.0f, 1.0f, 0.0f, 0.0f),
+                      vec4(1.0f, 0.0f, 0.0f, 0.0f), vec4(0.0f, 0.0f, 0.0f, 1.0f)};
+    const auto side = raycaster.render(dims, alongX, tf, CPURaycastingLight(), 1.0f);
+    const auto sideData = imageData(side);
+    EXPECT_GT(sideData[8 * dims.x + 8].a, 0);
+    EXPECT_EQ(0, sideData[0].a);
+}
+
+TEST(CPURaycaster, SamplesDataFormatDirectly) {
+    // The same normalized values stored as floats and as bytes with a data range of [0, 255]
+    const auto func = [](size_t x, size_t y, size_t z) {
+        return static_cast<float>((x * 7 + y * 13 + z * 29) % 256);
+    };
+    auto floats = unitVolume(size3_t{12}, [&](size_t x, size_t y, size_t z) {
+        return func(x, y, z) / 255.0f;
+    });
+    auto bytes = unitVolume<unsigned char>(size3_t{12}, func);
+    bytes->dataMap_.dataRange = dvec2(0.0, 255.0);
+
+    const TransferFunction tf({{0.0, vec4(0.0f)}, {1.0, vec4(1.0f, 0.5f, 0.25f, 0.2f)}});
+    CPURaycastingLight light;
+    light.shadingMode = ShadingMode::Phong;
+    light.position = vec3(2.0f);
+    light.ambientColor = vec3(0.2f);
+    light.specularColor = vec3(0.5f);
+    const mat4 viewProjection = glm::rotate(0.4f, vec3(0.3f, 1.0f, 0.2f));
+
+    const size2_t dims{16, 16};
+    const auto floatImage = CPURaycaster(*floats, 0).render(dims, viewProjection, tf, light, 2.0f);
+    const auto byteImage = CPURaycaster(*bytes, 0).render(dims, viewProjection, tf, light, 2.0f);
+    const auto expected = imageData(floatImage);
+    const auto result = imageData(byteImage);
+    for (size_t i = 0; i < glm::compMul(dims); ++i) {
+        for (int c = 0; c < 4; ++c) EXPECT_NEAR(expected[i][c], result[i][c], 1) << "pixel " << i;
+    }
+}
+
+}  // namespace inviwo
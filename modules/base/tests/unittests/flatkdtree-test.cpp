@@ -0,0 +1,200 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2014-2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/base/datastructures/flatkdtree.h>
+#include <inviwo/core/util/poolutils.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <tuple>
+
+namespace inviwo {
+
+namespace {
+
+std::vector<vec3> randomPoints(size_t count, unsigned int seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    std::vector<vec3> points(count);
+    for (auto& p : points) p = vec3(dist(gen), dist(gen), dist(gen));
+    return points;
+}
+
+}  // namespace
+
+TEST(FlatKDTreeTests, empty) {
+    FlatKDTree<3, int, float> tree;
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(0, tree.depth());
+    EXPECT_EQ(tree.npos, tree.findNearest(vec3(0.5f)));
+
+    std::vector<size_t> nodes;
+    tree.findCloseTo(vec3(0.5f), 1.0f, nodes);
+    EXPECT_TRUE(nodes.empty());
+}
+
+TEST(FlatKDTreeTests, build) {
+    const auto points = randomPoints(1000, 0);
+    std::vector<int> data(points.size());
+    std::iota(data.begin(), data.end(), 0);
+
+    FlatKDTree<3, int, float> tree(points, data);
+    EXPECT_EQ(points.size(), tree.size());
+    EXPECT_EQ(10, tree.depth());
+    for (size_t i = 0; i < tree.size(); ++i) {
+        EXPECT_EQ(points[tree.getData(i)], tree.getPosition(i)) << "node " << i;
+    }
+}
+
+TEST(FlatKDTreeTests, findNNearest) {
+    const auto points = randomPoints(1000, 1);
+    FlatKDTree<3, int, float> tree(points);
+    const auto queries = randomPoints(100, 2);
+
+    const size_t k = 10;
+    std::vector<size_t> indices(queries.size() * k);
+    std::vector<float> sqDists(queries.size() * k);
+    tree.findNNearest(queries.data(), queries.size(), k, indices.data(), sqDists.data());
+
+    for (size_t q = 0; q < queries.size(); ++q) {
+        std::vector<float> expected;
+        for (const auto& p : points) expected.push_back(glm::distance2(p, queries[q]));
+        std::sort(expected.begin(), expected.end());
+
+        for (size_t i = 0; i < k; ++i) {
+            EXPECT_EQ(expected[i], sqDists[q * k + i]) << "query " << q << ", neighbor " << i;
+            EXPECT_EQ(sqDists[q * k + i],
+                      glm::distance2(tree.getPosition(indices[q * k + i]), queries[q]));
+        }
+        EXPECT_EQ(expected[0], glm::distance2(tree.getPosition(tree.findNearest(queries[q])),
+                                              queries[q]));
+    }
+
+    // fewer points than requested
+    std::vector<size_t> all(points.size() + 5);
+    EXPECT_EQ(points.size(), tree.findNNearest(vec3(0.5f), all.size(), all.data()));
+    EXPECT_EQ(tree.npos, all.back());
+}
+
+TEST(FlatKDTreeTests, findCloseTo) {
+    const auto points = randomPoints(1000, 3);
+    FlatKDTree<3, int, float> tree(points);
+    const auto queries = randomPoints(100, 4);
+    const float radius = 0.15f;
+
+    std::vector<size_t> offsets;
+    std::vector<size_t> result;
+    tree.findCloseTo(queries.data(), queries.size(), radius, offsets, result);
+    ASSERT_EQ(queries.size() + 1, offsets.size());
+    ASSERT_EQ(result.size(), offsets.back());
+
+    for (size_t q = 0; q < queries.size(); ++q) {
+        size_t expected = 0;
+        for (const auto& p : points) {
+            if (glm::distance2(p, queries[q]) < radius * radius) ++expected;
+        }
+        EXPECT_EQ(expected, offsets[q + 1] - offsets[q]) << "query " << q;
+        for (size_t i = offsets[q]; i < offsets[q + 1]; ++i) {
+            EXPECT_LT(glm::distance2(tree.getPosition(result[i]), queries[q]), radius * radius);
+        }
+    }
+}
+
+TEST(FlatKDTreeTests, duplicates) {
+    std::vector<vec3> points(100, vec3(0.5f));
+    points.push_back(vec3(0.0f));
+    FlatKDTree<3, int, float> tree(points);
+
+    std::vector<size_t> nodes;
+    tree.findCloseTo(vec3(0.5f), 0.1f, nodes);
+    EXPECT_EQ(100, nodes.size());
+    EXPECT_EQ(vec3(0.0f), tree.getPosition(tree.findNearest(vec3(0.1f))));
+}
+
+TEST(FlatKDTreeTests, parallelMatchesSerial) {
+    // Large enough to partition the top levels in parallel, and for several ranges of queries
+    const auto points = randomPoints(1 << 17, 5);
+    std::vector<int> data(points.size());
+    std::iota(data.begin(), data.end(), 0);
+    const auto queries = randomPoints(4096, 6);
+    const size_t k = 4;
+    const float radius = 0.02f;
+
+    struct Result {
+        std::vector<vec3> positions;
+        std::vector<int> data;
+        std::vector<size_t> indices;
+        std::vector<float> sqDists;
+        std::vector<size_t> offsets;
+        std::vector<size_t> closeTo;
+    };
+    Result serial, parallel;
+    std::tie(serial, parallel) = util::serialAndParallel([&]() {
+        Result res;
+        FlatKDTree<3, int, float> tree(points, data);
+        res.positions = tree.getPositions();
+        for (size_t i = 0; i < tree.size(); ++i) res.data.push_back(tree.getData(i));
+        res.indices.resize(queries.size() * k);
+        res.sqDists.resize(queries.size() * k);
+        tree.findNNearest(queries.data(), queries.size(), k, res.indices.data(),
+                          res.sqDists.data());
+        tree.findCloseTo(queries.data(), queries.size(), radius, res.offsets, res.closeTo);
+        return res;
+    });
+
+    EXPECT_EQ(serial.positions, parallel.positions);
+    EXPECT_EQ(serial.data, parallel.data);
+    EXPECT_EQ(serial.indices, parallel.indices);
+    EXPECT_EQ(serial.sqDists, parallel.sqDists);
+    EXPECT_EQ(serial.offsets, parallel.offsets);
+    EXPECT_EQ(serial.closeTo, parallel.closeTo);
+
+    // Check some of the queries against brute force
+    for (size_t i = 0; i < parallel.positions.size(); ++i) {
+        ASSERT_EQ(points[parallel.data[i]], parallel.positions[i]) << "node " << i;
+    }
+    for (size_t q = 0; q < queries.size(); q += 256) {
+        float nearest = std::numeric_limits<float>::max();
+        size_t close = 0;
+        for (const auto& p : points) {
+            nearest = std::min(nearest, glm::distance2(p, queries[q]));
+            if (glm::distance2(p, queries[q]) < radius * radius) ++close;
+        }
+        EXPECT_EQ(nearest, parallel.sqDists[q * k]) << "query " << q;
+        EXPECT_EQ(close, parallel.offsets[q + 1] - parallel.offsets[q]) << "query " << q;
+    }
+}
+
+}  // namespace inviwo
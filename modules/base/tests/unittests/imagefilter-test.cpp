@@ -0,0 +1,175 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/image/layer.h>
+#include <inviwo/core/datastructures/image/layerramprecision.h>
+#include <modules/base/algorithm/image/imagefilter.h>
+
+namespace inviwo {
+
+namespace {
+
+template <typename Func>
+util::FilterImage makeImage(const size2_t& dims, Func func) {
+    util::FilterImage image(dims);
+    for (size_t y = 0; y < dims.y; ++y) {
+        for (size_t x = 0; x < dims.x; ++x) image(x, y) = func(x, y);
+    }
+    return image;
+}
+
+}  // namespace
+
+TEST(ImageFilter, LayerRoundTrip) {
+    const size2_t dims{5, 3};
+    auto ram = std::make_shared<LayerRAMPrecision<glm::u8vec2>>(dims);
+    auto data = ram->getDataTyped();
+    for (size_t i = 0; i < dims.x * dims.y; ++i) {
+        data[i] = glm::u8vec2(static_cast<glm::u8>(i * 17), static_cast<glm::u8>(255 - i));
+    }
+
+    const util::FilterImage image(*ram);
+    EXPECT_EQ(dims, image.dims);
+    EXPECT_FLOAT_EQ(17.0f / 255.0f, image(1, 0).r);
+    EXPECT_FLOAT_EQ(254.0f / 255.0f, image(1, 0).g);
+    EXPECT_FLOAT_EQ(0.0f, image(1, 0).b);
+    EXPECT_FLOAT_EQ(1.0f, image(1, 0).a);
+
+    auto layer = image.toLayer(DataVec2UInt8::get());
+    const auto res = static_cast<const glm::u8vec2*>(
+        layer->getRepresentation<LayerRAM>()->getData());
+    for (size_t i = 0; i < dims.x * dims.y; ++i) EXPECT_EQ(data[i], res[i]);
+}
+
+TEST(ImageFilter, ToLayerClamps) {
+    const auto image = makeImage(size2_t{2, 1}, [](size_t x, size_t) {
+        return x == 0 ? vec4(-0.5f) : vec4(1.5f);
+    });
+    auto layer = image.toLayer(DataUInt8::get());
+    const auto res = static_cast<const glm::u8*>(layer->getRepresentation<LayerRAM>()->getData());
+    EXPECT_EQ(0, res[0]);
+    EXPECT_EQ(255, res[1]);
+}
+
+TEST(ImageFilter, LowpassKeepsConstant) {
+    const auto image = makeImage(size2_t{9, 7}, [](size_t, size_t) { return vec4(0.25f); });
+    for (const auto& res : {util::lowpass(image, 3), util::lowpass(image, 4),
+                            util::gaussianLowpass(image, 1.5f)}) {
+        for (const auto& p : res.pixels) {
+            EXPECT_NEAR(0.25f, p.r, 1.0e-5f);
+            EXPECT_NEAR(0.25f, p.a, 1.0e-5f);
+        }
+    }
+}
+
+TEST(ImageFilter, EvenKernelInterpolates) {
+    // With two taps the samples fall halfway between pixels, as in the shader
+    const auto image = makeImage(size2_t{5, 1}, [](size_t x, size_t) {
+        return x == 2 ? vec4(1.0f, 1.0f, 1.0f, 1.0f) : vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    });
+    const auto res = util::convolveSeparable(image, {1.0f, 1.0f}, 2.0f);
+    EXPECT_FLOAT_EQ(0.0f, res(0, 0).r);
+    EXPECT_FLOAT_EQ(0.25f, res(1, 0).r);
+    EXPECT_FLOAT_EQ(0.5f, res(2, 0).r);
+    EXPECT_FLOAT_EQ(0.25f, res(3, 0).r);
+    EXPECT_FLOAT_EQ(0.0f, res(4, 0).r);
+    EXPECT_FLOAT_EQ(1.0f, res(2, 0).a);
+}
+
+TEST(ImageFilter, Highpass) {
+    const auto image = makeImage(size2_t{6, 6}, [](size_t x, size_t y) {
+        return x == 3 && y == 3 ? vec4(1.0f, 1.0f, 1.0f, 0.5f) : vec4(0.0f, 0.0f, 0.0f, 0.5f);
+    });
+    const auto res = util::highpass(image, 3, false);
+    EXPECT_FLOAT_EQ(1.0f, res(3, 3).r);
+    EXPECT_FLOAT_EQ(0.5f - 0.5f / 8.0f, res(2, 3).r);
+    EXPECT_FLOAT_EQ(0.5f, res(0, 0).r);
+    EXPECT_FLOAT_EQ(0.5f, res(3, 3).a);
+
+    const auto sharpened = util::highpass(image, 3, true);
+    EXPECT_FLOAT_EQ(2.0f, sharpened(3, 3).r);
+    EXPECT_FLOAT_EQ(-1.0f / 8.0f, sharpened(2, 3).r);
+}
+
+TEST(ImageFilter, Gradient) {
+    const size2_t dims{8, 4};
+    const auto image = makeImage(dims, [](size_t x, size_t y) {
+        return vec4(0.0f, 0.1f * x + 0.2f * y, 0.0f, 1.0f);
+    });
+    const auto res = util::gradient(image, 1, false);
+    EXPECT_NEAR(0.1f, res(3, 2).x, 1.0e-6f);
+    EXPECT_NEAR(0.2f, res(3, 2).y, 1.0e-6f);
+    EXPECT_FLOAT_EQ(0.0f, res(3, 2).z);
+    EXPECT_FLOAT_EQ(1.0f, res(3, 2).w);
+    // one sided at the border
+    EXPECT_NEAR(0.05f, res(0, 2).x, 1.0e-6f);
+
+    const auto renormalized = util::gradient(image, 1, true);
+    EXPECT_NEAR(0.1f * dims.x, renormalized(3, 2).x, 1.0e-5f);
+}
+
+TEST(ImageFilter, Resample) {
+    const auto image = makeImage(size2_t{4, 2}, [](size_t x, size_t) {
+        return vec4(static_cast<float>(x) / 3.0f, 0.0f, 0.0f, 1.0f);
+    });
+
+    const auto same = util::resample(image, image.dims, util::ImageInterpolation::Bilinear);
+    for (size_t i = 0; i < image.pixels.size(); ++i) {
+        EXPECT_FLOAT_EQ(image.pixels[i].r, same.pixels[i].r);
+    }
+
+    const auto half = util::resample(image, size2_t{2, 1}, util::ImageInterpolation::Bilinear);
+    EXPECT_FLOAT_EQ(0.5f / 3.0f, half(0, 0).r);
+    EXPECT_FLOAT_EQ(2.5f / 3.0f, half(1, 0).r);
+
+    // B-spline weights sum to one, constant images stay constant
+    const auto constant = makeImage(size2_t{3, 3}, [](size_t, size_t) { return vec4(0.75f); });
+    const auto bicubic = util::resample(constant, size2_t{7, 5}, util::ImageInterpolation::Bicubic);
+    for (const auto& p : bicubic.pixels) EXPECT_NEAR(0.75f, p.g, 1.0e-5f);
+}
+
+TEST(ImageFilter, TransformPixels) {
+    const auto image = makeImage(size2_t{3, 2}, [](size_t x, size_t y) {
+        return vec4(0.1f * x, 0.2f * y, 0.3f, 0.4f);
+    });
+    const auto res =
+        util::transformPixels(image, [](const vec4& p) { return vec4(1.0f - vec3(p), p.a); });
+    EXPECT_FLOAT_EQ(0.8f, res(2, 1).r);
+    EXPECT_FLOAT_EQ(0.8f, res(2, 1).g);
+    EXPECT_FLOAT_EQ(0.7f, res(2, 1).b);
+    EXPECT_FLOAT_EQ(0.4f, res(2, 1).a);
+}
+
+}  // namespace inviwo
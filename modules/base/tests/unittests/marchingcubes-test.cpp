@@ -33,7 +33,10 @@
 #include <warn/pop>
 
 #include <cmath>
+#include <map>
+#include <tuple>
 #include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/util/poolutils.h>
 #include <modules/base/algorithm/volume/volumegeneration.h>
 
 #include <modules/base/algorithm/volume/marchingcubes.h>
@@ -339,4 +342,60 @@ TEST(Marchingcubes, sphere) {
     */
 }
 
-}  // namespace inviwo
\ No newline at end of file
+TEST(Marchingcubes, slabsMatchSingleSlab) {
+    const size3_t dims{20, 20, 40};
+    auto vol =
+        std::shared_ptr<Volume>(util::generateVolume(dims, mat3(1.0f), [&](const size3_t& ind) {
+            const vec3 p = vec3(ind) / vec3(dims - size3_t(1)) - vec3(0.5f);
+            return glm::length(p * vec3(1.0f, 1.3f, 0.7f)) + 0.05f * std::sin(20.0f * p.z);
+        }));
+
+    // Without workers the volume is extracted as a single slab, with workers in 4 slabs since
+    // there are 39 cells along z and each slab is at least 8 cells thick.
+    std::shared_ptr<Mesh> single, slabs;
+    std::tie(single, slabs) = util::serialAndParallel([&]() {
+        return util::marchingCubesOpt(vol, 0.35, vec4(1.0f), false, false, nullptr,
+                                      [](const size3_t&) { return true; });
+    });
+
+    const auto& pos1 = getBufferData<vec3>(*single, 0);
+    const auto& pos2 = getBufferData<vec3>(*slabs, 0);
+    const auto& ind1 = getBufferIndexData(*single, 0);
+    const auto& ind2 = getBufferIndexData(*slabs, 0);
+    ASSERT_FALSE(pos1.empty());
+    // Vertices shared between slabs are welded
+    ASSERT_EQ(pos1.size(), pos2.size());
+    ASSERT_EQ(ind1.size(), ind2.size());
+
+    auto order = [](const vec3& a, const vec3& b) {
+        return std::lexicographical_compare(glm::value_ptr(a), glm::value_ptr(a) + 3,
+                                            glm::value_ptr(b), glm::value_ptr(b) + 3);
+    };
+    auto triangles = [&](const std::vector<vec3>& pos, const std::vector<uint32_t>& ind) {
+        std::vector<std::array<vec3, 3>> tris;
+        for (size_t i = 0; i + 2 < ind.size(); i += 3) {
+            tris.push_back({{pos[ind[i]], pos[ind[i + 1]], pos[ind[i + 2]]}});
+        }
+        std::sort(tris.begin(), tris.end(), [&](const auto& a, const auto& b) {
+            return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end(), order);
+        });
+        return tris;
+    };
+    // The positions are compared exactly. A vertex is interpolated from the same two voxels, and
+    // the z position of a slice is computed from its index rather than accumulated over the slab,
+    // hence the arithmetic is the same no matter which slab the cell belongs to.
+    EXPECT_EQ(triangles(pos1, ind1), triangles(pos2, ind2));
+
+    // The normals of welded vertices are accumulated from both slabs
+    const auto& normals1 = getBufferData<vec3>(*single, 3);
+    const auto& normals2 = getBufferData<vec3>(*slabs, 3);
+    std::map<vec3, vec3, decltype(order)> normals(order);
+    for (size_t i = 0; i < pos1.size(); ++i) normals[pos1[i]] = normals1[i];
+    for (size_t i = 0; i < pos2.size(); ++i) {
+        auto it = normals.find(pos2[i]);
+        ASSERT_NE(it, normals.end());
+        EXPECT_NEAR(glm::distance(it->second, normals2[i]), 0.0f, 1e-5f);
+    }
+}
+
+}  // namespace inviwo
@@ -0,0 +1,159 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
+#include <inviwo/core/util/poolutils.h>
+#include <modules/base/processors/meshclipping.h>
+
+#include <tuple>
+
+namespace inviwo {
+
+namespace {
+
+class MeshClippingTester : public MeshClipping {
+public:
+    using MeshClipping::clipGeometryAgainstPlane;
+};
+
+// A closed sphere as a triangle list, where neighboring triangles share their vertices
+std::shared_ptr<SimpleMesh> closedSphere(unsigned int loops, unsigned int segments,
+                                         DrawType dt = DrawType::Triangles) {
+    auto mesh = std::make_shared<SimpleMesh>(dt, ConnectivityType::None);
+    const auto addVertex = [&](const vec3& pos) {
+        return mesh->addVertex(pos, 0.5f * pos + vec3(0.5f), vec4(0.5f * pos + vec3(0.5f), 1.0f));
+    };
+    const auto north = addVertex(vec3(0.0f, 0.0f, 1.0f));
+    for (unsigned int i = 1; i < loops; ++i) {
+        for (unsigned int j = 0; j < segments; ++j) {
+            const float theta = static_cast<float>(M_PI) * i / loops;
+            const float phi = 2.0f * static_cast<float>(M_PI) * j / segments;
+            addVertex(vec3(std::cos(phi) * std::sin(theta), std::sin(phi) * std::sin(theta),
+                           std::cos(theta)));
+        }
+    }
+    const auto south = addVertex(vec3(0.0f, 0.0f, -1.0f));
+    const auto index = [&](unsigned int i, unsigned int j) {
+        return 1 + (i - 1) * segments + j % segments;
+    };
+    const auto addTriangle = [&](unsigned int a, unsigned int b, unsigned int c) {
+        mesh->addIndex(a);
+        mesh->addIndex(b);
+        mesh->addIndex(c);
+    };
+    for (unsigned int j = 0; j < segments; ++j) {
+        addTriangle(north, index(1, j), index(1, j + 1));
+        for (unsigned int i = 1; i + 1 < loops; ++i) {
+            addTriangle(index(i, j), index(i + 1, j), index(i + 1, j + 1));
+            addTriangle(index(i, j), index(i + 1, j + 1), index(i, j + 1));
+        }
+        addTriangle(index(loops - 1, j), south, index(loops - 1, j + 1));
+    }
+    return mesh;
+}
+
+template <typename T>
+const std::vector<T>& bufferData(const Mesh& mesh, size_t i) {
+    return static_cast<const Buffer<T>*>(mesh.getBuffer(i))
+        ->getRAMRepresentation()
+        ->getDataContainer();
+}
+
+}  // namespace
+
+TEST(MeshClipping, ChunksMatchSingleChunk) {
+    // 2 * 200 * 400 triangles, enough for several chunks
+    const auto mesh = closedSphere(200, 400);
+    const Plane plane(vec3(0.1f, 0.2f, 0.05f), glm::normalize(vec3(0.3f, -0.5f, 1.0f)));
+
+    std::shared_ptr<Mesh> single, chunks;
+    std::tie(single, chunks) = util::serialAndParallel([&]() {
+        MeshClippingTester clipping;
+        return clipping.clipGeometryAgainstPlane(mesh.get(), plane);
+    });
+
+    ASSERT_FALSE(bufferData<vec3>(*single, 0).empty());
+    EXPECT_EQ(bufferData<vec3>(*single, 0), bufferData<vec3>(*chunks, 0));
+    EXPECT_EQ(bufferData<vec3>(*single, 1), bufferData<vec3>(*chunks, 1));
+    EXPECT_EQ(bufferData<vec4>(*single, 2), bufferData<vec4>(*chunks, 2));
+}
+
+TEST(MeshClipping, PlaneThroughVertex) {
+    const auto mesh = closedSphere(20, 30);
+    const auto& vertices = bufferData<vec3>(*mesh, 0);
+    // A vertex with neighbors of both lower and higher index
+    const vec3 vertex = vertices[1 + 9 * 30 + 10];
+    const Plane plane(vertex, glm::normalize(vec3(0.3f, -0.5f, 1.0f)));
+
+    MeshClippingTester clipping;
+    std::shared_ptr<Mesh> clipped;
+    // The edges meeting at the vertex have to connect to a closed polygon
+    ASSERT_NO_THROW(clipped = clipping.clipGeometryAgainstPlane(mesh.get(), plane));
+    const auto& positions = bufferData<vec3>(*clipped, 0);
+    EXPECT_NE(positions.end(), std::find(positions.begin(), positions.end(), vertex));
+}
+
+TEST(MeshClipping, UnweldedMesh) {
+    // Every triangle has its own copies of its vertices, as in meshes read from STL files. The
+    // copies of a vertex have different indices in the triangles sharing an edge.
+    const auto welded = closedSphere(20, 30);
+    const auto& vertices = bufferData<vec3>(*welded, 0);
+    const auto& texCoords = bufferData<vec3>(*welded, 1);
+    const auto& colors = bufferData<vec4>(*welded, 2);
+    auto mesh = std::make_shared<SimpleMesh>(DrawType::Triangles, ConnectivityType::None);
+    for (auto i : welded->getIndexList()->getRAMRepresentation()->getDataContainer()) {
+        mesh->addIndex(mesh->addVertex(vertices[i], texCoords[i], colors[i]));
+    }
+    const Plane plane(vec3(0.1f, 0.2f, 0.05f), glm::normalize(vec3(0.3f, -0.5f, 1.0f)));
+
+    MeshClippingTester clipping;
+    std::shared_ptr<Mesh> clipped;
+    // The intersection points of the copies of an edge have to match to connect the polygon
+    ASSERT_NO_THROW(clipped = clipping.clipGeometryAgainstPlane(mesh.get(), plane));
+    MeshClippingTester weldedClipping;
+    const auto expected = weldedClipping.clipGeometryAgainstPlane(welded.get(), plane);
+    EXPECT_EQ(bufferData<vec3>(*expected, 0), bufferData<vec3>(*clipped, 0));
+}
+
+TEST(MeshClipping, OnlyTrianglesAreClipped) {
+    const auto mesh = closedSphere(20, 30, DrawType::Lines);
+    const Plane plane(vec3(0.0f), vec3(0.0f, 0.0f, 1.0f));
+
+    MeshClippingTester clipping;
+    const auto clipped = clipping.clipGeometryAgainstPlane(mesh.get(), plane);
+    EXPECT_TRUE(bufferData<vec3>(*clipped, 0).empty());
+}
+
+}  // namespace inviwo
@@ -0,0 +1,189 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/indexmapper.h>
+#include <inviwo/core/util/poolutils.h>
+#include <modules/base/algorithm/volume/volumederivatives.h>
+#include <modules/base/algorithm/volume/volumelaplacian.h>
+
+namespace inviwo {
+
+namespace {
+
+mat3 rotatedBasis() {
+    return mat3(glm::rotate(0.3f, vec3(0.2f, 1.0f, 0.5f))) *
+           mat3(glm::diagonal3x3(vec3(2.0f, 3.0f, 1.5f)));
+}
+
+// A volume with a rotated and scaled basis where each voxel holds func(world position)
+template <typename T, typename Func>
+std::shared_ptr<Volume> worldFunctionVolume(const size3_t& dims, Func func,
+                                            const mat3& basis = rotatedBasis()) {
+    auto ram = std::make_shared<VolumeRAMPrecision<T>>(dims);
+    auto volume = std::make_shared<Volume>(ram);
+    volume->setBasis(basis);
+    volume->setOffset(vec3(0.5f, -1.0f, 2.0f));
+
+    const auto m = volume->getCoordinateTransformer().getDataToWorldMatrix();
+    const util::IndexMapper3D im(dims);
+    auto data = ram->getDataTyped();
+    for (size_t z = 0; z < dims.z; ++z) {
+        for (size_t y = 0; y < dims.y; ++y) {
+            for (size_t x = 0; x < dims.x; ++x) {
+                const vec3 world{m * vec4(vec3(x, y, z) / vec3(dims - size3_t(1)), 1.0f)};
+                data[im(x, y, z)] = func(world);
+            }
+        }
+    }
+    return volume;
+}
+
+template <typename T>
+const T* volumeData(const std::unique_ptr<Volume>& volume) {
+    return static_cast<const T*>(volume->getRepresentation<VolumeRAM>()->getData());
+}
+
+}  // namespace
+
+TEST(VolumeDerivatives, LinearField) {
+    const size3_t dims{9, 7, 6};
+    // div F = 2, curl F = (5, -1, -2)
+    auto volume = worldFunctionVolume<vec3>(dims, [](const vec3& w) {
+        return vec3(2.0f * w.x + 3.0f * w.y - w.z, w.x - w.z, 4.0f * w.y);
+    });
+
+    util::VolumeDerivativeFields fields;
+    fields.gradient = true;
+    fields.divergence = true;
+    fields.curl = true;
+    const auto res = util::volumeDerivatives(*volume, fields);
+    ASSERT_TRUE(res.gradient);
+    ASSERT_TRUE(res.divergence);
+    ASSERT_TRUE(res.curl);
+    EXPECT_FALSE(res.laplacian);
+
+    const auto gradient = volumeData<vec3>(res.gradient);
+    const auto divergence = volumeData<float>(res.divergence);
+    const auto curl = volumeData<vec3>(res.curl);
+
+    // One sided differences at the boundaries are exact for a linear field as well
+    for (size_t i = 0; i < glm::compMul(dims); ++i) {
+        EXPECT_NEAR(2.0f, gradient[i].x, 1e-3f);
+        EXPECT_NEAR(3.0f, gradient[i].y, 1e-3f);
+        EXPECT_NEAR(-1.0f, gradient[i].z, 1e-3f);
+        EXPECT_NEAR(2.0f, divergence[i], 1e-3f);
+        EXPECT_NEAR(5.0f, curl[i].x, 1e-3f);
+        EXPECT_NEAR(-1.0f, curl[i].y, 1e-3f);
+        EXPECT_NEAR(-2.0f, curl[i].z, 1e-3f);
+    }
+}
+
+TEST(VolumeDerivatives, Laplacian) {
+    const size3_t dims{11, 8, 9};
+    auto volume = worldFunctionVolume<float>(dims, [](const vec3& w) { return glm::dot(w, w); });
+
+    const auto res = util::volumeLaplacian(volume, util::VolumeLaplacianPostProcessing::None, 1.0);
+    const auto data = static_cast<const float*>(res->getRepresentation<VolumeRAM>()->getData());
+
+    const util::IndexMapper3D im(dims);
+    for (size_t z = 1; z + 1 < dims.z; ++z) {
+        for (size_t y = 1; y + 1 < dims.y; ++y) {
+            for (size_t x = 1; x + 1 < dims.x; ++x) {
+                EXPECT_NEAR(6.0f, data[im(x, y, z)], 1e-2f);
+            }
+        }
+    }
+}
+
+TEST(VolumeDerivatives, LaplacianShearedBasis) {
+    const size3_t dims{11, 8, 9};
+    const mat3 basis{vec3(2.0f, 0.0f, 0.0f), vec3(1.2f, 3.0f, 0.0f), vec3(-0.5f, 0.8f, 1.5f)};
+    auto volume = worldFunctionVolume<float>(
+        dims, [](const vec3& w) { return glm::dot(w, w) + 3.0f * w.x * w.y - w.y * w.z; }, basis);
+
+    util::VolumeDerivativeFields fields;
+    fields.laplacian = true;
+    const auto res = util::volumeDerivatives(*volume, fields);
+    const auto data = volumeData<float>(res.laplacian);
+
+    // Central differences are exact for a quadratic field, the cross terms of the field do not
+    // contribute to the Laplacian, while those of the basis do
+    const util::IndexMapper3D im(dims);
+    for (size_t z = 1; z + 1 < dims.z; ++z) {
+        for (size_t y = 1; y + 1 < dims.y; ++y) {
+            for (size_t x = 1; x + 1 < dims.x; ++x) {
+                EXPECT_NEAR(6.0f, data[im(x, y, z)], 1e-2f);
+            }
+        }
+    }
+}
+
+TEST(VolumeDerivatives, SlabsMatchSingleSlab) {
+    const size3_t dims{7, 6, 37};
+    auto volume = worldFunctionVolume<glm::u8vec3>(dims, [](const vec3& w) {
+        return glm::u8vec3(vec3(100.0f) + 20.0f * glm::sin(w * vec3(1.0f, 2.0f, 0.7f)));
+    });
+    util::VolumeDerivativeFields fields;
+    fields.gradient = true;
+    fields.divergence = true;
+    fields.curl = true;
+    fields.laplacian = true;
+
+    // Without workers all slices are one slab, with workers there are 4 slabs of 9 or 10 slices
+    const auto res =
+        util::serialAndParallel([&]() { return util::volumeDerivatives(*volume, fields); });
+    const auto& single = res.first;
+    const auto& slabs = res.second;
+
+    const size_t size = glm::compMul(dims);
+    auto equal = [&](const auto* a, const auto* b, size_t comps) {
+        return std::equal(a, a + size * comps, b);
+    };
+    EXPECT_TRUE(equal(volumeData<vec3>(single.gradient), volumeData<vec3>(slabs.gradient), 1));
+    EXPECT_TRUE(
+        equal(volumeData<float>(single.divergence), volumeData<float>(slabs.divergence), 1));
+    EXPECT_TRUE(equal(volumeData<vec3>(single.curl), volumeData<vec3>(slabs.curl), 1));
+    EXPECT_TRUE(equal(volumeData<float>(single.laplacian), volumeData<float>(slabs.laplacian), 3));
+}
+
+TEST(VolumeDerivatives, CurlRequiresThreeComponents) {
+    auto volume = worldFunctionVolume<float>(size3_t{4}, [](const vec3& w) { return w.x; });
+    util::VolumeDerivativeFields fields;
+    fields.curl = true;
+    EXPECT_THROW(util::volumeDerivatives(*volume, fields), Exception);
+}
+
+}  // namespace inviwo
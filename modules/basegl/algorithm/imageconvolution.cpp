@@ -116,10 +116,15 @@ std::shared_ptr<Image> ImageConvolution::convolution_separable(
 std::shared_ptr<Image> ImageConvolution::convolution_internal(const Layer &layer, int kw, int kh,
                                                               const std::vector<float> &kernel,
                                                               const float &kernelScale) {
-    shader_.getFragmentShaderObject()->addShaderDefine("KERNELWIDTH", std::to_string(kw));
-    shader_.getFragmentShaderObject()->addShaderDefine("KERNELHEIGHT", std::to_string(kh));
-    shader_.getFragmentShaderObject()->addShaderDefine("KERNELSIZE", std::to_string(kw * kh));
-    shader_.build();
+    if (!shader_) {
+        shader_ = util::make_unique<Shader>("img_convolution.frag", false);
+        if (onReload_) shader_->onReload(onReload_);
+    }
+    auto &shader = *shader_;
+    shader.getFragmentShaderObject()->addShaderDefine("KERNELWIDTH", std::to_string(kw));
+    shader.getFragmentShaderObject()->addShaderDefine("KERNELHEIGHT", std::to_string(kh));
+    shader.getFragmentShaderObject()->addShaderDefine("KERNELSIZE", std::to_string(kw * kh));
+    shader.build();
 
     auto outImage = std::make_shared<Image>(std::make_shared<Layer>(
         layer.getDimensions(), layer.getDataFormat(),
@@ -129,17 +134,17 @@ std::shared_ptr<Image> ImageConvolution::convolution_internal(const Layer &layer
     TextureUnitContainer cont;
 
     utilgl::activateTarget(*outImage);
-    shader_.activate();
+    shader.activate();
 
-    utilgl::bindAndSetUniforms(shader_, cont, *layer.getRepresentation<LayerGL>()->getTexture(),
+    utilgl::bindAndSetUniforms(shader, cont, *layer.getRepresentation<LayerGL>()->getTexture(),
                                "tex");
 
-    shader_.setUniform("kernel", kw * kh, kernel.data());
-    shader_.setUniform("kernelScale", kernelScale);
-    shader_.setUniform("reciprocalDimensions", vec2(1) / vec2(layer.getDimensions()));
+    shader.setUniform("kernel", kw * kh, kernel.data());
+    shader.setUniform("kernelScale", kernelScale);
+    shader.setUniform("reciprocalDimensions", vec2(1) / vec2(layer.getDimensions()));
 
     utilgl::singleDrawImagePlaneRect();
-    shader_.deactivate();
+    shader.deactivate();
     utilgl::deactivateCurrentTarget();
 
     return outImage;
@@ -40,11 +40,12 @@ namespace inviwo {
 
 class IVW_MODULE_BASEGL_API ImageConvolution {
 public:
+    /**
+     * The shader is created on the first convolution, the callback is called when it is reloaded
+     */
     template <typename Callback>
-    ImageConvolution(Callback C) : ImageConvolution() {
-        shader_.onReload(C);
-    }
-    ImageConvolution() : shader_("img_convolution.frag", false) {}
+    ImageConvolution(Callback C) : onReload_(C) {}
+    ImageConvolution() = default;
     virtual ~ImageConvolution() {}
 
     std::shared_ptr<Image> convolution(const Layer &layer, std::function<float(vec2)> kernelWeight,
@@ -60,7 +61,8 @@ public:
     std::shared_ptr<Image> lowpass(const Layer &layer, int kernelSize);
 
 protected:
-    Shader shader_;
+    std::function<void()> onReload_;
+    std::unique_ptr<Shader> shader_;
 
     std::shared_ptr<Image> convolution_internal(const Layer &layer, int kw, int kh,
                                                 const std::vector<float> &kernel,
@@ -52,7 +52,7 @@ FindEdges::FindEdges()
 FindEdges::~FindEdges() = default;
 
 void FindEdges::preProcess(TextureUnitContainer &) {
-    shader_.setUniform("alpha_", alpha_.get());
+    getShader().setUniform("alpha_", alpha_.get());
 }
 
 }  // namespace
@@ -48,10 +48,19 @@ ImageBinary::ImageBinary()
     : ImageGLProcessor("img_binary.frag")
     , threshold_("threshold","Threshold", 0.5)  {
     addProperty(threshold_);
+    addProperty(backend_);
 }
 
 void ImageBinary::preProcess(TextureUnitContainer &) {
-    utilgl::setUniforms(shader_, threshold_);
+    utilgl::setUniforms(getShader(), threshold_);
+}
+
+util::FilterImage ImageBinary::processCPU(const util::FilterImage &input, const size2_t &) {
+    const float threshold = threshold_.get();
+    return util::transformPixels(input, [threshold](const vec4 &p) {
+        const float v = p.r >= threshold ? 1.0f : 0.0f;
+        return vec4(v, v, v, 1.0f);
+    });
 }
 
 } // namespace
@@ -51,6 +51,7 @@ namespace inviwo {
  * 
  * ### Properties
  *   * __Threshold__ Threshold used for the binarization of the input image
+ *   * __Backend__ Process the image with OpenGL or on the CPU
  */
 
 
@@ -68,6 +69,8 @@ public:
 
 protected:
     virtual void preProcess(TextureUnitContainer &cont) override;
+    virtual util::FilterImage processCPU(const util::FilterImage &input,
+                                         const size2_t &outputDims) override;
 
     FloatProperty threshold_;
 private:
@@ -48,12 +48,19 @@ ImageGamma::ImageGamma()
     , gamma_("gammaFactor", "Gamma Correction", 1.0f, 0.0f, 2.0f, 0.01f)
 {
     addProperty(gamma_);
+    addProperty(backend_);
 }
 
 ImageGamma::~ImageGamma() = default;
 
 void ImageGamma::preProcess(TextureUnitContainer &) {
-    shader_.setUniform("gamma_", gamma_.get());
+    getShader().setUniform("gamma_", gamma_.get());
+}
+
+util::FilterImage ImageGamma::processCPU(const util::FilterImage &input, const size2_t &) {
+    const vec3 gamma(gamma_.get());
+    return util::transformPixels(
+        input, [gamma](const vec4 &p) { return vec4(glm::pow(vec3(p), gamma), p.a); });
 }
 
 }  // namespace
@@ -53,6 +53,7 @@ namespace inviwo {
  *
  * ### Properties
  *   * __Gamma Correction__ Gamma factor.
+ *   * __Backend__ Process the image with OpenGL or on the CPU
  */
 
 /*! \class ImageGamma
@@ -72,6 +73,8 @@ public:
 
 protected:
     virtual void preProcess(TextureUnitContainer &cont) override;
+    virtual util::FilterImage processCPU(const util::FilterImage &input,
+                                         const size2_t &outputDims) override;
 
 private:
     FloatProperty gamma_;
@@ -33,6 +33,8 @@
 #include <modules/opengl/texture/textureutils.h>
 #include <modules/opengl/shader/shaderutils.h>
 #include <modules/opengl/buffer/framebufferobject.h>
+#include <inviwo/core/datastructures/image/layerram.h>
+#include <inviwo/core/util/exception.h>
 
 namespace inviwo {
 
@@ -44,11 +46,12 @@ ImageGLProcessor::ImageGLProcessor(std::shared_ptr<const ShaderResource> fragmen
     : Processor()
     , inport_("inputImage")
     , outport_("outputImage")
+    , backend_(util::createBackendProperty(InvalidationLevel::InvalidResources))
     , dataFormat_(nullptr)
     , swizzleMask_(swizzlemasks::rgba)
     , internalInvalid_(false)
-    , shader_({{ShaderType::Fragment, fragmentShader}},
-              buildShader ? Shader::Build::Yes : Shader::Build::No) {
+    , fragmentShader_(fragmentShader)
+    , buildShader_(buildShader) {
     addPort(inport_);
     addPort(outport_);
 
@@ -58,17 +61,36 @@ ImageGLProcessor::ImageGLProcessor(std::shared_ptr<const ShaderResource> fragmen
     });
     inport_.setOutportDeterminesSize(true);
     outport_.setHandleResizeEvents(false);
-    shader_.onReload([this]() { invalidate(InvalidationLevel::InvalidResources); });
 }
 
 ImageGLProcessor::~ImageGLProcessor() {}
 
 void ImageGLProcessor::initializeResources() {
-    shader_.build();
+    // the output image is replaced by the CPU backend and has to be recreated for OpenGL
     internalInvalid_ = true;
+    if (backend_.get() == ImageProcessingBackend::OpenGL) {
+        getShader().build();
+    }
 }
 
 void ImageGLProcessor::process() {
+    if (backend_.get() == ImageProcessingBackend::CPU) {
+        const auto input = inport_.getData();
+        const auto layer = input->getColorLayer();
+        const auto result = processCPU(util::FilterImage(*layer->getRepresentation<LayerRAM>()),
+                                       calcOutputDimensions());
+
+        auto img = std::make_shared<Image>(
+            dataFormat_ ? result.toLayer(dataFormat_, swizzleMask_)
+                        : result.toLayer(input->getDataFormat(), layer->getSwizzleMask()));
+        img->copyMetaDataFrom(*input);
+        outport_.setData(img);
+        internalInvalid_ = true;
+
+        postProcess();
+        return;
+    }
+
     if (internalInvalid_) {
         internalInvalid_ = false;
 
@@ -80,23 +102,24 @@ void ImageGLProcessor::process() {
         }
     }
 
+    auto &shader = getShader();
     utilgl::activateTargetAndCopySource(outport_, inport_, ImageType::ColorOnly);
-    shader_.activate();
+    shader.activate();
 
-    utilgl::setShaderUniforms(shader_, outport_, "outportParameters_");
+    utilgl::setShaderUniforms(shader, outport_, "outportParameters_");
 
     // bind input image
     TextureUnitContainer cont;
     TextureUnit imgUnit;
     utilgl::bindColorTexture(inport_, imgUnit);
-    shader_.setUniform("inport_", imgUnit);
+    shader.setUniform("inport_", imgUnit);
     cont.push_back(std::move(imgUnit));
 
     // trigger preprocessing
     preProcess(cont);
 
     utilgl::singleDrawImagePlaneRect();
-    shader_.deactivate();
+    shader.deactivate();
     utilgl::deactivateCurrentTarget();
 
     postProcess();
@@ -110,6 +133,21 @@ void ImageGLProcessor::postProcess() {}
 
 void ImageGLProcessor::afterInportChanged() {}
 
+util::FilterImage ImageGLProcessor::processCPU(const util::FilterImage &, const size2_t &) {
+    throw Exception("CPU backend not supported", IvwContext);
+}
+
+Shader &ImageGLProcessor::getShader() {
+    if (!shader_) {
+        shader_ = util::make_unique<Shader>(
+            std::vector<std::pair<ShaderType, std::shared_ptr<const ShaderResource>>>{
+                {ShaderType::Fragment, fragmentShader_}},
+            buildShader_ ? Shader::Build::Yes : Shader::Build::No);
+        shader_->onReload([this]() { invalidate(InvalidationLevel::InvalidResources); });
+    }
+    return *shader_;
+}
+
 void ImageGLProcessor::createCustomImage(const size2_t &dim, const DataFormatBase *dataFormat,
                                          const SwizzleMask &swizzleMask, ImageInport &inport,
                                          ImageOutport &outport) {
@@ -154,4 +192,14 @@ size2_t ImageGLProcessor::calcOutputDimensions() const {
     return dimensions;
 }
 
+TemplateOptionProperty<ImageProcessingBackend> util::createBackendProperty(
+    InvalidationLevel invalidationLevel) {
+    return {"backend",
+            "Backend",
+            {{"opengl", "OpenGL", ImageProcessingBackend::OpenGL},
+             {"cpu", "CPU", ImageProcessingBackend::CPU}},
+            0,
+            invalidationLevel};
+}
+
 }  // namespace inviwo
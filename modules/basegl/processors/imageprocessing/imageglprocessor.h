@@ -36,9 +36,12 @@
 #include <modules/opengl/shader/shader.h>
 #include <modules/opengl/texture/textureunit.h>
 #include <inviwo/core/ports/imageport.h>
+#include <inviwo/core/properties/optionproperty.h>
+#include <modules/base/algorithm/image/imagefilter.h>
 
 namespace inviwo {
 
+enum class ImageProcessingBackend { OpenGL, CPU };
 
 /*! \class ImageGLProcessor
  *
@@ -50,6 +53,11 @@ namespace inviwo {
  * post-processing of the image data set in the outport. Furthermore, it is possible to
  * be notified of changes in the input image by overwriting ImageGLProcessor::afterInportChanged().
  *
+ * Derived classes that also implement ImageGLProcessor::processCPU() can add the backend_
+ * property, the image is then processed on the CPU when the CPU backend is selected. This avoids
+ * the GPU round trip when the result is consumed on the CPU. The shader is only created once the
+ * OpenGL backend is used, so the CPU backend also works without an OpenGL context.
+ *
  * \see VolumeGLProcessor
  */
 class IVW_MODULE_BASEGL_API ImageGLProcessor : public Processor { 
@@ -84,6 +92,18 @@ protected:
      */
     virtual void afterInportChanged();
 
+    /*! \brief this function gets called instead of the shader pass if the CPU backend is selected
+     *
+     * overwrite this function in derived classes that add the backend_ property. The input
+     * contains the normalized values of the color layer of the inport, the returned image should
+     * have outputDims as dimensions and is converted to the format of the output image.
+     */
+    virtual util::FilterImage processCPU(const util::FilterImage &input, const size2_t &outputDims);
+
+    /*! \brief returns the shader, it is created on first use
+     */
+    Shader &getShader();
+
     static void createCustomImage(const size2_t &dim, const DataFormatBase *dataFormat,
                                   const SwizzleMask &swizzleMask, ImageInport &inport,
                                   ImageOutport &outport);
@@ -95,17 +115,32 @@ protected:
     ImageInport inport_;
     ImageOutport outport_;
 
+    // not added by default, only for derived classes implementing processCPU()
+    TemplateOptionProperty<ImageProcessingBackend> backend_;
+
     const DataFormatBase* dataFormat_;
     // if a custom data format is specified, i.e. dataFormat_ != nullptr, this swizzle mask is used
     SwizzleMask swizzleMask_; 
 
     bool internalInvalid_;
 
-    std::string fragmentShader_;
-
-    Shader shader_;
+private:
+    std::shared_ptr<const ShaderResource> fragmentShader_;
+    bool buildShader_;
+    std::unique_ptr<Shader> shader_;
 };
 
+namespace util {
+
+/**
+ * Creates the property selecting the ImageProcessingBackend for image processors that can also
+ * process on the CPU.
+ */
+IVW_MODULE_BASEGL_API TemplateOptionProperty<ImageProcessingBackend> createBackendProperty(
+    InvalidationLevel invalidationLevel = InvalidationLevel::InvalidOutput);
+
+}  // namespace util
+
 } // namespace
 
 #endif // IVW_IMAGEGLPROCESSOR_H
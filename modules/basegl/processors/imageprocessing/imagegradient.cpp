@@ -68,11 +68,17 @@ ImageGradient::ImageGradient()
 
     addProperty(channel_);
     addProperty(renormalization_);
+    addProperty(backend_);
 }
 
 void ImageGradient::preProcess(TextureUnitContainer &) {
-    shader_.setUniform("channel", channel_.getSelectedValue());
-    shader_.setUniform("renormalization_", renormalization_.get() ? 1 : 0);
+    getShader().setUniform("channel", channel_.getSelectedValue());
+    getShader().setUniform("renormalization_", renormalization_.get() ? 1 : 0);
+}
+
+util::FilterImage ImageGradient::processCPU(const util::FilterImage &input, const size2_t &) {
+    return util::gradient(input, static_cast<size_t>(channel_.getSelectedValue()),
+                          renormalization_.get());
 }
 
 } // namespace
@@ -53,6 +53,7 @@ namespace inviwo {
  * ### Properties
  *   * __Channel__ Selects the channel used for the gradient computation 
  *   * __Renormalization__ Re-normalize results by taking the grid spacing into account
+ *   * __Backend__ Process the image with OpenGL or on the CPU
  */
 
 
@@ -70,6 +71,8 @@ public:
 
 protected:
     virtual void preProcess(TextureUnitContainer &cont) override;
+    virtual util::FilterImage processCPU(const util::FilterImage &input,
+                                         const size2_t &outputDims) override;
 
 private:
     OptionPropertyInt channel_;
@@ -58,11 +58,12 @@ ImageGrayscale::ImageGrayscale()
     luminanceModel_.setCurrentStateAsDefault();
 
     addProperty(luminanceModel_);
+    addProperty(backend_);
 }
 
 ImageGrayscale::~ImageGrayscale() {}
 
-void ImageGrayscale::preProcess(TextureUnitContainer &) {
+vec3 ImageGrayscale::getLuminanceScale() const {
     vec3 lumScale(1.0f);
     switch (luminanceModel_.get()) {
     case LuminanceModels::PerceivedLum:
@@ -87,7 +88,18 @@ void ImageGrayscale::preProcess(TextureUnitContainer &) {
         break;
     }
 
-    shader_.setUniform("lumScale_", lumScale);
+    return lumScale;
+}
+
+void ImageGrayscale::preProcess(TextureUnitContainer &) {
+    getShader().setUniform("lumScale_", getLuminanceScale());
+}
+
+util::FilterImage ImageGrayscale::processCPU(const util::FilterImage &input, const size2_t &) {
+    const vec3 lumScale = getLuminanceScale();
+    return util::transformPixels(input, [lumScale](const vec4 &p) {
+        return vec4(vec3(glm::dot(lumScale, vec3(p))), p.a);
+    });
 }
 
 }  // namespace
@@ -75,6 +75,7 @@ namespace LuminanceModels {
  *   * __Luminance Model__ Model for converting the input to grayscale. Options are
  *                         perceived (default), relative, average, red only, green only, 
  *                         and blue only.
+ *   * __Backend__ Process the image with OpenGL or on the CPU
  */
 
 /*! \class ImageGrayscale
@@ -94,8 +95,12 @@ public:
 
 protected:
     virtual void preProcess(TextureUnitContainer &cont) override;
+    virtual util::FilterImage processCPU(const util::FilterImage &input,
+                                         const size2_t &outputDims) override;
 
 private:
+    vec3 getLuminanceScale() const;
+
     OptionPropertyInt luminanceModel_;
 };
 
@@ -50,11 +50,16 @@ ImageHighPass::ImageHighPass()
     , sharpen_("sharpen" , "Sharpen" , false){
     addProperty(kernelSize_);
     addProperty(sharpen_);
+    addProperty(backend_);
 }
 
 
 void ImageHighPass::preProcess(TextureUnitContainer &) {
-    utilgl::setUniforms(shader_, kernelSize_, sharpen_);
+    utilgl::setUniforms(getShader(), kernelSize_, sharpen_);
+}
+
+util::FilterImage ImageHighPass::processCPU(const util::FilterImage &input, const size2_t &) {
+    return util::highpass(input, kernelSize_.get(), sharpen_.get());
 }
 
 } // namespace
@@ -52,6 +52,7 @@ namespace inviwo {
  * ### Properties
  *   * __Kernel Size__ Size of the applied high pass filter
  *   * __Sharpen__ Toggles additional sharpening operation
+ *   * __Backend__ Process the image with OpenGL or on the CPU
  */
 
 
@@ -69,6 +70,8 @@ public:
 
 protected:
     virtual void preProcess(TextureUnitContainer &cont) override;
+    virtual util::FilterImage processCPU(const util::FilterImage &input,
+                                         const size2_t &outputDims) override;
     
 private:
     IntProperty kernelSize_;
@@ -41,9 +41,14 @@ const ProcessorInfo ImageInvert::getProcessorInfo() const {
     return processorInfo_;
 }
 
-ImageInvert::ImageInvert() : ImageGLProcessor("img_invert.frag") {}
+ImageInvert::ImageInvert() : ImageGLProcessor("img_invert.frag") { addProperty(backend_); }
 
 ImageInvert::~ImageInvert() {}
 
+util::FilterImage ImageInvert::processCPU(const util::FilterImage &input, const size2_t &) {
+    return util::transformPixels(input,
+                                 [](const vec4 &p) { return vec4(1.0f - vec3(p), p.a); });
+}
+
 }  // namespace
 
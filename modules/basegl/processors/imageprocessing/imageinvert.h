@@ -51,6 +51,9 @@ namespace inviwo {
  *
  * ### Outports
  *   * __ImageOutport__ The output image.
+ *
+ * ### Properties
+ *   * __Backend__ Process the image with OpenGL or on the CPU
  */
 
 /*! \class ImageInvert
@@ -67,6 +70,10 @@ public:
     virtual ~ImageInvert();
     virtual const ProcessorInfo getProcessorInfo() const override;
     static const ProcessorInfo processorInfo_;
+
+protected:
+    virtual util::FilterImage processCPU(const util::FilterImage &input,
+                                         const size2_t &outputDims) override;
 };
 
 } // namespace
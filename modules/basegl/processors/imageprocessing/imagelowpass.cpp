@@ -35,6 +35,7 @@
 #include <modules/opengl/shader/shaderutils.h>
 #include <modules/opengl/image/layergl.h>
 #include <modules/opengl/texture/texture2d.h>
+#include <inviwo/core/datastructures/image/layerram.h>
 
 namespace inviwo {
 // The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
@@ -54,6 +55,7 @@ ImageLowPass::ImageLowPass()
     , kernelSize_("kernelSize", "Kernel Size", 3, 1, 25, 1)
     , gaussian_("gaussian", "Use Gaussian weights", true)
     , sigma_("sigma", "Sigma", 1.f, 1.f, 100.f, 0.01f)
+    , backend_(util::createBackendProperty())
     , convolution_([&]() { this->invalidate(InvalidationLevel::InvalidOutput); }) {
 
     addPort(inport_);
@@ -62,6 +64,7 @@ ImageLowPass::ImageLowPass()
     addProperty(kernelSize_);
     addProperty(sigma_);
     addProperty(gaussian_);
+    addProperty(backend_);
     kernelSize_.setVisible(false);
     gaussian_.onChange([&]() {
         kernelSize_.setVisible(!gaussian_.get());
@@ -70,6 +73,19 @@ ImageLowPass::ImageLowPass()
 }
 
 void ImageLowPass::process() {
+    if (backend_.get() == ImageProcessingBackend::CPU) {
+        const auto image = inport_.getData();
+        const auto layer = image->getColorLayer();
+        const util::FilterImage input(*layer->getRepresentation<LayerRAM>());
+        const auto result = gaussian_ ? util::gaussianLowpass(input, sigma_.get())
+                                      : util::lowpass(input, kernelSize_.get());
+        auto img = std::make_shared<Image>(
+            result.toLayer(layer->getDataFormat(), layer->getSwizzleMask()));
+        img->copyMetaDataFrom(*image);
+        outport_.setData(img);
+        return;
+    }
+
     if (gaussian_) {
         outport_.setData(
             convolution_.gaussianLowpass(*inport_.getData()->getColorLayer(), sigma_.get()));
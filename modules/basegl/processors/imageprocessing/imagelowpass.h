@@ -55,6 +55,7 @@ namespace inviwo {
  *   * __Kernel Size__ Size of the kernel to use.
  *   * __Use Gaussian weights__ Whether to use Gaussian weights or constant weights.
  *   * __Sigma__ Controls the shape of the Gaussian bell curve. 
+ *   * __Backend__ Process the image with OpenGL or on the CPU
  */
 
 /**
@@ -79,6 +80,7 @@ private:
     IntProperty kernelSize_;
     BoolProperty gaussian_;
     FloatProperty sigma_;
+    TemplateOptionProperty<ImageProcessingBackend> backend_;
 
     ImageConvolution convolution_;
 };
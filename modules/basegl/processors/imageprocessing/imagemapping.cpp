@@ -50,6 +50,7 @@ ImageMapping::ImageMapping()
     : ImageGLProcessor("img_mapping.frag")
     , transferFunction_("transferFunction", "Transfer Function") {
     addProperty(transferFunction_);
+    addProperty(backend_);
 }
 
 ImageMapping::~ImageMapping() {}
@@ -60,7 +61,11 @@ void ImageMapping::preProcess(TextureUnitContainer &) {
     const LayerGL* transferFunctionGL = tfLayer->getRepresentation<LayerGL>();
 
     transferFunctionGL->bindTexture(transFuncUnit.getEnum());
-    shader_.setUniform("transferFunc_", transFuncUnit.getUnitNumber());
+    getShader().setUniform("transferFunc_", transFuncUnit.getUnitNumber());
+}
+
+util::FilterImage ImageMapping::processCPU(const util::FilterImage &input, const size2_t &) {
+    return util::mapValues(input, transferFunction_.get());
 }
 
 void ImageMapping::afterInportChanged() {
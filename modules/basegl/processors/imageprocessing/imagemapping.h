@@ -50,6 +50,7 @@ namespace inviwo {
  * ### Properties
  *   * __Transfer Function__ The transfer function used for mapping input to output values 
  *                           including the alpha channel.
+ *   * __Backend__ Process the image with OpenGL or on the CPU
  */
 
 /*! \class ImageMapping
@@ -66,6 +67,8 @@ public:
 protected:
     virtual void preProcess(TextureUnitContainer &cont) override;
     virtual void afterInportChanged() override;
+    virtual util::FilterImage processCPU(const util::FilterImage &input,
+                                         const size2_t &outputDims) override;
 
 private:
     TransferFunctionProperty transferFunction_;
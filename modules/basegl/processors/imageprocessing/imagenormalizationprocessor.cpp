@@ -89,17 +89,17 @@ void ImageNormalizationProcessor::preProcess(TextureUnitContainer &) {
         typeMin = df->getMin();
     }
 
-    shader_.setUniform("typeMax_", static_cast<float>(typeMax));
-    shader_.setUniform("typeMin_", static_cast<float>(typeMin));
+    getShader().setUniform("typeMax_", static_cast<float>(typeMax));
+    getShader().setUniform("typeMin_", static_cast<float>(typeMin));
 
     if (normalizeSeparately_.get()) {
-        shader_.setUniform("min_", static_cast<vec4>(dvec4(min, 0.0)));
-        shader_.setUniform("max_", static_cast<vec4>(dvec4(max, 1.0)));
+        getShader().setUniform("min_", static_cast<vec4>(dvec4(min, 0.0)));
+        getShader().setUniform("max_", static_cast<vec4>(dvec4(max, 1.0)));
     } else {
         double minV = std::min(std::min(min.x, min.y), min.z);
         double maxV = std::max(std::max(max.x, max.y), max.z);
-        shader_.setUniform("min_", vec4(minV, minV, minV, 0.0f));
-        shader_.setUniform("max_", vec4(maxV, maxV, maxV, 1.0f));
+        getShader().setUniform("min_", vec4(minV, minV, minV, 0.0f));
+        getShader().setUniform("max_", vec4(maxV, maxV, maxV, 1.0f));
     }
 }
 
@@ -45,7 +45,8 @@ const ProcessorInfo ImageResample::getProcessorInfo() const {
 
 ImageResample::ImageResample()
     : ImageGLProcessor("img_resample.frag")
-    , interpolationType_("interpolationType", "Interpolation Type")
+    , interpolationType_("interpolationType", "Interpolation Type",
+                         InvalidationLevel::InvalidResources)
     , outputSizeMode_("outputSizeMode", "Output Size Mode")
     , targetResolution_("targetResolution", "Target Resolution", ivec2(256, 256), ivec2(32, 32),
                   ivec2(4096, 4096), ivec2(1, 1)) {
@@ -53,7 +54,6 @@ ImageResample::ImageResample()
     interpolationType_.addOption("bilinear", "Bilinear", 0);
     interpolationType_.addOption("bicubic", "Bicubic", 1);
     interpolationType_.set(0);
-    interpolationType_.onChange([this]() { interpolationTypeChanged(); });
     interpolationType_.setCurrentStateAsDefault();
     addProperty(interpolationType_);
 
@@ -67,12 +67,16 @@ ImageResample::ImageResample()
 
     targetResolution_.onChange([this]() { dimensionChanged(); });
     addProperty(targetResolution_);
+    addProperty(backend_);
 }
 
 ImageResample::~ImageResample() = default;
 
 void ImageResample::initializeResources() {
-    interpolationTypeChanged();
+    // the shader is only needed by the OpenGL backend
+    if (backend_.get() == ImageProcessingBackend::OpenGL) {
+        interpolationTypeChanged();
+    }
     dimensionSourceChanged();
     ImageGLProcessor::initializeResources();
 }
@@ -80,12 +84,11 @@ void ImageResample::initializeResources() {
 void ImageResample::interpolationTypeChanged() {
     switch (interpolationType_.get()) {
         case 1:
-            shader_.getFragmentShaderObject()->addShaderDefine("BICUBIC_INTERPOLATION", "1");
+            getShader().getFragmentShaderObject()->addShaderDefine("BICUBIC_INTERPOLATION", "1");
             break;
         default:
-            shader_.getFragmentShaderObject()->removeShaderDefine("BICUBIC_INTERPOLATION");
+            getShader().getFragmentShaderObject()->removeShaderDefine("BICUBIC_INTERPOLATION");
     }
-    shader_.build();
 }
 
 void ImageResample::dimensionChanged() {
@@ -118,5 +121,12 @@ void ImageResample::dimensionSourceChanged() {
     }
 }
 
+util::FilterImage ImageResample::processCPU(const util::FilterImage &input,
+                                            const size2_t &outputDims) {
+    return util::resample(input, outputDims, interpolationType_.get() == 1
+                                                 ? util::ImageInterpolation::Bicubic
+                                                 : util::ImageInterpolation::Bilinear);
+}
+
 }  // namespace
 
@@ -53,6 +53,7 @@ namespace inviwo {
  *   * __Interpolation Type__ Determines the interpolation for resampling (bilinear or bicubic)
  *   * __Output Size Mode__ Determines the size of the resampled image (set by inport, resize events, or custom dimensions)
  *   * __Target Resolution__ Custom target resolution
+ *   * __Backend__ Process the image with OpenGL or on the CPU
  *
  */
 
@@ -75,6 +76,8 @@ protected:
     void interpolationTypeChanged();
     void dimensionChanged();
     void dimensionSourceChanged();
+    virtual util::FilterImage processCPU(const util::FilterImage &input,
+                                         const size2_t &outputDims) override;
 
 private:
     OptionPropertyInt interpolationType_;
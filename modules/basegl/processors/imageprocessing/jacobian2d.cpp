@@ -55,16 +55,16 @@ Jacobian2D::Jacobian2D()
 
 void Jacobian2D::initializeResources() {
     if (inverse_.get()) {
-        shader_.getFragmentShaderObject()->addShaderDefine("INVERT_JACOBIAN");
+        getShader().getFragmentShaderObject()->addShaderDefine("INVERT_JACOBIAN");
     }
     else {
-        shader_.getFragmentShaderObject()->removeShaderDefine("INVERT_JACOBIAN");
+        getShader().getFragmentShaderObject()->removeShaderDefine("INVERT_JACOBIAN");
     }
     ImageGLProcessor::initializeResources();
 }
     
 void Jacobian2D::preProcess(TextureUnitContainer &) {
-    shader_.setUniform("renormalization_", renormalization_.get() ? 1 : 0);
+    getShader().setUniform("renormalization_", renormalization_.get() ? 1 : 0);
 }
 
 } // namespace inviwo
@@ -64,20 +64,20 @@ bool BrushingAndLinkingManager::isFiltered(size_t idx) const { return filtered_.
 bool BrushingAndLinkingManager::isSelected(size_t idx) const { return selected_.has(idx); }
 
 void BrushingAndLinkingManager::setSelected(const BrushingAndLinkingInport* src,
-                                            const std::unordered_set<size_t>& indices) {
+                                            const BitSet& indices) {
     selected_.set(src, indices);
 }
 
 void BrushingAndLinkingManager::setFiltered(const BrushingAndLinkingInport* src,
-                                            const std::unordered_set<size_t>& indices) {
+                                            const BitSet& indices) {
     filtered_.set(src, indices);
 }
 
-const std::unordered_set<size_t>& BrushingAndLinkingManager::getSelectedIndices() const {
+const BitSet& BrushingAndLinkingManager::getSelectedIndices() const {
     return selected_.getIndices();
 }
 
-const std::unordered_set<size_t>& BrushingAndLinkingManager::getFilteredIndices() const {
+const BitSet& BrushingAndLinkingManager::getFilteredIndices() const {
     return filtered_.getIndices();
 }
 
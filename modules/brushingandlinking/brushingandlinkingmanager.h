@@ -57,14 +57,12 @@ public:
     bool isFiltered(size_t idx) const;
     bool isSelected(size_t idx) const;
 
-    void setSelected(const BrushingAndLinkingInport* src,
-                     const std::unordered_set<size_t>& indices);
+    void setSelected(const BrushingAndLinkingInport* src, const BitSet& indices);
 
-    void setFiltered(const BrushingAndLinkingInport* src,
-        const std::unordered_set<size_t>& indices);
+    void setFiltered(const BrushingAndLinkingInport* src, const BitSet& indices);
 
-    const std::unordered_set<size_t> &getSelectedIndices() const;
-    const std::unordered_set<size_t> &getFilteredIndices() const;
+    const BitSet &getSelectedIndices() const;
+    const BitSet &getFilteredIndices() const;
 
 private:
     IndexList selected_;
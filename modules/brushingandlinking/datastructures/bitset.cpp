@@ -0,0 +1,135 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *********************************************************************************/
+
+#include <modules/brushingandlinking/datastructures/bitset.h>
+
+#include <algorithm>
+
+namespace inviwo {
+
+constexpr size_t BitSet::bitsPerWord;
+
+BitSet::BitSet(std::initializer_list<size_t> indices) : BitSet(indices.begin(), indices.end()) {}
+
+bool BitSet::contains(size_t idx) const {
+    const auto word = idx / bitsPerWord;
+    return word < words_.size() && ((words_[word] >> (idx % bitsPerWord)) & 1u) != 0;
+}
+
+void BitSet::add(size_t idx) {
+    const auto word = idx / bitsPerWord;
+    if (word >= words_.size()) words_.resize(word + 1, 0);
+    const auto mask = std::uint64_t{1} << (idx % bitsPerWord);
+    if ((words_[word] & mask) == 0) {
+        words_[word] |= mask;
+        ++count_;
+    }
+}
+
+void BitSet::addRange(size_t begin, size_t end) {
+    if (begin >= end) return;
+    const auto lastWord = (end - 1) / bitsPerWord;
+    if (lastWord >= words_.size()) words_.resize(lastWord + 1, 0);
+    for (auto word = begin / bitsPerWord; word <= lastWord; ++word) {
+        const auto first = std::max(begin, word * bitsPerWord) - word * bitsPerWord;
+        const auto last = std::min(end, (word + 1) * bitsPerWord) - word * bitsPerWord;
+        const auto mask = (last == bitsPerWord ? ~std::uint64_t{0}
+                                               : (std::uint64_t{1} << last) - 1) &
+                          ~((std::uint64_t{1} << first) - 1);
+        count_ += popcount(mask & ~words_[word]);
+        words_[word] |= mask;
+    }
+}
+
+void BitSet::remove(size_t idx) {
+    const auto word = idx / bitsPerWord;
+    if (word >= words_.size()) return;
+    const auto mask = std::uint64_t{1} << (idx % bitsPerWord);
+    if ((words_[word] & mask) != 0) {
+        words_[word] &= ~mask;
+        --count_;
+        trim();
+    }
+}
+
+void BitSet::clear() {
+    words_.clear();
+    count_ = 0;
+}
+
+bool BitSet::isSubsetOf(const BitSet& rhs) const {
+    if (count_ > rhs.count_ || words_.size() > rhs.words_.size()) return false;
+    for (size_t i = 0; i < words_.size(); ++i) {
+        if ((words_[i] & ~rhs.words_[i]) != 0) return false;
+    }
+    return true;
+}
+
+BitSet& BitSet::operator|=(const BitSet& rhs) {
+    if (rhs.words_.size() > words_.size()) words_.resize(rhs.words_.size(), 0);
+    for (size_t i = 0; i < rhs.words_.size(); ++i) {
+        count_ += popcount(rhs.words_[i] & ~words_[i]);
+        words_[i] |= rhs.words_[i];
+    }
+    return *this;
+}
+
+BitSet& BitSet::operator&=(const BitSet& rhs) {
+    words_.resize(std::min(words_.size(), rhs.words_.size()));
+    count_ = 0;
+    for (size_t i = 0; i < words_.size(); ++i) {
+        words_[i] &= rhs.words_[i];
+        count_ += popcount(words_[i]);
+    }
+    trim();
+    return *this;
+}
+
+bool BitSet::operator==(const BitSet& rhs) const {
+    return count_ == rhs.count_ && words_ == rhs.words_;
+}
+
+bool BitSet::operator!=(const BitSet& rhs) const { return !(*this == rhs); }
+
+std::vector<size_t> BitSet::toVector() const {
+    std::vector<size_t> indices;
+    indices.reserve(count_);
+    forEach([&](size_t idx) { indices.push_back(idx); });
+    return indices;
+}
+
+void BitSet::trim() {
+    while (!words_.empty() && words_.back() == 0) words_.pop_back();
+}
+
+BitSet operator|(BitSet lhs, const BitSet& rhs) { return lhs |= rhs; }
+
+BitSet operator&(BitSet lhs, const BitSet& rhs) { return lhs &= rhs; }
+
+}  // namespace inviwo
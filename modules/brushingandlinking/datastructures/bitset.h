@@ -0,0 +1,128 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *********************************************************************************/
+
+#ifndef IVW_BITSET_H
+#define IVW_BITSET_H
+
+#include <modules/brushingandlinking/brushingandlinkingmoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+
+#include <bitset>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+namespace inviwo {
+
+/**
+ * \class BitSet
+ * \brief Set of indices stored as a dense bitmap.
+ *
+ * Membership tests are a single bit lookup and union/intersection are computed word by word,
+ * i.e. in O(max index / 64). The bitmap grows as needed when adding indices and trailing zero
+ * words are dropped, so the memory footprint is determined by the largest index in the set.
+ * The number of elements is kept up to date on all modifications.
+ */
+class IVW_MODULE_BRUSHINGANDLINKING_API BitSet {
+public:
+    BitSet() = default;
+    BitSet(std::initializer_list<size_t> indices);
+    template <typename InputIt>
+    BitSet(InputIt begin, InputIt end);
+
+    bool contains(size_t idx) const;
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    void add(size_t idx);
+    /**
+     * Add all indices in [begin, end)
+     */
+    void addRange(size_t begin, size_t end);
+    void remove(size_t idx);
+    void clear();
+
+    /**
+     * Returns true if all elements of this set are also in rhs
+     */
+    bool isSubsetOf(const BitSet& rhs) const;
+
+    BitSet& operator|=(const BitSet& rhs);
+    BitSet& operator&=(const BitSet& rhs);
+    bool operator==(const BitSet& rhs) const;
+    bool operator!=(const BitSet& rhs) const;
+
+    /**
+     * Call callback(size_t idx) for each index in the set in increasing order
+     */
+    template <typename Callback>
+    void forEach(Callback callback) const;
+
+    std::vector<size_t> toVector() const;
+
+    /**
+     * Direct access to the bitmap, bit i of word j corresponds to index 64 * j + i
+     */
+    const std::vector<std::uint64_t>& getWords() const { return words_; }
+
+private:
+    static constexpr size_t bitsPerWord = 64;
+    static size_t popcount(std::uint64_t word) { return std::bitset<bitsPerWord>(word).count(); }
+    void trim();
+
+    std::vector<std::uint64_t> words_;
+    size_t count_ = 0;
+};
+
+IVW_MODULE_BRUSHINGANDLINKING_API BitSet operator|(BitSet lhs, const BitSet& rhs);
+IVW_MODULE_BRUSHINGANDLINKING_API BitSet operator&(BitSet lhs, const BitSet& rhs);
+
+template <typename InputIt>
+BitSet::BitSet(InputIt begin, InputIt end) {
+    for (auto it = begin; it != end; ++it) {
+        add(static_cast<size_t>(*it));
+    }
+}
+
+template <typename Callback>
+void BitSet::forEach(Callback callback) const {
+    for (size_t i = 0; i < words_.size(); ++i) {
+        auto word = words_[i];
+        while (word != 0) {
+            // index of the lowest set bit, given by the number of trailing zeros
+            const auto lowest = word & (~word + 1);
+            callback(i * bitsPerWord + popcount(lowest - 1));
+            word ^= lowest;
+        }
+    }
+}
+
+}  // namespace inviwo
+
+#endif  // IVW_BITSET_H
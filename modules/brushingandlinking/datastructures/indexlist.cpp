@@ -38,12 +38,19 @@ IndexList::~IndexList() {}
 
 size_t IndexList::getSize() const { return indices_.size(); }
 
-bool IndexList::has(size_t idx) const { return indices_.find(idx) != indices_.end(); }
+bool IndexList::has(size_t idx) const { return indices_.contains(idx); }
 
-void IndexList::set(const BrushingAndLinkingInport *src,
-                    const std::unordered_set<size_t> &indices) {
-    indicesBySource_[src] = indices;
-    update();
+void IndexList::set(const BrushingAndLinkingInport *src, const BitSet &indices) {
+    auto &current = indicesBySource_[src];
+    if (src->isConnected() && current.isSubsetOf(indices)) {
+        // indices were only added, no need to merge all sources again
+        current = indices;
+        indices_ |= indices;
+        onUpdate_.invoke();
+    } else {
+        current = indices;
+        update();
+    }
 }
 
 void IndexList::remove(const BrushingAndLinkingInport *src) {
@@ -58,13 +65,13 @@ std::shared_ptr<std::function<void()>> IndexList::onChange(std::function<void()>
 void IndexList::update() {
     indices_.clear();
 
-    using T = std::unordered_map<const BrushingAndLinkingInport *, std::unordered_set<size_t>>::value_type;
+    using T = std::unordered_map<const BrushingAndLinkingInport *, BitSet>::value_type;
     util::map_erase_remove_if(indicesBySource_, [](const T & p) {
         return !p.first->isConnected() || p.second.empty(); //remove if port is disconnected or if the set is empty
     });
 
-    for (auto p : indicesBySource_) {
-        indices_.insert(p.second.begin(), p.second.end());
+    for (const auto &p : indicesBySource_) {
+        indices_ |= p.second;
     }
     onUpdate_.invoke();
 }
@@ -33,11 +33,18 @@
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/util/dispatcher.h>
 #include <modules/brushingandlinking/brushingandlinkingmoduledefine.h>
+#include <modules/brushingandlinking/datastructures/bitset.h>
 
 namespace inviwo {
 class BrushingAndLinkingInport;
 class BrushingAndLinkingManager;
 
+/**
+ * \class IndexList
+ * \brief Union of the index sets of several brushing and linking inports.
+ * The indices of each source are kept in a separate BitSet and merged into a single BitSet
+ * which can be queried with has() or iterated with forEach().
+ */
 class IVW_MODULE_BRUSHINGANDLINKING_API IndexList {
 public:
     IndexList();
@@ -46,21 +53,30 @@ public:
     size_t getSize() const;
     bool has(size_t idx) const;
 
-    void set(const BrushingAndLinkingInport *src, const std::unordered_set<size_t> &incices);
+    /**
+     * Replace the indices of src. The merged set is updated incrementally if indices only adds
+     * to the previous indices of src.
+     */
+    void set(const BrushingAndLinkingInport *src, const BitSet &indices);
     void remove(const BrushingAndLinkingInport *src);
 
     std::shared_ptr<std::function<void()>> onChange(std::function<void()> V);
 
     void update();
     void clear();
-    const std::unordered_set<size_t> &getIndices() const {
-        return indices_;
+    const BitSet &getIndices() const { return indices_; }
+
+    /**
+     * Call callback(size_t idx) for each index in increasing order
+     */
+    template <typename Callback>
+    void forEach(Callback callback) const {
+        indices_.forEach(callback);
     }
 
 private:
-    std::unordered_map<const BrushingAndLinkingInport *, std::unordered_set<size_t>>
-        indicesBySource_;
-    std::unordered_set<size_t> indices_;
+    std::unordered_map<const BrushingAndLinkingInport *, BitSet> indicesBySource_;
+    BitSet indices_;
     Dispatcher<void()> onUpdate_;
 };
 
@@ -41,14 +41,14 @@ BrushingAndLinkingInport::BrushingAndLinkingInport(std::string identifier)
     });
 }
 
-void BrushingAndLinkingInport::sendFilterEvent(const std::unordered_set<size_t> &indices) {
+void BrushingAndLinkingInport::sendFilterEvent(const BitSet &indices) {
     if (filterCache_.size() == 0 && indices.size() == 0) return;
     filterCache_ = indices;
     FilteringEvent event(this, filterCache_);
     getProcessor()->propagateEvent(&event, nullptr);
 }
 
-void BrushingAndLinkingInport::sendSelectionEvent(const std::unordered_set<size_t> &indices) {
+void BrushingAndLinkingInport::sendSelectionEvent(const BitSet &indices) {
     if (selectionCache_.size() == 0 && indices.size() == 0) return;
     selectionCache_ = indices;
     SelectionEvent event(this, selectionCache_);
@@ -59,7 +59,7 @@ bool BrushingAndLinkingInport::isFiltered(size_t idx) const {
     if (isConnected()) {
         return getData()->isFiltered(idx);
     } else {
-        return filterCache_.find(idx) != filterCache_.end();
+        return filterCache_.contains(idx);
     }
 }
 
@@ -67,11 +67,11 @@ bool BrushingAndLinkingInport::isSelected(size_t idx) const {
     if (isConnected()) {
         return getData()->isSelected(idx);
     } else {
-        return selectionCache_.find(idx) != selectionCache_.end();
+        return selectionCache_.contains(idx);
     }
 }
 
-const std::unordered_set<size_t> &BrushingAndLinkingInport::getSelectedIndices() const {
+const BitSet &BrushingAndLinkingInport::getSelectedIndices() const {
     if (isConnected()) {
         return getData()->getSelectedIndices();
     } else {
@@ -79,7 +79,7 @@ const std::unordered_set<size_t> &BrushingAndLinkingInport::getSelectedIndices()
     }
 }
 
-const std::unordered_set<size_t> &BrushingAndLinkingInport::getFilteredIndices() const {
+const BitSet &BrushingAndLinkingInport::getFilteredIndices() const {
     if (isConnected()) {
         return getData()->getFilteredIndices();
     } else {
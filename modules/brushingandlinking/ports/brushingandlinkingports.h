@@ -48,20 +48,20 @@ public:
     BrushingAndLinkingInport(std::string identifier);
     virtual ~BrushingAndLinkingInport() = default;
 
-    void sendFilterEvent(const std::unordered_set<size_t> &indices);
+    void sendFilterEvent(const BitSet &indices);
 
-    void sendSelectionEvent(const std::unordered_set<size_t> &indices);
+    void sendSelectionEvent(const BitSet &indices);
 
     bool isFiltered(size_t idx) const;
     bool isSelected(size_t idx) const;
 
-    const std::unordered_set<size_t> &getSelectedIndices()const;
-    const std::unordered_set<size_t> &getFilteredIndices()const;
+    const BitSet &getSelectedIndices()const;
+    const BitSet &getFilteredIndices()const;
 
     virtual std::string getClassIdentifier() const override;
 
-    std::unordered_set<size_t> filterCache_;
-    std::unordered_set<size_t> selectionCache_;
+    BitSet filterCache_;
+    BitSet selectionCache_;
 };
 
 class IVW_MODULE_BRUSHINGANDLINKING_API BrushingAndLinkingOutport
@@ -0,0 +1,120 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2014-2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/brushingandlinking/datastructures/bitset.h>
+
+#include <random>
+#include <set>
+
+namespace inviwo {
+
+TEST(BitSetTests, empty) {
+    BitSet set;
+    EXPECT_TRUE(set.empty());
+    EXPECT_EQ(0, set.size());
+    EXPECT_FALSE(set.contains(0));
+    EXPECT_FALSE(set.contains(1000000));
+    EXPECT_TRUE(set.toVector().empty());
+}
+
+TEST(BitSetTests, addRemove) {
+    BitSet set{3, 64, 65, 1000};
+    EXPECT_EQ(4, set.size());
+    EXPECT_TRUE(set.contains(3));
+    EXPECT_TRUE(set.contains(64));
+    EXPECT_FALSE(set.contains(63));
+    EXPECT_TRUE(set.contains(1000));
+
+    set.add(3);
+    EXPECT_EQ(4, set.size()) << "adding an existing index";
+
+    set.remove(1000);
+    set.remove(999);
+    EXPECT_EQ(3, set.size());
+    EXPECT_FALSE(set.contains(1000));
+    EXPECT_EQ(2, set.getWords().size()) << "trailing empty words are not trimmed";
+    EXPECT_EQ((std::vector<size_t>{3, 64, 65}), set.toVector());
+
+    set.clear();
+    EXPECT_TRUE(set.empty());
+}
+
+TEST(BitSetTests, addRange) {
+    BitSet set{5};
+    set.addRange(60, 200);
+    set.addRange(10, 10);
+    EXPECT_EQ(141, set.size());
+    EXPECT_FALSE(set.contains(59));
+    EXPECT_TRUE(set.contains(60));
+    EXPECT_TRUE(set.contains(199));
+    EXPECT_FALSE(set.contains(200));
+
+    set.addRange(0, 128);
+    EXPECT_EQ(200, set.size());
+}
+
+TEST(BitSetTests, setOperations) {
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<size_t> dist(0, 5000);
+    std::set<size_t> a, b;
+    for (int i = 0; i < 1000; ++i) a.insert(dist(gen));
+    for (int i = 0; i < 3000; ++i) b.insert(dist(gen) / 2);
+
+    const BitSet setA(a.begin(), a.end());
+    const BitSet setB(b.begin(), b.end());
+    EXPECT_EQ(a.size(), setA.size());
+    EXPECT_EQ(std::vector<size_t>(a.begin(), a.end()), setA.toVector());
+
+    std::set<size_t> expectedUnion(a);
+    expectedUnion.insert(b.begin(), b.end());
+    const auto setUnion = setA | setB;
+    EXPECT_EQ(expectedUnion.size(), setUnion.size());
+    EXPECT_EQ(std::vector<size_t>(expectedUnion.begin(), expectedUnion.end()),
+              setUnion.toVector());
+
+    std::vector<size_t> expectedIntersection;
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                          std::back_inserter(expectedIntersection));
+    const auto setIntersection = setA & setB;
+    EXPECT_EQ(expectedIntersection.size(), setIntersection.size());
+    EXPECT_EQ(expectedIntersection, setIntersection.toVector());
+
+    EXPECT_TRUE(setIntersection.isSubsetOf(setA));
+    EXPECT_TRUE(setA.isSubsetOf(setUnion));
+    EXPECT_FALSE(setUnion.isSubsetOf(setA));
+    EXPECT_EQ(setUnion, setB | setA);
+    EXPECT_NE(setUnion, setA);
+}
+
+}  // namespace inviwo
@@ -28,12 +28,9 @@
  *********************************************************************************/
 
 #include "hdf5handle.h"
+#include <modules/hdf5/datastructures/hdf5volumeramloader.h>
 #include <inviwo/core/util/stdextensions.h>
-#include <inviwo/core/util/formatdispatching.h>
-#include <inviwo/core/util/raiiutils.h>
-#include <inviwo/core/datastructures/volume/volumeramprecision.h>
-
-#include <modules/base/algorithm/dataminmax.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
 
 #include <algorithm>
 
@@ -43,26 +40,31 @@ namespace inviwo {
 namespace hdf5 {
 
 Handle::Handle(std::string filename) : filename_(filename), path_("/") {
+    std::lock_guard<std::recursive_mutex> lock(libraryMutex());
     H5::H5File hdfFile(filename_, H5F_ACC_RDONLY);
     data_ = hdfFile.openGroup(path_);
 }
 
 Handle::Handle(std::string filename, Path path) : filename_(filename), path_(path) {
+    std::lock_guard<std::recursive_mutex> lock(libraryMutex());
     H5::H5File hdfFile(filename_, H5F_ACC_RDONLY);
     data_ = hdfFile.openGroup(path_);
 }
 
 Handle::Handle(const Handle& rhs) : filename_(rhs.filename_), path_(rhs.path_) {
+    std::lock_guard<std::recursive_mutex> lock(libraryMutex());
     H5::H5File hdfFile(filename_, H5F_ACC_RDONLY);
     data_ = hdfFile.openGroup(path_);
 }
 
 Handle::Handle(Handle&& rhs) : filename_(rhs.filename_), path_(rhs.path_) {
+    std::lock_guard<std::recursive_mutex> lock(libraryMutex());
     H5::H5File hdfFile(filename_, H5F_ACC_RDONLY);
     data_ = hdfFile.openGroup(path_);
 }
 
 Handle& Handle::operator=(Handle&& that) {
+    std::lock_guard<std::recursive_mutex> lock(libraryMutex());
     if (this != &that) {
         filename_ = that.filename_;
         path_ = that.path_;
@@ -74,6 +76,7 @@ Handle& Handle::operator=(Handle&& that) {
 }
 
 Handle& Handle::operator=(const Handle& that) {
+    std::lock_guard<std::recursive_mutex> lock(libraryMutex());
     if (this != &that) {
         filename_ = that.filename_;
         path_ = that.path_;
@@ -85,6 +88,7 @@ Handle& Handle::operator=(const Handle& that) {
 }
 
 Handle::~Handle() {
+    std::lock_guard<std::recursive_mutex> lock(libraryMutex());
     data_.close();
 }
 
@@ -128,102 +132,35 @@ double Handle::getMax(const DataFormatBase* type) const {
 std::shared_ptr<Volume> Handle::getVolumeAtPathAsType(const Path& path,
                                                       std::vector<Selection> selection,
                                                       const DataFormatBase* type) const {
-    
-    auto dataset = data_.openDataSet(path);
-    ::inviwo::util::OnScopeExit closedataset{[&]() { dataset.close(); }};
-
-    const H5::DataSpace dataSpace = dataset.getSpace();
-    const size_t rank = dataSpace.getSimpleExtentNdims();
-    if (selection.size() != rank) {
-        throw Exception("Selection not of the same rank as the data", IvwContext);
-    }
 
-    std::vector<hsize_t> dataDimensions(rank);
-    dataSpace.getSimpleExtentDims(dataDimensions.data());
-    const hsize_t dataSize = dataSpace.getSelectNpoints();
-
-    std::vector<hsize_t> start(rank);
-    std::vector<hsize_t> count(rank);
-    std::vector<hsize_t> stride(rank);
-
-    /*
-     * Column major, i.e. the FIRST listed dimension is the fasted changing
-     * Inviwo, OpenGL, matlab, Fortran
-     *
-     * Row major, i.e. the LAST listed dimension is the fasted changing
-     * HDF, C/C++, Mathematica, Python
-     *
-     * Solution reverse all the dimension lists.
-     * Row major version of the selection to match the hdf row major dataDimensions.
-     */
-    std::reverse(selection.begin(), selection.end());
-
-    size3_t volumeDimensions(1);
-    int resRank = 0;
-    std::vector<hsize_t> memoryDimensions{ 1, 1, 1 };
-
-    for (size_t i = 0; i < rank; ++i) {
-        start[i] = selection[i].start;
-        count[i] =
-            static_cast<hsize_t>((selection[i].end - selection[i].start) / selection[i].stride);
-        stride[i] = selection[i].stride;
-
-        if (count[i] > 1) {
-            if (resRank > 2) throw Exception("Invalid selection, resulting rank > 3", IvwContext);
-            memoryDimensions[resRank] = count[i];
-            volumeDimensions[resRank] = count[i];
-            resRank++;
-        }
+    auto loader = ::inviwo::util::make_unique<VolumeRAMLoader>(filename_, path,
+                                                               std::move(selection), type);
+
+    auto volume = std::make_shared<Volume>(loader->getDimensions(), loader->getDataFormat());
+
+    // Defer reading the data if the data range is known, otherwise read it now to compute it.
+    dvec2 dataRange;
+    if (loader->readDataRangeAttributes(dataRange)) {
+        LogInfo("Opened HDF volume type: " << loader->getDataFormat()->getString()
+                                           << " dims: " << loader->getDimensions()
+                                           << " data range: " << dataRange
+                                           << " file: " << filename_ << path);
+    } else {
+        auto volumeram = loader->readVolume(&dataRange);
+        volume->addRepresentation(volumeram);
+        LogInfo("Read HDF volume type: " << loader->getDataFormat()->getString()
+                                         << " dims: " << loader->getDimensions()
+                                         << " data range: " << dataRange
+                                         << " file: " << filename_ << path);
     }
+    volume->dataMap_.dataRange = dataRange;
+    volume->dataMap_.valueRange = dataRange;
 
-    dataSpace.selectHyperslab(H5S_SELECT_SET, count.data(), start.data(), stride.data(), nullptr);
-
-    H5::DataSpace memorySpace(3, memoryDimensions.data());
-    memorySpace.selectAll();
-
-    hsize_t selectionSize = memorySpace.getSelectNpoints();
-
-    LogInfo("Data rank: " << rank << " dims " << joinString(dataDimensions, " x ") << " size "
-                          << dataSize << " selection " << dataSpace.getSelectNpoints()
-                          << " memory size " << memorySpace.getSelectNpoints() << " memory dim "
-                          << volumeDimensions);
-
-    const DataFormatBase* format = type ? type : util::getDataFormatFromDataSet(dataset);
-
-    // Reverse back the Column major
-    std::reverse(&volumeDimensions[0], &volumeDimensions[0] + volumeDimensions.length());
-    auto volumeram = createVolumeRAM(volumeDimensions, format);
-
-    auto minmax = volumeram->dispatch<std::pair<dvec4, dvec4>, dispatching::filter::Scalars>([&](
-        auto vrprecision) {
-        using ValueType = ::inviwo::util::PrecsionValueType<decltype(vrprecision)>;
-
-        ValueType* data = vrprecision->getDataTyped();
-
-        try {
-            dataset.read(data, TypeMap<ValueType>::getType(), memorySpace, dataSpace);
-        } catch (H5::DataSetIException& e) {
-            throw Exception("HDF: unable to read data: " + e.getDetailMsg(), IvwContext);
-        }
-
-        auto res = ::inviwo::util::dataMinMax(data, selectionSize);
-
-        LogInfo("Read HDF volume type: " << DataFormat<ValueType>::str()
-                                         << " data range: " << res.first << ", " << res.second
-                                         << " file: " << dataset.getFileName());
-
-        return res;
-    });
-
-    auto volume = std::make_shared<Volume>();
-    volume->dataMap_.dataRange.x = glm::compMin(minmax.first);
-    volume->dataMap_.dataRange.y = glm::compMax(minmax.second);
-    volume->dataMap_.valueRange = volume->dataMap_.dataRange;
+    auto volumeDisk = std::make_shared<VolumeDisk>(filename_, loader->getDimensions(),
+                                                   loader->getDataFormat());
+    volumeDisk->setLoader(loader.release());
+    volume->addRepresentation(volumeDisk);
 
-    volume->setDimensions(volumeram->getDimensions());
-    volume->setDataFormat(volumeram->getDataFormat());
-    volume->addRepresentation(volumeram);
-  
     return volume;
 }
 
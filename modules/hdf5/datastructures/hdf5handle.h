@@ -103,6 +103,7 @@ private:
 
 template <typename T>
 std::vector<T> Handle::getVectorAtPath(const Path& path) const {
+    std::lock_guard<std::recursive_mutex> lock(libraryMutex());
     H5::DataSet ds = data_.openDataSet(path);
     size_t rank = ds.getSpace().getSimpleExtentNdims();
 
@@ -126,6 +127,7 @@ std::vector<T> Handle::getVectorAtPath(const Path& path) const {
 
 template <typename T>
 std::vector<glm::tvec3<T, glm::defaultp>> Handle::getVectorOfVec3AtPath(const Path& path) const {
+    std::lock_guard<std::recursive_mutex> lock(libraryMutex());
     H5::DataSet ds = data_.openDataSet(path);
     size_t rank = ds.getSpace().getSimpleExtentNdims();
 
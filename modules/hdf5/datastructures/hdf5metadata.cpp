@@ -28,6 +28,7 @@
  *********************************************************************************/
 
 #include "hdf5metadata.h"
+#include <modules/hdf5/hdf5utils.h>
 #include <inviwo/core/util/formats.h>
 #include <inviwo/core/util/stringconversion.h>
 
@@ -88,6 +89,7 @@ std::vector<MetaData> getAttributeMetaData(const T& grp, Path path) {
 }
 
 IVW_MODULE_HDF5_API std::vector<MetaData> getMetaData(const H5::Group& grp, Path path) {
+    std::lock_guard<std::recursive_mutex> lock(libraryMutex());
     std::vector<MetaData> metadata{};
     metadata.emplace_back(path, MetaData::HDFType::Group);
 
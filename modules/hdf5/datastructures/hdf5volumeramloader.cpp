@@ -0,0 +1,349 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/hdf5/datastructures/hdf5volumeramloader.h>
+#include <modules/hdf5/hdf5types.h>
+#include <modules/hdf5/hdf5utils.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/raiiutils.h>
+
+#include <modules/base/algorithm/dataminmax.h>
+
+#include <algorithm>
+#include <future>
+
+namespace inviwo {
+
+namespace hdf5 {
+
+namespace {
+
+H5::PredType getMemoryType(const DataFormatBase* format) {
+    switch (format->getId()) {
+        case DataFormatId::Float32:
+            return H5::PredType::NATIVE_FLOAT;
+        case DataFormatId::Float64:
+            return H5::PredType::NATIVE_DOUBLE;
+        case DataFormatId::Int8:
+            return H5::PredType::NATIVE_INT8;
+        case DataFormatId::Int16:
+            return H5::PredType::NATIVE_INT16;
+        case DataFormatId::Int32:
+            return H5::PredType::NATIVE_INT32;
+        case DataFormatId::Int64:
+            return H5::PredType::NATIVE_INT64;
+        case DataFormatId::UInt8:
+            return H5::PredType::NATIVE_UINT8;
+        case DataFormatId::UInt16:
+            return H5::PredType::NATIVE_UINT16;
+        case DataFormatId::UInt32:
+            return H5::PredType::NATIVE_UINT32;
+        case DataFormatId::UInt64:
+            return H5::PredType::NATIVE_UINT64;
+        default:
+            throw Exception("HDF: unsupported volume format " + std::string(format->getString()),
+                            IvwContextCustom("hdf5::VolumeRAMLoader"));
+    }
+}
+
+// Size of the chunk cache is limited to this, larger slabs will read chunks more than once
+constexpr size_t maxCacheBytes = 512 * 1024 * 1024;
+// Minimum number of bytes to read in each slab when the data is not chunked
+constexpr size_t minSlabBytes = 16 * 1024 * 1024;
+
+}  // namespace
+
+VolumeRAMLoader::VolumeRAMLoader(const std::string& filename, const Path& path,
+                                 std::vector<Handle::Selection> selection,
+                                 const DataFormatBase* format)
+    : filename_(filename)
+    , path_(path)
+    , format_(format)
+    , dimensions_(1)
+    , axisDims_{{-1, -1, -1}}
+    , cacheBytes_(0)
+    , cacheSlots_(0) {
+
+    std::lock_guard<std::recursive_mutex> lock(libraryMutex());
+    H5::H5File file(filename_, H5F_ACC_RDONLY);
+    auto dataset = file.openDataSet(path_);
+    ::inviwo::util::OnScopeExit closedataset{[&]() {
+        dataset.close();
+        file.close();
+    }};
+
+    const H5::DataSpace dataSpace = dataset.getSpace();
+    const size_t rank = dataSpace.getSimpleExtentNdims();
+    if (selection.size() != rank) {
+        throw Exception("Selection not of the same rank as the data", IvwContext);
+    }
+    if (!format_) format_ = util::getDataFormatFromDataSet(dataset);
+    getMemoryType(format_);  // throws for unsupported formats
+
+    // Inviwo is column major and HDF5 row major, reverse the selection to match HDF5.
+    std::reverse(selection.begin(), selection.end());
+
+    start_.resize(rank);
+    count_.resize(rank);
+    stride_.resize(rank);
+
+    size3_t dims{1};
+    int resRank = 0;
+    for (size_t i = 0; i < rank; ++i) {
+        start_[i] = selection[i].start;
+        count_[i] =
+            static_cast<hsize_t>((selection[i].end - selection[i].start) / selection[i].stride);
+        stride_[i] = selection[i].stride;
+
+        if (count_[i] > 1) {
+            if (resRank > 2) throw Exception("Invalid selection, resulting rank > 3", IvwContext);
+            dims[resRank] = count_[i];
+            axisDims_[2 - resRank] = static_cast<int>(i);
+            resRank++;
+        }
+    }
+    // Reverse back to column major
+    dimensions_ = size3_t{dims[2], dims[1], dims[0]};
+
+    const auto plist = dataset.getCreatePlist();
+    if (plist.getLayout() == H5D_CHUNKED) {
+        chunk_.resize(rank);
+        plist.getChunk(static_cast<int>(rank), chunk_.data());
+
+        // Make room for all chunks intersecting one slab of the selection
+        const size_t elementSize = dataset.getDataType().getSize();
+        size_t chunks = 1;
+        size_t chunkBytes = elementSize;
+        for (size_t i = 0; i < rank; ++i) {
+            chunkBytes *= chunk_[i];
+            if (axisDims_[2] == static_cast<int>(i)) continue;
+            const hsize_t extent = count_[i] > 0 ? (count_[i] - 1) * stride_[i] + 1 : 0;
+            chunks *= static_cast<size_t>((start_[i] % chunk_[i] + extent + chunk_[i] - 1) /
+                                          chunk_[i]);
+        }
+        cacheBytes_ = std::min(chunks * chunkBytes, maxCacheBytes);
+        cacheSlots_ = std::max<size_t>(521, 100 * (cacheBytes_ / std::max<size_t>(chunkBytes, 1)));
+    }
+}
+
+VolumeRAMLoader::VolumeRAMLoader(const VolumeRAMLoader& rhs)
+    : filename_(rhs.filename_)
+    , path_(rhs.path_)
+    , format_(rhs.format_)
+    , dimensions_(rhs.dimensions_)
+    , start_(rhs.start_)
+    , count_(rhs.count_)
+    , stride_(rhs.stride_)
+    , chunk_(rhs.chunk_)
+    , axisDims_(rhs.axisDims_)
+    , cacheBytes_(rhs.cacheBytes_)
+    , cacheSlots_(rhs.cacheSlots_) {
+    // The copy opens its own file handles when it first reads
+    std::lock_guard<std::recursive_mutex> lock(libraryMutex());
+}
+
+VolumeRAMLoader::~VolumeRAMLoader() {
+    std::lock_guard<std::recursive_mutex> lock(libraryMutex());
+    dataset_.reset();
+    file_.reset();
+}
+
+VolumeRAMLoader* VolumeRAMLoader::clone() const { return new VolumeRAMLoader(*this); }
+
+std::shared_ptr<VolumeRepresentation> VolumeRAMLoader::createRepresentation() const {
+    return readVolume();
+}
+
+void VolumeRAMLoader::updateRepresentation(std::shared_ptr<VolumeRepresentation> dest) const {
+    auto volumeDst = std::static_pointer_cast<VolumeRAM>(dest);
+
+    if (dimensions_ != volumeDst->getDimensions()) {
+        throw Exception("Mismatching volume dimensions, can't update", IvwContext);
+    }
+    readRegion(size3_t{0}, dimensions_, volumeDst->getData());
+}
+
+void VolumeRAMLoader::readRegion(const size3_t& offset, const size3_t& dimensions,
+                                 void* dest) const {
+    if (glm::any(glm::greaterThan(offset + dimensions, dimensions_))) {
+        throw Exception("Region outside of volume, can't read", IvwContext);
+    }
+    if (dimensions.x == 0 || dimensions.y == 0 || dimensions.z == 0) return;
+
+    auto start = start_;
+    auto count = count_;
+    for (size_t axis = 0; axis < 3; ++axis) {
+        if (axisDims_[axis] < 0) continue;
+        const auto dim = static_cast<size_t>(axisDims_[axis]);
+        start[dim] += offset[axis] * stride_[dim];
+        count[dim] = dimensions[axis];
+    }
+    std::vector<hsize_t> memoryDimensions{dimensions.z, dimensions.y, dimensions.x};
+
+    std::lock_guard<std::recursive_mutex> lock(libraryMutex());
+    auto& dataset = getDataSet();
+    try {
+        H5::DataSpace dataSpace = dataset.getSpace();
+        dataSpace.selectHyperslab(H5S_SELECT_SET, count.data(), start.data(), stride_.data(),
+                                  nullptr);
+        H5::DataSpace memorySpace(3, memoryDimensions.data());
+        memorySpace.selectAll();
+        dataset.read(dest, getMemoryType(format_), memorySpace, dataSpace);
+    } catch (const H5::Exception& e) {
+        throw Exception("HDF: unable to read data: " + e.getDetailMsg(), IvwContext);
+    }
+}
+
+std::shared_ptr<VolumeRAM> VolumeRAMLoader::readVolume(dvec2* dataRange) const {
+    auto volumeram = createVolumeRAM(dimensions_, format_);
+    auto data = static_cast<char*>(volumeram->getData());
+    const size_t sliceSize = dimensions_.x * dimensions_.y;
+    const size_t sliceBytes = sliceSize * format_->getSize();
+
+    const auto minMax = [volumeram, sliceSize](size_t z, size_t slices) {
+        return volumeram->dispatch<std::pair<dvec4, dvec4>, dispatching::filter::Scalars>(
+            [&](auto vrprecision) {
+                return ::inviwo::util::dataMinMax(vrprecision->getDataTyped() + z * sliceSize,
+                                                  slices * sliceSize);
+            });
+    };
+    const bool parallel = InviwoApplication::isInitialized();
+
+    // Compute the min max of each slab while the next one is read
+    std::vector<std::future<std::pair<dvec4, dvec4>>> minmaxes;
+    const size_t slabSize = getSlabSize();
+    for (size_t z = 0; z < dimensions_.z;) {
+        // Align the end of the slabs with the chunks of the dataset
+        size_t slices = slabSize;
+        if (axisDims_[2] >= 0 && !chunk_.empty()) {
+            const auto dim = static_cast<size_t>(axisDims_[2]);
+            const hsize_t pos = start_[dim] + z * stride_[dim];
+            hsize_t end = (pos + slabSize * stride_[dim]) / chunk_[dim] * chunk_[dim];
+            if (end <= pos) end = (pos / chunk_[dim] + 1) * chunk_[dim];
+            slices = static_cast<size_t>((end - pos + stride_[dim] - 1) / stride_[dim]);
+        }
+        slices = std::min(slices, dimensions_.z - z);
+
+        readRegion(size3_t{0, 0, z}, size3_t{dimensions_.x, dimensions_.y, slices},
+                   data + z * sliceBytes);
+
+        if (dataRange) {
+            if (parallel) {
+                minmaxes.push_back(dispatchPool(minMax, z, slices));
+            } else {
+                std::promise<std::pair<dvec4, dvec4>> promise;
+                promise.set_value(minMax(z, slices));
+                minmaxes.push_back(promise.get_future());
+            }
+        }
+        z += slices;
+    }
+
+    if (dataRange) {
+        *dataRange = dvec2{std::numeric_limits<double>::max(),
+                           std::numeric_limits<double>::lowest()};
+        for (auto& f : minmaxes) {
+            if (parallel) waitForTask(f);
+            const auto res = f.get();
+            dataRange->x = std::min(dataRange->x, res.first.x);
+            dataRange->y = std::max(dataRange->y, res.second.x);
+        }
+    }
+
+    return volumeram;
+}
+
+bool VolumeRAMLoader::readDataRangeAttributes(dvec2& dataRange) const {
+    std::lock_guard<std::recursive_mutex> lock(libraryMutex());
+    auto& dataset = getDataSet();
+
+    const auto read = [&](const std::string& name, size_t size, double* dest) {
+        if (H5Aexists(dataset.getId(), name.c_str()) <= 0) return false;
+        try {
+            auto attr = dataset.openAttribute(name);
+            if (static_cast<size_t>(attr.getSpace().getSimpleExtentNpoints()) != size) {
+                return false;
+            }
+            attr.read(H5::PredType::NATIVE_DOUBLE, dest);
+            return true;
+        } catch (const H5::Exception&) {
+            return false;
+        }
+    };
+
+    dvec2 range;
+    for (auto name : {"actual_range", "data_range", "valid_range"}) {
+        if (read(name, 2, &range[0])) {
+            dataRange = range;
+            return true;
+        }
+    }
+    for (auto names : {std::make_pair("min", "max"), std::make_pair("valid_min", "valid_max")}) {
+        if (read(names.first, 1, &range[0]) && read(names.second, 1, &range[1])) {
+            dataRange = range;
+            return true;
+        }
+    }
+    return false;
+}
+
+const size3_t& VolumeRAMLoader::getDimensions() const { return dimensions_; }
+
+const DataFormatBase* VolumeRAMLoader::getDataFormat() const { return format_; }
+
+H5::DataSet& VolumeRAMLoader::getDataSet() const {
+    if (!dataset_) {
+        H5::FileAccPropList access;
+        if (cacheBytes_ > 0) {
+            access.setCache(0, cacheSlots_, cacheBytes_, 1.0);
+        }
+        file_ = ::inviwo::util::make_unique<H5::H5File>(filename_, H5F_ACC_RDONLY,
+                                              H5::FileCreatPropList::DEFAULT, access);
+        dataset_ = ::inviwo::util::make_unique<H5::DataSet>(file_->openDataSet(path_));
+    }
+    return *dataset_;
+}
+
+size_t VolumeRAMLoader::getSlabSize() const {
+    const size_t sliceBytes = dimensions_.x * dimensions_.y * format_->getSize();
+    if (axisDims_[2] >= 0 && !chunk_.empty()) {
+        // As many slices as fit in the chunk cache
+        const auto dim = static_cast<size_t>(axisDims_[2]);
+        const size_t chunkSlices =
+            std::max<size_t>(1, static_cast<size_t>(chunk_[dim] / stride_[dim]));
+        return std::max(chunkSlices, minSlabBytes / std::max<size_t>(sliceBytes, 1));
+    } else {
+        return std::max<size_t>(1, minSlabBytes / std::max<size_t>(sliceBytes, 1));
+    }
+}
+
+}  // namespace hdf5
+
+}  // namespace inviwo
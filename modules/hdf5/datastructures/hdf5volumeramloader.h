@@ -0,0 +1,135 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_HDF5VOLUMERAMLOADER_H
+#define IVW_HDF5VOLUMERAMLOADER_H
+
+#include <modules/hdf5/hdf5moduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/diskrepresentation.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+
+#include <modules/hdf5/datastructures/hdf5handle.h>
+#include <modules/hdf5/datastructures/hdf5path.h>
+
+#include <H5Cpp.h>
+
+#include <array>
+
+namespace inviwo {
+
+namespace hdf5 {
+
+/**
+ * \class VolumeRAMLoader
+ * \brief A loader of volumes stored as datasets in HDF5 files. Used to create VolumeRAM
+ * representations of a selection of a dataset on demand, see Handle::getVolumeAtPathAsType.
+ *
+ * Data is read in slabs aligned to the chunking of the dataset, with a chunk cache large enough
+ * to hold one slab of chunks, such that each chunk is only read and decompressed once.
+ * Sub regions of the volume can be read using readRegion, which is used by VolumeBricked.
+ * The HDF5 library is not thread safe, hence all calls into it are serialized using
+ * libraryMutex().
+ */
+class IVW_MODULE_HDF5_API VolumeRAMLoader : public DiskRepresentationLoader<VolumeRepresentation>,
+                                            public VolumeRegionLoader {
+public:
+    /**
+     * @param filename of the HDF5 file
+     * @param path absolute path of the dataset within the file
+     * @param selection of the dataset for each dimension, fastest changing first. At most three
+     * dimensions can have more than one element selected.
+     * @param format of the volume, the data will be converted by HDF5 if it differs from the
+     * format of the dataset. Only scalar formats are supported.
+     * @throws Exception if the selection is invalid
+     */
+    VolumeRAMLoader(const std::string& filename, const Path& path,
+                    std::vector<Handle::Selection> selection, const DataFormatBase* format);
+    VolumeRAMLoader(const VolumeRAMLoader& rhs);
+    VolumeRAMLoader& operator=(const VolumeRAMLoader& that) = delete;
+    virtual ~VolumeRAMLoader();
+
+    virtual VolumeRAMLoader* clone() const override;
+    virtual std::shared_ptr<VolumeRepresentation> createRepresentation() const override;
+    virtual void updateRepresentation(std::shared_ptr<VolumeRepresentation> dest) const override;
+    virtual void readRegion(const size3_t& offset, const size3_t& dimensions,
+                            void* dest) const override;
+
+    /**
+     * Read the whole selection into a new VolumeRAM. If dataRange is not null the minimum and
+     * maximum value of the data is computed as well, concurrently with reading the next slab.
+     */
+    std::shared_ptr<VolumeRAM> readVolume(dvec2* dataRange = nullptr) const;
+
+    /**
+     * Look for the data range of the dataset in its attributes. The attributes "actual_range",
+     * "data_range" and "valid_range" with two values, or pairs of "min"/"max" and
+     * "valid_min"/"valid_max" attributes are used, in that order.
+     * @return true if a data range was found, in which case it is written to dataRange.
+     */
+    bool readDataRangeAttributes(dvec2& dataRange) const;
+
+    const size3_t& getDimensions() const;
+    const DataFormatBase* getDataFormat() const;
+
+private:
+    /**
+     * Open the dataset if needed and return it, libraryMutex() has to be locked.
+     */
+    H5::DataSet& getDataSet() const;
+    /**
+     * Number of z slices in each slab read by readVolume.
+     */
+    size_t getSlabSize() const;
+
+    std::string filename_;
+    Path path_;
+    const DataFormatBase* format_;
+    size3_t dimensions_;
+
+    // Row major, i.e. slowest changing dimension first, as used by HDF5
+    std::vector<hsize_t> start_;
+    std::vector<hsize_t> count_;
+    std::vector<hsize_t> stride_;
+    std::vector<hsize_t> chunk_;  // empty if the dataset is not chunked
+    // The row major dataset dimension of the x, y and z axis of the volume, -1 if none
+    std::array<int, 3> axisDims_;
+    size_t cacheBytes_;
+    size_t cacheSlots_;
+
+    mutable std::unique_ptr<H5::H5File> file_;
+    mutable std::unique_ptr<H5::DataSet> dataset_;
+};
+
+}  // namespace hdf5
+
+}  // namespace inviwo
+
+#endif  // IVW_HDF5VOLUMERAMLOADER_H
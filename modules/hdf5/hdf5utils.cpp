@@ -33,7 +33,13 @@ namespace inviwo {
 
 namespace hdf5 {
 
+std::recursive_mutex& libraryMutex() {
+    static std::recursive_mutex mutex;
+    return mutex;
+}
+
 Paths findpaths(const H5::Group& grp, const Path& path, const std::string& type) {
+    std::lock_guard<std::recursive_mutex> lock(libraryMutex());
     Paths paths;
 
     if (isOfType(grp, type)) {
@@ -52,6 +58,7 @@ Paths findpaths(const H5::Group& grp, const Path& path, const std::string& type)
 }
 
 VolumeInfos getVolumeInfo(const H5::DataSet& ds, const Path& path) {
+    std::lock_guard<std::recursive_mutex> lock(libraryMutex());
     auto size = std::make_unique<hsize_t[]>(ds.getSpace().getSimpleExtentNdims());
     ds.getSpace().getSimpleExtentDims(size.get());
     int sub_densities = (int)size[0];
@@ -73,6 +80,7 @@ VolumeInfos getVolumeInfo(const H5::DataSet& ds, const Path& path) {
 }
 
 bool isOfType(const H5::Group& grp, const std::string& type) {
+    std::lock_guard<std::recursive_mutex> lock(libraryMutex());
     bool result = false;
     try {
         if (grp.attrExists("type")) {
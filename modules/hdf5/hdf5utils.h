@@ -35,6 +35,8 @@
 #include <inviwo/core/common/inviwo.h>
 #include <H5Cpp.h>
 
+#include <mutex>
+
 namespace inviwo {
 
 namespace hdf5 {
@@ -48,6 +50,12 @@ struct IVW_MODULE_HDF5_API VolumeInfo {
 using VolumeInfos = std::vector<VolumeInfo>;
 using Paths = std::vector<Path>;
 
+/**
+ * The HDF5 library is not built thread safe, every call into it has to hold this mutex. It is
+ * recursive such that functions locking it can call each other.
+ */
+IVW_MODULE_HDF5_API std::recursive_mutex& libraryMutex();
+
 IVW_MODULE_HDF5_API Paths findpaths(const H5::Group& grp, const Path& path,
                                     const std::string& type);
 IVW_MODULE_HDF5_API bool isOfType(const H5::Group& grp, const std::string& type);
@@ -204,6 +204,7 @@ mat4 HDF5ToVolume::getBasisFromMeta(MetaData meta) {
 
     if (inport_.hasData()) {
         const auto data = inport_.getData();
+        std::lock_guard<std::recursive_mutex> lock(hdf5::libraryMutex());
         H5::DataSet dataset = data->getGroup().openDataSet(meta.path_);
         H5::DataSpace space = dataset.getSpace();
         int rank = space.getSimpleExtentNdims();
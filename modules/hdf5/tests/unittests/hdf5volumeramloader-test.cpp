@@ -0,0 +1,269 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/hdf5/datastructures/hdf5handle.h>
+#include <modules/hdf5/datastructures/hdf5volumeramloader.h>
+#include <inviwo/core/io/tempfilehandle.h>
+#include <inviwo/core/util/indexmapper.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+
+#include <atomic>
+#include <thread>
+#include <utility>
+
+namespace inviwo {
+
+namespace {
+
+/**
+ * Write a chunked uint16 dataset, value(x, y, z) gives the voxel values. The dimensions and the
+ * chunk size are given fastest changing first.
+ */
+template <typename Func>
+H5::DataSet writeVolume(H5::H5File& file, const std::string& name, const size3_t& dims,
+                        const size3_t& chunk, Func value) {
+    std::vector<unsigned short> data(glm::compMul(dims));
+    util::IndexMapper3D im(dims);
+    for (size_t z = 0; z < dims.z; ++z) {
+        for (size_t y = 0; y < dims.y; ++y) {
+            for (size_t x = 0; x < dims.x; ++x) data[im(x, y, z)] = value(x, y, z);
+        }
+    }
+
+    const hsize_t fileDims[3] = {dims.z, dims.y, dims.x};
+    const hsize_t fileChunk[3] = {chunk.z, chunk.y, chunk.x};
+    H5::DSetCreatPropList plist;
+    plist.setChunk(3, fileChunk);
+    H5::DataSpace space(3, fileDims);
+    auto dataset = file.createDataSet(name, H5::PredType::NATIVE_UINT16, space, plist);
+    dataset.write(data.data(), H5::PredType::NATIVE_UINT16);
+    return dataset;
+}
+
+// Write a chunked dataset where each voxel holds its own linear index
+void writeIndexVolume(const std::string& filename, const size3_t& dims) {
+    H5::H5File file(filename, H5F_ACC_TRUNC);
+    util::IndexMapper3D im(dims);
+    writeVolume(file, "/volume", dims, size3_t{4}, [&](size_t x, size_t y, size_t z) {
+        return static_cast<unsigned short>(im(x, y, z));
+    });
+}
+
+void writeAttribute(H5::DataSet& dataset, const std::string& name, std::vector<double> values) {
+    const hsize_t size = values.size();
+    H5::DataSpace space(1, &size);
+    auto attr = dataset.createAttribute(name, H5::PredType::NATIVE_DOUBLE, space);
+    attr.write(H5::PredType::NATIVE_DOUBLE, values.data());
+}
+
+std::vector<hdf5::Handle::Selection> selectAll(const size3_t& dims) {
+    return {{0, dims.x, 1}, {0, dims.y, 1}, {0, dims.z, 1}};
+}
+
+}  // namespace
+
+TEST(HDF5VolumeRAMLoader, LoadsDataOnFirstAccess) {
+    const size3_t dims{12, 10, 9};
+    util::TempFileHandle tmpFile("hdf5", ".h5");
+    writeIndexVolume(tmpFile.getFileName(), dims);
+    {
+        H5::H5File file(tmpFile.getFileName(), H5F_ACC_RDWR);
+        auto dataset = file.openDataSet("/volume");
+        writeAttribute(dataset, "actual_range", {0.0, 2000.0});
+    }
+
+    hdf5::Handle handle(tmpFile.getFileName());
+    auto volume =
+        handle.getVolumeAtPathAsType(hdf5::Path("/volume"), selectAll(dims), DataUInt16::get());
+
+    // The data range is given by the attribute, hence nothing is read until the data is used
+    EXPECT_EQ(dvec2(0.0, 2000.0), volume->dataMap_.dataRange);
+    EXPECT_TRUE(volume->hasRepresentation<VolumeDisk>());
+    EXPECT_FALSE(volume->hasRepresentation<VolumeRAM>());
+
+    const auto ram = volume->getRepresentation<VolumeRAM>();
+    ASSERT_EQ(dims, ram->getDimensions());
+    const auto data = static_cast<const unsigned short*>(ram->getData());
+    size_t errors = 0;
+    for (size_t i = 0; i < glm::compMul(dims); ++i) {
+        if (data[i] != i) ++errors;
+    }
+    EXPECT_EQ(0, errors);
+}
+
+TEST(HDF5VolumeRAMLoader, ReadsDataWithoutRangeAttributes) {
+    const size3_t dims{12, 10, 9};
+    util::TempFileHandle tmpFile("hdf5", ".h5");
+    writeIndexVolume(tmpFile.getFileName(), dims);
+
+    hdf5::Handle handle(tmpFile.getFileName());
+    auto volume =
+        handle.getVolumeAtPathAsType(hdf5::Path("/volume"), selectAll(dims), DataUInt16::get());
+
+    // The data is read up front to compute the data range
+    EXPECT_TRUE(volume->hasRepresentation<VolumeRAM>());
+    EXPECT_EQ(dvec2(0.0, glm::compMul(dims) - 1.0), volume->dataMap_.dataRange);
+}
+
+TEST(HDF5VolumeRAMLoader, ReadDataRangeAttributes) {
+    const size3_t dims{4, 4, 4};
+    util::TempFileHandle tmpFile("hdf5", ".h5");
+    {
+        H5::H5File file(tmpFile.getFileName(), H5F_ACC_TRUNC);
+        const auto write = [&](const std::string& name,
+                               std::vector<std::pair<std::string, std::vector<double>>> attrs) {
+            auto dataset =
+                writeVolume(file, name, dims, dims, [](size_t, size_t, size_t) { return 0; });
+            for (auto& attr : attrs) writeAttribute(dataset, attr.first, attr.second);
+        };
+        write("/actual", {{"actual_range", {1.0, 2.0}}});
+        write("/data", {{"data_range", {3.0, 4.0}}});
+        write("/valid", {{"valid_range", {5.0, 6.0}}});
+        write("/minmax", {{"min", {7.0}}, {"max", {8.0}}});
+        write("/validminmax", {{"valid_min", {9.0}}, {"valid_max", {10.0}}});
+        write("/both", {{"min", {7.0}}, {"max", {8.0}}, {"data_range", {3.0, 4.0}}});
+        write("/minonly", {{"min", {7.0}}});
+        write("/wrongsize", {{"actual_range", {1.0, 2.0, 3.0}}});
+        write("/none", {});
+    }
+
+    const auto range = [&](const std::string& name) {
+        const hdf5::VolumeRAMLoader loader(tmpFile.getFileName(), hdf5::Path(name),
+                                           selectAll(dims), DataUInt16::get());
+        dvec2 dataRange{-1.0};
+        const bool found = loader.readDataRangeAttributes(dataRange);
+        return std::make_pair(found, dataRange);
+    };
+    EXPECT_EQ(std::make_pair(true, dvec2(1.0, 2.0)), range("/actual"));
+    EXPECT_EQ(std::make_pair(true, dvec2(3.0, 4.0)), range("/data"));
+    EXPECT_EQ(std::make_pair(true, dvec2(5.0, 6.0)), range("/valid"));
+    EXPECT_EQ(std::make_pair(true, dvec2(7.0, 8.0)), range("/minmax"));
+    EXPECT_EQ(std::make_pair(true, dvec2(9.0, 10.0)), range("/validminmax"));
+    // Ranges have precedence over min and max
+    EXPECT_EQ(std::make_pair(true, dvec2(3.0, 4.0)), range("/both"));
+    EXPECT_FALSE(range("/minonly").first);
+    EXPECT_FALSE(range("/wrongsize").first);
+    EXPECT_FALSE(range("/none").first);
+}
+
+TEST(HDF5VolumeRAMLoader, SlabMinMax) {
+    // Slices of 4 MB as doubles, hence read in slabs of 4 slices aligned to the chunks. Selecting
+    // z from 1 gives slabs of 3, 4 and 2 slices.
+    const size3_t dims{1024, 512, 10};
+    const auto value = [](size_t x, size_t y, size_t z) -> unsigned short {
+        if (x == 0 && y == 0 && z == 0) return 1;      // Not selected
+        if (x == 3 && y == 4 && z == 5) return 60000;  // Maximum in the second slab
+        if (x == 7 && y == 8 && z == 9) return 3;      // Minimum in the last slab
+        return static_cast<unsigned short>(1000 + 10 * z + (x + y) % 7);
+    };
+    util::TempFileHandle tmpFile("hdf5", ".h5");
+    {
+        H5::H5File file(tmpFile.getFileName(), H5F_ACC_TRUNC);
+        writeVolume(file, "/volume", dims, size3_t{64, 64, 4}, value);
+    }
+
+    const hdf5::VolumeRAMLoader loader(tmpFile.getFileName(), hdf5::Path("/volume"),
+                                       {{0, dims.x, 1}, {0, dims.y, 1}, {1, dims.z, 1}},
+                                       DataFloat64::get());
+    dvec2 dataRange;
+    const auto ram = loader.readVolume(&dataRange);
+    EXPECT_EQ(dvec2(3.0, 60000.0), dataRange);
+
+    const size3_t ramDims = ram->getDimensions();
+    ASSERT_EQ(size3_t(dims.x, dims.y, dims.z - 1), ramDims);
+    const auto data = static_cast<const double*>(ram->getData());
+    util::IndexMapper3D im(ramDims);
+    size_t errors = 0;
+    for (size_t z = 0; z < ramDims.z; ++z) {
+        for (size_t y = 0; y < ramDims.y; ++y) {
+            for (size_t x = 0; x < ramDims.x; ++x) {
+                if (data[im(x, y, z)] != value(x, y, z + 1)) ++errors;
+            }
+        }
+    }
+    EXPECT_EQ(0, errors);
+}
+
+TEST(HDF5VolumeRAMLoader, ConcurrentReadsAndHandles) {
+    const size3_t dims{12, 10, 9};
+    util::TempFileHandle tmpFile("hdf5", ".h5");
+    writeIndexVolume(tmpFile.getFileName(), dims);
+
+    const hdf5::VolumeRAMLoader loader(
+        tmpFile.getFileName(), hdf5::Path("/volume"),
+        {{0, dims.x, 1}, {0, dims.y, 1}, {0, dims.z, 1}}, DataUInt16::get());
+    ASSERT_EQ(dims, loader.getDimensions());
+
+    // Threads reading regions through copies of the loader, while others open new loaders and
+    // handles on the same file, all of which call into the library.
+    std::atomic<size_t> errors{0};
+    const auto reader = [&](size_t seed) {
+        const hdf5::VolumeRAMLoader copy(loader);
+        util::IndexMapper3D vm(dims);
+        for (size_t i = 0; i < 20; ++i) {
+            const size3_t offset{(seed + i) % 4, i % 3, (seed * i) % 5};
+            const size3_t regionDims{dims.x - offset.x, 6, 4};
+            std::vector<unsigned short> region(glm::compMul(regionDims));
+            copy.readRegion(offset, regionDims, region.data());
+            util::IndexMapper3D rm(regionDims);
+            for (size_t z = 0; z < regionDims.z; ++z) {
+                for (size_t y = 0; y < regionDims.y; ++y) {
+                    for (size_t x = 0; x < regionDims.x; ++x) {
+                        if (region[rm(x, y, z)] != vm(offset + size3_t(x, y, z))) ++errors;
+                    }
+                }
+            }
+        }
+    };
+    const auto opener = [&]() {
+        for (size_t i = 0; i < 20; ++i) {
+            hdf5::Handle handle(tmpFile.getFileName());
+            hdf5::Handle copy(handle);
+            const hdf5::VolumeRAMLoader other(
+                tmpFile.getFileName(), hdf5::Path("/volume"),
+                {{0, dims.x, 1}, {0, dims.y, 1}, {2, dims.z, 1}}, DataUInt16::get());
+            if (other.getDimensions() != size3_t(dims.x, dims.y, dims.z - 2)) ++errors;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < 3; ++i) threads.emplace_back(reader, i);
+    for (size_t i = 0; i < 2; ++i) threads.emplace_back(opener);
+    for (auto& thread : threads) thread.join();
+
+    EXPECT_EQ(0, errors);
+}
+
+}  // namespace inviwo
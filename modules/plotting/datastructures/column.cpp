@@ -33,6 +33,8 @@ namespace inviwo {
 
 namespace plot {
 
+const DataFormatBase *Column::getDataFormat() const { return getBuffer()->getDataFormat(); }
+
 CategoricalColumn::CategoricalColumn(const std::string &header)
     : TemplateColumn<std::uint32_t>(header) {}
 
@@ -62,12 +64,14 @@ void CategoricalColumn::add(const std::string &value) {
 }
 
 glm::uint32_t CategoricalColumn::addOrGetID(const std::string &str) {
-    auto it = std::find(lookUpTable_.begin(), lookUpTable_.end(), str);
-    if (it != lookUpTable_.end()) {
-        return static_cast<glm::uint32_t>(std::distance(lookUpTable_.begin(), it));
+    auto it = lookUpIndex_.find(str);
+    if (it != lookUpIndex_.end()) {
+        return it->second;
     }
+    const auto id = static_cast<glm::uint32_t>(lookUpTable_.size());
     lookUpTable_.push_back(str);
-    return static_cast<glm::uint32_t>(lookUpTable_.size() - 1);
+    lookUpIndex_.emplace(str, id);
+    return id;
 }
 
 }  // namespace plot
@@ -35,10 +35,16 @@
 
 #include <inviwo/core/datastructures/buffer/buffer.h>
 #include <inviwo/core/datastructures/buffer/bufferram.h>
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
 #include <inviwo/core/util/exception.h>
 
 #include <modules/plotting/datastructures/datapoint.h>
 
+#include <unordered_map>
+#include <functional>
+#include <mutex>
+#include <atomic>
+
 namespace inviwo {
 
 class DataPointBase;
@@ -74,6 +80,12 @@ public:
 
     virtual size_t getSize() const = 0;
 
+    /**
+     * \brief returns the data format of the column values. Unlike getBuffer()->getDataFormat(),
+     * this will not materialize the data of lazily evaluated columns.
+     */
+    virtual const DataFormatBase *getDataFormat() const;
+
     virtual double getAsDouble(size_t idx) const = 0;
     virtual dvec2 getAsDVec2(size_t idx) const = 0;
     virtual dvec3 getAsDVec3(size_t idx) const = 0;
@@ -153,6 +165,8 @@ public:
 
     virtual size_t getSize() const override;
 
+    virtual const DataFormatBase *getDataFormat() const override;
+
 protected:
     std::string header_;
     std::shared_ptr<Buffer<T>> buffer_;
@@ -206,6 +220,96 @@ private:
     virtual glm::uint32_t addOrGetID(const std::string &str);
 
     std::vector<std::string> lookUpTable_;
+    std::unordered_map<std::string, glm::uint32_t> lookUpIndex_;  // string -> index in lookUpTable_
+};
+
+/**
+ * \class ComputedColumn
+ * \brief Data column of type T whose values are computed on access by a generator function
+ * mapping a row index to a value. The generator can be an index expression, i.e. a voxel
+ * position, or be derived from other columns by capturing them.
+ *
+ * No memory is allocated for the values until getBuffer() is called, at which point all values
+ * are evaluated once and cached. Subsequent accesses, including edits through the returned
+ * buffer, will use the cached values. Use forEachChunk() to iterate over all values without
+ * materializing the column.
+ *
+ * \see TemplateColumn
+ */
+template <typename T>
+class ComputedColumn : public Column {
+public:
+    using type = T;
+    using Generator = std::function<T(size_t)>;
+
+    ComputedColumn(const std::string &header, size_t size, Generator generator);
+
+    ComputedColumn(const ComputedColumn<T> &rhs);
+    ComputedColumn<T> &operator=(const ComputedColumn<T> &rhs);
+
+    virtual ComputedColumn *clone() const override;
+
+    virtual ~ComputedColumn() = default;
+
+    virtual const std::string &getHeader() const override;
+    virtual void setHeader(const std::string &header) override;
+
+    /**
+     * \brief computed columns cannot be extended
+     * @throws InvalidConversion
+     */
+    virtual void add(const std::string &value) override;
+
+    T get(size_t idx) const;
+    virtual std::shared_ptr<DataPointBase> get(size_t idx, bool getStringsAsStrings) const override;
+
+    virtual double getAsDouble(size_t idx) const override;
+    virtual dvec2 getAsDVec2(size_t idx) const override;
+    virtual dvec3 getAsDVec3(size_t idx) const override;
+    virtual dvec4 getAsDVec4(size_t idx) const override;
+
+    virtual std::string getAsString(size_t idx) const override;
+
+    /**
+     * \brief evaluates all values into a buffer, which is cached for subsequent calls
+     */
+    virtual std::shared_ptr<BufferBase> getBuffer() override;
+    virtual std::shared_ptr<const BufferBase> getBuffer() const override;
+
+    std::shared_ptr<Buffer<T>> getTypedBuffer();
+    std::shared_ptr<const Buffer<T>> getTypedBuffer() const;
+
+    virtual size_t getSize() const override;
+
+    virtual const DataFormatBase *getDataFormat() const override;
+
+    /**
+     * \brief returns true if the values have been evaluated into a buffer
+     */
+    bool isMaterialized() const;
+
+    /**
+     * \brief iterate over all values in chunks of at most \p chunkSize elements without
+     * materializing the column. The callback is called as callback(offset, data, count) where
+     * \p data points to \p count consecutive values starting at row \p offset.
+     */
+    template <typename Callback>
+    void forEachChunk(size_t chunkSize, Callback callback) const;
+
+private:
+    std::shared_ptr<Buffer<T>> materialize() const;
+    void setBuffer(std::shared_ptr<Buffer<T>> buffer) const;
+
+    std::string header_;
+    size_t size_;
+    Generator generator_;
+
+    mutable std::mutex mutex_;
+    mutable std::atomic<bool> materialized_;
+    mutable std::shared_ptr<Buffer<T>> buffer_;
+    // The RAM representation of buffer_, retrieved once since get() is called per element. Holding
+    // it also keeps it from being evicted.
+    mutable std::shared_ptr<const BufferRAMPrecision<T>> ram_;
 };
 
 template <typename T>
@@ -375,6 +479,186 @@ size_t TemplateColumn<T>::getSize() const {
     return buffer_->getSize();
 }
 
+template <typename T>
+const DataFormatBase *TemplateColumn<T>::getDataFormat() const {
+    return DataFormat<T>::get();
+}
+
+template <typename T>
+ComputedColumn<T>::ComputedColumn(const std::string &header, size_t size, Generator generator)
+    : header_(header), size_(size), generator_(std::move(generator)), materialized_(false) {}
+
+template <typename T>
+ComputedColumn<T>::ComputedColumn(const ComputedColumn<T> &rhs)
+    : header_(rhs.header_), size_(rhs.size_), generator_(rhs.generator_), materialized_(false) {
+    if (rhs.isMaterialized()) {
+        setBuffer(std::shared_ptr<Buffer<T>>(rhs.getTypedBuffer()->clone()));
+        materialized_ = true;
+    }
+}
+
+template <typename T>
+ComputedColumn<T> &ComputedColumn<T>::operator=(const ComputedColumn<T> &rhs) {
+    if (this != &rhs) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        header_ = rhs.header_;
+        size_ = rhs.size_;
+        generator_ = rhs.generator_;
+        if (rhs.isMaterialized()) {
+            setBuffer(std::shared_ptr<Buffer<T>>(rhs.getTypedBuffer()->clone()));
+            materialized_ = true;
+        } else {
+            materialized_ = false;
+            buffer_.reset();
+            ram_.reset();
+        }
+    }
+    return *this;
+}
+
+template <typename T>
+ComputedColumn<T> *ComputedColumn<T>::clone() const {
+    return new ComputedColumn(*this);
+}
+
+template <typename T>
+const std::string &ComputedColumn<T>::getHeader() const {
+    return header_;
+}
+
+template <typename T>
+void ComputedColumn<T>::setHeader(const std::string &header) {
+    header_ = header;
+}
+
+template <typename T>
+void ComputedColumn<T>::add(const std::string &value) {
+    throw InvalidConversion("cannot add values to computed column \"" + header_ + "\" (\"" +
+                            value + "\")");
+}
+
+template <typename T>
+T ComputedColumn<T>::get(size_t idx) const {
+    if (materialized_.load(std::memory_order_acquire)) {
+        return ram_->getDataContainer()[idx];
+    }
+    return generator_(idx);
+}
+
+template <typename T>
+std::shared_ptr<DataPointBase> ComputedColumn<T>::get(size_t idx, bool) const {
+    return std::make_shared<DataPoint<T>>(get(idx));
+}
+
+template <typename T>
+double ComputedColumn<T>::getAsDouble(size_t idx) const {
+    return util::glm_convert<double>(get(idx));
+}
+
+template <typename T>
+dvec2 ComputedColumn<T>::getAsDVec2(size_t idx) const {
+    return util::glm_convert<dvec2>(get(idx));
+}
+
+template <typename T>
+dvec3 ComputedColumn<T>::getAsDVec3(size_t idx) const {
+    return util::glm_convert<dvec3>(get(idx));
+}
+
+template <typename T>
+dvec4 ComputedColumn<T>::getAsDVec4(size_t idx) const {
+    return util::glm_convert<dvec4>(get(idx));
+}
+
+template <typename T>
+std::string ComputedColumn<T>::getAsString(size_t idx) const {
+    std::ostringstream ss;
+    ss << get(idx);
+    return ss.str();
+}
+
+template <typename T>
+std::shared_ptr<BufferBase> ComputedColumn<T>::getBuffer() {
+    return materialize();
+}
+
+template <typename T>
+std::shared_ptr<const BufferBase> ComputedColumn<T>::getBuffer() const {
+    return materialize();
+}
+
+template <typename T>
+std::shared_ptr<Buffer<T>> ComputedColumn<T>::getTypedBuffer() {
+    return materialize();
+}
+
+template <typename T>
+std::shared_ptr<const Buffer<T>> ComputedColumn<T>::getTypedBuffer() const {
+    return materialize();
+}
+
+template <typename T>
+size_t ComputedColumn<T>::getSize() const {
+    if (materialized_.load(std::memory_order_acquire)) {
+        return buffer_->getSize();
+    }
+    return size_;
+}
+
+template <typename T>
+const DataFormatBase *ComputedColumn<T>::getDataFormat() const {
+    return DataFormat<T>::get();
+}
+
+template <typename T>
+bool ComputedColumn<T>::isMaterialized() const {
+    return materialized_.load(std::memory_order_acquire);
+}
+
+template <typename T>
+template <typename Callback>
+void ComputedColumn<T>::forEachChunk(size_t chunkSize, Callback callback) const {
+    chunkSize = std::max(chunkSize, size_t{1});
+    if (materialized_.load(std::memory_order_acquire)) {
+        const auto &data = ram_->getDataContainer();
+        for (size_t offset = 0; offset < data.size(); offset += chunkSize) {
+            callback(offset, data.data() + offset, std::min(chunkSize, data.size() - offset));
+        }
+        return;
+    }
+    std::vector<T> chunk(std::min(chunkSize, size_));
+    for (size_t offset = 0; offset < size_; offset += chunkSize) {
+        const size_t count = std::min(chunkSize, size_ - offset);
+        for (size_t i = 0; i < count; ++i) {
+            chunk[i] = generator_(offset + i);
+        }
+        callback(offset, static_cast<const T *>(chunk.data()), count);
+    }
+}
+
+template <typename T>
+std::shared_ptr<Buffer<T>> ComputedColumn<T>::materialize() const {
+    if (materialized_.load(std::memory_order_acquire)) return buffer_;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!materialized_.load(std::memory_order_relaxed)) {
+        std::vector<T> data(size_);
+        for (size_t i = 0; i < size_; ++i) {
+            data[i] = generator_(i);
+        }
+        setBuffer(util::makeBuffer(std::move(data)));
+        materialized_.store(true, std::memory_order_release);
+    }
+    return buffer_;
+}
+
+template <typename T>
+void ComputedColumn<T>::setBuffer(std::shared_ptr<Buffer<T>> buffer) const {
+    ram_ = std::static_pointer_cast<const BufferRAMPrecision<T>>(
+        buffer->template getRepresentationShared<BufferRAM>());
+    buffer_ = std::move(buffer);
+}
+
 }  // namespace plot
 
 }  // namespace inviwo
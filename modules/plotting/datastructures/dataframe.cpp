@@ -149,7 +149,7 @@ std::vector<std::shared_ptr<Column>>::const_iterator DataFrame::end() const {
 const std::vector<std::pair<std::string, const DataFormatBase *>> DataFrame::getHeaders() const {
     std::vector<std::pair<std::string, const DataFormatBase *>> headers;
     for (const auto &c : columns_) {
-        headers.emplace_back(c->getHeader(), c->getBuffer()->getDataFormat());
+        headers.emplace_back(c->getHeader(), c->getDataFormat());
     }
     return headers;
 }
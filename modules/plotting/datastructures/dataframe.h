@@ -100,6 +100,20 @@ public:
     template <typename T>
     std::shared_ptr<TemplateColumn<T>> addColumn(const std::string &header, size_t size = 0);
 
+    /**
+     * \brief add a lazily evaluated column of type T with \p size rows. Values are computed on
+     * access by calling generator(row) and no memory is allocated for them unless the buffer of
+     * the column is requested.
+     * updateIndexBuffer() needs to be called after all columns have been added before
+     * the DataFrame can be used
+     *
+     * \see ComputedColumn
+     */
+    template <typename T>
+    std::shared_ptr<ComputedColumn<T>> addComputedColumn(
+        const std::string &header, size_t size,
+        typename ComputedColumn<T>::Generator generator);
+
     /**
      * \brief add a categorical column 
      * updateIndexBuffer() needs to be called after all columns have been added before 
@@ -179,6 +193,14 @@ std::shared_ptr<TemplateColumn<T>> DataFrame::addColumn(const std::string &heade
     return col;
 }
 
+template <typename T>
+std::shared_ptr<ComputedColumn<T>> DataFrame::addComputedColumn(
+    const std::string &header, size_t size, typename ComputedColumn<T>::Generator generator) {
+    auto col = std::make_shared<ComputedColumn<T>>(header, size, std::move(generator));
+    columns_.push_back(col);
+    return col;
+}
+
 }  // namespace plot
 
 template <>
@@ -201,8 +223,8 @@ struct DataTraits<plot::DataFrame> {
         const size_t ncols = (data.getNumberOfColumns() > 20) ? 10 : data.getNumberOfColumns();
 
         for (size_t i = 0; i < ncols; i++) {
-            tb2(std::to_string(i + 1), data.getColumn(i)->getBuffer()->getDataFormat()->getString(),
-                data.getColumn(i)->getBuffer()->getSize(), data.getHeader(i));
+            tb2(std::to_string(i + 1), data.getColumn(i)->getDataFormat()->getString(),
+                data.getColumn(i)->getSize(), data.getHeader(i));
         }
         if (ncols != data.getNumberOfColumns()) {
             doc.append("span", "... (" + std::to_string(data.getNumberOfColumns() - ncols) +
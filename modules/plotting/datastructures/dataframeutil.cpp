@@ -101,7 +101,7 @@ std::shared_ptr<plot::DataFrame> combineDataFrames(
 
         for (auto col : first) {
             if (skipIndexColumn && toLower(col->getHeader()) == skipcol) continue;
-            columnType[col->getHeader()] = col->getBuffer()->getDataFormat();
+            columnType[col->getHeader()] = col->getDataFormat();
         }
 
         for (auto df = dataFrames.begin() + 1; df != dataFrames.end(); ++df) {
@@ -116,13 +116,13 @@ std::shared_ptr<plot::DataFrame> combineDataFrames(
                     throw inviwo::Exception(oss.str(),
                                             IvwContextCustom("dataframeutil::combineDataFrames"));
                 }
-                if (it->second != col->getBuffer()->getDataFormat()) {
+                if (it->second != col->getDataFormat()) {
                     if (it == columnType.end()) {
                         std::ostringstream oss;
                         oss << "Column " << col->getHeader()
                             << " has different format in different data frames ("
                             << it->second->getString() << " and "
-                            << col->getBuffer()->getDataFormat()->getSize() << ")";
+                            << col->getDataFormat()->getSize() << ")";
                         throw inviwo::Exception(
                             oss.str(), IvwContextCustom("dataframeutil::combineDataFrames"));
                     }
@@ -64,6 +64,8 @@ CSVSource::CSVSource()
     addProperty(reloadData_);
 
     reloadData_.onChange([&] {});
+
+    getProgressBar().hide();
 }
 
 void CSVSource::process() {
@@ -71,7 +73,9 @@ void CSVSource::process() {
 
     reader.setDelimiters(delimiters_.get());
     reader.setFirstRowHeader(firstRowIsHeaders_.get());
+    reader.setProgressCallback([this](float progress) { updateProgress(progress); });
 
+    getProgressBar().resetProgress();
     data_.setData(reader.readData(inputFile_.get()));
 }
 
@@ -35,6 +35,7 @@
 #include <modules/plotting/datastructures/dataframe.h>
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/processors/processor.h>
+#include <inviwo/core/processors/progressbarowner.h>
 #include <inviwo/core/properties/fileproperty.h>
 #include <inviwo/core/properties/boolproperty.h>
 #include <inviwo/core/ports/dataoutport.h>
@@ -57,7 +58,7 @@ namespace plot {
  *   * __Delimiters__          defines the delimiter between values (default ',')
  */
 
-class IVW_MODULE_PLOTTING_API CSVSource : public Processor {
+class IVW_MODULE_PLOTTING_API CSVSource : public Processor, public ProgressBarOwner {
 public:
     CSVSource();
     virtual ~CSVSource() = default;
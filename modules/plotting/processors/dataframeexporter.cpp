@@ -110,7 +110,7 @@ void DataFrameExporter::exportAsCSV(bool separateVectorTypesIntoColumns) {
     // headers
     auto oj = util::make_ostream_joiner(file, delimiter);
     for (const auto& col : *dataFrame) {
-        const auto components = col->getBuffer()->getDataFormat()->getComponents();
+        const auto components = col->getDataFormat()->getComponents();
         if (components > 1 && separateVectorTypesIntoColumns) {
             for (size_t k = 0; k < components; k++) {
                 oj = col->getHeader() + ' ' + componentNames[k];
@@ -123,7 +123,7 @@ void DataFrameExporter::exportAsCSV(bool separateVectorTypesIntoColumns) {
 
     std::vector<std::function<void(std::ostream&, size_t)>> printers;
     for (const auto& col : *dataFrame) {
-        auto df = col->getBuffer()->getDataFormat();
+        auto df = col->getDataFormat();
         if (auto cc = dynamic_cast<const CategoricalColumn*>(col.get())) {
             printers.push_back([cc](std::ostream& os, size_t index) {
                 os << "\"" << cc->getAsString(index) << "\"";
@@ -30,6 +30,7 @@
 #include <modules/plotting/processors/volumetodataframe.h>
 #include <inviwo/core/datastructures/volume/volumeram.h>
 #include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/indexmapper.h>
 
 namespace inviwo {
 
@@ -82,80 +83,65 @@ void VolumeToDataFrame::process() {
     const auto volume = inport_.getData();
     switch (mode_.get()) {
         case Mode::Analytics: {
-            const auto size = (rangeX_.getEnd() - rangeX_.getStart()) *
-                              (rangeY_.getEnd() - rangeY_.getStart()) *
-                              (rangeZ_.getEnd() - rangeZ_.getStart());
+            // All columns are computed lazily from the volume data, no per-voxel memory is
+            // allocated until a consumer requests the buffer of a column.
+            const size3_t start{rangeX_.getStart(), rangeY_.getStart(), rangeZ_.getStart()};
+            const size3_t extent{rangeX_.getEnd() - rangeX_.getStart(),
+                                 rangeY_.getEnd() - rangeY_.getStart(),
+                                 rangeZ_.getEnd() - rangeZ_.getStart()};
+            const auto size = extent.x * extent.y * extent.z;
+
+            // map a row of the data frame to a voxel index, x varying fastest
+            const auto toIndex = [start, extent](size_t row) {
+                return start + size3_t{row % extent.x, (row / extent.x) % extent.y,
+                                       row / (extent.x * extent.y)};
+            };
 
             auto dataFrame = std::make_shared<plot::DataFrame>(static_cast<glm::u32>(size));
-            std::vector<std::vector<float>*> channelBuffer_;
-            const auto numCh = volume->getDataFormat()->getComponents();
-            for (size_t c = 0; c < numCh; c++) {
-                auto col = dataFrame->addColumn<float>("Channel " + toString(c + 1), size);
-                channelBuffer_.push_back(
-                    &col->getTypedBuffer()->getEditableRAMRepresentation()->getDataContainer());
-            }
-            auto& magnitudes = dataFrame->addColumn<float>("Magnitude", size)
-                                   ->getTypedBuffer()
-                                   ->getEditableRAMRepresentation()
-                                   ->getDataContainer();
-            auto& indx = dataFrame->addColumn<int>("Index X", size)
-                             ->getTypedBuffer()
-                             ->getEditableRAMRepresentation()
-                             ->getDataContainer();
-            auto& indy = dataFrame->addColumn<int>("Index Y", size)
-                             ->getTypedBuffer()
-                             ->getEditableRAMRepresentation()
-                             ->getDataContainer();
-            auto& indz = dataFrame->addColumn<int>("Index Z", size)
-                             ->getTypedBuffer()
-                             ->getEditableRAMRepresentation()
-                             ->getDataContainer();
-            auto& posx = dataFrame->addColumn<float>("Position X", size)
-                             ->getTypedBuffer()
-                             ->getEditableRAMRepresentation()
-                             ->getDataContainer();
-            auto& posy = dataFrame->addColumn<float>("Position Y", size)
-                             ->getTypedBuffer()
-                             ->getEditableRAMRepresentation()
-                             ->getDataContainer();
-            auto& posz = dataFrame->addColumn<float>("Position Z", size)
-                             ->getTypedBuffer()
-                             ->getEditableRAMRepresentation()
-                             ->getDataContainer();
-
-            const auto indexToModel = volume->getCoordinateTransformer().getIndexToModelMatrix();
 
-            volume->getRepresentation<VolumeRAM>()->dispatch<void>([&](auto vr) {
-                const auto im = util::IndexMapper3D(vr->getDimensions());
+            const auto ram = volume->getRepresentationShared<VolumeRAM>();
+            ram->dispatch<void>([&](auto vr) {
                 using ValueType = util::PrecsionValueType<decltype(vr)>;
-                const auto data = vr->getDataTyped();
-                auto i = 0;
-                size3_t ind;
-                for (ind.z = rangeZ_.getStart(); ind.z < rangeZ_.getEnd(); ind.z++) {
-                    for (ind.y = rangeY_.getStart(); ind.y < rangeY_.getEnd(); ind.y++) {
-                        for (ind.x = rangeX_.getStart(); ind.x < rangeX_.getEnd(); ind.x++) {
-                            const auto v = util::glm_convert<dvec4>(data[im(ind)]);
-                            double m = 0.0;
-                            for (size_t c = 0; c < DataFormat<ValueType>::comp; c++) {
-                                (*channelBuffer_[c])[i] = static_cast<float>(v[c]);
-                                m += v[c] * v[c];
-                            }
-                            magnitudes[i] = static_cast<float>(std::sqrt(m));
+                using PrecisionType = typename std::remove_pointer<decltype(vr)>::type;
+                const auto im = util::IndexMapper3D(vr->getDimensions());
+                // Read through the shared representation, it owns the data the columns refer to
+                const auto typed = std::static_pointer_cast<PrecisionType>(ram);
+                const auto value = [typed, im, toIndex](size_t row) {
+                    return util::glm_convert<dvec4>(typed->getDataTyped()[im(toIndex(row))]);
+                };
+
+                for (size_t c = 0; c < DataFormat<ValueType>::comp; c++) {
+                    dataFrame->addComputedColumn<float>(
+                        "Channel " + toString(c + 1), size,
+                        [value, c](size_t row) { return static_cast<float>(value(row)[c]); });
+                }
+                dataFrame->addComputedColumn<float>("Magnitude", size, [value](size_t row) {
+                    const auto v = value(row);
+                    double m = 0.0;
+                    for (size_t c = 0; c < DataFormat<ValueType>::comp; c++) {
+                        m += v[c] * v[c];
+                    }
+                    return static_cast<float>(std::sqrt(m));
+                });
+            });
 
-                            indx[i] = static_cast<int>(ind.x);
-                            indy[i] = static_cast<int>(ind.y);
-                            indz[i] = static_cast<int>(ind.z);
+            for (size_t i = 0; i < 3; ++i) {
+                const std::string name = std::string("Index ") + "XYZ"[i];
+                dataFrame->addComputedColumn<int>(name, size, [toIndex, i](size_t row) {
+                    return static_cast<int>(toIndex(row)[i]);
+                });
+            }
 
-                            const dvec3 pos{indexToModel * dvec4{ind, 1}};
+            const auto indexToModel = volume->getCoordinateTransformer().getIndexToModelMatrix();
+            for (size_t i = 0; i < 3; ++i) {
+                const std::string name = std::string("Position ") + "XYZ"[i];
+                dataFrame->addComputedColumn<float>(
+                    name, size, [toIndex, indexToModel, i](size_t row) {
+                        const dvec3 pos{indexToModel * dvec4{toIndex(row), 1}};
+                        return static_cast<float>(pos[i]);
+                    });
+            }
 
-                            posx[i] = static_cast<float>(pos.x);
-                            posy[i] = static_cast<float>(pos.y);
-                            posz[i] = static_cast<float>(pos.z);
-                            ++i;
-                        }
-                    }
-                }
-            });
             outport_.setData(dataFrame);
             break;
         }
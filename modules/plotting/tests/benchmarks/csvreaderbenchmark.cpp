@@ -0,0 +1,103 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2013-2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/io/tempfilehandle.h>
+#include <modules/plotting/utils/csvreader.h>
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <fstream>
+#include <random>
+
+using namespace inviwo;
+
+namespace {
+
+/**
+ * CSV data with a header, four float columns and one categorical column
+ */
+std::string makeCSV(size_t rows, bool quoted) {
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<float> dist(-1000.0f, 1000.0f);
+    const std::array<std::string, 4> categories = {"alpha", "beta", "gamma", "delta"};
+
+    std::ostringstream oss;
+    oss << "x,y,z,w,category\n";
+    for (size_t i = 0; i < rows; ++i) {
+        oss << dist(gen) << "," << dist(gen) << "," << dist(gen) << "," << dist(gen) << ",";
+        if (quoted) {
+            oss << "\"" << categories[i % categories.size()] << "\"\n";
+        } else {
+            oss << categories[i % categories.size()] << "\n";
+        }
+    }
+    return oss.str();
+}
+
+void readStream(benchmark::State& state, bool quoted) {
+    const auto csv = makeCSV(static_cast<size_t>(state.range(0)), quoted);
+    CSVReader reader;
+
+    for (auto _ : state) {
+        std::istringstream in(csv);
+        auto dataframe = reader.readData(in);
+        benchmark::DoNotOptimize(dataframe->getNumberOfRows());
+    }
+    state.SetBytesProcessed(state.iterations() * csv.size());
+}
+
+}  // namespace
+
+static void CSVReadStream(benchmark::State& state) { readStream(state, false); }
+
+static void CSVReadStreamQuoted(benchmark::State& state) { readStream(state, true); }
+
+static void CSVReadFile(benchmark::State& state) {
+    const auto csv = makeCSV(static_cast<size_t>(state.range(0)), false);
+    util::TempFileHandle file("benchmark", ".csv");
+    {
+        std::ofstream out(file.getFileName(), std::ios::out | std::ios::binary);
+        out << csv;
+    }
+    CSVReader reader;
+
+    for (auto _ : state) {
+        auto dataframe = reader.readData(file.getFileName());
+        benchmark::DoNotOptimize(dataframe->getNumberOfRows());
+    }
+    state.SetBytesProcessed(state.iterations() * csv.size());
+}
+
+BENCHMARK(CSVReadStream)->RangeMultiplier(10)->Range(100, 1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(CSVReadStreamQuoted)
+    ->RangeMultiplier(10)
+    ->Range(100, 1000000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(CSVReadFile)->RangeMultiplier(10)->Range(100, 1000000)->Unit(benchmark::kMillisecond);
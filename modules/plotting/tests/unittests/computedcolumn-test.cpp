@@ -0,0 +1,117 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/plotting/datastructures/dataframe.h>
+
+namespace inviwo {
+
+namespace plot {
+
+TEST(ComputedColumnTest, ComputesValuesOnAccess) {
+    size_t calls = 0;
+    ComputedColumn<float> col("square", 10, [&calls](size_t i) {
+        ++calls;
+        return static_cast<float>(i * i);
+    });
+
+    EXPECT_EQ(10u, col.getSize());
+    EXPECT_EQ(DataFormat<float>::get(), col.getDataFormat());
+    EXPECT_EQ(0u, calls);
+    EXPECT_FALSE(col.isMaterialized());
+
+    EXPECT_FLOAT_EQ(9.0f, col.get(3));
+    EXPECT_DOUBLE_EQ(16.0, col.getAsDouble(4));
+    EXPECT_EQ("25", col.getAsString(5));
+    EXPECT_EQ(3u, calls);
+    EXPECT_FALSE(col.isMaterialized());
+}
+
+TEST(ComputedColumnTest, MaterializesBufferOnce) {
+    size_t calls = 0;
+    ComputedColumn<int> col("index", 5, [&calls](size_t i) {
+        ++calls;
+        return static_cast<int>(i) + 1;
+    });
+
+    auto buffer = col.getTypedBuffer();
+    EXPECT_TRUE(col.isMaterialized());
+    EXPECT_EQ(5u, calls);
+    EXPECT_EQ(buffer, col.getBuffer());
+    EXPECT_EQ(5u, calls);
+
+    const auto& data = buffer->getRAMRepresentation()->getDataContainer();
+    EXPECT_EQ((std::vector<int>{1, 2, 3, 4, 5}), data);
+
+    // edits of the materialized buffer are visible through the column
+    buffer->getEditableRAMRepresentation()->set(2, 42);
+    EXPECT_EQ(42, col.get(2));
+    EXPECT_EQ(5u, calls);
+}
+
+TEST(ComputedColumnTest, ForEachChunk) {
+    ComputedColumn<double> col("half", 10, [](size_t i) { return 0.5 * i; });
+
+    std::vector<double> values;
+    std::vector<size_t> offsets;
+    col.forEachChunk(4, [&](size_t offset, const double* data, size_t count) {
+        offsets.push_back(offset);
+        values.insert(values.end(), data, data + count);
+    });
+
+    EXPECT_FALSE(col.isMaterialized());
+    EXPECT_EQ((std::vector<size_t>{0, 4, 8}), offsets);
+    ASSERT_EQ(10u, values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        EXPECT_DOUBLE_EQ(0.5 * i, values[i]);
+    }
+}
+
+TEST(ComputedColumnTest, DataFrameCopy) {
+    DataFrame dataFrame(4);
+    dataFrame.addComputedColumn<float>("value", 4, [](size_t i) { return 2.0f * i; });
+    dataFrame.updateIndexBuffer();
+
+    EXPECT_EQ(4u, dataFrame.getNumberOfRows());
+    EXPECT_EQ(DataFormat<float>::get(), dataFrame.getHeaders()[1].second);
+
+    DataFrame copy(dataFrame);
+    auto col = std::dynamic_pointer_cast<const ComputedColumn<float>>(copy.getColumn(1));
+    ASSERT_TRUE(col != nullptr);
+    EXPECT_FALSE(col->isMaterialized());
+    EXPECT_DOUBLE_EQ(6.0, col->getAsDouble(3));
+}
+
+}  // namespace plot
+
+}  // namespace inviwo
@@ -36,6 +36,9 @@
 #include <modules/plotting/utils/csvreader.h>
 
 #include <sstream>
+#include <algorithm>
+#include <string>
+#include <vector>
 
 namespace inviwo {
 
@@ -449,4 +452,79 @@ TEST(CSVlinebreaks, mixed) {
     ASSERT_EQ(4, dataframe->getNumberOfRows()) << "row count does not match";
 }
 
+TEST(CSVdata, floatsRoundedOnce) {
+    // Rounding these to double first gives a value exactly halfway between two floats, and
+    // rounding that to float again gives a different float than std::stof
+    const std::vector<std::string> numbers{"18.77647113800049", "72.69191360473633",
+                                           "4.196024656295776", "-0.15625", "1e-3", "123456789"};
+    std::ostringstream oss;
+    for (const auto& number : numbers) oss << number << "\n";
+    std::istringstream ss(oss.str());
+
+    CSVReader reader;
+    reader.setFirstRowHeader(false);
+    auto dataframe = reader.readData(ss);
+    ASSERT_EQ(numbers.size(), dataframe->getNumberOfRows()) << "row count does not match";
+
+    auto column = std::dynamic_pointer_cast<const plot::TemplateColumn<float>>(
+        dataframe->getColumn(1));
+    ASSERT_TRUE(column != nullptr) << "column 1 is not a float column";
+    const auto& values = column->getTypedBuffer()->getRAMRepresentation()->getDataContainer();
+    for (size_t i = 0; i < numbers.size(); ++i) {
+        EXPECT_EQ(std::stof(numbers[i]), values[i]) << numbers[i];
+    }
+}
+
+TEST(CSVlarge, values) {
+    const size_t rows = 100000;
+    std::ostringstream oss;
+    oss << "index,value,category\r\n";
+    for (size_t i = 0; i < rows; ++i) {
+        oss << i << ",-" << i / 4 << "." << (i % 4) * 25 << "e1,cat" << (i % 7) << "\r\n";
+    }
+    std::istringstream ss(oss.str());
+
+    CSVReader reader;
+    auto dataframe = reader.readData(ss);
+
+    ASSERT_EQ(4, dataframe->getNumberOfColumns()) << "column count does not match";
+    ASSERT_EQ(rows, dataframe->getNumberOfRows()) << "row count does not match";
+
+    auto index = std::dynamic_pointer_cast<const plot::TemplateColumn<float>>(
+        dataframe->getColumn(1));
+    auto value = std::dynamic_pointer_cast<const plot::TemplateColumn<float>>(
+        dataframe->getColumn(2));
+    ASSERT_TRUE(index != nullptr) << "column 1 is not a float column";
+    ASSERT_TRUE(value != nullptr) << "column 2 is not a float column";
+    const auto& indices = index->getTypedBuffer()->getRAMRepresentation()->getDataContainer();
+    const auto& values = value->getTypedBuffer()->getRAMRepresentation()->getDataContainer();
+    for (size_t i = 0; i < rows; ++i) {
+        ASSERT_EQ(static_cast<float>(i), indices[i]) << "row " << i;
+        ASSERT_EQ(static_cast<float>(-2.5 * static_cast<double>(i)), values[i]) << "row " << i;
+    }
+    EXPECT_EQ("cat0", dataframe->getColumn(3)->getAsString(0)) << "Column 3";
+    const auto category = "cat" + std::to_string((rows - 4) % 7);
+    EXPECT_EQ(category, dataframe->getColumn(3)->getAsString(rows - 4)) << "Column 3";
+}
+
+TEST(CSVlarge, progress) {
+    std::ostringstream oss;
+    for (size_t i = 0; i < 200000; ++i) {
+        oss << i << ";" << 2 * i << "\n";
+    }
+    std::istringstream ss(oss.str());
+
+    std::vector<float> progress;
+    CSVReader reader;
+    reader.setFirstRowHeader(false);
+    reader.setDelimiters(";");
+    reader.setProgressCallback([&](float p) { progress.push_back(p); });
+    auto dataframe = reader.readData(ss);
+
+    ASSERT_EQ(200000, dataframe->getNumberOfRows()) << "row count does not match";
+    ASSERT_FALSE(progress.empty()) << "no progress reported";
+    EXPECT_TRUE(std::is_sorted(progress.begin(), progress.end())) << "progress not monotonic";
+    EXPECT_EQ(1.0f, progress.back()) << "progress not finished";
+}
+
 }  // namespace inviwo
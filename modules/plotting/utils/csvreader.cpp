@@ -31,177 +31,372 @@
 
 #include <modules/plotting/datastructures/column.h>
 #include <modules/plotting/datastructures/dataframe.h>
+#include <inviwo/core/util/foreach.h>
+#include <inviwo/core/io/memorymappedfile.h>
 #include <inviwo/core/util/filesystem.h>
 
 #include <fstream>
+#include <array>
+#include <cstring>
+#include <cfloat>
+#include <cctype>
+#include <locale>
+#include <numeric>
+#include <sstream>
 
 namespace inviwo {
 
-CSVDataReaderException::CSVDataReaderException(const std::string& message, ExceptionContext context)
-    : DataReaderException("CSVReader: " + message, context) {}
+namespace {
 
-CSVReader::CSVReader() : delimiters_(","), firstRowHeader_(true) {}
+enum class Terminator { Delimiter, LineBreak, End };
 
-CSVReader* CSVReader::clone() const { return new CSVReader(*this); }
+/**
+ * View of a single field within the CSV data, i.e. no characters are copied. Enclosing quotes
+ * are part of the field.
+ */
+struct Field {
+    const char* begin;
+    const char* end;
+    Terminator terminator;
+    bool hasCR;  // field contains quoted CR or CRLF line breaks, which are converted to LF
 
-void CSVReader::setDelimiters(const std::string& delim) { delimiters_ = delim; }
+    bool empty() const { return begin == end; }
 
-void CSVReader::setFirstRowHeader(bool hasHeader) { firstRowHeader_ = hasHeader; }
-
-std::shared_ptr<plot::DataFrame> CSVReader::readData(const std::string& fileName) {
-    auto file = filesystem::ifstream(fileName);
-
-    if (!file.is_open()) {
-        throw FileException(std::string("CSVReader: Could not open file \"" + fileName + "\"."),
-                            IvwContext);
+    void assignTo(std::string& value) const {
+        if (!hasCR) {
+            value.assign(begin, end);
+            return;
+        }
+        value.clear();
+        for (auto it = begin; it != end; ++it) {
+            if (*it == '\r') {
+                if ((it + 1 != end) && (it[1] == '\n')) ++it;
+                value += '\n';
+            } else {
+                value += *it;
+            }
+        }
     }
-    file.seekg(0, std::ios::end);
-    std::streampos len = file.tellg();
-    file.seekg(0, std::ios::beg);
-
-    if (len == std::streampos(0)) {
-        throw CSVDataReaderException("Empty file, no data", IvwContext);
+    std::string str() const {
+        std::string value;
+        assignTo(value);
+        return value;
     }
+};
 
-    return readData(file);
-}
-
-std::shared_ptr<plot::DataFrame> CSVReader::readData(std::istream& stream) const {
-    if (stream.bad() || stream.fail()) {
-        throw CSVDataReaderException("Input stream in a bad state", IvwContext);
+// Line number of pos, line breaks are either LF, CR, or CRLF
+size_t lineNumber(const char* data, const char* pos) {
+    size_t line = 1u;
+    for (auto it = data; it < pos; ++it) {
+        if (*it == '\r') {
+            if ((it + 1 < pos) && (it[1] == '\n')) ++it;
+            ++line;
+        } else if (*it == '\n') {
+            ++line;
+        }
     }
+    return line;
+}
 
-    // create a string stream from input stream for buffering
-    std::stringstream in;
-    in << stream.rdbuf();
-    if (in.fail()) {
-        throw CSVDataReaderException("No data", IvwContext);
+class Tokenizer {
+public:
+    /**
+     * Tokenizer for the range [begin, end). data refers to the beginning of the entire CSV data
+     * and is used to determine line numbers for error messages.
+     */
+    Tokenizer(const char* data, const char* begin, const char* end, const std::string& delims)
+        : data_(data), pos_(begin), end_(end) {
+        isDelim_.fill(false);
+        for (auto ch : delims) {
+            isDelim_[static_cast<unsigned char>(ch)] = true;
+        }
     }
 
-    // current line
-    size_t lineNumber = 1u;
+    const char* data() const { return data_; }
+    const char* pos() const { return pos_; }
 
-    // extract exactly one field from the current stream position, the bool return value indicates
-    // whether a line break was detected following the field
-    auto extractField = [&in, &lineNumber, delims = delimiters_ ]()->std::pair<std::string, bool> {
-        std::string value;
+    // extract exactly one field from the current position
+    Field next() {
+        const char* begin = pos_;
         size_t quoteCount = 0;
-        size_t quoteBeginLine = 0;
+        const char* quoteBegin = nullptr;
         char prev = 0;
+        bool hasCR = false;
 
-        auto isLineBreak = [](const char ch, std::istream& stream) {
+        while (pos_ != end_) {
+            const char* current = pos_++;
+            char ch = *current;
+            bool linebreak = false;
             if (ch == '\r') {
                 // consume potential LF (\n) following CR (\r)
-                if (stream.peek() == '\n') {
-                    stream.get();
-                }
-                return true;
+                if ((pos_ != end_) && (*pos_ == '\n')) ++pos_;
+                linebreak = true;
             } else {
-                return (ch == '\n');
+                linebreak = (ch == '\n');
             }
-        };
-
-        char ch;
-        while (in.get(ch) && in.good()) {
-            bool linebreak = isLineBreak(ch, in);
             if (linebreak) {
-                ++lineNumber;  // increase line counter
-                // ensure that ch is equal to '\n'
-                ch = '\n';
-                // consume line break, if inside quotes
+                // keep line break, if inside quotes
                 if ((quoteCount & 1) != 0) {
-                    value += ch;
-                    prev = ch;
+                    hasCR |= (ch == '\r');
+                    prev = '\n';
                     continue;
                 }
+                ch = '\n';
             }
             if (ch == '"') {  // found a quote
-                if (quoteCount == 0) quoteBeginLine = lineNumber;
+                if (quoteCount == 0) quoteBegin = current;
                 ++quoteCount;
-            } else if (util::contains(delims, ch) || linebreak) {
+            } else if (isDelim_[static_cast<unsigned char>(ch)] || linebreak) {
                 // found a delimiter/newline, ensure that it isn't enclosed by quotes,
                 // i.e. a quote count of 0 or an even count of quotes if the previous
                 // character was a quote
                 if ((quoteCount == 0) || ((prev == '"') && ((quoteCount & 1) == 0))) {
-                    return {value, linebreak};
+                    return {begin, current,
+                            linebreak ? Terminator::LineBreak : Terminator::Delimiter, hasCR};
                 }
             }
             prev = ch;
-            value += ch;
         }
-        if (((quoteCount & 1) != 0) && in.eof()) {
+        if ((quoteCount & 1) != 0) {
             throw CSVDataReaderException("Unmatched quotes (starting in line " +
-                                         std::to_string(quoteBeginLine) + ")");
+                                         std::to_string(lineNumber(data_, quoteBegin)) + ")");
         }
-        return {value, false};
-    };
+        return {begin, end_, Terminator::End, hasCR};
+    }
 
-    // extract one row from the current stream position, the bool return value indicates whether
-    // the end-of-file was detected
-    auto extractRow = [&in, extractField,
-                       &lineNumber](size_t maxColCount = std::numeric_limits<size_t>::max())
-        -> std::pair<std::vector<std::string>, bool> {
-        auto val = extractField();
-        if (in.eof() && val.first.empty()) {
-            // reached end of file, no more data
-            return {{}, true};
-        } else if (val.first.empty() && val.second) {
-            // empty line, ignore
-            return {{}, false};
-        }
-        std::vector<std::string> values;
-        values.push_back(val.first);
-        while (!val.second && !in.eof()) {
-            val = extractField();
-            values.push_back(val.first);
-        }
-        // ignore last field _if_ it is empty and would be inserted in the maxColCount+1 column
-        if (values.back().empty() && (values.size() - 1 == maxColCount)) {
-            values.resize(values.size() - 1);
-        } else if ((values.size() != maxColCount) &&
-                   (maxColCount != std::numeric_limits<size_t>::max())) {
-            // mismatch in the number of columns
-            throw CSVDataReaderException("Column counts do not match (line " +
-                                         std::to_string(lineNumber) + ": " +
-                                         std::to_string(values.size()) + " fields; DataFrame has " +
-                                         std::to_string(maxColCount) + " columns)");
-        }
-        return {values, false};
-    };
+private:
+    const char* data_;
+    const char* pos_;
+    const char* end_;
+    std::array<bool, 256> isDelim_;
+};
+
+enum class RowStatus { Row, EmptyLine, End };
+
+// extract one row from the current position of the tokenizer into row
+RowStatus extractRow(Tokenizer& tokenizer, std::vector<Field>& row,
+                     size_t maxColCount = std::numeric_limits<size_t>::max()) {
+    const char* rowBegin = tokenizer.pos();
+    auto field = tokenizer.next();
+    if (field.empty() && (field.terminator == Terminator::End)) {
+        // reached end of data
+        return RowStatus::End;
+    } else if (field.empty() && (field.terminator == Terminator::LineBreak)) {
+        // empty line, ignore
+        return RowStatus::EmptyLine;
+    }
+    row.clear();
+    row.push_back(field);
+    while (field.terminator == Terminator::Delimiter) {
+        field = tokenizer.next();
+        row.push_back(field);
+    }
+    // ignore last field _if_ it is empty and would be inserted in the maxColCount+1 column
+    if (row.back().empty() && (row.size() - 1 == maxColCount)) {
+        row.pop_back();
+    } else if ((row.size() != maxColCount) &&
+               (maxColCount != std::numeric_limits<size_t>::max())) {
+        // mismatch in the number of columns
+        throw CSVDataReaderException(
+            "Column counts do not match (line " +
+            std::to_string(lineNumber(tokenizer.data(), rowBegin)) + ": " +
+            std::to_string(row.size()) + " fields; DataFrame has " +
+            std::to_string(maxColCount) + " columns)");
+    }
+    return RowStatus::Row;
+}
+
+bool isDigit(char ch) { return (ch >= '0') && (ch <= '9'); }
+
+/**
+ * Parse a floating point number in the same way as std::istream >> float using the "C" locale,
+ * i.e. leading whitespace is skipped and trailing characters are ignored. Returns NaN if the
+ * field does not start with a number. Numbers which can be represented exactly by a double
+ * mantissa and a power of ten are converted directly, others are passed on to a stream.
+ * The direct conversion rounds to double and then to float. This equals rounding straight to
+ * float, as std::stof does, unless the double is exactly halfway between two floats, since the
+ * halfway points are doubles themselves. Such numbers are passed on to the stream as well.
+ */
+float parseFloat(const char* begin, const char* end) {
+    static const double powers[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                    1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                    1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+
+    auto it = begin;
+    while ((it != end) && std::isspace(static_cast<unsigned char>(*it))) ++it;
+    const char* numberBegin = it;
+
+    bool negative = false;
+    if ((it != end) && ((*it == '+') || (*it == '-'))) {
+        negative = (*it == '-');
+        ++it;
+    }
+    std::uint64_t mantissa = 0;
+    int digits = 0;  // significant digits in mantissa
+    int exponent = 0;
+    bool hasDigits = false;
+    bool exact = true;
+    for (; (it != end) && isDigit(*it); ++it) {
+        hasDigits = true;
+        if (digits < 19) {
+            mantissa = mantissa * 10 + static_cast<std::uint64_t>(*it - '0');
+            if (mantissa != 0) ++digits;
+        } else {
+            ++exponent;
+            exact &= (*it == '0');
+        }
+    }
+    if ((it != end) && (*it == '.')) {
+        for (++it; (it != end) && isDigit(*it); ++it) {
+            hasDigits = true;
+            if (digits < 19) {
+                mantissa = mantissa * 10 + static_cast<std::uint64_t>(*it - '0');
+                if (mantissa != 0) ++digits;
+                --exponent;
+            } else {
+                exact &= (*it == '0');
+            }
+        }
+    }
+    if (!hasDigits) return nan;
+    if ((it != end) && ((*it == 'e') || (*it == 'E'))) {
+        ++it;
+        bool negativeExp = false;
+        if ((it != end) && ((*it == '+') || (*it == '-'))) {
+            negativeExp = (*it == '-');
+            ++it;
+        }
+        if ((it == end) || !isDigit(*it)) return nan;
+        int exp = 0;
+        for (; (it != end) && isDigit(*it); ++it) {
+            if (exp < 100000) exp = exp * 10 + (*it - '0');
+        }
+        exponent += negativeExp ? -exp : exp;
+    }
+
+    if (exact && (mantissa < (std::uint64_t{1} << 53)) && (exponent >= -22) && (exponent <= 22)) {
+        double value = static_cast<double>(mantissa);
+        value = (exponent < 0) ? value / powers[-exponent] : value * powers[exponent];
+        if (value > FLT_MAX) return nan;
+        // the 29 lowest mantissa bits are dropped when rounding a double to a normalized float
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        const bool halfway = (bits & 0x1fffffff) == 0x10000000;
+        if (!halfway && ((value >= FLT_MIN) || (value == 0.0))) {
+            return static_cast<float>(negative ? -value : value);
+        }
+    }
+
+    std::istringstream stream(std::string(numberBegin, it));
+    stream.imbue(std::locale::classic());
+    float result;
+    stream >> result;
+    return stream.fail() ? nan : result;
+}
+
+// Parsed rows of a consecutive range of the CSV data, stored column by column
+struct Chunk {
+    std::vector<std::vector<float>> floats;  // values of float columns
+    std::vector<std::vector<Field>> fields;  // fields of all other columns
+    size_t rows = 0;
+};
+
+}  // namespace
+
+CSVDataReaderException::CSVDataReaderException(const std::string& message, ExceptionContext context)
+    : DataReaderException("CSVReader: " + message, context) {}
+
+CSVReader::CSVReader() : delimiters_(","), firstRowHeader_(true) {}
+
+CSVReader* CSVReader::clone() const { return new CSVReader(*this); }
+
+void CSVReader::setDelimiters(const std::string& delim) { delimiters_ = delim; }
+
+void CSVReader::setFirstRowHeader(bool hasHeader) { firstRowHeader_ = hasHeader; }
+
+void CSVReader::setProgressCallback(std::function<void(float)> callback) {
+    progress_ = std::move(callback);
+}
+
+std::shared_ptr<plot::DataFrame> CSVReader::readData(const std::string& fileName) {
+    auto file = filesystem::ifstream(fileName);
+
+    if (!file.is_open()) {
+        throw FileException(std::string("CSVReader: Could not open file \"" + fileName + "\"."),
+                            IvwContext);
+    }
+    file.seekg(0, std::ios::end);
+    std::streampos len = file.tellg();
+    file.seekg(0, std::ios::beg);
+
+    if (len == std::streampos(0)) {
+        throw CSVDataReaderException("Empty file, no data", IvwContext);
+    }
+
+    std::unique_ptr<util::MemoryMappedFile> mapped;
+    try {
+        mapped = util::make_unique<util::MemoryMappedFile>(fileName, 0, static_cast<size_t>(len));
+    } catch (const FileException&) {
+        // mapping not possible, read the file into memory instead
+    }
+    if (mapped) {
+        const auto data = static_cast<const char*>(mapped->getData());
+        return parse(data, data + mapped->getSize());
+    }
+    return readData(file);
+}
+
+std::shared_ptr<plot::DataFrame> CSVReader::readData(std::istream& stream) const {
+    if (stream.bad() || stream.fail()) {
+        throw CSVDataReaderException("Input stream in a bad state", IvwContext);
+    }
+
+    std::string data{std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+    if (data.empty()) {
+        throw CSVDataReaderException("No data", IvwContext);
+    }
+    return parse(data.data(), data.data() + data.size());
+}
+
+std::shared_ptr<plot::DataFrame> CSVReader::parse(const char* begin, const char* end) const {
+    Tokenizer tokenizer(begin, begin, end, delimiters_);
+    std::vector<Field> row;
 
     std::vector<std::string> headers;
     size_t maxColCount = std::numeric_limits<size_t>::max();
     if (firstRowHeader_) {
         // read headers
-        auto row = extractRow();
-        if (row.second || row.first.empty()) {
+        if (extractRow(tokenizer, row) != RowStatus::Row) {
             throw CSVDataReaderException("Empty file, column headers not found");
         }
-        headers = row.first;
+        for (const auto& field : row) {
+            headers.push_back(field.str());
+        }
         maxColCount = headers.size();
     }
 
+    const char* dataBegin = tokenizer.pos();
+
     std::vector<std::vector<std::string>> exampleRows;
-    std::vector<size_t> exampleLineNumbers;  // line numbers matching the example rows
-    std::streampos streamPos = in.tellg();
+    std::vector<const char*> exampleRowPositions;  // positions of the example rows for line numbers
     for (auto exampleRow = 0u; exampleRow < 50u; ++exampleRow) {
-        size_t currentLine = lineNumber;
-        auto row = extractRow(maxColCount);
-        if (row.second) {
-            // reached end-of-file
-            if (exampleRow == 0) {
-                throw CSVDataReaderException("Empty file, no data");
-            }
-            in.clear();  // clear eof-bit
+        const char* rowBegin = tokenizer.pos();
+        const auto status = extractRow(tokenizer, row, maxColCount);
+        if (status == RowStatus::End) {
             break;
-        } else if (!row.first.empty()) {  // ignore empty lines
-            exampleRows.emplace_back(row.first);
-            exampleLineNumbers.emplace_back(currentLine);
+        } else if (status == RowStatus::Row) {  // ignore empty lines
+            exampleRows.emplace_back();
+            for (const auto& field : row) {
+                exampleRows.back().push_back(field.str());
+            }
+            exampleRowPositions.push_back(rowBegin);
         }
     }
+    if (exampleRows.empty()) {
+        throw CSVDataReaderException("Empty file, no data");
+    }
 
-    // Rewind to start position
-    in.seekg(streamPos, std::ios::beg);
     if (!firstRowHeader_) {
         // assign default column headers
         for (size_t i = 0; i < exampleRows.front().size(); ++i) {
@@ -216,7 +411,8 @@ std::shared_ptr<plot::DataFrame> CSVReader::readData(std::istream& stream) const
     for (size_t i = 0; i < exampleRows.size(); ++i) {
         if (exampleRows[i].size() != maxColCount) {
             throw CSVDataReaderException(
-                "Column counts do not match (line " + std::to_string(exampleLineNumbers[i]) + ": " +
+                "Column counts do not match (line " +
+                std::to_string(lineNumber(begin, exampleRowPositions[i])) + ": " +
                 std::to_string(exampleRows[i].size()) + " fields; DataFrame has " +
                 std::to_string(maxColCount) + " columns)");
         }
@@ -224,21 +420,105 @@ std::shared_ptr<plot::DataFrame> CSVReader::readData(std::istream& stream) const
 
     auto dataFrame = plot::createDataFrame(exampleRows, headers);
 
-    size_t rowIndex = firstRowHeader_ ? 1 : 0;
-    auto row = extractRow(maxColCount);
-    while (!row.second) {
-        // Do not add empty rows, i.e. rows with only delimiters (,,,,) or newline
-        auto emptyIt = std::find_if(std::begin(row.first), std::end(row.first),
-                                    [](const auto& a) { return !a.empty(); });
-        if (emptyIt != row.first.end()) {
-            // May throw DataTypeMismatch, but do not catch it here since it indicates
-            // that the DataFrame is in an invalid state
-            dataFrame->addRow(row.first);
+    // float columns are parsed directly, all other columns are filled via Column::add()
+    std::vector<plot::TemplateColumn<float>*> floatColumns(maxColCount, nullptr);
+    for (size_t col = 0; col < maxColCount; ++col) {
+        floatColumns[col] =
+            dynamic_cast<plot::TemplateColumn<float>*>(dataFrame->getColumn(col + 1).get());
+    }
+
+    // Split the data into chunks at line breaks. This is only possible if the data does not
+    // contain quotes since quoted fields might contain line breaks.
+    const auto bytes = static_cast<size_t>(end - dataBegin);
+    const size_t jobs =
+        std::memchr(dataBegin, '"', bytes) ? 1 : util::parallelRangeCount(bytes, 1024 * 1024);
+    std::vector<const char*> chunkBounds{dataBegin};
+    for (size_t job = 1; job < jobs; ++job) {
+        const char* pos = std::max(chunkBounds.back(), dataBegin + job * bytes / jobs);
+        while ((pos != end) && (*pos != '\n') && (*pos != '\r')) ++pos;
+        if ((pos != end) && (*pos++ == '\r') && (pos != end) && (*pos == '\n')) ++pos;
+        chunkBounds.push_back(pos);
+    }
+    chunkBounds.push_back(end);
+
+    auto parseChunk = [&](const char* chunkBegin, const char* chunkEnd, bool reportProgress) {
+        Chunk chunk;
+        chunk.floats.resize(maxColCount);
+        chunk.fields.resize(maxColCount);
+
+        Tokenizer chunkTokenizer(begin, chunkBegin, chunkEnd, delimiters_);
+        std::vector<Field> values;
+        RowStatus status;
+        while ((status = extractRow(chunkTokenizer, values, maxColCount)) != RowStatus::End) {
+            // Do not add empty rows, i.e. rows with only delimiters (,,,,) or newline
+            if ((status == RowStatus::EmptyLine) ||
+                std::all_of(values.begin(), values.end(),
+                            [](const Field& field) { return field.empty(); })) {
+                continue;
+            }
+            for (size_t col = 0; col < maxColCount; ++col) {
+                if (floatColumns[col]) {
+                    chunk.floats[col].push_back(parseFloat(values[col].begin, values[col].end));
+                } else {
+                    chunk.fields[col].push_back(values[col]);
+                }
+            }
+            ++chunk.rows;
+            if (reportProgress && ((chunk.rows & 0xffff) == 0)) {
+                progress_(static_cast<float>(chunkTokenizer.pos() - begin) /
+                          static_cast<float>(end - begin));
+            }
+        }
+        return chunk;
+    };
+
+    // one range per chunk, the progress is reported while parsing if there is only one
+    std::vector<Chunk> chunks(jobs);
+    util::forEachRangeParallelN(
+        jobs, jobs,
+        [&](size_t job, size_t) {
+            chunks[job] = parseChunk(chunkBounds[job], chunkBounds[job + 1],
+                                     (jobs == 1) && (progress_ != nullptr));
+        },
+        [&](size_t job) {
+            if (progress_ && (jobs > 1)) {
+                progress_(static_cast<float>(job + 1) / static_cast<float>(jobs));
+            }
+        });
+
+    const size_t rows = std::accumulate(chunks.begin(), chunks.end(), size_t{0},
+                                        [](size_t sum, const Chunk& c) { return sum + c.rows; });
+    std::string value;
+    for (size_t col = 0; col < maxColCount; ++col) {
+        if (auto floatColumn = floatColumns[col]) {
+            auto& data =
+                floatColumn->getTypedBuffer()->getEditableRAMRepresentation()->getDataContainer();
+            data.reserve(data.size() + rows);
+            for (const auto& chunk : chunks) {
+                data.insert(data.end(), chunk.floats[col].begin(), chunk.floats[col].end());
+            }
+        } else {
+            auto column = dataFrame->getColumn(col + 1);
+            column->getBuffer()->getEditableRepresentation<BufferRAM>()->reserve(rows);
+            for (const auto& chunk : chunks) {
+                for (const auto& field : chunk.fields[col]) {
+                    field.assignTo(value);
+                    try {
+                        column->add(value);
+                    } catch (InvalidConversion&) {
+                        throw plot::DataTypeMismatch(
+                            "Data type mismatch for column " + std::to_string(col + 1) +
+                                " with value (" + value +
+                                "). DataFrame will be in an invalid state since all columns must "
+                                "be of equal size.",
+                            IvwContext);
+                    }
+                }
+            }
         }
-        row = extractRow(maxColCount);
-        ++rowIndex;
     }
     dataFrame->updateIndexBuffer();
+    if (progress_) progress_(1.0f);
     return dataFrame;
 }
 
@@ -59,6 +59,11 @@ public:
  *
  * \brief A reader for comma separated value (CSV) files with customizable delimiters.
  * The default delimiter is ',' and headers are included
+ *
+ * Files are memory mapped, if possible, and parsed in place without copying the individual
+ * fields. The column types are derived from the first 50 rows. If the data does not contain
+ * any quotes, it is split at line breaks into chunks which are parsed concurrently on the
+ * thread pool. Numerical columns are parsed directly into the buffers of the DataFrame.
  */
 class IVW_MODULE_PLOTTING_API CSVReader : public DataReaderType<plot::DataFrame> { 
 public:
@@ -72,6 +77,11 @@ public:
 
     void setDelimiters(const std::string &delim);
     void setFirstRowHeader(bool hasHeader);
+    /**
+     * set a callback which is called with the current progress in [0,1] while reading data.
+     * The callback is always invoked on the thread calling readData.
+     */
+    void setProgressCallback(std::function<void(float)> callback);
 
     /**
      * read a CSV file from a file
@@ -99,8 +109,11 @@ public:
     std::shared_ptr<plot::DataFrame> readData(std::istream& stream) const;
 
 private:
+    std::shared_ptr<plot::DataFrame> parse(const char* begin, const char* end) const;
+
     std::string delimiters_;
     bool firstRowHeader_;
+    std::function<void(float)> progress_;
 };
 
 } // namespace
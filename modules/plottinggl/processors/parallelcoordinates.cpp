@@ -171,7 +171,7 @@ struct Axis : public ParallelCoordinates::AxisBase {
     virtual float getRangeMin() const override { return static_cast<float>(range_->getRangeMin()); }
     virtual float getRangeMax() const override { return static_cast<float>(range_->getRangeMax()); }
 
-    virtual void updateBrushing(std::unordered_set<size_t> &brushed) override {
+    virtual void updateBrushing(BitSet &brushed) override {
         auto range = range_->get();
         // Increase range to avoid conversion issues
         range +=
@@ -179,7 +179,7 @@ struct Axis : public ParallelCoordinates::AxisBase {
         auto &vec = *dataVector_;
         for (size_t i = 0; i < vec.size(); i++) {
             if (filterValue(vec[i], range)) {
-                brushed.insert(i);
+                brushed.add(i);
             }
         }
     }
@@ -757,16 +757,19 @@ void ParallelCoordinates::drawLines(size2_t size, std::vector<AxisBase *> enable
     std::vector<size_t> filteredIndices;
     std::vector<size_t> selectIndices;
 
+    const auto &filtered = brushingAndLinking_.getFilteredIndices();
+    const auto &selected = brushingAndLinking_.getSelectedIndices();
+
     lineShader_.setUniform("selected", 0);
     lineShader_.setUniform("filtered", 0);
     for (size_t i = 0; i < numLines; i++) {
-        if (brushingAndLinking_.isFiltered(indexCol[i])) {
+        if (filtered.contains(indexCol[i])) {
             if (showFiltered_) {
                 filteredIndices.push_back(i);
             }
             continue;
         }
-        if (brushingAndLinking_.isSelected(indexCol[i])) {
+        if (selected.contains(indexCol[i])) {
             selectIndices.push_back(i);
             continue;
         }
@@ -784,7 +787,6 @@ void ParallelCoordinates::drawLines(size2_t size, std::vector<AxisBase *> enable
     lineShader_.setUniform("selected", 1);
     lineShader_.setUniform("filtered", 0);
     for (const auto &i : selectIndices) {
-        if (brushingAndLinking_.isFiltered(indexCol[i])) continue;
         drawObject.draw(i);
     }
 
@@ -935,18 +937,17 @@ void ParallelCoordinates::handlePicked(PickingEvent *p) {
 
 void ParallelCoordinates::updateBrushing() {
     brushingDirty_ = false;
-    std::unordered_set<size_t> brushed;
+    BitSet brushed;
 
     for (auto &axes : axisVector_) {
         axes->updateBrushing(brushed);
     }
 
-    std::unordered_set<size_t> brushedID;
+    BitSet brushedID;
     auto iCol = dataFrame_.getData()->getIndexColumn();
     auto &indexCol = iCol->getTypedBuffer()->getRAMRepresentation()->getDataContainer();
 
-    std::for_each(brushed.begin(), brushed.end(),
-                  [&](const auto &id) { brushedID.insert(indexCol[id]); });
+    brushed.forEach([&](size_t id) { brushedID.add(indexCol[id]); });
 
     brushingAndLinking_.sendFilterEvent(brushedID);
 }
@@ -105,7 +105,7 @@ public:
 
         float getNormalizedAt(size_t idx) const { return getNormalized(at(idx)); }
 
-        virtual void updateBrushing(std::unordered_set<size_t> &brushed) = 0;
+        virtual void updateBrushing(BitSet &brushed) = 0;
         virtual void updateRange(bool upper, float y) = 0;
     };
 
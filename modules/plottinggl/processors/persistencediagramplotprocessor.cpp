@@ -91,14 +91,14 @@ void PersistenceDiagramPlotProcessor::process() {
         auto iCol = dataframe->getIndexColumn();
         auto &indexCol = iCol->getTypedBuffer()->getRAMRepresentation()->getDataContainer();
 
-        auto filteredIndicies = brushing_.getFilteredIndices();
+        const auto &filteredIndicies = brushing_.getFilteredIndices();
         IndexBuffer indicies;
         auto &vec = indicies.getEditableRAMRepresentation()->getDataContainer();
-        vec.reserve(dfSize - filteredIndicies.size());
+        vec.reserve(dfSize - std::min(dfSize, filteredIndicies.size()));
 
-        auto seq = util::sequence<uint32_t>(0, static_cast<uint32_t>(dfSize), 1);
-        std::copy_if(seq.begin(), seq.end(), std::back_inserter(vec),
-                     [&](const auto &id) { return !brushing_.isFiltered(indexCol[id]); });
+        for (uint32_t id = 0; id < static_cast<uint32_t>(dfSize); ++id) {
+            if (!filteredIndicies.contains(indexCol[id])) vec.push_back(id);
+        }
 
         persistenceDiagramPlot_.plot(outport_, &indicies, true);
     } else {
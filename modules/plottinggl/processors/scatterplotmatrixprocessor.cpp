@@ -213,14 +213,14 @@ void ScatterPlotMatrixProcessor::process() {
         auto iCol = dataframe->getIndexColumn();
         auto &indexCol = iCol->getTypedBuffer()->getRAMRepresentation()->getDataContainer();
 
-        auto brushedIndicies = brushing_.getFilteredIndices();
+        const auto &brushedIndicies = brushing_.getFilteredIndices();
         indicies = std::make_unique<IndexBuffer>();
         auto &vec = indicies->getEditableRAMRepresentation()->getDataContainer();
-        vec.reserve(dfSize - brushedIndicies.size());
+        vec.reserve(dfSize - std::min(dfSize, brushedIndicies.size()));
 
-        auto seq = util::sequence<uint32_t>(0, static_cast<uint32_t>(dfSize), 1);
-        std::copy_if(seq.begin(), seq.end(), std::back_inserter(vec),
-                     [&](const auto &id) { return !brushing_.isFiltered(indexCol[id]); });
+        for (uint32_t id = 0; id < static_cast<uint32_t>(dfSize); ++id) {
+            if (!brushedIndicies.contains(indexCol[id])) vec.push_back(id);
+        }
     }
 
     utilgl::activateAndClearTarget(outport_);
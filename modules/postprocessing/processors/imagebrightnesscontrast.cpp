@@ -54,7 +54,7 @@ ImageBrightnessContrast::ImageBrightnessContrast()
 }
     
 void ImageBrightnessContrast::preProcess(TextureUnitContainer &) {
-    utilgl::setUniforms(shader_, brightness_, contrast_);
+    utilgl::setUniforms(getShader(), brightness_, contrast_);
 }
 
 } // namespace
@@ -54,7 +54,7 @@ ImageEdgeDarken::ImageEdgeDarken()
 }
     
 void ImageEdgeDarken::preProcess(TextureUnitContainer &) {
-    utilgl::setUniforms(shader_, darken_, intensity_);
+    utilgl::setUniforms(getShader(), darken_, intensity_);
 }
 
 } // namespace
@@ -54,7 +54,7 @@ ImageHueSaturationLuminance::ImageHueSaturationLuminance()
 }
 
 void ImageHueSaturationLuminance::preProcess(TextureUnitContainer &) {
-    utilgl::setUniforms(shader_, hue_, saturation_, luminance_);
+    utilgl::setUniforms(getShader(), hue_, saturation_, luminance_);
 }
 
 }  // namespace
@@ -58,7 +58,7 @@ ImageSharpen::ImageSharpen()
 
 void ImageSharpen::preProcess(TextureUnitContainer &) {
     kernel_.set(kernels_[filter_.get()]);
-    utilgl::setUniforms(shader_, sharpen_);
-    shader_.setUniform("kernel", kernels_[filter_.get()]);
+    utilgl::setUniforms(getShader(), sharpen_);
+    getShader().setUniform("kernel", kernels_[filter_.get()]);
 }
 }  // namespace inviwo
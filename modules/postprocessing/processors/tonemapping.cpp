@@ -79,12 +79,13 @@ Tonemapping::Tonemapping()
 }
 
 void Tonemapping::initializeResources() {
-    shader_.getFragmentShaderObject()->addShaderDefine("METHOD", std::to_string(method_.get()));
+    getShader().getFragmentShaderObject()->addShaderDefine("METHOD",
+                                                           std::to_string(method_.get()));
     ImageGLProcessor::initializeResources();
 }
 
 void Tonemapping::preProcess(TextureUnitContainer &) {
-    utilgl::setUniforms(shader_, exposure_, gamma_);
+    utilgl::setUniforms(getShader(), exposure_, gamma_);
 }
 
 }  // namespace
@@ -111,18 +111,11 @@ void exposeBuffer(pybind11::module &m) {
         .def_property("size", &BufferBase::getSize, &BufferBase::setSize)
         .def_property(
             "data",
-            [&](BufferBase *buffer) -> py::array {
-                auto df = buffer->getDataFormat();
-                std::vector<size_t> shape = {buffer->getSize()};
-                std::vector<size_t> strides = {df->getSize()};
-
-                if (df->getComponents() > 1) {
-                    shape.push_back(df->getComponents());
-                    strides.push_back(df->getSize() / df->getComponents());
-                }
-
-                auto data = buffer->getEditableRepresentation<BufferRAM>()->getData();
-                return py::array(pyutil::toNumPyFormat(df), shape, strides, data, py::cast<>(1));
+            [](BufferBase *buffer) -> py::array {
+                auto rep = buffer->getEditableRepresentationShared<BufferRAM>();
+                const auto size = rep->getSize();
+                auto data = rep->getData();
+                return pyutil::dataView(std::move(rep), data, buffer->getDataFormat(), {size});
             },
             [](BufferBase *buffer, py::array data) {
                 auto rep = buffer->getEditableRepresentation<BufferRAM>();
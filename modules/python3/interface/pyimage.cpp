@@ -75,26 +75,22 @@ void exposeImage(py::module &m) {
         .def_property_readonly("dimensions", &Layer::getDimensions)
         .def_property(
             "data",
-            [&](Layer *layer) -> py::array {
-                auto df = layer->getDataFormat();
-                auto dims = layer->getDimensions();
-
-                std::vector<size_t> shape = {dims.x, dims.y};
-                std::vector<size_t> strides = {df->getSize(), df->getSize() * dims.x};
-
-                if (df->getComponents() > 1) {
-                    shape.push_back(df->getComponents());
-                    strides.push_back(df->getSize() / df->getComponents());
-                }
-
-                auto data = layer->getEditableRepresentation<LayerRAM>()->getData();
-                return py::array(pyutil::toNumPyFormat(df), shape, strides, data, py::cast<>(1));
+            [](Layer *layer) -> py::array {
+                auto rep = layer->getEditableRepresentationShared<LayerRAM>();
+                const auto dims = rep->getDimensions();
+                auto data = rep->getData();
+                return pyutil::dataView(std::move(rep), data, layer->getDataFormat(),
+                                        {dims.x, dims.y});
             },
             [](Layer *layer, py::array data) {
-                auto rep = layer->getEditableRepresentation<LayerRAM>();
+                auto rep = layer->getRepresentation<LayerRAM>();
                 pyutil::checkDataFormat<2>(rep->getDataFormat(), rep->getDimensions(), data);
 
-                memcpy(rep->getData(), data.data(0), data.nbytes());
+                // Replace the RAM representation with one using the memory of the array
+                auto ram =
+                    pyutil::createLayerRAM(data, rep->getLayerType(), rep->getSwizzleMask());
+                layer->addRepresentation(ram);
+                layer->invalidateAllOther(ram.get());
             });
 
     exposeInport<ImageInport>(m, "Image");
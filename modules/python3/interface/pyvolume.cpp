@@ -61,27 +61,21 @@ void exposeVolume(pybind11::module &m) {
         .def_readwrite("dataMap", &Volume::dataMap_)
         .def_property(
             "data",
-            [&](Volume *volume) -> py::array {
-                auto df = volume->getDataFormat();
-                auto dims = volume->getDimensions();
-
-                std::vector<size_t> shape = {dims.x, dims.y, dims.z};
-                std::vector<size_t> strides = {df->getSize(), df->getSize() * dims.x,
-                                               df->getSize() * dims.x * dims.y};
-
-                if (df->getComponents() > 1) {
-                    shape.push_back(df->getComponents());
-                    strides.push_back(df->getSize() / df->getComponents());
-                }
-
-                auto data = volume->getEditableRepresentation<VolumeRAM>()->getData();
-                return py::array(pyutil::toNumPyFormat(df), shape, strides, data, py::cast<>(1));
+            [](Volume *volume) -> py::array {
+                auto rep = volume->getEditableRepresentationShared<VolumeRAM>();
+                const auto dims = rep->getDimensions();
+                auto data = rep->getData();
+                return pyutil::dataView(std::move(rep), data, volume->getDataFormat(),
+                                        {dims.x, dims.y, dims.z});
             },
             [](Volume *volume, py::array data) {
-                auto rep = volume->getEditableRepresentation<VolumeRAM>();
+                auto rep = volume->getRepresentation<VolumeRAM>();
                 pyutil::checkDataFormat<3>(rep->getDataFormat(), rep->getDimensions(), data);
 
-                memcpy(rep->getData(), data.data(0), data.nbytes());
+                // Replace the RAM representation with one using the memory of the array
+                auto ram = pyutil::createVolumeRAM(data);
+                volume->addRepresentation(ram);
+                volume->invalidateAllOther(ram.get());
             })
         .def("__repr__", [](const Volume &volume) {
             std::ostringstream oss;
@@ -89,6 +89,26 @@ const DataFormatBase *getDataFormat(size_t components, pybind11::array &arr) {
     return format;
 }
 
+std::shared_ptr<void> keepAlive(pybind11::array arr) {
+    auto obj = arr.release().ptr();
+    return std::shared_ptr<void>(obj, [](void *ptr) {
+        // The last reference might be released on any thread, possibly after the interpreter has
+        // been shut down.
+        if (!Py_IsInitialized()) return;
+        pybind11::gil_scoped_acquire gil;
+        Py_DECREF(static_cast<PyObject *>(ptr));
+    });
+}
+
+pybind11::array adoptableArray(pybind11::array arr) {
+    namespace py = pybind11;
+    const auto flags = arr.flags();
+    const bool contiguous = (flags & (py::array::c_style | py::array::f_style)) != 0;
+    const bool aligned = (flags & py::detail::npy_api::NPY_ARRAY_ALIGNED_) != 0;
+    if (contiguous && aligned && arr.writeable()) return arr;
+    return pybind11::array(arr.attr("copy")("C"));
+}
+
 struct BufferFromArrayDispatcher {
     using type = std::unique_ptr<BufferBase>;
 
@@ -101,29 +121,31 @@ struct BufferFromArrayDispatcher {
     }
 };
 
-struct LayerFromArrayDispatcher {
-    using type = std::unique_ptr<Layer>;
+struct LayerRAMFromArrayDispatcher {
+    using type = std::shared_ptr<LayerRAM>;
 
     template <typename T>
-    std::unique_ptr<Layer> dispatch(pybind11::array &arr) {
+    std::shared_ptr<LayerRAM> dispatch(pybind11::array &arr, LayerType layerType,
+                                       const SwizzleMask &swizzleMask) {
         using Type = typename T::type;
         size2_t dims(arr.shape(0), arr.shape(1));
-        auto layerRAM = std::make_shared<LayerRAMPrecision<Type>>(dims);
-        memcpy(layerRAM->getData(), arr.data(0), arr.nbytes());
-        return std::make_unique<Layer>(layerRAM);
+        auto data = adoptableArray(arr);
+        auto ptr = static_cast<Type *>(data.mutable_data());
+        return std::make_shared<LayerRAMPrecision<Type>>(ptr, dims, keepAlive(std::move(data)),
+                                                         layerType, swizzleMask);
     }
 };
 
-struct VolumeFromArrayDispatcher {
-    using type = std::unique_ptr<Volume>;
+struct VolumeRAMFromArrayDispatcher {
+    using type = std::shared_ptr<VolumeRAM>;
 
     template <typename T>
-    std::unique_ptr<Volume> dispatch(pybind11::array &arr) {
+    std::shared_ptr<VolumeRAM> dispatch(pybind11::array &arr) {
         using Type = typename T::type;
         size3_t dims(arr.shape(0), arr.shape(1), arr.shape(2));
-        auto volumeRAM = std::make_shared<VolumeRAMPrecision<Type>>(dims);
-        memcpy(volumeRAM->getData(), arr.data(0), arr.nbytes());
-        return std::make_unique<Volume>(volumeRAM);
+        auto data = adoptableArray(arr);
+        auto ptr = static_cast<Type *>(data.mutable_data());
+        return std::make_shared<VolumeRAMPrecision<Type>>(ptr, dims, keepAlive(std::move(data)));
     }
 };
 
@@ -135,21 +157,51 @@ std::unique_ptr<BufferBase> createBuffer(pybind11::array &arr) {
     return df->dispatch(dispatcher, arr);
 }
 
-std::unique_ptr<Layer> createLayer(pybind11::array &arr) {
+std::shared_ptr<LayerRAM> createLayerRAM(pybind11::array &arr, LayerType layerType,
+                                         const SwizzleMask &swizzleMask) {
     auto ndim = arr.ndim();
     ivwAssert(ndim == 2 || ndim == 3, "Ndims must be either 2 or 3");
     auto df = pyutil::getDataFormat(ndim == 2 ? 1 : arr.shape(2), arr);
-    LayerFromArrayDispatcher dispatcher{};
-    return df->dispatch(dispatcher, arr);
+    LayerRAMFromArrayDispatcher dispatcher{};
+    return df->dispatch(dispatcher, arr, layerType, swizzleMask);
 }
 
-std::unique_ptr<Volume> createVolume(pybind11::array &arr) {
+std::shared_ptr<VolumeRAM> createVolumeRAM(pybind11::array &arr) {
     auto ndim = arr.ndim();
     ivwAssert(ndim == 3 || ndim == 4, "Ndims must be either 3 or 4");
     auto df = pyutil::getDataFormat(ndim == 3 ? 1 : arr.shape(3), arr);
-    VolumeFromArrayDispatcher dispatcher{};
+    VolumeRAMFromArrayDispatcher dispatcher{};
     return df->dispatch(dispatcher, arr);
 }
 
+std::unique_ptr<Layer> createLayer(pybind11::array &arr) {
+    return std::make_unique<Layer>(createLayerRAM(arr));
+}
+
+std::unique_ptr<Volume> createVolume(pybind11::array &arr) {
+    return std::make_unique<Volume>(createVolumeRAM(arr));
+}
+
+pybind11::array dataView(std::shared_ptr<void> representation, void *data,
+                         const DataFormatBase *df, std::vector<size_t> dims) {
+    namespace py = pybind11;
+    std::vector<size_t> shape = dims;
+    std::vector<size_t> strides;
+    size_t stride = df->getSize();
+    for (auto dim : dims) {
+        strides.push_back(stride);
+        stride *= dim;
+    }
+    if (df->getComponents() > 1) {
+        shape.push_back(df->getComponents());
+        strides.push_back(df->getSize() / df->getComponents());
+    }
+
+    // The capsule keeps the representation alive for as long as the view exists.
+    py::capsule base(new std::shared_ptr<void>(std::move(representation)),
+                     [](void *ptr) { delete static_cast<std::shared_ptr<void> *>(ptr); });
+    return py::array(pyutil::toNumPyFormat(df), shape, strides, data, base);
+}
+
 }  // namespace pyutil
 }  // namespace inviwo
@@ -44,21 +44,55 @@
 #include <inviwo/core/processors/processor.h>
 #include <inviwo/core/util/formats.h>
 #include <inviwo/core/util/stringconversion.h>
+#include <inviwo/core/datastructures/image/imagetypes.h>
 
 namespace inviwo {
 
 class BufferBase;
 class Layer;
+class LayerRAM;
 class Volume;
+class VolumeRAM;
 
 namespace pyutil {
 
 IVW_MODULE_PYTHON3_API pybind11::dtype toNumPyFormat(const DataFormatBase *df);
 IVW_MODULE_PYTHON3_API const DataFormatBase *getDataFormat(size_t components, pybind11::array &arr);
 IVW_MODULE_PYTHON3_API std::unique_ptr<BufferBase> createBuffer(pybind11::array &arr);
+
+/**
+ * Returns a handle that keeps the array alive. The GIL is acquired when the last copy of the
+ * handle is released, hence the handle can be released from any thread.
+ */
+IVW_MODULE_PYTHON3_API std::shared_ptr<void> keepAlive(pybind11::array arr);
+
+/**
+ * Returns the array itself if its memory can be used directly by a RAM representation, i.e. if it
+ * is contiguous, aligned, and writeable. Otherwise a C-contiguous copy is returned.
+ */
+IVW_MODULE_PYTHON3_API pybind11::array adoptableArray(pybind11::array arr);
+
+/**
+ * Create RAM representations that use the memory of the array without copying it, when
+ * possible. See adoptableArray. The memory is used as is, i.e. the first dimension of the array
+ * is expected to vary fastest. The array is kept alive by the representation.
+ */
+IVW_MODULE_PYTHON3_API std::shared_ptr<LayerRAM> createLayerRAM(
+    pybind11::array &arr, LayerType layerType = LayerType::Color,
+    const SwizzleMask &swizzleMask = swizzlemasks::rgba);
+IVW_MODULE_PYTHON3_API std::shared_ptr<VolumeRAM> createVolumeRAM(pybind11::array &arr);
 IVW_MODULE_PYTHON3_API std::unique_ptr<Layer> createLayer(pybind11::array &arr);
 IVW_MODULE_PYTHON3_API std::unique_ptr<Volume> createVolume(pybind11::array &arr);
 
+/**
+ * Create a NumPy array that views the data of a representation without copying it. The view
+ * shares ownership of the representation, so the data stays valid even if the representation is
+ * removed from its owner. The first dimension varies fastest in memory.
+ */
+IVW_MODULE_PYTHON3_API pybind11::array dataView(std::shared_ptr<void> representation, void *data,
+                                                const DataFormatBase *df,
+                                                std::vector<size_t> dims);
+
 template <int Dim>
 void checkDataFormat(const DataFormatBase *format, const Vector<Dim, size_t> &dim,
                      const pybind11::array &data) {
@@ -243,4 +243,38 @@ const static std::vector<std::string> dtypes = {{"float16"}, {"float32"}, {"floa
 
 INSTANTIATE_TEST_CASE_P(DefaultTypes, DTypeTest, ::testing::ValuesIn(dtypes));
 
+TEST(Python3Scripts, VolumeUsesArrayMemory) {
+    PythonScript s;
+    s.setSource(
+        "import numpy as np\n"
+        "a = np.arange(24, dtype=np.float32).reshape((2, 3, 4))\n"
+        "b = np.arange(48, dtype=np.float32)[::2].reshape((2, 3, 4))\n");
+    bool status = false;
+    s.run([&](pybind11::dict dict) {
+        auto a = pybind11::cast<pybind11::array>(dict["a"]);
+        auto volume = pyutil::createVolume(a);
+        auto ram = volume->getEditableRepresentationShared<VolumeRAM>();
+        EXPECT_EQ(size3_t(2, 3, 4), ram->getDimensions());
+        EXPECT_EQ(a.data(), ram->getData()) << "contiguous arrays should not be copied";
+
+        auto view = pyutil::dataView(ram, ram->getData(), volume->getDataFormat(), {2, 3, 4});
+        EXPECT_EQ(a.data(), view.data());
+        ram.reset();
+        volume.reset();
+        a = pybind11::array();
+        // The view keeps the representation, and hence the array, alive
+        EXPECT_EQ(23.0f, static_cast<const float *>(view.data())[23]);
+
+        // Non contiguous arrays are copied
+        auto b = pybind11::cast<pybind11::array>(dict["b"]);
+        auto copy = pyutil::createVolume(b);
+        auto copyRam = copy->getRepresentation<VolumeRAM>();
+        EXPECT_NE(b.data(), copyRam->getData());
+        EXPECT_EQ(46.0f, static_cast<const float *>(copyRam->getData())[23]);
+
+        status = true;
+    });
+    EXPECT_TRUE(status);
+}
+
 }  // namespace inviwo
@@ -66,6 +66,9 @@ TFEditorView::TFEditorView(util::TFPropertyConcept* tfProperty, QGraphicsScene*
 
     if (volumeInport_) {
         const auto portChange = [this]() {
+            // The histograms of the previous volume are outdated
+            stopHistCalculation_ = true;
+            coarseHistograms_.reset();
             if (histogramMode_ != HistogramMode::Off && volumeInport_->hasData()) {
                 updateHistogram();
                 resetCachedContent();
@@ -75,6 +78,7 @@ TFEditorView::TFEditorView(util::TFPropertyConcept* tfProperty, QGraphicsScene*
 
         callbackOnInvalid = volumeInport_->onInvalid([this]() {
             stopHistCalculation_ = true;
+            coarseHistograms_.reset();
             resetCachedContent();
             update();
         });
@@ -82,6 +86,7 @@ TFEditorView::TFEditorView(util::TFPropertyConcept* tfProperty, QGraphicsScene*
         callbackOnConnect = volumeInport_->onConnect(portChange);
         callbackOnDisconnect = volumeInport_->onDisconnect([this]() {
             stopHistCalculation_ = true;
+            coarseHistograms_.reset();
             histograms_.clear();
             resetCachedContent();
             update();
@@ -290,21 +295,36 @@ const HistogramContainer* TFEditorView::getNormalizedHistograms() {
 
                 const auto done = [this]() {
                     histCalculation_.get();
+                    coarseHistograms_.reset();
                     updateHistogram();
                     resetCachedContent();
                     update();
                 };
 
-                const auto histcalc =
-                    [& stop = stopHistCalculation_, volume = volumeInport_->getData(), done ]()
-                        ->void {
+                // Show a coarse histogram while the full one is calculated
+                const auto progress = [this](const HistogramContainer& histograms) {
+                    dispatchFront([this, histograms]() {
+                        // Skip progress of a calculation stopped since
+                        if (!histCalculation_.valid() || stopHistCalculation_) return;
+                        coarseHistograms_ = std::make_unique<HistogramContainer>(histograms);
+                        updateHistogram();
+                        resetCachedContent();
+                        update();
+                    });
+                };
+
+                const auto histcalc = [&stop = stopHistCalculation_,
+                                       volume = volumeInport_->getData(), done,
+                                       progress]() -> void {
                     auto ram = volume->getRepresentation<VolumeRAM>();
-                    ram->calculateHistograms(2048, size3_t(1), stop);
+                    ram->calculateHistograms(2048, size3_t(1), stop, progress);
                     dispatchFront(done);
                     return;
                 };
                 stopHistCalculation_ = false;
                 histCalculation_ = dispatchPool(histcalc);
+            } else if (coarseHistograms_) {
+                return coarseHistograms_.get();
             }
         }
     }
@@ -83,6 +83,8 @@ private:
 
     bool stopHistCalculation_ = false;
     std::future<void> histCalculation_;
+    // Shown while histCalculation_ is running
+    std::unique_ptr<HistogramContainer> coarseHistograms_;
 
     dvec2 maskHorizontal_;
 
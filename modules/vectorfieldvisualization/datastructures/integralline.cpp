@@ -33,7 +33,7 @@
 namespace inviwo {
 
 IntegralLine::IntegralLine()
-    : positions_(), metaData_(), terminationReason_(TerminationReason::Steps) , length_(-1)
+    : positions_(), metaData_(), terminationReason_(TerminationReason::Steps) , length_(-1), idx_(0)
 {}
 
 IntegralLine::IntegralLine(const IntegralLine &rhs)
@@ -43,6 +43,13 @@ IntegralLine::IntegralLine(const IntegralLine &rhs)
     , length_(rhs.length_)
     , idx_(rhs.idx_) {}
 
+IntegralLine::IntegralLine(IntegralLine &&rhs)
+    : positions_(std::move(rhs.positions_))
+    , metaData_(std::move(rhs.metaData_))
+    , terminationReason_(rhs.terminationReason_)
+    , length_(rhs.length_)
+    , idx_(rhs.idx_) {}
+
 inviwo::IntegralLine &IntegralLine::operator=(const IntegralLine &that) {
     if (&that != this) {
         positions_ = that.positions_;
@@ -54,6 +61,17 @@ inviwo::IntegralLine &IntegralLine::operator=(const IntegralLine &that) {
     return *this;
 }
 
+inviwo::IntegralLine &IntegralLine::operator=(IntegralLine &&that) {
+    if (&that != this) {
+        positions_ = std::move(that.positions_);
+        metaData_ = std::move(that.metaData_);
+        terminationReason_ = that.terminationReason_;
+        length_ = that.length_;
+        idx_ = that.idx_;
+    }
+    return *this;
+}
+
 IntegralLine::~IntegralLine() {}
 
 const std::vector<dvec3> &IntegralLine::getPositions() const { return positions_; }
@@ -52,8 +52,10 @@ public:
 
     IntegralLine();
     IntegralLine(const IntegralLine &rhs);
+    IntegralLine(IntegralLine &&rhs);
 
     IntegralLine &operator=(const IntegralLine &that);
+    IntegralLine &operator=(IntegralLine &&that);
 
     virtual ~IntegralLine();
 
@@ -76,4 +76,8 @@ void IntegralLineSet::push_back(const IntegralLine &line, size_t idx)
     push_back(copy,idx);
 }
 
+void IntegralLineSet::push_back(IntegralLine &&line) { lines_.push_back(std::move(line)); }
+
+void IntegralLineSet::reserve(size_t size) { lines_.reserve(size); }
+
 }  // namespace
@@ -75,6 +75,12 @@ public:
     void push_back(IntegralLine &line, size_t idx);
     void push_back(const IntegralLine &line);
     void push_back(const IntegralLine &line, size_t idx);
+    /**
+     * Move the line into the set, keeping the index it already has.
+     */
+    void push_back(IntegralLine &&line);
+
+    void reserve(size_t size);
 
 private:
     std::vector<IntegralLine> lines_;
@@ -33,6 +33,8 @@
 #include <modules/vectorfieldvisualization/vectorfieldvisualizationmoduledefine.h>
 #include <inviwo/core/common/inviwo.h>
 #include <modules/vectorfieldvisualization/properties/integrallineproperties.h>
+#include <modules/vectorfieldvisualization/datastructures/integralline.h>
+#include <inviwo/core/util/foreach.h>
 
 namespace inviwo {
 
@@ -51,6 +53,22 @@ public:
     void setIntegrationScheme(IntegralLineProperties::IntegrationScheme scheme);
 
 protected:
+    /**
+     * Trace one line per seed in parallel on the thread pool. The result is preallocated with one
+     * line per seed, line i is traced from seeds[i] by `trace(seeds[i], line)` and gets the index
+     * `startIndex + i`. Each job writes to its own slots, so there is no synchronization while
+     * tracing. Falls back to tracing inline when there is no application or only a few seeds.
+     *
+     * All jobs share the samplers of the tracer rather than each getting its own copy. This
+     * requires the samplers to be safe to call concurrently. The samplers in core are: their
+     * representations and kernels are set up at construction and not modified when sampling, and
+     * VolumeDoubleSampler remembers the last brick it used per thread, not per sampler. Copying
+     * the samplers per job would only duplicate that setup.
+     */
+    template <typename Seed, typename Trace>
+    static std::vector<IntegralLine> traceBatch(const std::vector<Seed> &seeds, size_t startIndex,
+                                                Trace trace);
+
     IntegralLineProperties::IntegrationScheme integrationScheme_;
 
     int steps_;
@@ -59,6 +77,20 @@ protected:
 
 };
 
+template <typename Seed, typename Trace>
+std::vector<IntegralLine> IntegralLineTracer::traceBatch(const std::vector<Seed> &seeds,
+                                                         size_t startIndex, Trace trace) {
+    std::vector<IntegralLine> lines(seeds.size());
+    // Lines vary a lot in length, the pool gets a few ranges per thread to balance the load
+    util::forEachRangeParallel(seeds.size(), 8, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            lines[i].setIndex(startIndex + i);
+            trace(seeds[i], lines[i]);
+        }
+    });
+    return lines;
+}
+
 } // namespace
 
 #endif // IVW_INTEGRALLINETRACER_H
@@ -46,8 +46,19 @@ inviwo::IntegralLine PathLineTracer::traceFrom(const vec4 &p) { return traceFrom
 
 inviwo::IntegralLine PathLineTracer::traceFrom(const dvec4 &p) {
     IntegralLine line;
-    auto& positions = line.getPositions();
+    trace(p, line);
+    return line;
+}
 
+std::vector<IntegralLine> PathLineTracer::traceFrom(const std::vector<vec3> &seeds,
+                                                    const mat4 &seedTransform, double startT,
+                                                    size_t startIndex) const {
+    return traceBatch(seeds, startIndex, [&](const vec3 &seed, IntegralLine &line) {
+        trace(dvec4(dvec3(vec3(seedTransform * vec4(seed, 1.0f))), startT), line);
+    });
+}
+
+void PathLineTracer::trace(const dvec4 &p, IntegralLine &line) const {
     auto direction = dir_;
     bool fwd = direction == IntegralLineProperties::Direction::BOTH ||
                direction == IntegralLineProperties::Direction::FWD;
@@ -55,47 +66,47 @@ inviwo::IntegralLine PathLineTracer::traceFrom(const dvec4 &p) {
                direction == IntegralLineProperties::Direction::BWD;
     bool both = fwd && bwd;
 
-    positions.reserve(steps_ + 2);
-    line.getMetaData("velocity").reserve(steps_ + 2);
-    line.getMetaData("timestamp").reserve(steps_ + 2);
+    Channels channels;
+    channels.positions = &line.getPositions();
+    channels.velocity = &line.getMetaData("velocity");
+    channels.timestamp = &line.getMetaData("timestamp");
+
+    channels.positions->reserve(steps_ + 2);
+    channels.velocity->reserve(steps_ + 2);
+    channels.timestamp->reserve(steps_ + 2);
 
     if (bwd) {
-        step(steps_ / (both ? 2 : 1), p, line, false);
+        step(steps_ / (both ? 2 : 1), p, line, channels, false);
     }
-    if (both && !positions.empty()) {
-        std::reverse(positions.begin(),
-            positions.end());  // reverse is faster than insert first
-        positions.pop_back();           // dont repeat first step
-        auto keys = line.getMetaDataKeys();
-        for (auto &key : keys) {
-            auto m = line.getMetaData(key);
-            std::reverse(m.begin(), m.end());  // reverse is faster than insert first
-            m.pop_back();                             // dont repeat first step
+    if (both && !channels.positions->empty()) {
+        // reverse is faster than insert first, and dont repeat first step
+        for (auto v : {channels.positions, channels.velocity, channels.timestamp}) {
+            std::reverse(v->begin(), v->end());
+            v->pop_back();
         }
     }
     if (fwd) {
-        step(steps_ / (both ? 2 : 1), p, line, true);
+        step(steps_ / (both ? 2 : 1), p, line, channels, true);
     }
-
-    return line;
 }
 
-void PathLineTracer::step(int steps, dvec4 curPos, IntegralLine &line, bool fwd) {
-    auto& positions = line.getPositions();
-
+void PathLineTracer::step(int steps, dvec4 curPos, IntegralLine &line, Channels &channels,
+                          bool fwd) const {
     for (int i = 0; i <= steps; i++) {
         if (!sampler_->withinBounds(curPos)) {
             line.setTerminationReason(IntegralLine::TerminationReason::OutOfBounds);
             return;
         }
+        // The velocity at curPos is the first sample of either scheme, reuse it for the meta data
+        dvec3 worldVelocity;
         dvec3 v;
         switch (integrationScheme_) {
             case IntegralLineProperties::IntegrationScheme::RK4:
-                v = rk4(curPos, fwd);
+                v = rk4(curPos, fwd, worldVelocity);
                 break;
             case IntegralLineProperties::IntegrationScheme::Euler:
             default:
-                v = euler(curPos);
+                v = worldVelocity = euler(curPos);
                 break;
         }
 
@@ -104,29 +115,27 @@ void PathLineTracer::step(int steps, dvec4 curPos, IntegralLine &line, bool fwd)
             return;
         }
 
-        dvec3 worldVelocty = sample(curPos);
-
         dvec3 velocity = invBasis_ * (v * stepSize_ * (fwd ? 1.0 : -1.0));
 
-        positions.push_back(vec3(curPos));
-        line.getMetaData("velocity").push_back(worldVelocty);
-        line.getMetaData("timestamp").push_back(dvec3(curPos.a));
+        channels.positions->push_back(vec3(curPos));
+        channels.velocity->push_back(worldVelocity);
+        channels.timestamp->push_back(dvec3(curPos.a));
 
         curPos += dvec4(velocity, stepSize_* (fwd ? 1.0 : -1.0));
     }
 }
 
-dvec3 PathLineTracer::sample(const dvec4 &pos) {
+dvec3 PathLineTracer::sample(const dvec4 &pos) const {
     return sampler_->sample(pos);
 }
 
-inviwo::dvec3 PathLineTracer::euler(const dvec4 &curPos) { return sample(curPos); }
+inviwo::dvec3 PathLineTracer::euler(const dvec4 &curPos) const { return sample(curPos); }
 
-inviwo::dvec3 PathLineTracer::rk4(const dvec4 &curPos, bool fwd) {
+inviwo::dvec3 PathLineTracer::rk4(const dvec4 &curPos, bool fwd, dvec3 &k1) const {
     auto h = stepSize_;
     if (!fwd) h = -h;
     auto h2 = h / 2;
-    auto k1 = sample(curPos);
+    k1 = sample(curPos);
     auto K1 = invBasis_ * k1;
     auto k2 = sample(curPos + dvec4(K1 * h2, h2));
     auto K2 = invBasis_ * k2;
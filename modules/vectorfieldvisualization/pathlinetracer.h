@@ -54,20 +54,38 @@ public:
     IntegralLine traceFrom(const vec4 &p);
     IntegralLine traceFrom(const dvec4 &p);
 
+    /**
+     * Trace one line from each seed, transformed by seedTransform and starting at time startT,
+     * in parallel on the thread pool. Line i of the result is traced from seeds[i] and has the
+     * index `startIndex + i`.
+     */
+    std::vector<IntegralLine> traceFrom(const std::vector<vec3> &seeds, const mat4 &seedTransform,
+                                        double startT, size_t startIndex = 0) const;
+
 private:
-    void step(int steps, dvec4 curPos, IntegralLine &line, bool fwd);
+    /**
+     * Output vectors of a line, looked up once per line instead of by name in every step.
+     */
+    struct Channels {
+        std::vector<dvec3> *positions;
+        std::vector<dvec3> *velocity;
+        std::vector<dvec3> *timestamp;
+    };
 
-    dvec3 sample(const dvec4 &pos);
+    void trace(const dvec4 &p, IntegralLine &line) const;
+    void step(int steps, dvec4 curPos, IntegralLine &line, Channels &channels, bool fwd) const;
 
-    dvec3 euler(const dvec4 &curPos);
-    dvec3 rk4(const dvec4 &curPos, bool fwd);
-    
-    
-    dmat3 invBasis_;
-    
-    std::shared_ptr<const Spatial4DSampler<3, double>> sampler_;
+    dvec3 sample(const dvec4 &pos) const;
 
+    dvec3 euler(const dvec4 &curPos) const;
+    /**
+     * Returns the averaged RK4 velocity, k1 is set to the sample at curPos.
+     */
+    dvec3 rk4(const dvec4 &curPos, bool fwd, dvec3 &k1) const;
 
+    dmat3 invBasis_;
+
+    std::shared_ptr<const Spatial4DSampler<3, double>> sampler_;
 };
 
 }  // namespace
@@ -133,20 +133,13 @@ void PathLines::process() {
     PathLineTracer tracer(sampler, pathLineProperties_);
     auto lines = std::make_shared<IntegralLineSet>(sampler->getModelMatrix());
 
-    size_t startID = 0;
     for (const auto &seeds : seedPoints_) {
-#pragma omp parallel for
-        for (long long j = 0; j < static_cast<long long>(seeds->size()); j++) {
-            const auto &p = (*seeds)[j];
-            vec4 P = m * vec4(p, 1.0f);
-            auto line = tracer.traceFrom(vec4(vec3(P), pathLineProperties_.getStartT()));
-            auto size = line.getPositions().size();
-            if (size > 1) {
-#pragma omp critical
-                lines->push_back(line, lines->size());
-            };
+        for (auto &line : tracer.traceFrom(*seeds, m, pathLineProperties_.getStartT())) {
+            if (line.getPositions().size() > 1) {
+                line.setIndex(lines->size());
+                lines->push_back(std::move(line));
+            }
         }
-        startID += seeds->size();
     }
 
     const std::function<vec4(float, float, size_t)> coloring =
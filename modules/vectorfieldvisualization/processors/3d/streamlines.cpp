@@ -36,7 +36,7 @@ StreamLines::StreamLines()
               {{0.0f, vec4(0, 0, 1, 1)}, {0.5f, vec4(1, 1, 0, 1)}, {1.0, vec4(1, 0, 0, 1)}}})
     , velocityScale_("velocityScale_", "Velocity Scale (inverse)", 1, 0, 10)
     , maxVelocity_("minMaxVelocity", "Velocity Range", "0", InvalidationLevel::Valid)
-    , useOpenMP_("useOpenMP", "Use OpenMP", true) {
+    , useOpenMP_("useOpenMP", "Trace in Parallel", true) {
 
     isReady_.setUpdate([this]() {
         if (allInportsAreReady()) {
@@ -91,25 +91,16 @@ void StreamLines::process() {
     StreamLineTracer tracer(sampler, streamLineProperties_);
     auto lines = std::make_shared<IntegralLineSet>(sampler->getModelMatrix());
 
-    if (useOpenMP_) {
-        size_t startID = 0;
-        for (const auto &seeds : seedPoints_) {
-#pragma omp parallel for
-            for (long long j = 0; j < static_cast<long long>(seeds->size()); j++) {
-                auto p = seeds->at(j);
-                vec4 P = m * vec4(p, 1.0f);
-                auto line = tracer.traceFrom(vec3(P));
-                auto size = line.getPositions().size();
-                if (size > 1) {
-#pragma omp critical
-                    lines->push_back(line, startID + j);
-                };
+    size_t startID = 0;
+    for (const auto &seeds : seedPoints_) {
+        if (useOpenMP_) {
+            for (auto &line : tracer.traceFrom(*seeds, m, startID)) {
+                if (line.getPositions().size() > 1) {
+                    lines->push_back(std::move(line));
+                }
             }
             startID += seeds->size();
-        }
-    } else {
-        size_t startID = 0;
-        for (const auto &seeds : seedPoints_) {
+        } else {
             for (const auto &p : *seeds.get()) {
                 vec4 P = m * vec4(p, 1.0f);
                 auto line = tracer.traceFrom(vec3(P));
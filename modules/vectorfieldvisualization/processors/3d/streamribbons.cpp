@@ -183,9 +183,7 @@ void StreamRibbons::process() {
     size_t lineId = 0;
 
     for (const auto& seeds : seedPoints_) {
-        for (auto& p : *seeds) {
-            vec4 P = m * vec4(p, 1.0f);
-            auto line = tracer.traceFrom(vec3(P));
+        for (const auto& line : tracer.traceFrom(*seeds, m)) {
             auto size = line.getPositions().size();
             if (size <= 1) continue;
 
@@ -45,102 +45,119 @@ StreamLineTracer::StreamLineTracer(std::shared_ptr<const SpatialSampler<3, 3, do
 StreamLineTracer::~StreamLineTracer() {}
 
 void StreamLineTracer::addMetaVolume(const std::string &name, std::shared_ptr<const Volume> vol) {
-    metaSamplers_.insert(std::make_pair(name, std::make_shared<VolumeDoubleSampler<3>>(vol)));
+    addMetaSampler(name, std::make_shared<VolumeDoubleSampler<3>>(vol));
 }
 
 void StreamLineTracer::addMetaSampler(const std::string &name,
                                       std::shared_ptr<const SpatialSampler<3, 3, double>> sampler) {
-    metaSamplers_.insert(std::make_pair(name, sampler));
+    auto it = std::find_if(metaSamplers_.begin(), metaSamplers_.end(),
+                           [&](const auto &m) { return m.first == name; });
+    if (it == metaSamplers_.end()) {
+        metaSamplers_.emplace_back(name, sampler);
+    }
 }
 
 inviwo::IntegralLine StreamLineTracer::traceFrom(const dvec3 &p) {
     IntegralLine line;
-    auto& positions = line.getPositions();
+    trace(p, line);
+    return line;
+}
+
+inviwo::IntegralLine StreamLineTracer::traceFrom(const vec3 &p) {
+    return traceFrom(dvec3(p));
+}
+
+std::vector<IntegralLine> StreamLineTracer::traceFrom(const std::vector<vec3> &seeds,
+                                                      const mat4 &seedTransform,
+                                                      size_t startIndex) const {
+    return traceBatch(seeds, startIndex, [&](const vec3 &seed, IntegralLine &line) {
+        trace(dvec3(vec3(seedTransform * vec4(seed, 1.0f))), line);
+    });
+}
 
+void StreamLineTracer::trace(const dvec3 &p, IntegralLine &line) const {
     bool fwd = dir_ == IntegralLineProperties::Direction::BOTH ||
                dir_ == IntegralLineProperties::Direction::FWD;
     bool bwd = dir_ == IntegralLineProperties::Direction::BOTH ||
                dir_ == IntegralLineProperties::Direction::BWD;
     bool both = fwd && bwd;
 
-    positions.reserve(steps_ + 2);
-    line.getMetaData("velocity").reserve(steps_ + 2);
+    Channels channels;
+    channels.positions = &line.getPositions();
+    channels.velocity = &line.getMetaData("velocity");
     for (auto &m : metaSamplers_) {
-        line.getMetaData(m.first).reserve(steps_ + 2);
+        channels.meta.push_back(&line.getMetaData(m.first));
+    }
+
+    channels.positions->reserve(steps_ + 2);
+    channels.velocity->reserve(steps_ + 2);
+    for (auto m : channels.meta) {
+        m->reserve(steps_ + 2);
     }
 
     if (bwd) {
-        step(steps_ / (both ? 2 : 1), p, line, false);
+        step(steps_ / (both ? 2 : 1), p, line, channels, false);
     }
-    if (both && !positions.empty()) {
-        std::reverse(positions.begin(),
-            positions.end());  // reverse is faster than insert first
-        positions.pop_back();           // dont repeat first step
-        auto keys = line.getMetaDataKeys();
-        for (auto &key : keys) {
-            auto m = line.getMetaData(key);
-            std::reverse(m.begin(), m.end());  // reverse is faster than insert first
-            m.pop_back();                             // dont repeat first step
+    if (both && !channels.positions->empty()) {
+        // reverse is faster than insert first, and dont repeat first step
+        auto reverse = [](std::vector<dvec3> &v) {
+            std::reverse(v.begin(), v.end());
+            v.pop_back();
+        };
+        reverse(*channels.positions);
+        reverse(*channels.velocity);
+        for (auto m : channels.meta) {
+            reverse(*m);
         }
     }
     if (fwd) {
-        step(steps_ / (both ? 2 : 1), p, line, true);
+        step(steps_ / (both ? 2 : 1), p, line, channels, true);
     }
-
-    return line;
-}
-
-inviwo::IntegralLine StreamLineTracer::traceFrom(const vec3 &p) {
-    return traceFrom(dvec3(p));
 }
 
-void StreamLineTracer::step(int steps, dvec3 curPos, IntegralLine &line,bool fwd) {
-    auto& positions = line.getPositions();
-
+void StreamLineTracer::step(int steps, dvec3 curPos, IntegralLine &line, Channels &channels,
+                            bool fwd) const {
     for (int i = 0; i <= steps; i++) {
         if (!volumeSampler_->withinBounds(curPos)) {
             line.setTerminationReason(IntegralLine::TerminationReason::OutOfBounds);
             break;
         }
 
+        // The velocity at curPos is the first sample of either scheme, reuse it for the meta data
+        dvec3 worldVelocity;
         dvec3 v;
-        switch (integrationScheme_)
-        {
-        case IntegralLineProperties::IntegrationScheme::RK4:
-            v = rk4(curPos, invBasis_ , fwd);
-            break;
-        case IntegralLineProperties::IntegrationScheme::Euler:
-        default:
-            v = euler(curPos);
-            break;
+        switch (integrationScheme_) {
+            case IntegralLineProperties::IntegrationScheme::RK4:
+                v = rk4(curPos, invBasis_, fwd, worldVelocity);
+                break;
+            case IntegralLineProperties::IntegrationScheme::Euler:
+            default:
+                v = worldVelocity = euler(curPos);
+                break;
         }
-        
+
         if (glm::length(v) < std::numeric_limits<double>::epsilon()) {
             line.setTerminationReason(IntegralLine::TerminationReason::ZeroVelocity);
             break;
         }
 
-        
-        const dvec3 worldVelocty{volumeSampler_->sample(curPos)};
-
-
         if (normalizeSample_) v = glm::normalize(v);
         dvec3 velocity = invBasis_ * (v * stepSize_ * (fwd ? 1.0 : -1.0));
-        positions.push_back(curPos);
-        line.getMetaData("velocity").push_back(worldVelocty);
-        for (auto &m : metaSamplers_) {
-            line.getMetaData(m.first).push_back(m.second->sample(curPos));
+        channels.positions->push_back(curPos);
+        channels.velocity->push_back(worldVelocity);
+        for (size_t j = 0; j < metaSamplers_.size(); ++j) {
+            channels.meta[j]->push_back(metaSamplers_[j].second->sample(curPos));
         }
 
         curPos += velocity;
     }
 }
 
-dvec3 StreamLineTracer::euler(const dvec3 &curPos) {
+dvec3 StreamLineTracer::euler(const dvec3 &curPos) const {
     return dvec3(volumeSampler_->sample(curPos));
 }
 
-dvec3 StreamLineTracer::rk4(const dvec3 &curPos ,const  dmat3 &m , bool fwd ) {
+dvec3 StreamLineTracer::rk4(const dvec3 &curPos, const dmat3 &m, bool fwd, dvec3 &k1) const {
     auto h = stepSize_;
     if (!fwd) h = -h;
     auto h2 = h / 2;
@@ -155,9 +172,9 @@ dvec3 StreamLineTracer::rk4(const dvec3 &curPos ,const  dmat3 &m , bool fwd ) {
         }
     };
 
-    auto k1 = dvec3(volumeSampler_->sample(curPos));
-    if (normalizeSample_) k1 = normalize(k1);
-    auto K1 = m * k1;
+    k1 = dvec3(volumeSampler_->sample(curPos));
+    auto n1 = normalizeSample_ ? normalize(k1) : k1;
+    auto K1 = m * n1;
     auto k2 = dvec3(volumeSampler_->sample(curPos + K1 * h2));
     if (normalizeSample_) k2 = normalize(k2);
     auto K2 = m * k2;
@@ -167,7 +184,7 @@ dvec3 StreamLineTracer::rk4(const dvec3 &curPos ,const  dmat3 &m , bool fwd ) {
     auto k4 = dvec3(volumeSampler_->sample(curPos + K3 * h));
     if (normalizeSample_) k4 = normalize(k4);
 
-    return (k1 + 2.0 * (k2 + k3) + k4) / 6.0;
+    return (n1 + 2.0 * (k2 + k3) + k4) / 6.0;
 }
 
 }  // namespace
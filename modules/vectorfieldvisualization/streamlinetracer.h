@@ -59,19 +59,39 @@ public:
     IntegralLine traceFrom(const dvec3 &p);
     IntegralLine traceFrom(const vec3 &p);
 
+    /**
+     * Trace one line from each seed, transformed by seedTransform, in parallel on the thread
+     * pool. Line i of the result is traced from seeds[i] and has the index `startIndex + i`.
+     */
+    std::vector<IntegralLine> traceFrom(const std::vector<vec3> &seeds,
+                                        const mat4 &seedTransform = mat4(1.0f),
+                                        size_t startIndex = 0) const;
 
 private:
-    void step(int steps, dvec3 curPos, IntegralLine &line,bool fwd);
-    dvec3 euler(const dvec3 &curPos);
-    dvec3 rk4(const dvec3 &curPos , const dmat3 &m , bool fwd);
+    /**
+     * Output vectors of a line, looked up once per line instead of by name in every step. The
+     * meta vectors are in the same order as metaSamplers_.
+     */
+    struct Channels {
+        std::vector<dvec3> *positions;
+        std::vector<dvec3> *velocity;
+        std::vector<std::vector<dvec3> *> meta;
+    };
+
+    void trace(const dvec3 &p, IntegralLine &line) const;
+    void step(int steps, dvec3 curPos, IntegralLine &line, Channels &channels, bool fwd) const;
+    dvec3 euler(const dvec3 &curPos) const;
+    /**
+     * Returns the averaged RK4 velocity, k1 is set to the unnormalized sample at curPos.
+     */
+    dvec3 rk4(const dvec3 &curPos, const dmat3 &m, bool fwd, dvec3 &k1) const;
 
     dmat3 invBasis_;
-    std::map<std::string, std::shared_ptr<const SpatialSampler<3,3,double>>> metaSamplers_;
+    std::vector<std::pair<std::string, std::shared_ptr<const SpatialSampler<3, 3, double>>>>
+        metaSamplers_;
     std::shared_ptr<const SpatialSampler<3, 3, double>> volumeSampler_;
 
-
     bool normalizeSample_;
-    
 };
 
 }  // namespace
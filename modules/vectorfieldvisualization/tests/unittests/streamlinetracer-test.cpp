@@ -0,0 +1,165 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/util/poolutils.h>
+#include <inviwo/core/util/spatialsampler.h>
+#include <modules/vectorfieldvisualization/streamlinetracer.h>
+
+#include <tuple>
+
+namespace inviwo {
+
+namespace {
+
+// Rotation around the center of the volume, counter clockwise in the xy-plane
+class RotationSampler : public SpatialSampler<3, 3, double> {
+public:
+    RotationSampler(const Volume& volume) : SpatialSampler<3, 3, double>(volume) {}
+
+protected:
+    virtual dvec3 sampleDataSpace(const dvec3& pos) const override {
+        const dvec3 d = pos - dvec3(0.5);
+        return dvec3(-d.y, d.x, 0.0);
+    }
+    virtual bool withinBoundsDataSpace(const dvec3& pos) const override {
+        return !(glm::any(glm::lessThan(pos, dvec3(0.0))) ||
+                 glm::any(glm::greaterThan(pos, dvec3(1.0))));
+    }
+};
+
+// Returns the position it is sampled at, to check which position meta data belongs to
+class PositionSampler : public RotationSampler {
+public:
+    using RotationSampler::RotationSampler;
+
+protected:
+    virtual dvec3 sampleDataSpace(const dvec3& pos) const override { return pos; }
+};
+
+class TestProperties : public StreamLineProperties {
+public:
+    TestProperties(IntegralLineProperties::Direction dir)
+        : StreamLineProperties("streamLineProperties", "Stream Line Properties") {
+        numberOfSteps_.set(200);
+        stepSize_.set(0.01f);
+        stepDirection_.setSelectedValue(dir);
+    }
+};
+
+std::shared_ptr<Volume> unitVolume() {
+    auto volume = std::make_shared<Volume>(size3_t(8), DataVec3Float64::get());
+    volume->setBasis(mat3(1.0f));
+    volume->setOffset(vec3(0.0f));
+    return volume;
+}
+
+std::vector<vec3> gridSeeds(size_t n) {
+    std::vector<vec3> seeds;
+    for (size_t j = 0; j < n; ++j) {
+        for (size_t i = 0; i < n; ++i) {
+            seeds.emplace_back(0.2f + 0.6f * i / (n - 1), 0.2f + 0.6f * j / (n - 1), 0.5f);
+        }
+    }
+    return seeds;
+}
+
+void expectEqualLines(const IntegralLine& expected, const IntegralLine& line) {
+    EXPECT_EQ(expected.getPositions(), line.getPositions());
+    EXPECT_EQ(expected.getMetaData("velocity"), line.getMetaData("velocity"));
+    EXPECT_EQ(expected.getMetaData("position"), line.getMetaData("position"));
+}
+
+}  // namespace
+
+TEST(StreamLineTracer, BatchedMatchesSingleLines) {
+    const auto volume = unitVolume();
+    const TestProperties properties(IntegralLineProperties::Direction::BOTH);
+    StreamLineTracer tracer(std::make_shared<RotationSampler>(*volume), properties);
+    tracer.addMetaSampler("position", std::make_shared<PositionSampler>(*volume));
+
+    // Enough seeds for several ranges when there is a pool
+    const auto seeds = gridSeeds(16);
+    const size_t startIndex = 10;
+
+    std::vector<IntegralLine> serial, batched;
+    std::tie(serial, batched) = util::serialAndParallel(
+        [&]() { return tracer.traceFrom(seeds, mat4(1.0f), startIndex); });
+
+    ASSERT_EQ(seeds.size(), serial.size());
+    ASSERT_EQ(seeds.size(), batched.size());
+    for (size_t i = 0; i < seeds.size(); ++i) {
+        const auto single = tracer.traceFrom(dvec3(seeds[i]));
+        ASSERT_FALSE(single.getPositions().empty());
+        EXPECT_EQ(startIndex + i, serial[i].getIndex());
+        EXPECT_EQ(startIndex + i, batched[i].getIndex());
+        expectEqualLines(single, serial[i]);
+        expectEqualLines(single, batched[i]);
+    }
+}
+
+TEST(StreamLineTracer, BothDirectionsKeepsMetaDataInLineOrder) {
+    const auto volume = unitVolume();
+    const TestProperties properties(IntegralLineProperties::Direction::BOTH);
+    const RotationSampler rotation(*volume);
+    StreamLineTracer tracer(std::make_shared<RotationSampler>(*volume), properties);
+    tracer.addMetaSampler("position", std::make_shared<PositionSampler>(*volume));
+
+    const dvec3 seed(0.8, 0.5, 0.5);
+    const auto line = tracer.traceFrom(seed);
+    const auto& positions = line.getPositions();
+    const auto& velocities = line.getMetaData("velocity");
+    const auto& meta = line.getMetaData("position");
+
+    // 100 steps backward, reversed and without the seed, then the seed and 100 steps forward
+    ASSERT_EQ(201, positions.size());
+    ASSERT_EQ(positions.size(), velocities.size());
+    ASSERT_EQ(positions.size(), meta.size());
+    EXPECT_EQ(seed, positions[100]);
+
+    for (size_t i = 0; i < positions.size(); ++i) {
+        EXPECT_EQ(positions[i], meta[i]) << "at " << i;
+        EXPECT_EQ(rotation.sample(positions[i]), velocities[i]) << "at " << i;
+    }
+    // The whole line runs counter clockwise around the center
+    for (size_t i = 0; i + 1 < positions.size(); ++i) {
+        const dvec3 a = positions[i] - dvec3(0.5);
+        const dvec3 b = positions[i + 1] - dvec3(0.5);
+        EXPECT_GT(a.x * b.y - a.y * b.x, 0.0) << "at " << i;
+    }
+}
+
+}  // namespace inviwo
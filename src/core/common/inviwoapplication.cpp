@@ -31,6 +31,8 @@
 #include <inviwo/core/common/inviwomodule.h>
 #include <inviwo/core/common/moduleaction.h>
 #include <inviwo/core/datastructures/camerafactory.h>
+#include <inviwo/core/datastructures/representationmemorymanager.h>
+#include <inviwo/core/datastructures/volume/volumebrickcache.h>
 #include <inviwo/core/interaction/pickingmanager.h>
 #include <inviwo/core/io/datareaderfactory.h>
 #include <inviwo/core/io/datawriterfactory.h>
@@ -58,6 +60,7 @@
 #include <inviwo/core/util/dialogfactory.h>
 #include <inviwo/core/util/fileobserver.h>
 #include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/util/formatconversion.h>
 #include <inviwo/core/util/rendercontext.h>
 #include <inviwo/core/util/settings/settings.h>
 #include <inviwo/core/util/systemcapabilities.h>
@@ -65,6 +68,7 @@
 #include <inviwo/core/util/consolelogger.h>
 #include <inviwo/core/util/filelogger.h>
 #include <inviwo/core/util/timer.h>
+#include <inviwo/core/util/trace.h>
 #include <inviwo/core/util/settings/systemsettings.h>
 
 namespace inviwo {
@@ -90,6 +94,28 @@ void dataFormatDummyInitialization() {
 
 }  // namespace util
 
+namespace {
+/*
+ * Relative file names given on the command line are relative to the output path, if one is given,
+ * otherwise to the working directory. The directory of the file is created if needed.
+ */
+std::string outputFilePath(const CommandLineParser& parser, std::string filename) {
+    if (!filesystem::isAbsolutePath(filename)) {
+        auto outputDir = parser.getOutputPath();
+        if (!outputDir.empty()) {
+            filename = outputDir + "/" + filename;
+        } else {
+            filename = filesystem::getWorkingDirectory() + "/" + filename;
+        }
+    }
+    auto dir = filesystem::getFileDirectory(filename);
+    if (!filesystem::directoryExists(dir)) {
+        filesystem::createDirectoryRecursively(dir);
+    }
+    return filename;
+}
+}  // namespace
+
 InviwoApplication* InviwoApplication::instance_ = nullptr;
 
 InviwoApplication::InviwoApplication(int argc, char** argv, std::string displayName)
@@ -106,19 +132,8 @@ InviwoApplication::InviwoApplication(int argc, char** argv, std::string displayN
     }()}
     , filelogger_{[&]() {
         if (commandLineParser_.getLogToFile()) {
-            auto filename = commandLineParser_.getLogToFileFileName();
-            if (!filesystem::isAbsolutePath(filename)) {
-                auto outputDir = commandLineParser_.getOutputPath();
-                if (!outputDir.empty()) {
-                    filename = outputDir + "/" + filename;
-                } else {
-                    filename = filesystem::getWorkingDirectory() + "/" + filename;
-                }
-            }
-            auto dir = filesystem::getFileDirectory(filename);
-            if (!filesystem::directoryExists(dir)) {
-                filesystem::createDirectoryRecursively(dir);
-            }
+            auto filename =
+                outputFilePath(commandLineParser_, commandLineParser_.getLogToFileFileName());
             auto flog = std::make_shared<FileLogger>(filename);
             LogCentral::getPtr()->registerLogger(flog);
             return flog;
@@ -132,6 +147,8 @@ InviwoApplication::InviwoApplication(int argc, char** argv, std::string displayN
     , clearAllSingeltons_{[]() {
         PickingManager::deleteInstance();
         RenderContext::deleteInstance();
+        VolumeBrickCache::deleteInstance();
+        RepresentationMemoryManager::deleteInstance();
     }}
     , resourceManager_{std::make_unique<ResourceManager>()}
     , cameraFactory_{std::make_unique<CameraFactory>()}
@@ -161,6 +178,11 @@ InviwoApplication::InviwoApplication(int argc, char** argv, std::string displayN
     , propertyPresetManager_{std::make_unique<PropertyPresetManager>(this)}
     , portInspectorManager_{std::make_unique<PortInspectorManager>(this)} {
 
+    if (!commandLineParser_.getTraceFileName().empty()) {
+        trace::Tracer::setThreadName("Main");
+        trace::Tracer::start();
+    }
+
     // Keep the pool at size 0 if are quiting directly to make sure that we don't have
     // unfinished results in the worker threads
     if (!commandLineParser_.getQuitApplicationAfterStartup()) {
@@ -168,6 +190,13 @@ InviwoApplication::InviwoApplication(int argc, char** argv, std::string displayN
         systemSettings_->poolSize_.onChange([this]() { resizePool(systemSettings_->poolSize_); });
     }
 
+    processorNetworkEvaluator_->setConcurrentEvaluation(
+        systemSettings_->concurrentEvaluation_.get());
+    systemSettings_->concurrentEvaluation_.onChange([this]() {
+        processorNetworkEvaluator_->setConcurrentEvaluation(
+            systemSettings_->concurrentEvaluation_.get());
+    });
+
     resourceManager_->setEnabled(systemSettings_->enableResourceManager_.get());
     systemSettings_->enableResourceManager_.onChange(
         [this]() { resourceManager_->setEnabled(systemSettings_->enableResourceManager_.get()); });
@@ -187,6 +216,25 @@ InviwoApplication::InviwoApplication(int argc, char** argv, std::string displayN
     init(this);
     RenderContext::init();
     PickingManager::init();
+    VolumeBrickCache::init();
+    VolumeBrickCache::getPtr()->setBudget(systemSettings_->brickCacheSize_.get() * 1024 * 1024);
+    systemSettings_->brickCacheSize_.onChange([this]() {
+        VolumeBrickCache::getPtr()->setBudget(systemSettings_->brickCacheSize_.get() * 1024 * 1024);
+    });
+    RepresentationMemoryManager::init();
+    auto memoryManager = RepresentationMemoryManager::getPtr();
+    representationMemoryHandle_ = memoryManager->onEvict([this, memoryManager]() {
+        systemSettings_->representationMemoryUsage_.set(
+            util::formatBytesToString(memoryManager->getSize()) + " in " +
+            toString(memoryManager->getNumberOfRepresentations()) + " representations, " +
+            util::formatBytesToString(memoryManager->getEvictedBytes()) + " evicted");
+    });
+    memoryManager->setBudget(systemSettings_->representationMemoryBudget_.get() * 1024 * 1024);
+    systemSettings_->representationMemoryBudget_.onChange([this]() {
+        RepresentationMemoryManager::getPtr()->setBudget(
+            systemSettings_->representationMemoryBudget_.get() * 1024 * 1024);
+    });
+    processorNetworkEvaluator_->addObserver(memoryManager);
 
     workspaceManager_->registerFactory(getProcessorFactory());
     workspaceManager_->registerFactory(getMetaDataFactory());
@@ -228,7 +276,20 @@ InviwoApplication::InviwoApplication() : InviwoApplication(0, nullptr, "Inviwo")
 InviwoApplication::InviwoApplication(std::string displayName)
     : InviwoApplication(0, nullptr, displayName) {}
 
-InviwoApplication::~InviwoApplication() { resizePool(0); }
+InviwoApplication::~InviwoApplication() {
+    resizePool(0);
+
+    const auto traceFile = commandLineParser_.getTraceFileName();
+    if (!traceFile.empty()) {
+        trace::Tracer::stop();
+        try {
+            trace::Tracer::writeChromeTrace(outputFilePath(commandLineParser_, traceFile));
+        } catch (const Exception& e) {
+            util::log(e.getContext(), "Unable to write trace file: " + e.getMessage(),
+                      LogLevel::Error);
+        }
+    }
+}
 
 void InviwoApplication::registerModules(
     std::vector<std::unique_ptr<InviwoModuleFactoryObject>> moduleFactories) {
@@ -313,6 +374,8 @@ void InviwoApplication::postProgress(std::string progress) {
 
 size_t InviwoApplication::getPoolSize() const { return pool_.getSize(); }
 
+size_t InviwoApplication::getNumberOfPoolTasks() const { return pool_.getNumberOfTasks(); }
+
 void InviwoApplication::setPostEnqueueFront(std::function<void()> func) {
     queue_.postEnqueue = std::move(func);
 }
@@ -36,6 +36,7 @@
 
 // Data Structures
 #include <inviwo/core/datastructures/volume/volumeramconverter.h>
+#include <inviwo/core/datastructures/volume/volumebrickedconverter.h>
 #include <inviwo/core/datastructures/image/layerramconverter.h>
 #include <inviwo/core/datastructures/representationconverterfactory.h>
 
@@ -158,6 +159,10 @@ InviwoCore::InviwoCore(InviwoApplication* app)
     // Register Converters
     registerRepresentationConverter<VolumeRepresentation>(
         util::make_unique<VolumeDisk2RAMConverter>());
+    registerRepresentationConverter<VolumeRepresentation>(
+        util::make_unique<VolumeDisk2BrickedConverter>());
+    registerRepresentationConverter<VolumeRepresentation>(
+        util::make_unique<VolumeBricked2RAMConverter>());
     registerRepresentationConverter<LayerRepresentation>(
         util::make_unique<LayerDisk2RAMConverter>());
 
@@ -0,0 +1,155 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/datastructures/representationmemorymanager.h>
+#include <inviwo/core/common/inviwoapplication.h>
+
+#include <algorithm>
+
+namespace inviwo {
+
+RepresentationMemoryManager* RepresentationMemoryManager::instance_ = nullptr;
+
+RepresentationMemoryManager::RepresentationMemoryManager(size_t budget)
+    : epoch_{0}, budget_{budget}, evictedBytes_{0}, evictions_{0} {}
+
+std::shared_ptr<RepresentationMemoryManager::Usage> RepresentationMemoryManager::use(
+    Owner* owner, const void* repr, size_t bytes) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = entries_.find(repr);
+    if (it != entries_.end()) {
+        lru_.splice(lru_.begin(), lru_, it->second);
+        it->second->owner = owner;
+    } else {
+        lru_.push_front(Entry{owner, repr, std::make_shared<Usage>()});
+        entries_[repr] = lru_.begin();
+    }
+    auto usage = lru_.front().usage;
+    touch(*usage, bytes);
+    return usage;
+}
+
+void RepresentationMemoryManager::remove(const void* repr) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = entries_.find(repr);
+    if (it != entries_.end()) {
+        lru_.erase(it->second);
+        entries_.erase(it);
+    }
+}
+
+void RepresentationMemoryManager::evict() {
+    // Tasks on the pool, like background jobs, might use representations by raw pointer
+    if (InviwoApplication::isInitialized() &&
+        InviwoApplication::getPtr()->getNumberOfPoolTasks() > 0) {
+        return;
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        const auto epoch = epoch_.load();
+
+        // Least recently used first, the order of the list breaks ties within an epoch.
+        // Representations used in the current or the last evaluation are pinned, the outputs of
+        // the last evaluation are still referenced by raw pointer in the network.
+        std::vector<std::list<Entry>::iterator> candidates;
+        for (auto it = lru_.begin(); it != lru_.end(); ++it) {
+            if (it->usage->epoch + 1 < epoch) candidates.push_back(it);
+        }
+        std::reverse(candidates.begin(), candidates.end());
+        std::stable_sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+            return a->usage->epoch < b->usage->epoch;
+        });
+
+        // Skip representations that are in use or that can not be rebuilt
+        auto size = computeSize();
+        for (auto it : candidates) {
+            if (size <= budget_) break;
+            if (it->owner->evictRepresentation(it->repr)) {
+                const size_t bytes = it->usage->bytes;
+                size -= bytes;
+                evictedBytes_ += bytes;
+                ++evictions_;
+                entries_.erase(it->repr);
+                lru_.erase(it);
+            }
+        }
+    }
+    onEvict_.invoke();
+}
+
+void RepresentationMemoryManager::setBudget(size_t bytes) {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        budget_ = bytes;
+    }
+    evict();
+}
+
+size_t RepresentationMemoryManager::getBudget() const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return budget_;
+}
+
+size_t RepresentationMemoryManager::getSize() const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return computeSize();
+}
+
+size_t RepresentationMemoryManager::computeSize() const {
+    size_t size = 0;
+    for (const auto& entry : lru_) size += entry.usage->bytes;
+    return size;
+}
+
+size_t RepresentationMemoryManager::getNumberOfRepresentations() const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return lru_.size();
+}
+
+size_t RepresentationMemoryManager::getEvictedBytes() const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return evictedBytes_;
+}
+
+size_t RepresentationMemoryManager::getNumberOfEvictions() const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return evictions_;
+}
+
+std::shared_ptr<std::function<void()>> RepresentationMemoryManager::onEvict(
+    std::function<void()> callback) {
+    return onEvict_.add(std::move(callback));
+}
+
+void RepresentationMemoryManager::onProcessorNetworkEvaluationEnd() {
+    ++epoch_;
+    evict();
+}
+
+}  // namespace inviwo
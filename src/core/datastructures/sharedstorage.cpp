@@ -0,0 +1,63 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/datastructures/sharedstorage.h>
+
+#include <atomic>
+
+namespace inviwo {
+
+namespace {
+
+std::atomic<std::ptrdiff_t>& logicalBytes() {
+    static std::atomic<std::ptrdiff_t> bytes{0};
+    return bytes;
+}
+
+std::atomic<std::ptrdiff_t>& physicalBytes() {
+    static std::atomic<std::ptrdiff_t> bytes{0};
+    return bytes;
+}
+
+}  // namespace
+
+void detail::trackSharedStorageLogical(std::ptrdiff_t bytes) {
+    logicalBytes().fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void detail::trackSharedStoragePhysical(std::ptrdiff_t bytes) {
+    physicalBytes().fetch_add(bytes, std::memory_order_relaxed);
+}
+
+util::SharedStorageMemory util::getSharedStorageMemory() {
+    return {static_cast<size_t>(std::max<std::ptrdiff_t>(0, logicalBytes().load())),
+            static_cast<size_t>(std::max<std::ptrdiff_t>(0, physicalBytes().load()))};
+}
+
+}  // namespace inviwo
@@ -0,0 +1,118 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *********************************************************************************/
+
+#include <inviwo/core/datastructures/volume/volumebrickcache.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+
+namespace inviwo {
+
+VolumeBrickCache* VolumeBrickCache::instance_ = nullptr;
+std::atomic<size_t> VolumeBrickCache::volumeIdCounter_{0};
+
+VolumeBrickCache::VolumeBrickCache(size_t budget) : budget_{budget}, size_{0} {}
+
+std::shared_ptr<const VolumeRAM> VolumeBrickCache::get(size_t volumeId, size_t brick,
+                                                       const Loader& loader) {
+    const Key key{volumeId, brick};
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            return it->second->brick;
+        }
+    }
+
+    // Load without holding the lock, other threads might load other bricks meanwhile.
+    auto loaded = loader();
+    if (!loaded) return loaded;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {  // Someone else loaded the same brick, use that one.
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return it->second->brick;
+    }
+    const auto bytes = loaded->getNumberOfBytes();
+    lru_.push_front(Entry{key, loaded, bytes});
+    entries_[key] = lru_.begin();
+    size_ += bytes;
+    evict();
+    return loaded;
+}
+
+void VolumeBrickCache::clear(size_t volumeId) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (auto it = lru_.begin(); it != lru_.end();) {
+        if (it->key.volume == volumeId) {
+            size_ -= it->bytes;
+            entries_.erase(it->key);
+            it = lru_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void VolumeBrickCache::clear() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    entries_.clear();
+    lru_.clear();
+    size_ = 0;
+}
+
+void VolumeBrickCache::setBudget(size_t bytes) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    budget_ = bytes;
+    evict();
+}
+
+size_t VolumeBrickCache::getBudget() const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return budget_;
+}
+
+size_t VolumeBrickCache::getSize() const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return size_;
+}
+
+size_t VolumeBrickCache::newVolumeId() { return ++volumeIdCounter_; }
+
+void VolumeBrickCache::evict() {
+    // Always keep the most recently used brick, even if it is larger than the budget.
+    while (size_ > budget_ && lru_.size() > 1) {
+        auto& last = lru_.back();
+        size_ -= last.bytes;
+        entries_.erase(last.key);
+        lru_.pop_back();
+    }
+}
+
+}  // namespace inviwo
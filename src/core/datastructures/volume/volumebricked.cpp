@@ -0,0 +1,195 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *********************************************************************************/
+
+#include <inviwo/core/datastructures/volume/volumebricked.h>
+#include <inviwo/core/datastructures/volume/volumebrickcache.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/datastructures/representationconverter.h>
+#include <inviwo/core/datastructures/representationmemorymanager.h>
+
+#include <cstring>
+#include <limits>
+
+namespace inviwo {
+
+VolumeBricked::CacheHandle::CacheHandle() : id{VolumeBrickCache::newVolumeId()} {}
+
+VolumeBricked::CacheHandle::~CacheHandle() {
+    if (VolumeBrickCache::isInitialized()) VolumeBrickCache::getPtr()->clear(id);
+}
+
+VolumeBricked::VolumeBricked(const DiskRepresentationLoader<VolumeRepresentation>& loader,
+                             size3_t dimensions, const DataFormatBase* format, size3_t brickSize,
+                             size_t ghostBorder)
+    : VolumeRepresentation(format)
+    , loader_{loader.clone()}
+    , regionLoader_{dynamic_cast<const VolumeRegionLoader*>(loader_.get())}
+    , dimensions_{dimensions}
+    , brickSize_{glm::max(brickSize, size3_t(1))}
+    , ghostBorder_{ghostBorder}
+    , cache_{std::make_shared<CacheHandle>()} {
+
+    if (!regionLoader_) {
+        throw Exception("A VolumeBricked requires a loader that is a VolumeRegionLoader",
+                        IvwContext);
+    }
+}
+
+VolumeBricked* VolumeBricked::clone() const { return new VolumeBricked(*this); }
+
+std::type_index VolumeBricked::getTypeIndex() const {
+    return std::type_index(typeid(VolumeBricked));
+}
+
+void VolumeBricked::setDimensions(size3_t) {
+    throw Exception("Can not set dimension of a Volume Bricked", IvwContext);
+}
+
+const size3_t& VolumeBricked::getDimensions() const { return dimensions_; }
+
+const size3_t& VolumeBricked::getBrickSize() const { return brickSize_; }
+
+size_t VolumeBricked::getGhostBorder() const { return ghostBorder_; }
+
+size3_t VolumeBricked::getBrickCount() const {
+    return (dimensions_ + brickSize_ - size3_t(1)) / brickSize_;
+}
+
+size3_t VolumeBricked::getBrickIndex(const size3_t& pos) const { return pos / brickSize_; }
+
+size3_t VolumeBricked::getBrickDataOffset(const size3_t& brick) const {
+    const size3_t start = brick * brickSize_;
+    return glm::max(start, size3_t(ghostBorder_)) - size3_t(ghostBorder_);
+}
+
+size3_t VolumeBricked::getBrickDataDimensions(const size3_t& brick) const {
+    const size3_t end = glm::min((brick + size3_t(1)) * brickSize_ + size3_t(ghostBorder_),
+                                 dimensions_);
+    return end - getBrickDataOffset(brick);
+}
+
+std::shared_ptr<const VolumeRAM> VolumeBricked::getBrick(const size3_t& brick) const {
+    const auto load = [&]() -> std::shared_ptr<const VolumeRAM> {
+        const auto offset = getBrickDataOffset(brick);
+        const auto dims = getBrickDataDimensions(brick);
+        auto ram = createVolumeRAM(dims, getDataFormat());
+        regionLoader_->readRegion(offset, dims, ram->getData());
+        return ram;
+    };
+
+    if (!VolumeBrickCache::isInitialized()) return load();
+
+    const auto count = getBrickCount();
+    const size_t index = brick.x + count.x * (brick.y + count.y * brick.z);
+    return VolumeBrickCache::getPtr()->get(cache_->id, index, load);
+}
+
+std::shared_ptr<VolumeRAM> VolumeBricked::getRegion(const size3_t& offset,
+                                                    const size3_t& dimensions) const {
+    auto ram = createVolumeRAM(dimensions, getDataFormat());
+    readRegion(offset, dimensions, ram->getData());
+    return ram;
+}
+
+void VolumeBricked::readRegion(const size3_t& offset, const size3_t& dimensions,
+                               void* dest) const {
+    if (glm::any(glm::greaterThan(offset + dimensions, dimensions_))) {
+        throw Exception("Region outside of volume, can't read", IvwContext);
+    }
+    if (dimensions.x == 0 || dimensions.y == 0 || dimensions.z == 0) return;
+
+    const size_t voxelSize = getDataFormat()->getSize();
+    const size3_t end = offset + dimensions;
+    const size3_t first = getBrickIndex(offset);
+    const size3_t last = getBrickIndex(end - size3_t(1));
+    auto dst = static_cast<char*>(dest);
+
+    size3_t brick;
+    for (brick.z = first.z; brick.z <= last.z; ++brick.z) {
+        for (brick.y = first.y; brick.y <= last.y; ++brick.y) {
+            for (brick.x = first.x; brick.x <= last.x; ++brick.x) {
+                const auto data = getBrick(brick);
+                const auto src = static_cast<const char*>(data->getData());
+                const auto dataOffset = getBrickDataOffset(brick);
+                const auto dataDims = getBrickDataDimensions(brick);
+
+                // The part of the region covered by this brick, excluding the ghost border
+                const size3_t lo = glm::max(brick * brickSize_, offset);
+                const size3_t hi = glm::min((brick + size3_t(1)) * brickSize_, end);
+                const size_t rowBytes = (hi.x - lo.x) * voxelSize;
+
+                for (size_t z = lo.z; z < hi.z; ++z) {
+                    for (size_t y = lo.y; y < hi.y; ++y) {
+                        const size_t srcIndex =
+                            ((z - dataOffset.z) * dataDims.y + (y - dataOffset.y)) * dataDims.x +
+                            (lo.x - dataOffset.x);
+                        const size_t dstIndex =
+                            ((z - offset.z) * dimensions.y + (y - offset.y)) * dimensions.x +
+                            (lo.x - offset.x);
+                        std::memcpy(dst + dstIndex * voxelSize, src + srcIndex * voxelSize,
+                                    rowBytes);
+                    }
+                }
+            }
+        }
+    }
+}
+
+const DiskRepresentationLoader<VolumeRepresentation>& VolumeBricked::getLoader() const {
+    return *loader_;
+}
+
+size_t VolumeBricked::getCacheId() const { return cache_->id; }
+
+const VolumeBricked* util::getBrickedRepresentation(const Volume& volume) {
+    if (volume.hasRepresentation<VolumeRAM>() || !volume.hasRepresentation<VolumeDisk>()) {
+        return nullptr;
+    }
+    try {
+        if (!volume.hasRepresentation<VolumeBricked>()) {
+            const auto loader = volume.getRepresentation<VolumeDisk>()->getLoader();
+            if (!dynamic_cast<const VolumeRegionLoader*>(loader)) return nullptr;
+        }
+        return volume.getRepresentation<VolumeBricked>();
+    } catch (const ConverterException&) {
+        return nullptr;
+    }
+}
+
+const VolumeBricked* util::getBrickedRepresentationOverBudget(const Volume& volume) {
+    const size_t budget = RepresentationMemoryManager::isInitialized()
+                              ? RepresentationMemoryManager::getPtr()->getBudget()
+                              : std::numeric_limits<size_t>::max();
+    const size_t bytes = glm::compMul(volume.getDimensions()) * volume.getDataFormat()->getSize();
+    if (bytes <= budget) return nullptr;
+    return getBrickedRepresentation(volume);
+}
+
+}  // namespace inviwo
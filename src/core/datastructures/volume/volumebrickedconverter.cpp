@@ -0,0 +1,60 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *********************************************************************************/
+
+#include <inviwo/core/datastructures/volume/volumebrickedconverter.h>
+
+namespace inviwo {
+
+std::shared_ptr<VolumeBricked> VolumeDisk2BrickedConverter::createFrom(
+    std::shared_ptr<const VolumeDisk> source) const {
+    if (!source->getLoader()) {
+        throw ConverterException("Volume disk without loader", IvwContext);
+    }
+    // A ghost border of one voxel lets trilinear interpolation be done within a single brick
+    return std::make_shared<VolumeBricked>(*source->getLoader(), source->getDimensions(),
+                                           source->getDataFormat(), size3_t(64), 1);
+}
+
+void VolumeDisk2BrickedConverter::update(std::shared_ptr<const VolumeDisk>,
+                                         std::shared_ptr<VolumeBricked>) const {
+    // The bricks are read from disk on demand, nothing to update
+}
+
+std::shared_ptr<VolumeRAM> VolumeBricked2RAMConverter::createFrom(
+    std::shared_ptr<const VolumeBricked> source) const {
+    // Load the whole volume directly, going through the bricks would only thrash the cache
+    return std::static_pointer_cast<VolumeRAM>(source->getLoader().createRepresentation());
+}
+
+void VolumeBricked2RAMConverter::update(std::shared_ptr<const VolumeBricked> source,
+                                        std::shared_ptr<VolumeRAM> destination) const {
+    source->getLoader().updateRepresentation(destination);
+}
+
+}  // namespace inviwo
@@ -32,8 +32,62 @@
 #include <inviwo/core/util/raiiutils.h>
 #include <inviwo/core/util/filesystem.h>
 
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+
 namespace inviwo {
 
+namespace {
+
+inline std::uint16_t byteSwap(std::uint16_t v) {
+    return static_cast<std::uint16_t>((v << 8) | (v >> 8));
+}
+inline std::uint32_t byteSwap(std::uint32_t v) {
+    return ((v & 0x000000ffu) << 24) | ((v & 0x0000ff00u) << 8) | ((v & 0x00ff0000u) >> 8) |
+           ((v & 0xff000000u) >> 24);
+}
+inline std::uint64_t byteSwap(std::uint64_t v) {
+    return (static_cast<std::uint64_t>(byteSwap(static_cast<std::uint32_t>(v))) << 32) |
+           byteSwap(static_cast<std::uint32_t>(v >> 32));
+}
+
+// Branch free loop over plain integers, simple enough to be vectorized by the compiler.
+template <typename T>
+void swapBytesTyped(char* data, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        T v;
+        std::memcpy(&v, data + i * sizeof(T), sizeof(T));
+        v = byteSwap(v);
+        std::memcpy(data + i * sizeof(T), &v, sizeof(T));
+    }
+}
+
+}  // namespace
+
+void util::swapBytes(void* data, size_t bytes, size_t elementSize) {
+    auto bytePtr = static_cast<char*>(data);
+    switch (elementSize) {
+        case 0:
+        case 1:
+            break;
+        case 2:
+            swapBytesTyped<std::uint16_t>(bytePtr, bytes / 2);
+            break;
+        case 4:
+            swapBytesTyped<std::uint32_t>(bytePtr, bytes / 4);
+            break;
+        case 8:
+            swapBytesTyped<std::uint64_t>(bytePtr, bytes / 8);
+            break;
+        default:
+            for (size_t i = 0; i + elementSize <= bytes; i += elementSize) {
+                std::reverse(bytePtr + i, bytePtr + i + elementSize);
+            }
+            break;
+    }
+}
+
 void util::readBytesIntoBuffer(const std::string& file, size_t offset, size_t bytes,
                                bool littleEndian, size_t elementSize, void* dest) {
     auto fin = filesystem::ifstream(file, std::ios::in | std::ios::binary);
@@ -44,17 +98,7 @@ void util::readBytesIntoBuffer(const std::string& file, size_t offset, size_t by
         fin.read(static_cast<char*>(dest), bytes);
 
         if (!littleEndian && elementSize > 1) {
-            char* temp = new char[elementSize];
-
-            for (std::size_t i = 0; i < bytes; i += elementSize) {
-                for (std::size_t j = 0; j < elementSize; j++)
-                    temp[j] = static_cast<char*>(dest)[i + j];
-
-                for (std::size_t j = 0; j < elementSize; j++)
-                    static_cast<char*>(dest)[i + j] = temp[elementSize - j - 1];
-            }
-
-            delete[] temp;
+            swapBytes(dest, bytes, elementSize);
         }
     } else {
         throw DataReaderException("Error: Could not read from file: " + file,
@@ -0,0 +1,161 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *********************************************************************************/
+
+#include <inviwo/core/io/memorymappedfile.h>
+#include <inviwo/core/util/exception.h>
+#include <inviwo/core/util/stringconversion.h>
+#include <inviwo/core/util/raiiutils.h>
+
+#ifdef WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace inviwo {
+
+namespace util {
+
+MemoryMappedFile::MemoryMappedFile(const std::string& filename, size_t offset, size_t bytes)
+    : filename_{filename}, mapping_{nullptr}, mappingSize_{0}, offset_{0}, size_{bytes} {
+
+#ifdef WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    const size_t granularity = info.dwAllocationGranularity;
+    const size_t start = offset - offset % granularity;
+    offset_ = offset - start;
+    mappingSize_ = offset_ + bytes;
+
+    HANDLE file = CreateFileW(util::toWstring(filename).c_str(), GENERIC_READ, FILE_SHARE_READ,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw FileException("Could not open file: " + filename, IvwContext);
+    }
+    OnScopeExit closeFile([file]() { CloseHandle(file); });
+
+    const auto end = static_cast<unsigned long long>(start + mappingSize_);
+    HANDLE map = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, static_cast<DWORD>(end >> 32),
+                                    static_cast<DWORD>(end & 0xffffffff), nullptr);
+    if (!map) {
+        throw FileException("Could not map file: " + filename, IvwContext);
+    }
+    OnScopeExit closeMap([map]() { CloseHandle(map); });
+
+    const auto begin = static_cast<unsigned long long>(start);
+    mapping_ = MapViewOfFile(map, FILE_MAP_COPY, static_cast<DWORD>(begin >> 32),
+                             static_cast<DWORD>(begin & 0xffffffff), mappingSize_);
+    if (!mapping_) {
+        throw FileException("Could not map file: " + filename, IvwContext);
+    }
+#else
+    const size_t granularity = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t start = offset - offset % granularity;
+    offset_ = offset - start;
+    mappingSize_ = offset_ + bytes;
+
+    int file = ::open(filename.c_str(), O_RDONLY);
+    if (file == -1) {
+        throw FileException("Could not open file: " + filename, IvwContext);
+    }
+    OnScopeExit closeFile([file]() { ::close(file); });
+
+    struct stat fileStat;
+    if (::fstat(file, &fileStat) != 0 ||
+        static_cast<size_t>(fileStat.st_size) < start + mappingSize_) {
+        throw FileException("File is smaller than the requested mapping: " + filename, IvwContext);
+    }
+
+    // A private mapping is copy-on-write, the file will never be modified.
+    void* mapping = ::mmap(nullptr, mappingSize_, PROT_READ | PROT_WRITE, MAP_PRIVATE, file,
+                           static_cast<off_t>(start));
+    if (mapping == MAP_FAILED) {
+        throw FileException("Could not map file: " + filename, IvwContext);
+    }
+    mapping_ = mapping;
+#endif
+}
+
+MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& rhs)
+    : filename_{std::move(rhs.filename_)}
+    , mapping_{rhs.mapping_}
+    , mappingSize_{rhs.mappingSize_}
+    , offset_{rhs.offset_}
+    , size_{rhs.size_} {
+    rhs.mapping_ = nullptr;
+    rhs.mappingSize_ = 0;
+    rhs.size_ = 0;
+}
+
+MemoryMappedFile& MemoryMappedFile::operator=(MemoryMappedFile&& rhs) {
+    if (this != &rhs) {
+        cleanup();
+        filename_ = std::move(rhs.filename_);
+        mapping_ = rhs.mapping_;
+        mappingSize_ = rhs.mappingSize_;
+        offset_ = rhs.offset_;
+        size_ = rhs.size_;
+        rhs.mapping_ = nullptr;
+        rhs.mappingSize_ = 0;
+        rhs.size_ = 0;
+    }
+    return *this;
+}
+
+MemoryMappedFile::~MemoryMappedFile() { cleanup(); }
+
+void* MemoryMappedFile::getData() { return static_cast<char*>(mapping_) + offset_; }
+
+const void* MemoryMappedFile::getData() const {
+    return static_cast<const char*>(mapping_) + offset_;
+}
+
+size_t MemoryMappedFile::getSize() const { return size_; }
+
+const std::string& MemoryMappedFile::getFileName() const { return filename_; }
+
+void MemoryMappedFile::cleanup() {
+    if (mapping_) {
+#ifdef WIN32
+        UnmapViewOfFile(mapping_);
+#else
+        ::munmap(mapping_, mappingSize_);
+#endif
+        mapping_ = nullptr;
+    }
+}
+
+}  // namespace util
+
+}  // namespace inviwo
@@ -28,6 +28,8 @@
  *********************************************************************************/
 
 #include <inviwo/core/io/rawvolumeramloader.h>
+#include <inviwo/core/util/raiiutils.h>
+#include <inviwo/core/util/filesystem.h>
 
 namespace inviwo {
 
@@ -55,6 +57,60 @@ void RawVolumeRAMLoader::updateRepresentation(std::shared_ptr<VolumeRepresentati
 
     std::size_t size = dimensions_.x * dimensions_.y * dimensions_.z;
     util::readBytesIntoBuffer(rawFile_, offset_, size * format_->getSize(), littleEndian_,
-                              format_->getSize(), volumeDst->getData());
+                              format_->getSize() / format_->getComponents(),
+                              volumeDst->getData());
 }
+
+void RawVolumeRAMLoader::readRegion(const size3_t& offset, const size3_t& dimensions,
+                                    void* dest) const {
+    if (glm::any(glm::greaterThan(offset + dimensions, dimensions_))) {
+        throw Exception("Region outside of volume, can't read", IvwContext);
+    }
+    if (dimensions.x == 0 || dimensions.y == 0 || dimensions.z == 0) return;
+
+    auto fin = filesystem::ifstream(rawFile_, std::ios::in | std::ios::binary);
+    util::OnScopeExit close([&fin]() { fin.close(); });
+    if (!fin.good()) {
+        throw DataReaderException("Error: Could not read from file: " + rawFile_, IvwContext);
+    }
+
+    const size_t voxelSize = format_->getSize();
+    const auto filePos = [&](size_t y, size_t z) {
+        return offset_ + ((z * dimensions_.y + y) * dimensions_.x + offset.x) * voxelSize;
+    };
+    const auto read = [&](size_t pos, char* dst, size_t bytes) {
+        fin.seekg(pos);
+        fin.read(dst, bytes);
+        if (!fin) {
+            throw DataReaderException("Error: Could not read from file: " + rawFile_, IvwContext);
+        }
+    };
+
+    // Merge reads of consecutive rows and slices when the region spans the whole volume
+    auto dst = static_cast<char*>(dest);
+    const size_t rowBytes = dimensions.x * voxelSize;
+    const bool wholeRows = offset.x == 0 && dimensions.x == dimensions_.x;
+    const bool wholeSlices = wholeRows && offset.y == 0 && dimensions.y == dimensions_.y;
+    if (wholeSlices) {
+        read(filePos(0, offset.z), dst, rowBytes * dimensions.y * dimensions.z);
+    } else if (wholeRows) {
+        for (size_t z = 0; z < dimensions.z; ++z) {
+            read(filePos(offset.y, offset.z + z), dst, rowBytes * dimensions.y);
+            dst += rowBytes * dimensions.y;
+        }
+    } else {
+        for (size_t z = 0; z < dimensions.z; ++z) {
+            for (size_t y = 0; y < dimensions.y; ++y) {
+                read(filePos(offset.y + y, offset.z + z), dst, rowBytes);
+                dst += rowBytes;
+            }
+        }
+    }
+
+    const size_t componentSize = format_->getSize() / format_->getComponents();
+    if (!littleEndian_ && componentSize > 1) {
+        util::swapBytes(dest, rowBytes * dimensions.y * dimensions.z, componentSize);
+    }
+}
+
 }  // namespace
@@ -32,6 +32,7 @@
 #include <inviwo/core/properties/propertyconvertermanager.h>
 #include <inviwo/core/properties/propertyconverter.h>
 #include <inviwo/core/util/raiiutils.h>
+#include <inviwo/core/util/trace.h>
 #include <inviwo/core/properties/property.h>
 #include <inviwo/core/processors/processor.h>
 #include <inviwo/core/network/processornetwork.h>
@@ -51,15 +52,14 @@ void LinkEvaluator::addLink(const PropertyLink& propertyLink) {
     Processor* p2 = dst->getOwner()->getProcessor();
     processorLinksCache_[ProcessorPair(p1, p2)].push_back(propertyLink);
 
-    // Update primary cache
+    // Update primary cache, the converter is only looked up once here
     auto& cachelist = propertyLinkPrimaryCache_[src];
-    util::push_back_unique(cachelist, dst);
-
-    if (cachelist.empty()) {
-        propertyLinkPrimaryCache_.erase(src);
+    if (!util::contains_if(cachelist, [dst](const Link& link) { return link.dst_ == dst; })) {
+        auto manager = network_->getApplication()->getPropertyConverterManager();
+        cachelist.emplace_back(src, dst, manager->getConverter(src, dst));
     }
 
-    propertyLinkSecondaryCache_.clear();
+    invalidateSecondaryCache(src);
 }
 
 bool LinkEvaluator::canLink(const Property* src, const Property* dst) const {
@@ -86,14 +86,39 @@ void LinkEvaluator::removeLink(const PropertyLink& propertyLink) {
     }
 
     // Update primary cache
-    auto& cachelist = propertyLinkPrimaryCache_[src];
-    util::erase_remove(cachelist, dst);
-
-    if (cachelist.empty()) {
-        propertyLinkPrimaryCache_.erase(src);
+    auto cacheIt = propertyLinkPrimaryCache_.find(src);
+    if (cacheIt != propertyLinkPrimaryCache_.end()) {
+        util::erase_remove_if(cacheIt->second, [dst](const Link& link) { return link.dst_ == dst; });
+        if (cacheIt->second.empty()) propertyLinkPrimaryCache_.erase(cacheIt);
     }
 
-    propertyLinkSecondaryCache_.clear();
+    invalidateSecondaryCache(src);
+}
+
+void LinkEvaluator::invalidateSecondaryCache(Property* property) {
+    auto invalidate = [this](Property* prop) {
+        auto it = secondaryCacheDependents_.find(prop);
+        if (it == secondaryCacheDependents_.end()) return;
+        const auto dependents = std::move(it->second);
+        secondaryCacheDependents_.erase(it);
+
+        for (auto key : dependents) {
+            auto entry = propertyLinkSecondaryCache_.find(key);
+            if (entry == propertyLinkSecondaryCache_.end()) continue;
+            for (auto dependency : entry->second.dependencies) {
+                auto depIt = secondaryCacheDependents_.find(dependency);
+                if (depIt == secondaryCacheDependents_.end()) continue;
+                util::erase_remove(depIt->second, key);
+                if (depIt->second.empty()) secondaryCacheDependents_.erase(depIt);
+            }
+            propertyLinkSecondaryCache_.erase(entry);
+        }
+    };
+
+    // Links of sub properties are followed when linking to a CompositeProperty, hence entries
+    // that followed the links of the owner might also be affected.
+    invalidate(property);
+    if (auto owner = dynamic_cast<Property*>(property->getOwner())) invalidate(owner);
 }
 
 std::vector<PropertyLink> LinkEvaluator::getLinksBetweenProcessors(Processor* p1, Processor* p2) {
@@ -105,71 +130,91 @@ std::vector<PropertyLink> LinkEvaluator::getLinksBetweenProcessors(Processor* p1
     }
 }
 
-std::vector<LinkEvaluator::Link>& LinkEvaluator::getTriggerdLinksForProperty(Property* property) {
-    if (propertyLinkSecondaryCache_.find(property) != propertyLinkSecondaryCache_.end()) {
-        return propertyLinkSecondaryCache_[property];
+const std::shared_ptr<const LinkEvaluator::Links>& LinkEvaluator::getTriggerdLinksForProperty(
+    Property* property) {
+    auto it = propertyLinkSecondaryCache_.find(property);
+    if (it != propertyLinkSecondaryCache_.end()) {
+        return it->second.links;
     } else {
-        return addToSecondaryCache(property);
+        return addToSecondaryCache(property).links;
     }
 }
 
 std::vector<Property*> LinkEvaluator::getPropertiesLinkedTo(Property* property) {
     // check if link connectivity has been computed and cached already
-    auto& list = (propertyLinkSecondaryCache_.find(property) != propertyLinkSecondaryCache_.end())
-                     ? propertyLinkSecondaryCache_[property]
-                     : addToSecondaryCache(property);
-
-    return util::transform(list, [](const Link& link) { return link.dst_; });
+    auto& links = *getTriggerdLinksForProperty(property);
+    return util::transform(links, [](const Link& link) { return link.dst_; });
 }
 
-std::vector<LinkEvaluator::Link>& LinkEvaluator::addToSecondaryCache(Property* src) {
-    for (auto& dst : propertyLinkPrimaryCache_[src]) {
-        if (src != dst) secondaryCacheHelper(propertyLinkSecondaryCache_[src], src, dst);
+LinkEvaluator::TriggeredLinks& LinkEvaluator::addToSecondaryCache(Property* src) {
+    Links links;
+    std::unordered_set<Property*> linked;
+    std::unordered_set<Property*> dependencies{src};
+
+    auto it = propertyLinkPrimaryCache_.find(src);
+    if (it != propertyLinkPrimaryCache_.end()) {
+        for (auto& link : it->second) {
+            if (src != link.dst_) secondaryCacheHelper(links, linked, dependencies, link);
+        }
     }
-    return propertyLinkSecondaryCache_[src];
+
+    for (auto dependency : dependencies) secondaryCacheDependents_[dependency].push_back(src);
+
+    auto& entry = propertyLinkSecondaryCache_[src];
+    entry.links = std::make_shared<const Links>(std::move(links));
+    entry.dependencies.assign(dependencies.begin(), dependencies.end());
+    return entry;
 }
 
-void LinkEvaluator::secondaryCacheHelper(std::vector<Link>& links, Property* src, Property* dst) {
+void LinkEvaluator::secondaryCacheHelper(Links& links, std::unordered_set<Property*>& linked,
+                                         std::unordered_set<Property*>& dependencies,
+                                         const Link& link) {
     // Check that we don't use a previous source or destination as the new destination.
-    if (!util::contains_if(
-            links, [dst](const Link& link) { return link.src_ == dst || link.dst_ == dst; })) {
-        auto manager = network_->getApplication()->getPropertyConverterManager();
-        if (auto converter = manager->getConverter(src, dst)) {
-            links.emplace_back(src, dst, converter);
-        }
+    Property* dst = link.dst_;
+    if (linked.count(dst) != 0) return;
 
-        // Follow the links of destination all links of all owners (CompositeProperties).
-        for (Property* newSrc = dst; newSrc != nullptr;
-             newSrc = dynamic_cast<Property*>(newSrc->getOwner())) {
-            // Recurse over outgoing links.
-            for (auto& elem : propertyLinkPrimaryCache_[newSrc]) {
-                if (newSrc != elem) secondaryCacheHelper(links, newSrc, elem);
-            }
-        }
+    if (link.converter_) {
+        links.push_back(link);
+        linked.insert(link.src_);
+        linked.insert(dst);
+    }
 
-        // If we link to a CompositeProperty, make sure to evaluate sub-links.
-        if (auto cp = dynamic_cast<CompositeProperty*>(dst)) {
-            for (auto& srcProp : cp->getProperties()) {
-                // Recurse over outgoing links.
-                for (auto& elem : propertyLinkPrimaryCache_[srcProp]) {
-                    if (srcProp != elem) secondaryCacheHelper(links, srcProp, elem);
-                }
-            }
+    // Recurse over outgoing links.
+    auto follow = [&](Property* newSrc) {
+        dependencies.insert(newSrc);
+        auto it = propertyLinkPrimaryCache_.find(newSrc);
+        if (it == propertyLinkPrimaryCache_.end()) return;
+        for (auto& elem : it->second) {
+            if (newSrc != elem.dst_) secondaryCacheHelper(links, linked, dependencies, elem);
         }
+    };
+
+    // Follow the links of destination all links of all owners (CompositeProperties).
+    for (Property* newSrc = dst; newSrc != nullptr;
+         newSrc = dynamic_cast<Property*>(newSrc->getOwner())) {
+        follow(newSrc);
+    }
+
+    // If we link to a CompositeProperty, make sure to evaluate sub-links.
+    if (auto cp = dynamic_cast<CompositeProperty*>(dst)) {
+        for (auto& srcProp : cp->getProperties()) follow(srcProp);
     }
 }
 
 bool LinkEvaluator::isLinking() const { return !visited_.empty(); }
 
 void LinkEvaluator::evaluateLinksFromProperty(Property* modifiedProperty) {
-    if (util::contains(visited_, modifiedProperty)) return;
+    if (visited_.count(modifiedProperty) != 0) return;
 
     NetworkLock lock(network_);
 
-    auto& links = getTriggerdLinksForProperty(modifiedProperty);
-    VisitedHelper helper(visited_, links);
+    // All linked properties are marked as visited up front, so the property changes caused by
+    // the conversions below will not trigger any further traversals.
+    VisitedHelper helper(visited_, getTriggerdLinksForProperty(modifiedProperty));
 
-    for (auto& link : links) {
+    for (auto& link : helper.links()) {
+        IVW_TRACE_SCOPE("link", joinString(link.src_->getPath(), ".") + " -> " +
+                                    joinString(link.dst_->getPath(), "."));
         link.converter_->convert(link.src_, link.dst_);
     }
 }
@@ -35,6 +35,13 @@
 #include <inviwo/core/network/networkutils.h>
 #include <inviwo/core/network/networklock.h>
 #include <inviwo/core/util/clock.h>
+#include <inviwo/core/util/trace.h>
+#include <inviwo/core/common/inviwoapplication.h>
+
+#include <list>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
 
 namespace inviwo {
 
@@ -42,6 +49,7 @@ ProcessorNetworkEvaluator::ProcessorNetworkEvaluator(ProcessorNetwork* processor
     : processorNetwork_(processorNetwork)
     , processorsSorted_(util::topologicalSort(processorNetwork_))
     , evaulationQueued_(false)
+    , concurrentEvaluation_(false)
     , exceptionHandler_(StandardEvaluationErrorHandler()) {
     
     processorNetwork_->addObserver(this);
@@ -93,6 +101,12 @@ void ProcessorNetworkEvaluator::requestEvaluate() {
     evaluate();
 }
 
+void ProcessorNetworkEvaluator::setConcurrentEvaluation(bool enable) {
+    concurrentEvaluation_ = enable;
+}
+
+bool ProcessorNetworkEvaluator::getConcurrentEvaluation() const { return concurrentEvaluation_; }
+
 void ProcessorNetworkEvaluator::evaluate() {
     // lock processor network to avoid concurrent evaluation
     NetworkLock lock(processorNetwork_);
@@ -100,41 +114,65 @@ void ProcessorNetworkEvaluator::evaluate() {
     notifyObserversProcessorNetworkEvaluationBegin();
     
     IVW_CPU_PROFILING_IF(500, "Evaluated Processor Network");
-    
+    IVW_TRACE_SCOPE("network", "Evaluate Network");
+
+    auto app = processorNetwork_->getApplication();
+    const size_t poolSize = app ? app->getPoolSize() : 0;
+    if (concurrentEvaluation_ && poolSize > 1) {
+        evaluateConcurrent(poolSize - 1);
+    } else {
+        evaluateSerial();
+    }
+
+    notifyObserversProcessorNetworkEvaluationEnd();
+}
+
+bool ProcessorNetworkEvaluator::prepareProcess(Processor* processor) {
+    try {
+        // re-initialize resources (e.g., shaders) if necessary
+        if (processor->getInvalidationLevel() >= InvalidationLevel::InvalidResources) {
+            IVW_TRACE_SCOPE("initializeResources", processor->getIdentifier());
+            processor->initializeResources();
+        }
+        // call onChange for all invalid inports
+        for (auto inport : processor->getInports()) {
+            inport->callOnChangeIfChanged();
+        }
+    } catch (...) {
+        exceptionHandler_(processor, EvaluationType::InitResource, IvwContext);
+        processor->setValid();
+        return false;
+    }
+
+    processor->notifyObserversAboutToProcess(processor);
+    return true;
+}
+
+void ProcessorNetworkEvaluator::finishProcess(Processor* processor) {
+    // Set processor as valid only if we still are ready. 
+    // Callbacks might have made our inports invalid, if so abort
+    // the evaluation by not setting the processor valid.
+    if (processor->isReady()) processor->setValid();
+
+    processor->notifyObserversFinishedProcess(processor);
+}
+
+void ProcessorNetworkEvaluator::evaluateSerial() {
     for (auto processor : processorsSorted_) {
         if (!processor->isValid()) {
             if (processor->isReady()) {
-                try {
-                    // re-initialize resources (e.g., shaders) if necessary
-                    if (processor->getInvalidationLevel() >= InvalidationLevel::InvalidResources) {
-                        processor->initializeResources();
-                    }
-                    // call onChange for all invalid inports
-                    for (auto inport : processor->getInports()) {
-                        inport->callOnChangeIfChanged();
-                    }
-                } catch (...) {
-                    exceptionHandler_(processor, EvaluationType::InitResource, IvwContext);
-                    processor->setValid();
-                    continue;
-                }
-
-                processor->notifyObserversAboutToProcess(processor);
+                if (!prepareProcess(processor)) continue;
 
                 try {
                     IVW_CPU_PROFILING_IF(500, "Processed " << processor->getIdentifier());
+                    IVW_TRACE_SCOPE("process", processor->getIdentifier());
                     // do the actual processing
                     processor->process();
                 } catch (...) {
                     exceptionHandler_(processor, EvaluationType::Process, IvwContext);
                 }
 
-                // Set processor as valid only if we still are ready. 
-                // Callbacks might have made our inports invalid, if so abort
-                // the evaluation by not setting the processor valid.
-                if (processor->isReady()) processor->setValid();
-
-                processor->notifyObserversFinishedProcess(processor);
+                finishProcess(processor);
 
             } else {
                 try {
@@ -145,8 +183,138 @@ void ProcessorNetworkEvaluator::evaluate() {
             }
         }
     }
-    
-    notifyObserversProcessorNetworkEvaluationEnd();
+}
+
+void ProcessorNetworkEvaluator::evaluateConcurrent(size_t maxConcurrent) {
+    // Processors finished by the pool, handed back to the main thread
+    struct {
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::vector<std::pair<Processor*, std::exception_ptr>> processors;
+    } finished;
+
+    auto app = processorNetwork_->getApplication();
+
+    std::unordered_set<Processor*> evaluated;
+    const std::unordered_set<Processor*> sorted(processorsSorted_.begin(),
+                                                processorsSorted_.end());
+
+    // pending processors in topological order together with their direct predecessors
+    std::list<std::pair<Processor*, std::unordered_set<Processor*>>> pending;
+    for (auto processor : processorsSorted_) {
+        pending.emplace_back(processor, util::getDirectPredecessors(processor));
+    }
+
+    auto isAvailable = [&](const std::unordered_set<Processor*>& predecessors) {
+        return util::all_of(predecessors, [&](Processor* p) {
+            return evaluated.count(p) != 0 || sorted.count(p) == 0;
+        });
+    };
+
+    size_t running = 0;
+    while (!pending.empty() || running > 0) {
+        bool progress = false;
+        for (auto it = pending.begin(); it != pending.end();) {
+            auto processor = it->first;
+            if (!isAvailable(it->second)) {
+                ++it;
+                continue;
+            }
+
+            const bool concurrent = processor->getTags().getMatches(Tags::Concurrent) > 0;
+            if (concurrent && running >= maxConcurrent && !processor->isValid() &&
+                processor->isReady()) {
+                ++it;
+                continue;
+            }
+
+            it = pending.erase(it);
+            progress = true;
+
+            if (processor->isValid()) {
+                evaluated.insert(processor);
+                continue;
+            }
+
+            if (!processor->isReady()) {
+                try {
+                    processor->doIfNotReady();
+                } catch (...) {
+                    exceptionHandler_(processor, EvaluationType::NotReady, IvwContext);
+                }
+                evaluated.insert(processor);
+                continue;
+            }
+
+            if (!prepareProcess(processor)) {
+                evaluated.insert(processor);
+                continue;
+            }
+
+            if (concurrent) {
+                // Conversions of the input data might need an OpenGL context, do them here.
+                try {
+                    for (auto inport : processor->getInports()) {
+                        inport->prefetchRAMRepresentations();
+                    }
+                } catch (...) {
+                    exceptionHandler_(processor, EvaluationType::Process, IvwContext);
+                    finishProcess(processor);
+                    evaluated.insert(processor);
+                    continue;
+                }
+
+                ++running;
+                app->dispatchPool([processor, &finished]() {
+                    std::exception_ptr error;
+                    try {
+                        IVW_CPU_PROFILING_IF(500, "Processed " << processor->getIdentifier());
+                        IVW_TRACE_SCOPE("process", processor->getIdentifier());
+                        processor->process();
+                    } catch (...) {
+                        error = std::current_exception();
+                    }
+                    std::unique_lock<std::mutex> lock(finished.mutex);
+                    finished.processors.emplace_back(processor, error);
+                    finished.condition.notify_one();
+                });
+            } else {
+                try {
+                    IVW_CPU_PROFILING_IF(500, "Processed " << processor->getIdentifier());
+                    IVW_TRACE_SCOPE("process", processor->getIdentifier());
+                    processor->process();
+                } catch (...) {
+                    exceptionHandler_(processor, EvaluationType::Process, IvwContext);
+                }
+                finishProcess(processor);
+                evaluated.insert(processor);
+            }
+        }
+
+        if (running > 0) {
+            std::vector<std::pair<Processor*, std::exception_ptr>> done;
+            {
+                std::unique_lock<std::mutex> lock(finished.mutex);
+                finished.condition.wait(lock, [&]() { return !finished.processors.empty(); });
+                std::swap(done, finished.processors);
+            }
+            for (auto& item : done) {
+                --running;
+                if (item.second) {
+                    try {
+                        std::rethrow_exception(item.second);
+                    } catch (...) {
+                        exceptionHandler_(item.first, EvaluationType::Process, IvwContext);
+                    }
+                }
+                finishProcess(item.first);
+                evaluated.insert(item.first);
+            }
+        } else if (!progress) {
+            // should not happen for a topologically sorted network, but never spin forever.
+            break;
+        }
+    }
 }
 
 void ProcessorNetworkEvaluator::onProcessorSinkChanged(Processor*) {
@@ -77,6 +77,8 @@ size_t Inport::getNumberOfConnections() const { return connectedOutports_.size()
 
 std::vector<const Outport*> Inport::getChangedOutports() const { return changedSources_; }
 
+void Inport::prefetchRAMRepresentations() const {}
+
 void Inport::propagateEvent(Event* event, Outport* target) {
     if (target) {
         target->propagateEvent(event);
@@ -0,0 +1,98 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/processors/backgroundjob.h>
+
+namespace inviwo {
+
+JobCancelledException::JobCancelledException(const std::string& message,
+                                             ExceptionContext context)
+    : Exception(message, context) {}
+
+StopToken::StopToken() : stop_{std::make_shared<std::atomic<bool>>(false)} {}
+
+bool StopToken::isStopRequested() const { return stop_->load(std::memory_order_relaxed); }
+
+void StopToken::requestStop() { stop_->store(true, std::memory_order_relaxed); }
+
+void StopToken::throwIfStopRequested() const {
+    if (isStopRequested()) {
+        throw JobCancelledException("Job cancelled", IvwContextCustom("StopToken"));
+    }
+}
+
+namespace detail {
+
+BackgroundJobIndicator::BackgroundJobIndicator(ActivityIndicator* indicator)
+    : indicator_{indicator}
+    , progressBar_{dynamic_cast<ProgressBar*>(indicator)}
+    , progress_{0.0f}
+    , progressQueued_{false} {}
+
+void BackgroundJobIndicator::started() {
+    if (progressBar_) {
+        progressBar_->resetProgress();
+        progressBar_->show();
+    } else if (indicator_) {
+        indicator_->setActive(true);
+    }
+}
+
+void BackgroundJobIndicator::finished() {
+    if (progressBar_) {
+        progressBar_->hide();
+    } else if (indicator_) {
+        indicator_->setActive(false);
+    }
+}
+
+void BackgroundJobIndicator::detach() {
+    indicator_ = nullptr;
+    progressBar_ = nullptr;
+}
+
+std::function<void(float)> BackgroundJobIndicator::progressCallback(const StopToken& token) {
+    if (!progressBar_) return [](float) {};
+
+    return [token, self = shared_from_this()](float progress) {
+        if (token.isStopRequested()) return;
+        self->progress_.store(progress);
+        // Only queue a new update if the previous one has been handled, the front thread will
+        // then pick up the latest value.
+        if (self->progressQueued_.exchange(true)) return;
+        dispatchFront([self]() {
+            self->progressQueued_.store(false);
+            if (self->progressBar_) self->progressBar_->updateProgress(self->progress_.load());
+        });
+    };
+}
+
+}  // namespace detail
+
+}  // namespace inviwo
@@ -113,6 +113,13 @@ const Tags Tags::None("");
 const Tags Tags::GL("GL");
 const Tags Tags::CL("CL");
 const Tags Tags::CPU("CPU");
+const Tags Tags::Concurrent("Concurrent");
+
+Tags operator|(const Tags& lhs, const Tags& rhs) {
+    Tags result{lhs};
+    result.addTags(rhs);
+    return result;
+}
 
 namespace util {
 
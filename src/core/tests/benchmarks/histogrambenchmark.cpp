@@ -0,0 +1,88 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2013-2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/volume/volumeramhistogram.h>
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+using namespace inviwo;
+
+namespace {
+
+template <typename T>
+std::vector<T> randomData(size_t count, double max) {
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<double> dist(0.0, max);
+    std::vector<T> data(count);
+    for (auto& v : data) v = static_cast<T>(dist(gen));
+    return data;
+}
+
+template <typename T>
+void histogram(benchmark::State& state, double max, size3_t sampleRate) {
+    const auto size = static_cast<size_t>(state.range(0));
+    const size3_t dims{size};
+    const auto data = randomData<T>(size * size * size, max);
+
+    for (auto _ : state) {
+        auto histograms =
+            util::calculateVolumeHistogram(data.data(), dims, dvec2(0.0, max), false, 2048,
+                                           sampleRate);
+        benchmark::DoNotOptimize(histograms.size());
+    }
+    state.SetItemsProcessed(state.iterations() * size * size * size);
+}
+
+}  // namespace
+
+static void VolumeHistogramUInt8(benchmark::State& state) {
+    histogram<unsigned char>(state, 255.0, size3_t(1));
+}
+
+static void VolumeHistogramFloat(benchmark::State& state) {
+    histogram<float>(state, 1.0, size3_t(1));
+}
+
+static void VolumeHistogramVec4(benchmark::State& state) {
+    histogram<vec4>(state, 1.0, size3_t(1));
+}
+
+static void VolumeHistogramFloatSampled(benchmark::State& state) {
+    histogram<float>(state, 1.0, size3_t(4));
+}
+
+BENCHMARK(VolumeHistogramUInt8)->RangeMultiplier(2)->Range(32, 256)->Unit(benchmark::kMillisecond);
+BENCHMARK(VolumeHistogramFloat)->RangeMultiplier(2)->Range(32, 256)->Unit(benchmark::kMillisecond);
+BENCHMARK(VolumeHistogramVec4)->RangeMultiplier(2)->Range(32, 128)->Unit(benchmark::kMillisecond);
+BENCHMARK(VolumeHistogramFloatSampled)
+    ->RangeMultiplier(2)
+    ->Range(32, 256)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,200 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2013-2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/io/serialization/serializer.h>
+#include <inviwo/core/network/networklock.h>
+#include <inviwo/core/network/processornetwork.h>
+#include <inviwo/core/network/processornetworkevaluator.h>
+#include <inviwo/core/ports/datainport.h>
+#include <inviwo/core/ports/dataoutport.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/util/filesystem.h>
+
+#include <benchmark/benchmark.h>
+
+#include <numeric>
+
+using namespace inviwo;
+
+namespace {
+
+using Data = std::vector<float>;
+
+/**
+ * Synthetic processors with a small, fixed amount of work per process call, such that the
+ * benchmarks measure the cost of evaluating the network rather than the processors.
+ */
+class BenchmarkSource : public Processor {
+public:
+    BenchmarkSource() : Processor(), outport_("outport"), value_("value", "Value", 0, 0, 1) {
+        addPort(outport_);
+        addProperty(value_);
+    }
+    virtual const ProcessorInfo getProcessorInfo() const override { return processorInfo_; }
+    static const ProcessorInfo processorInfo_;
+
+    virtual void process() override {
+        outport_.setData(std::make_shared<Data>(1024, static_cast<float>(value_.get())));
+    }
+
+    DataOutport<Data> outport_;
+    IntProperty value_;
+};
+const ProcessorInfo BenchmarkSource::processorInfo_{
+    "org.inviwo.BenchmarkSource", "Benchmark Source", "Benchmark", CodeState::Stable, Tags::CPU};
+
+class BenchmarkFilter : public Processor {
+public:
+    BenchmarkFilter(bool concurrent)
+        : Processor(), inport_("inport"), outport_("outport"), concurrent_(concurrent) {
+        addPort(inport_);
+        addPort(outport_);
+    }
+    virtual const ProcessorInfo getProcessorInfo() const override {
+        return concurrent_ ? concurrentInfo_ : processorInfo_;
+    }
+    static const ProcessorInfo processorInfo_;
+    static const ProcessorInfo concurrentInfo_;
+
+    virtual void process() override {
+        auto data = std::make_shared<Data>(*inport_.getData());
+        for (auto& v : *data) v = v * 0.5f + 1.0f;
+        outport_.setData(data);
+    }
+
+    DataInport<Data> inport_;
+    DataOutport<Data> outport_;
+    bool concurrent_;
+};
+const ProcessorInfo BenchmarkFilter::processorInfo_{
+    "org.inviwo.BenchmarkFilter", "Benchmark Filter", "Benchmark", CodeState::Stable, Tags::CPU};
+const ProcessorInfo BenchmarkFilter::concurrentInfo_{"org.inviwo.BenchmarkFilter",
+                                                     "Benchmark Filter", "Benchmark",
+                                                     CodeState::Stable,
+                                                     Tags::CPU | Tags::Concurrent};
+
+class BenchmarkSink : public Processor {
+public:
+    BenchmarkSink() : Processor(), inport_("inport"), sum_(0.0f) { addPort(inport_); }
+    virtual const ProcessorInfo getProcessorInfo() const override { return processorInfo_; }
+    static const ProcessorInfo processorInfo_;
+
+    virtual void process() override {
+        sum_ = 0.0f;
+        for (const auto& data : inport_.getVectorData()) {
+            sum_ += std::accumulate(data->begin(), data->end(), 0.0f);
+        }
+    }
+
+    DataInport<Data, 0> inport_;
+    float sum_;
+};
+const ProcessorInfo BenchmarkSink::processorInfo_{
+    "org.inviwo.BenchmarkSink", "Benchmark Sink", "Benchmark", CodeState::Stable, Tags::CPU};
+
+/**
+ * Builds a network with one source feeding `branches` independent chains of `depth` filters,
+ * that all end in one sink. The network is cleared when the object goes out of scope.
+ */
+struct SyntheticNetwork {
+    SyntheticNetwork(size_t branches, size_t depth, bool concurrent)
+        : network{InviwoApplication::getPtr()->getProcessorNetwork()} {
+        NetworkLock lock(network);
+        source = network->addProcessor(util::make_unique<BenchmarkSource>());
+        source->setIdentifier("source");
+        auto sink = network->addProcessor(util::make_unique<BenchmarkSink>());
+        sink->setIdentifier("sink");
+        for (size_t branch = 0; branch < branches; ++branch) {
+            Outport* prev = source->getOutports().front();
+            for (size_t i = 0; i < depth; ++i) {
+                auto filter = network->addProcessor(util::make_unique<BenchmarkFilter>(concurrent));
+                filter->setIdentifier("filter" + toString(branch) + "_" + toString(i));
+                network->addConnection(prev, filter->getInports().front());
+                prev = filter->getOutports().front();
+            }
+            network->addConnection(prev, sink->getInports().front());
+        }
+    }
+    ~SyntheticNetwork() { network->clear(); }
+
+    /**
+     * Change the source such that the whole network is invalidated and evaluated
+     */
+    void evaluate() {
+        auto& value = static_cast<BenchmarkSource*>(source)->value_;
+        value.set(1 - value.get());
+    }
+
+    ProcessorNetwork* network;
+    Processor* source;
+};
+
+void evaluateNetwork(benchmark::State& state, bool concurrent) {
+    const auto branches = static_cast<size_t>(state.range(0));
+    const auto depth = static_cast<size_t>(state.range(1));
+    auto evaluator = InviwoApplication::getPtr()->getProcessorNetworkEvaluator();
+    const auto wasConcurrent = evaluator->getConcurrentEvaluation();
+    evaluator->setConcurrentEvaluation(concurrent);
+
+    SyntheticNetwork network(branches, depth, concurrent);
+    for (auto _ : state) {
+        network.evaluate();
+    }
+    evaluator->setConcurrentEvaluation(wasConcurrent);
+    state.counters["Processors"] = static_cast<double>(branches * depth + 2);
+}
+
+}  // namespace
+
+static void NetworkEvaluateSerial(benchmark::State& state) { evaluateNetwork(state, false); }
+
+static void NetworkEvaluateConcurrent(benchmark::State& state) { evaluateNetwork(state, true); }
+
+static void NetworkSerialize(benchmark::State& state) {
+    const auto branches = static_cast<size_t>(state.range(0));
+    const auto depth = static_cast<size_t>(state.range(1));
+    SyntheticNetwork network(branches, depth, false);
+    const auto refPath = filesystem::findBasePath();
+
+    for (auto _ : state) {
+        std::stringstream ss;
+        Serializer serializer(refPath);
+        network.network->serialize(serializer);
+        serializer.writeFile(ss);
+        benchmark::DoNotOptimize(ss.tellp());
+    }
+    state.counters["Processors"] = static_cast<double>(branches * depth + 2);
+}
+
+// {branches, depth}
+BENCHMARK(NetworkEvaluateSerial)->Args({1, 1})->Args({1, 32})->Args({8, 4})->Args({32, 8});
+BENCHMARK(NetworkEvaluateConcurrent)->Args({1, 32})->Args({8, 4})->Args({32, 8});
+BENCHMARK(NetworkSerialize)->Args({1, 8})->Args({8, 8})->Args({32, 8});
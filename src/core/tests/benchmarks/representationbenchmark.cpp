@@ -0,0 +1,161 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2013-2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/datastructures/image/layerramprecision.h>
+#include <inviwo/core/io/rawvolumeramloader.h>
+#include <inviwo/core/io/tempfilehandle.h>
+
+#include <benchmark/benchmark.h>
+
+#include <fstream>
+
+using namespace inviwo;
+
+namespace {
+
+/**
+ * A temporary raw file with size^3 voxels of T.
+ */
+template <typename T>
+util::TempFileHandle makeRawFile(size_t size) {
+    util::TempFileHandle file("benchmark", ".raw");
+    std::vector<T> data(size * size * size);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<T>(i);
+    std::ofstream out(file.getFileName(), std::ios::out | std::ios::binary);
+    out.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(T));
+    return file;
+}
+
+template <typename T>
+void diskToRAM(benchmark::State& state, bool littleEndian) {
+    const auto size = static_cast<size_t>(state.range(0));
+    auto file = makeRawFile<T>(size);
+    const size3_t dims{size};
+    const auto format = DataFormat<T>::get();
+
+    for (auto _ : state) {
+        auto disk = std::make_shared<VolumeDisk>(file.getFileName(), dims, format);
+        disk->setLoader(
+            new RawVolumeRAMLoader(file.getFileName(), 0u, dims, littleEndian, format));
+        Volume volume(disk);
+        // touch every page such that memory mapped data is actually read
+        const auto ram = volume.getRepresentation<VolumeRAM>();
+        const auto data = static_cast<const unsigned char*>(ram->getData());
+        size_t sum = 0;
+        for (size_t i = 0; i < size * size * size * sizeof(T); i += 4096) sum += data[i];
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(state.iterations() * size * size * size * sizeof(T));
+}
+
+}  // namespace
+
+static void VolumeDiskToRAMMapped(benchmark::State& state) {
+    diskToRAM<float>(state, true);
+}
+
+static void VolumeDiskToRAMSwapped(benchmark::State& state) {
+    diskToRAM<float>(state, false);
+}
+
+static void VolumeRAMToDisk(benchmark::State& state) {
+    const auto size = static_cast<size_t>(state.range(0));
+    VolumeRAMPrecision<float> ram(size3_t{size});
+
+    for (auto _ : state) {
+        util::TempFileHandle file("benchmark", ".raw");
+        std::ofstream out(file.getFileName(), std::ios::out | std::ios::binary);
+        out.write(static_cast<const char*>(ram.getData()), size * size * size * sizeof(float));
+    }
+    state.SetBytesProcessed(state.iterations() * size * size * size * sizeof(float));
+}
+
+static void VolumeRAMClone(benchmark::State& state) {
+    const auto size = static_cast<size_t>(state.range(0));
+    VolumeRAMPrecision<float> ram(size3_t{size});
+
+    for (auto _ : state) {
+        std::unique_ptr<VolumeRAM> copy(ram.clone());
+        benchmark::DoNotOptimize(copy->getData());
+    }
+    state.SetBytesProcessed(state.iterations() * size * size * size * sizeof(float));
+}
+
+// Format conversion through the virtual per pixel interface used by generic code
+static void LayerRAMConvertNormalized(benchmark::State& state) {
+    const auto size = static_cast<size_t>(state.range(0));
+    const size2_t dims{size};
+    LayerRAMPrecision<glm::u8vec4> src(dims);
+    LayerRAMPrecision<vec4> dst(dims);
+    const LayerRAM& in = src;
+    LayerRAM& out = dst;
+
+    for (auto _ : state) {
+        size2_t pos;
+        for (pos.y = 0; pos.y < dims.y; ++pos.y) {
+            for (pos.x = 0; pos.x < dims.x; ++pos.x) {
+                out.setFromNormalizedDVec4(pos, in.getAsNormalizedDVec4(pos));
+            }
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * size * size);
+}
+
+// Format conversion on the typed data, as done when both formats are known
+static void LayerRAMConvertTyped(benchmark::State& state) {
+    const auto size = static_cast<size_t>(state.range(0));
+    const size2_t dims{size};
+    LayerRAMPrecision<glm::u8vec4> src(dims);
+    LayerRAMPrecision<vec4> dst(dims);
+
+    for (auto _ : state) {
+        const auto in = src.getDataTyped();
+        auto out = dst.getDataTyped();
+        for (size_t i = 0; i < size * size; ++i) {
+            out[i] = util::glm_convert_normalized<vec4>(in[i]);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * size * size);
+}
+
+BENCHMARK(VolumeDiskToRAMMapped)->RangeMultiplier(2)->Range(32, 256)->Unit(benchmark::kMillisecond);
+BENCHMARK(VolumeDiskToRAMSwapped)
+    ->RangeMultiplier(2)
+    ->Range(32, 256)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(VolumeRAMToDisk)->RangeMultiplier(2)->Range(32, 256)->Unit(benchmark::kMillisecond);
+BENCHMARK(VolumeRAMClone)->RangeMultiplier(2)->Range(32, 256)->Unit(benchmark::kMillisecond);
+
+BENCHMARK(LayerRAMConvertNormalized)->RangeMultiplier(2)->Range(256, 2048);
+BENCHMARK(LayerRAMConvertTyped)->RangeMultiplier(2)->Range(256, 2048);
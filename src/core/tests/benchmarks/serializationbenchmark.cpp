@@ -0,0 +1,91 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2013-2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/io/serialization/serialization.h>
+#include <inviwo/core/util/filesystem.h>
+
+#include <benchmark/benchmark.h>
+
+using namespace inviwo;
+
+namespace {
+
+template <typename T>
+std::vector<T> makeValues(size_t count) {
+    std::vector<T> values(count);
+    for (size_t i = 0; i < count; ++i) values[i] = T(static_cast<float>(i));
+    return values;
+}
+
+template <typename T>
+std::string serialized(const std::vector<T>& values, const std::string& refPath) {
+    std::stringstream ss;
+    Serializer serializer(refPath);
+    serializer.serialize("values", values, "value");
+    serializer.writeFile(ss);
+    return ss.str();
+}
+
+template <typename T>
+void serialize(benchmark::State& state) {
+    const auto values = makeValues<T>(static_cast<size_t>(state.range(0)));
+    const auto refPath = filesystem::findBasePath();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(serialized(values, refPath).size());
+    }
+    state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+template <typename T>
+void deserialize(benchmark::State& state) {
+    const auto refPath = filesystem::findBasePath();
+    const auto xml = serialized(makeValues<T>(static_cast<size_t>(state.range(0))), refPath);
+
+    for (auto _ : state) {
+        std::stringstream ss(xml);
+        Deserializer deserializer(ss, refPath);
+        std::vector<T> values;
+        deserializer.deserialize("values", values, "value");
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+static void SerializeFloats(benchmark::State& state) { serialize<float>(state); }
+static void SerializeVec3s(benchmark::State& state) { serialize<vec3>(state); }
+static void DeserializeFloats(benchmark::State& state) { deserialize<float>(state); }
+static void DeserializeVec3s(benchmark::State& state) { deserialize<vec3>(state); }
+
+BENCHMARK(SerializeFloats)->RangeMultiplier(8)->Range(64, 64 << 9);
+BENCHMARK(SerializeVec3s)->RangeMultiplier(8)->Range(64, 64 << 9);
+BENCHMARK(DeserializeFloats)->RangeMultiplier(8)->Range(64, 64 << 9);
+BENCHMARK(DeserializeVec3s)->RangeMultiplier(8)->Range(64, 64 << 9);
@@ -0,0 +1,105 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2013-2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/util/volumesampler.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+using namespace inviwo;
+
+namespace {
+
+std::shared_ptr<Volume> vectorVolume(size_t size) {
+    auto ram = std::make_shared<VolumeRAMPrecision<vec3>>(size3_t{size});
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    auto data = ram->getDataTyped();
+    for (size_t i = 0; i < size * size * size; ++i) data[i] = vec3(dist(gen), dist(gen), dist(gen));
+    return std::make_shared<Volume>(ram);
+}
+
+std::vector<dvec3> positions(size_t count) {
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    std::vector<dvec3> res(count);
+    for (auto& p : res) p = dvec3(dist(gen), dist(gen), dist(gen));
+    return res;
+}
+
+constexpr size_t samples = 1 << 16;
+
+}  // namespace
+
+// Through the virtual SpatialSampler interface, as used by the integral line tracers
+static void volumeDoubleSampler(benchmark::State& state) {
+    const auto volume = vectorVolume(static_cast<size_t>(state.range(0)));
+    const auto pos = positions(samples);
+    std::shared_ptr<const SpatialSampler<3, 3, double>> sampler =
+        std::make_shared<VolumeDoubleSampler<3>>(volume);
+    for (auto _ : state) {
+        dvec3 sum{0.0};
+        for (const auto& p : pos) sum += sampler->sample(p);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * samples);
+}
+BENCHMARK(volumeDoubleSampler)->Arg(64)->Arg(256);
+
+static void volumeDoubleSamplerBatch(benchmark::State& state) {
+    const auto volume = vectorVolume(static_cast<size_t>(state.range(0)));
+    const auto pos = positions(samples);
+    VolumeDoubleSampler<3> sampler(volume);
+    for (auto _ : state) {
+        auto res = sampler.sample(pos);
+        benchmark::DoNotOptimize(res.data());
+    }
+    state.SetItemsProcessed(state.iterations() * samples);
+}
+BENCHMARK(volumeDoubleSamplerBatch)->Arg(64)->Arg(256);
+
+template <typename P>
+static void volumeRAMSampler(benchmark::State& state) {
+    const auto volume = vectorVolume(static_cast<size_t>(state.range(0)));
+    const auto dpos = positions(samples);
+    const std::vector<Vector<3, P>> pos(dpos.begin(), dpos.end());
+    const VolumeRAMSampler<vec3, 3, P> sampler(
+        *static_cast<const VolumeRAMPrecision<vec3>*>(volume->getRepresentation<VolumeRAM>()));
+    std::vector<Vector<3, P>> res(samples);
+    for (auto _ : state) {
+        sampler.sample(pos.begin(), pos.end(), res.begin());
+        benchmark::DoNotOptimize(res.data());
+    }
+    state.SetItemsProcessed(state.iterations() * samples);
+}
+BENCHMARK_TEMPLATE(volumeRAMSampler, double)->Arg(64)->Arg(256);
+BENCHMARK_TEMPLATE(volumeRAMSampler, float)->Arg(64)->Arg(256);
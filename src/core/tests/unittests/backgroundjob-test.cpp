@@ -0,0 +1,171 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/processors/backgroundjob.h>
+#include <inviwo/core/processors/processor.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace inviwo {
+
+namespace {
+
+class JobTestProcessor : public Processor {
+public:
+    virtual const ProcessorInfo getProcessorInfo() const override {
+        return {"org.inviwo.JobTestProcessor", "Job Test", "Testing", CodeState::Experimental,
+                Tags::None};
+    }
+    virtual void invalidate(InvalidationLevel, Property* = nullptr) override { ++invalidations; }
+
+    int invalidations = 0;
+};
+
+template <typename Pred>
+bool processFrontUntil(Pred pred) {
+    const auto end = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > end) return false;
+        InviwoApplication::getPtr()->processFront();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+}  // namespace
+
+TEST(BackgroundJob, Result) {
+    JobTestProcessor processor;
+    BackgroundJob<int> job(processor);
+
+    job.submit([](const StopToken&, const std::function<void(float)>&) { return 42; });
+    ASSERT_TRUE(processFrontUntil([&]() { return job.hasResult(); }));
+    EXPECT_FALSE(job.isRunning());
+    EXPECT_EQ(1, processor.invalidations);
+    EXPECT_EQ(42, job.takeResult());
+    EXPECT_FALSE(job.hasResult());
+}
+
+TEST(BackgroundJob, Exception) {
+    JobTestProcessor processor;
+    BackgroundJob<int> job(processor);
+
+    job.submit([](const StopToken&, const std::function<void(float)>&) -> int {
+        throw Exception("failed", IvwContextCustom("BackgroundJobTest"));
+    });
+    ASSERT_TRUE(processFrontUntil([&]() { return job.hasResult(); }));
+    EXPECT_THROW(job.takeResult(), Exception);
+    EXPECT_FALSE(job.hasResult());
+}
+
+TEST(BackgroundJob, LatestWins) {
+    if (InviwoApplication::getPtr()->getPoolSize() == 0) return;  // Jobs would run inline
+
+    JobTestProcessor processor;
+    ProgressBar progressBar;
+    BackgroundJob<int> job(processor, &progressBar);
+
+    std::atomic<bool> started{false};
+    std::atomic<int> calls{0};
+    job.submit([&](const StopToken& token, const std::function<void(float)>& progress) {
+        started = true;
+        while (!token.isStopRequested()) {
+            progress(0.5f);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        token.throwIfStopRequested();
+        return 1;
+    });
+    EXPECT_TRUE(job.isRunning());
+    EXPECT_TRUE(progressBar.isVisible());
+    while (!started) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    for (int i = 2; i <= 10; ++i) {
+        job.submit([&calls, i](const StopToken&, const std::function<void(float)>&) {
+            ++calls;
+            return i;
+        });
+    }
+    ASSERT_TRUE(processFrontUntil([&]() { return job.hasResult(); }));
+    EXPECT_EQ(1, calls.load());
+    EXPECT_EQ(1, processor.invalidations);
+    EXPECT_EQ(10, job.takeResult());
+    EXPECT_FALSE(progressBar.isVisible());
+}
+
+TEST(BackgroundJob, Cancel) {
+    if (InviwoApplication::getPtr()->getPoolSize() == 0) return;  // Jobs would run inline
+
+    JobTestProcessor processor;
+    BackgroundJob<int> job(processor);
+
+    job.submit([](const StopToken& token, const std::function<void(float)>&) {
+        while (!token.isStopRequested()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return 1;
+    });
+    job.cancel();
+    ASSERT_TRUE(processFrontUntil([&]() { return !job.isRunning(); }));
+    EXPECT_FALSE(job.hasResult());
+    EXPECT_EQ(0, processor.invalidations);
+}
+
+TEST(BackgroundJob, CancelAfterJobReturned) {
+    auto app = InviwoApplication::getPtr();
+    if (app->getPoolSize() == 0) return;  // Jobs would run inline
+
+    JobTestProcessor processor;
+    BackgroundJob<int> job(processor);
+
+    std::atomic<bool> returned{false};
+    job.submit([&](const StopToken&, const std::function<void(float)>&) {
+        returned = true;
+        return 1;
+    });
+    // Let the job return and queue its result on the front thread, then cancel before the result
+    // is dispatched
+    while (!returned || app->getNumberOfPoolTasks() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    job.cancel();
+    ASSERT_TRUE(processFrontUntil([&]() { return !job.isRunning(); }));
+    EXPECT_FALSE(job.hasResult());
+    EXPECT_EQ(0, processor.invalidations);
+}
+
+}  // namespace inviwo
@@ -0,0 +1,238 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/stdextensions.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+// A loader that takes a while and counts how many times it was asked to load
+class SlowVolumeLoader : public DiskRepresentationLoader<VolumeRepresentation> {
+public:
+    SlowVolumeLoader(size3_t dims, std::shared_ptr<std::atomic<int>> loads)
+        : dims_{dims}, loads_{std::move(loads)} {}
+    virtual SlowVolumeLoader* clone() const override { return new SlowVolumeLoader(*this); }
+    virtual std::shared_ptr<VolumeRepresentation> createRepresentation() const override {
+        ++(*loads_);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        return std::make_shared<VolumeRAMPrecision<float>>(dims_);
+    }
+    virtual void updateRepresentation(std::shared_ptr<VolumeRepresentation>) const override {
+        ++(*loads_);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+private:
+    size3_t dims_;
+    std::shared_ptr<std::atomic<int>> loads_;
+};
+
+std::shared_ptr<Volume> makeSlowVolume(std::shared_ptr<std::atomic<int>> loads) {
+    const size3_t dims{8, 8, 8};
+    auto disk = std::make_shared<VolumeDisk>(dims, DataFloat32::get());
+    disk->setLoader(new SlowVolumeLoader(dims, std::move(loads)));
+    return std::make_shared<Volume>(disk);
+}
+
+// A slow loader that records whether two updates of the same representation ever overlapped
+class OverlapVolumeLoader : public DiskRepresentationLoader<VolumeRepresentation> {
+public:
+    struct Log {
+        std::mutex mutex;
+        std::vector<const VolumeRepresentation*> updating;
+        std::atomic<int> updates{0};
+        std::atomic<int> creates{0};
+        bool overlap = false;
+    };
+
+    OverlapVolumeLoader(size3_t dims, std::shared_ptr<Log> log)
+        : dims_{dims}, log_{std::move(log)} {}
+    virtual OverlapVolumeLoader* clone() const override { return new OverlapVolumeLoader(*this); }
+    virtual std::shared_ptr<VolumeRepresentation> createRepresentation() const override {
+        ++log_->creates;
+        return std::make_shared<VolumeRAMPrecision<float>>(dims_);
+    }
+    virtual void updateRepresentation(std::shared_ptr<VolumeRepresentation> dest) const override {
+        {
+            std::lock_guard<std::mutex> lock(log_->mutex);
+            if (util::contains(log_->updating, dest.get())) log_->overlap = true;
+            log_->updating.push_back(dest.get());
+        }
+        ++log_->updates;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        std::lock_guard<std::mutex> lock(log_->mutex);
+        util::erase_remove(log_->updating, dest.get());
+    }
+
+private:
+    size3_t dims_;
+    std::shared_ptr<Log> log_;
+};
+
+}  // namespace
+
+TEST(DataRepresentations, ConcurrentRequestsShareConversion) {
+    auto loads = std::make_shared<std::atomic<int>>(0);
+    auto volume = makeSlowVolume(loads);
+
+    std::vector<std::future<const VolumeRAM*>> requests;
+    for (int i = 0; i < 4; ++i) {
+        requests.push_back(std::async(std::launch::async, [volume]() {
+            return volume->getRepresentation<VolumeRAM>();
+        }));
+    }
+    std::vector<const VolumeRAM*> results;
+    for (auto& request : requests) results.push_back(request.get());
+
+    EXPECT_EQ(1, loads->load());
+    for (auto result : results) EXPECT_EQ(results.front(), result);
+    EXPECT_EQ(results.front(), volume->getRepresentation<VolumeRAM>());
+}
+
+TEST(DataRepresentations, ValidRepresentationDoesNotWait) {
+    auto loads = std::make_shared<std::atomic<int>>(0);
+    auto volume = makeSlowVolume(loads);
+    const auto disk = volume->getRepresentation<VolumeDisk>();
+
+    auto conversion = std::async(std::launch::async, [volume]() {
+        return volume->getRepresentation<VolumeRAM>();
+    });
+    while (loads->load() == 0) std::this_thread::yield();
+
+    EXPECT_EQ(disk, volume->getRepresentation<VolumeDisk>());
+    EXPECT_EQ(std::future_status::timeout, conversion.wait_for(std::chrono::seconds(0)));
+    EXPECT_NE(nullptr, conversion.get());
+}
+
+TEST(DataRepresentations, GetRepresentationAsync) {
+    auto loads = std::make_shared<std::atomic<int>>(0);
+    auto volume = makeSlowVolume(loads);
+
+    auto prefetch = volume->getRepresentationAsync<VolumeRAM>();
+    auto ram = prefetch.get();
+    ASSERT_NE(nullptr, ram);
+    EXPECT_EQ(ram.get(), volume->getRepresentation<VolumeRAM>());
+    EXPECT_EQ(1, loads->load());
+
+    auto ready = volume->getRepresentationAsync<VolumeRAM>();
+    EXPECT_EQ(std::future_status::ready, ready.wait_for(std::chrono::seconds(0)));
+    EXPECT_EQ(ram, ready.get());
+}
+
+TEST(DataRepresentations, EditDuringConversion) {
+    auto loads = std::make_shared<std::atomic<int>>(0);
+    auto volume = makeSlowVolume(loads);
+    const auto disk = volume->getRepresentation<VolumeDisk>();
+
+    auto conversion = std::async(std::launch::async, [volume]() {
+        return volume->getRepresentation<VolumeRAM>();
+    });
+    while (loads->load() == 0) std::this_thread::yield();
+    volume->invalidateAllOther(disk);
+
+    // The conversion finished after the edit, hence its result is stale and gets updated
+    const auto ram = conversion.get();
+    EXPECT_EQ(2, loads->load());
+    EXPECT_TRUE(ram->isValid());
+    EXPECT_EQ(ram, volume->getRepresentation<VolumeRAM>());
+    EXPECT_EQ(2, loads->load());
+}
+
+TEST(DataRepresentations, ReplacedDuringConversion) {
+    auto loads = std::make_shared<std::atomic<int>>(0);
+    auto volume = makeSlowVolume(loads);
+    volume->getRepresentation<VolumeDisk>();
+
+    std::vector<std::future<const VolumeRAM*>> requests;
+    for (int i = 0; i < 3; ++i) {
+        requests.push_back(std::async(std::launch::async, [volume]() {
+            return volume->getRepresentation<VolumeRAM>();
+        }));
+    }
+    while (loads->load() == 0) std::this_thread::yield();
+
+    auto replacement = std::make_shared<VolumeRAMPrecision<float>>(size3_t{8, 8, 8});
+    replacement->getDataTyped()[0] = 3.0f;
+    volume->addRepresentation(replacement);
+
+    // The outdated result of the conversion is dropped, all requests get the representation
+    // held by the volume
+    for (auto& request : requests) {
+        const auto ram = request.get();
+        EXPECT_EQ(replacement.get(), ram);
+        EXPECT_EQ(3.0, ram->getAsDouble(size3_t{0}));
+    }
+    replacement.reset();
+    EXPECT_EQ(3.0, volume->getRepresentation<VolumeRAM>()->getAsDouble(size3_t{0}));
+    EXPECT_EQ(1, loads->load());
+}
+
+TEST(DataRepresentations, EditDuringUpdate) {
+    const size3_t dims{8, 8, 8};
+    auto log = std::make_shared<OverlapVolumeLoader::Log>();
+    auto disk = std::make_shared<VolumeDisk>(dims, DataFloat32::get());
+    disk->setLoader(new OverlapVolumeLoader(dims, log));
+    auto volume = std::make_shared<Volume>(disk);
+    const auto first = volume->getRepresentation<VolumeRAM>();
+    volume->invalidateAllOther(disk.get());
+
+    // The outdated update is still running on the existing representation when the data is edited
+    // and requested again, the second request must not update the same representation
+    auto stale = std::async(std::launch::async, [volume]() {
+        return volume->getRepresentation<VolumeRAM>();
+    });
+    while (log->updates.load() == 0) std::this_thread::yield();
+    volume->invalidateAllOther(disk.get());
+    const auto current = volume->getRepresentation<VolumeRAM>();
+
+    EXPECT_EQ(current, stale.get());
+    EXPECT_NE(first, current);
+    EXPECT_TRUE(current->isValid());
+    EXPECT_EQ(current, volume->getRepresentation<VolumeRAM>());
+    std::lock_guard<std::mutex> lock(log->mutex);
+    EXPECT_FALSE(log->overlap);
+    EXPECT_EQ(2, log->creates.load());
+}
+
+}  // namespace inviwo
@@ -0,0 +1,111 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/util/foreach.h>
+#include <inviwo/core/util/poolutils.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+namespace inviwo {
+
+TEST(ForEachRangeParallel, RangesCoverAllElements) {
+    const size_t size = 1000;
+    std::vector<int> visits(size, 0);
+    std::vector<size_t> begins;
+    std::vector<size_t> done;
+    util::withPoolSize(2, [&]() {
+        const size_t ranges = util::parallelRangeCount(size, 10);
+        EXPECT_EQ(8, ranges);
+        begins.resize(ranges, size);
+        util::forEachRangeParallelN(size, ranges,
+                                    [&](size_t begin, size_t end, size_t range) {
+                                        begins[range] = begin;
+                                        for (size_t i = begin; i < end; ++i) ++visits[i];
+                                    },
+                                    [&](size_t range) { done.push_back(range); });
+    });
+
+    EXPECT_EQ(std::vector<int>(size, 1), visits);
+    ASSERT_EQ(begins.size(), done.size());
+    for (size_t range = 0; range < begins.size(); ++range) {
+        EXPECT_EQ(range * size / begins.size(), begins[range]);
+        EXPECT_EQ(range, done[range]);
+    }
+}
+
+TEST(ForEachRangeParallel, GivenNumberOfRanges) {
+    // The number of ranges does not depend on the pool size
+    for (const size_t poolSize : {0, 1, 3}) {
+        std::vector<size_t> ends(5, 0);
+        util::withPoolSize(poolSize, [&]() {
+            util::forEachRangeParallelN(
+                100, ends.size(), [&](size_t, size_t end, size_t range) { ends[range] = end; });
+        });
+        EXPECT_EQ((std::vector<size_t>{20, 40, 60, 80, 100}), ends);
+    }
+}
+
+TEST(ForEachRangeParallel, SingleRange) {
+    EXPECT_EQ(1, util::withPoolSize(0, []() { return util::parallelRangeCount(1000, 10); }));
+    EXPECT_EQ(1, util::withPoolSize(2, []() { return util::parallelRangeCount(15, 10); }));
+
+    size_t calls = 0;
+    util::withPoolSize(2, [&]() {
+        util::forEachRangeParallel(15, 10, [&](size_t begin, size_t end) {
+            EXPECT_EQ(0, begin);
+            EXPECT_EQ(15, end);
+            ++calls;
+        });
+    });
+    EXPECT_EQ(1, calls);
+}
+
+TEST(ForEachRangeParallel, RethrowsAfterAllRanges) {
+    std::atomic<size_t> finished{0};
+    util::withPoolSize(2, [&]() {
+        EXPECT_THROW(util::forEachRangeParallel(100, 1,
+                                                [&](size_t begin, size_t) {
+                                                    if (begin == 0) {
+                                                        throw std::runtime_error("range");
+                                                    }
+                                                    ++finished;
+                                                }),
+                     std::runtime_error);
+        EXPECT_EQ(util::parallelRangeCount(100) - 1, finished);
+    });
+}
+
+}  // namespace inviwo
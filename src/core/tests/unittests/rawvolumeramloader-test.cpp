@@ -0,0 +1,175 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *********************************************************************************/
+
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/io/rawvolumeramloader.h>
+#include <inviwo/core/io/memorymappedfile.h>
+#include <inviwo/core/io/tempfilehandle.h>
+#include <inviwo/core/util/filesystem.h>
+
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+using Voxel = glm::u16vec3;
+
+std::vector<Voxel> makeVoxels(size3_t dims) {
+    std::vector<Voxel> voxels(dims.x * dims.y * dims.z);
+    for (size_t i = 0; i < voxels.size(); ++i) {
+        const auto v = static_cast<glm::u16>(i);
+        voxels[i] = Voxel(v, static_cast<glm::u16>(v + 1000), static_cast<glm::u16>(v + 2000));
+    }
+    return voxels;
+}
+
+// Write offset zero bytes followed by the voxels, with each component in the given byte order
+void writeRaw(util::TempFileHandle& file, size_t offset, const std::vector<Voxel>& voxels,
+              bool littleEndian) {
+    std::vector<unsigned char> bytes(offset, 0);
+    for (const auto& voxel : voxels) {
+        for (glm::length_t c = 0; c < 3; ++c) {
+            const auto lo = static_cast<unsigned char>(voxel[c] & 0xff);
+            const auto hi = static_cast<unsigned char>(voxel[c] >> 8);
+            bytes.push_back(littleEndian ? lo : hi);
+            bytes.push_back(littleEndian ? hi : lo);
+        }
+    }
+    ASSERT_EQ(bytes.size(), std::fwrite(bytes.data(), 1, bytes.size(), file.getHandle()));
+    ASSERT_EQ(0, std::fflush(file.getHandle()));
+}
+
+std::vector<char> readFile(const std::string& filename) {
+    auto fin = filesystem::ifstream(filename, std::ios::in | std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(fin),
+                             std::istreambuf_iterator<char>());
+}
+
+std::shared_ptr<VolumeRAMPrecision<Voxel>> load(const std::string& filename, size_t offset,
+                                                size3_t dims, bool littleEndian) {
+    RawVolumeRAMLoader loader(filename, offset, dims, littleEndian, DataVec3UInt16::get());
+    return std::dynamic_pointer_cast<VolumeRAMPrecision<Voxel>>(loader.createRepresentation());
+}
+
+std::vector<Voxel> values(const VolumeRAMPrecision<Voxel>& ram) {
+    const Voxel* data = ram.getDataTyped();
+    const auto dims = ram.getDimensions();
+    return std::vector<Voxel>(data, data + dims.x * dims.y * dims.z);
+}
+
+bool isMapped(const std::shared_ptr<VolumeRAMPrecision<Voxel>>& ram) {
+    return std::dynamic_pointer_cast<detail::MappedVolumeRAMPrecision<Voxel>>(ram) != nullptr;
+}
+
+}  // namespace
+
+TEST(RawVolumeRAMLoader, BigEndianRoundTrip) {
+    const size3_t dims{7, 5, 3};
+    const auto voxels = makeVoxels(dims);
+    util::TempFileHandle file("raw", ".raw");
+    writeRaw(file, 0, voxels, false);
+
+    // Each component is swapped on its own, the order of the components is kept
+    auto ram = load(file.getFileName(), 0, dims, false);
+    ASSERT_TRUE(ram);
+    EXPECT_FALSE(isMapped(ram));
+    EXPECT_EQ(voxels, values(*ram));
+}
+
+TEST(RawVolumeRAMLoader, MappedAndReadDataAreIdentical) {
+    const size3_t dims{7, 5, 3};
+    const auto voxels = makeVoxels(dims);
+    for (const size_t offset : {0, 6, 4096}) {
+        util::TempFileHandle file("raw", ".raw");
+        writeRaw(file, offset, voxels, true);
+
+        auto mapped = load(file.getFileName(), offset, dims, true);
+        ASSERT_TRUE(mapped);
+        EXPECT_TRUE(isMapped(mapped));
+
+        auto read = std::make_shared<VolumeRAMPrecision<Voxel>>(dims);
+        RawVolumeRAMLoader(file.getFileName(), offset, dims, true, DataVec3UInt16::get())
+            .updateRepresentation(read);
+
+        EXPECT_EQ(values(*read), values(*mapped));
+        EXPECT_EQ(voxels, values(*read));
+    }
+}
+
+TEST(RawVolumeRAMLoader, MisalignedOffsetIsRead) {
+    const size3_t dims{7, 5, 3};
+    const auto voxels = makeVoxels(dims);
+    util::TempFileHandle file("raw", ".raw");
+    writeRaw(file, 3, voxels, true);
+
+    auto ram = load(file.getFileName(), 3, dims, true);
+    ASSERT_TRUE(ram);
+    EXPECT_FALSE(isMapped(ram));
+    EXPECT_EQ(voxels, values(*ram));
+}
+
+TEST(RawVolumeRAMLoader, EditingDoesNotModifyTheFile) {
+    const size3_t dims{7, 5, 3};
+    const auto voxels = makeVoxels(dims);
+    util::TempFileHandle file("raw", ".raw");
+    writeRaw(file, 0, voxels, true);
+    const auto before = readFile(file.getFileName());
+
+    auto ram = load(file.getFileName(), 0, dims, true);
+    ASSERT_TRUE(isMapped(ram));
+    std::fill_n(ram->getDataTyped(), voxels.size(), Voxel(0xffff));
+    EXPECT_EQ(std::vector<Voxel>(voxels.size(), Voxel(0xffff)), values(*ram));
+
+    // The mapping is private, the write is neither seen in the file nor by other mappings
+    EXPECT_EQ(before, readFile(file.getFileName()));
+    EXPECT_EQ(voxels, values(*load(file.getFileName(), 0, dims, true)));
+}
+
+TEST(MemoryMappedFile, ThrowsIfTheFileCanNotBeMapped) {
+    util::TempFileHandle file("raw", ".raw");
+    writeRaw(file, 0, makeVoxels(size3_t{2, 2, 2}), true);
+
+    EXPECT_THROW(util::MemoryMappedFile(file.getFileName() + ".missing", 0, 8), FileException);
+    EXPECT_THROW(util::MemoryMappedFile(file.getFileName(), 0, 1024), FileException);
+
+    util::MemoryMappedFile mapping(file.getFileName(), 6, 6);
+    EXPECT_EQ(6, mapping.getSize());
+    EXPECT_EQ(0, std::memcmp(mapping.getData(), makeVoxels(size3_t{2, 2, 2}).data() + 1, 6));
+}
+
+}  // namespace inviwo
@@ -0,0 +1,305 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/datastructures/representationmemorymanager.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/datastructures/image/image.h>
+#include <inviwo/core/datastructures/image/layerdisk.h>
+#include <inviwo/core/datastructures/image/layerramprecision.h>
+#include <inviwo/core/util/imagesampler.h>
+#include <inviwo/core/util/raiiutils.h>
+
+#include <future>
+#include <thread>
+
+namespace inviwo {
+
+namespace {
+
+class TestOwner : public RepresentationMemoryManager::Owner {
+public:
+    virtual bool evictRepresentation(const void* repr) override {
+        if (!evictable) return false;
+        evicted.push_back(repr);
+        return true;
+    }
+    bool evictable = true;
+    std::vector<const void*> evicted;
+};
+
+class CountingVolumeLoader : public DiskRepresentationLoader<VolumeRepresentation> {
+public:
+    CountingVolumeLoader(size3_t dims, std::shared_ptr<int> loads)
+        : dims_{dims}, loads_{std::move(loads)} {}
+    virtual CountingVolumeLoader* clone() const override {
+        return new CountingVolumeLoader(*this);
+    }
+    virtual std::shared_ptr<VolumeRepresentation> createRepresentation() const override {
+        ++(*loads_);
+        return std::make_shared<VolumeRAMPrecision<float>>(dims_);
+    }
+    virtual void updateRepresentation(std::shared_ptr<VolumeRepresentation>) const override {
+        ++(*loads_);
+    }
+
+private:
+    size3_t dims_;
+    std::shared_ptr<int> loads_;
+};
+
+class ConstantLayerLoader : public DiskRepresentationLoader<LayerRepresentation> {
+public:
+    ConstantLayerLoader(size2_t dims, vec4 value) : dims_{dims}, value_{value} {}
+    virtual ConstantLayerLoader* clone() const override { return new ConstantLayerLoader(*this); }
+    virtual std::shared_ptr<LayerRepresentation> createRepresentation() const override {
+        auto ram = std::make_shared<LayerRAMPrecision<vec4>>(dims_);
+        std::fill_n(ram->getDataTyped(), dims_.x * dims_.y, value_);
+        return ram;
+    }
+    virtual void updateRepresentation(std::shared_ptr<LayerRepresentation> dest) const override {
+        auto ram = std::static_pointer_cast<LayerRAMPrecision<vec4>>(dest);
+        std::fill_n(ram->getDataTyped(), dims_.x * dims_.y, value_);
+    }
+
+private:
+    size2_t dims_;
+    vec4 value_;
+};
+
+}  // namespace
+
+TEST(RepresentationMemoryManager, EvictsLeastRecentlyUsed) {
+    auto manager = RepresentationMemoryManager::getPtr();
+    const auto budget = manager->getBudget();
+    const auto size = manager->getSize();
+    const auto count = manager->getNumberOfRepresentations();
+    const auto evictions = manager->getNumberOfEvictions();
+    manager->setBudget(size + 250);
+
+    TestOwner owner;
+    int a, b, c;
+    manager->use(&owner, &a, 100);
+    manager->use(&owner, &b, 100);
+    manager->use(&owner, &a, 100);  // b is now the least recently used
+    manager->use(&owner, &c, 100);
+    EXPECT_EQ(size + 300, manager->getSize());
+    EXPECT_EQ(count + 3, manager->getNumberOfRepresentations());
+
+    // Used in the current evaluation, and then in the last one, hence pinned
+    manager->evict();
+    EXPECT_TRUE(owner.evicted.empty());
+    manager->onProcessorNetworkEvaluationEnd();
+    EXPECT_TRUE(owner.evicted.empty());
+
+    manager->onProcessorNetworkEvaluationEnd();
+    ASSERT_EQ(1, owner.evicted.size());
+    EXPECT_EQ(&b, owner.evicted.front());
+    EXPECT_EQ(size + 200, manager->getSize());
+    EXPECT_EQ(evictions + 1, manager->getNumberOfEvictions());
+
+    manager->remove(&a);
+    manager->remove(&c);
+    EXPECT_EQ(size, manager->getSize());
+    EXPECT_EQ(count, manager->getNumberOfRepresentations());
+    manager->setBudget(budget);
+}
+
+TEST(RepresentationMemoryManager, SkipsRepresentationsThatCanNotBeEvicted) {
+    auto manager = RepresentationMemoryManager::getPtr();
+    const auto budget = manager->getBudget();
+    const auto size = manager->getSize();
+    manager->setBudget(size + 150);
+
+    TestOwner pinned;
+    pinned.evictable = false;
+    TestOwner owner;
+    int a, b;
+    manager->use(&pinned, &a, 100);
+    manager->use(&owner, &b, 100);
+    manager->onProcessorNetworkEvaluationEnd();
+    manager->onProcessorNetworkEvaluationEnd();
+    EXPECT_TRUE(pinned.evicted.empty());
+    ASSERT_EQ(1, owner.evicted.size());
+    EXPECT_EQ(&b, owner.evicted.front());
+    EXPECT_EQ(size + 100, manager->getSize());
+
+    manager->remove(&a);
+    manager->setBudget(budget);
+}
+
+TEST(RepresentationMemoryManager, EvictsVolumeRAMBackedByDisk) {
+    auto manager = RepresentationMemoryManager::getPtr();
+    const auto budget = manager->getBudget();
+
+    const size3_t dims{8, 8, 8};
+    auto loads = std::make_shared<int>(0);
+    auto disk = std::make_shared<VolumeDisk>(dims, DataFloat32::get());
+    disk->setLoader(new CountingVolumeLoader(dims, loads));
+    Volume volume(disk);
+
+    volume.getRepresentation<VolumeRAM>();
+    EXPECT_EQ(1, *loads);
+
+    // Pinned until the evaluation after the one using it has ended
+    manager->setBudget(0);
+    EXPECT_TRUE(volume.hasRepresentation<VolumeRAM>());
+    manager->onProcessorNetworkEvaluationEnd();
+    EXPECT_TRUE(volume.hasRepresentation<VolumeRAM>());
+    manager->onProcessorNetworkEvaluationEnd();
+    EXPECT_FALSE(volume.hasRepresentation<VolumeRAM>());
+    EXPECT_TRUE(volume.hasRepresentation<VolumeDisk>());
+    volume.getRepresentation<VolumeRAM>();
+    EXPECT_EQ(2, *loads);
+
+    // Representations in use are kept
+    {
+        auto ram = volume.getRepresentationShared<VolumeRAM>();
+        manager->onProcessorNetworkEvaluationEnd();
+        manager->onProcessorNetworkEvaluationEnd();
+        EXPECT_TRUE(volume.hasRepresentation<VolumeRAM>());
+    }
+
+    // An edited volume can not be rebuilt from disk
+    volume.getEditableRepresentation<VolumeRAM>();
+    manager->onProcessorNetworkEvaluationEnd();
+    manager->onProcessorNetworkEvaluationEnd();
+    EXPECT_TRUE(volume.hasRepresentation<VolumeRAM>());
+
+    manager->setBudget(budget);
+}
+
+TEST(RepresentationMemoryManager, KeepsRepresentationsOfTheLastEvaluation) {
+    auto manager = RepresentationMemoryManager::getPtr();
+    const auto budget = manager->getBudget();
+    util::OnScopeExit restore([&]() { manager->setBudget(budget); });
+
+    const size3_t dims{8, 8, 8};
+    auto loads = std::make_shared<int>(0);
+    auto disk = std::make_shared<VolumeDisk>(dims, DataFloat32::get());
+    disk->setLoader(new CountingVolumeLoader(dims, loads));
+    Volume volume(disk);
+    manager->setBudget(0);
+
+    // Evaluation N retrieves the representation by raw pointer, as processors do with the data
+    // of their ports, and the network might still use it after N has ended
+    const VolumeRAM* ram = volume.getRepresentation<VolumeRAM>();
+    manager->onProcessorNetworkEvaluationEnd();
+    ASSERT_TRUE(volume.hasRepresentation<VolumeRAM>());
+    EXPECT_EQ(ram, volume.getRepresentation<VolumeRAM>());
+    EXPECT_EQ(1, *loads);
+
+    // Used in N + 1 as well, kept after it
+    manager->onProcessorNetworkEvaluationEnd();
+    EXPECT_TRUE(volume.hasRepresentation<VolumeRAM>());
+
+    // Not used in N + 2, evicted after it
+    manager->onProcessorNetworkEvaluationEnd();
+    EXPECT_FALSE(volume.hasRepresentation<VolumeRAM>());
+}
+
+TEST(RepresentationMemoryManager, WaitsForTasksOnThePool) {
+    auto app = InviwoApplication::getPtr();
+    const auto poolSize = app->getPoolSize();
+    app->resizePool(2);
+    auto manager = RepresentationMemoryManager::getPtr();
+    const auto budget = manager->getBudget();
+    util::OnScopeExit restore([&]() {
+        manager->setBudget(budget);
+        app->resizePool(poolSize);
+    });
+
+    const size3_t dims{8, 8, 8};
+    auto loads = std::make_shared<int>(0);
+    auto disk = std::make_shared<VolumeDisk>(dims, DataFloat32::get());
+    disk->setLoader(new CountingVolumeLoader(dims, loads));
+    Volume volume(disk);
+
+    // A background reader holding the representation by raw pointer, across an eviction pass
+    std::promise<void> started;
+    std::promise<void> release;
+    auto reader = dispatchPool([&volume, &started, future = release.get_future()]() {
+        const VolumeRAM* ram = volume.getRepresentation<VolumeRAM>();
+        started.set_value();
+        future.wait();
+        return ram->getDimensions();
+    });
+    started.get_future().wait();
+
+    manager->setBudget(0);
+    manager->onProcessorNetworkEvaluationEnd();
+    EXPECT_TRUE(volume.hasRepresentation<VolumeRAM>());
+
+    release.set_value();
+    EXPECT_EQ(dims, reader.get());
+    while (app->getNumberOfPoolTasks() > 0) std::this_thread::yield();
+
+    manager->onProcessorNetworkEvaluationEnd();
+    manager->onProcessorNetworkEvaluationEnd();
+    EXPECT_FALSE(volume.hasRepresentation<VolumeRAM>());
+    EXPECT_EQ(1, *loads);
+}
+
+TEST(RepresentationMemoryManager, KeepsTheLayerRAMOfAnImageSampler) {
+    auto manager = RepresentationMemoryManager::getPtr();
+    const auto budget = manager->getBudget();
+    util::OnScopeExit restore([&]() { manager->setBudget(budget); });
+
+    const size2_t dims{4, 4};
+    const vec4 value{0.25f, 0.5f, 0.75f, 1.0f};
+    auto disk = std::make_shared<LayerDisk>();
+    disk->updateDataFormat(DataVec4Float32::get());
+    disk->setLoader(new ConstantLayerLoader(dims, value));
+    auto layer = std::make_shared<Layer>(disk);
+    disk->setDimensions(dims);
+    auto image = std::make_shared<const Image>(layer);
+    manager->setBudget(0);
+
+    // A sampler put on an outport outlives the evaluation that created it
+    auto sampler = std::make_shared<ImageSampler>(image);
+    manager->onProcessorNetworkEvaluationEnd();
+    manager->onProcessorNetworkEvaluationEnd();
+    manager->onProcessorNetworkEvaluationEnd();
+    EXPECT_TRUE(layer->hasRepresentation<LayerRAM>());
+    EXPECT_EQ(dvec4(value), sampler->sample(dvec2(0.5), CoordinateSpace::Data));
+
+    // Evictable again once the sampler is gone
+    sampler.reset();
+    manager->onProcessorNetworkEvaluationEnd();
+    manager->onProcessorNetworkEvaluationEnd();
+    EXPECT_FALSE(layer->hasRepresentation<LayerRAM>());
+}
+
+}  // namespace inviwo
@@ -0,0 +1,138 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/datastructures/sharedstorage.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+
+#include <numeric>
+
+namespace inviwo {
+
+TEST(SharedStorage, CopyShares) {
+    SharedStorage<int> a(16);
+    std::iota(a.data(), a.data() + a.size(), 0);
+    const auto before = util::getSharedStorageMemory();
+
+    SharedStorage<int> b(a);
+    EXPECT_EQ(a.data(), b.data());
+    EXPECT_TRUE(a.isShared());
+    EXPECT_TRUE(b.isShared());
+
+    const auto after = util::getSharedStorageMemory();
+    EXPECT_EQ(before.logicalBytes + 16 * sizeof(int), after.logicalBytes);
+    EXPECT_EQ(before.physicalBytes, after.physicalBytes);
+}
+
+TEST(SharedStorage, MakeUniqueCopies) {
+    SharedStorage<int> a(16);
+    std::iota(a.data(), a.data() + a.size(), 0);
+    SharedStorage<int> b(a);
+    const auto before = util::getSharedStorageMemory();
+
+    b.makeUnique();
+    EXPECT_NE(a.data(), b.data());
+    EXPECT_FALSE(a.isShared());
+    EXPECT_FALSE(b.isShared());
+    b[3] = 42;
+    EXPECT_EQ(3, a[3]);
+    EXPECT_EQ(42, b[3]);
+    EXPECT_EQ(15, b[15]);
+
+    const auto after = util::getSharedStorageMemory();
+    EXPECT_EQ(before.logicalBytes, after.logicalBytes);
+    EXPECT_EQ(before.physicalBytes + 16 * sizeof(int), after.physicalBytes);
+
+    const auto data = b.data();
+    b.makeUnique();
+    EXPECT_EQ(data, b.data());
+}
+
+TEST(SharedStorage, CopyAfterMakeUniqueShares) {
+    SharedStorage<int> a(16);
+    a.makeUnique();
+    const auto data = a.data();
+
+    const SharedStorage<int> b(a);
+    a.makeUnique();
+    EXPECT_NE(data, a.data());
+    a[3] = 42;
+    EXPECT_EQ(0, b[3]);
+
+    SharedStorage<int> c(16);
+    c.makeUnique();
+    c = a;
+    c.makeUnique();
+    EXPECT_NE(a.data(), c.data());
+
+    SharedStorage<int> d(std::move(c));
+    const auto moved = d.data();
+    d.makeUnique();
+    EXPECT_EQ(moved, d.data());
+}
+
+TEST(SharedStorage, ExternalOwner) {
+    auto owner = std::make_shared<std::vector<int>>(8, 7);
+    std::weak_ptr<std::vector<int>> weak = owner;
+    {
+        SharedStorage<int> a(owner->data(), owner->size(), owner);
+        owner.reset();
+        SharedStorage<int> b(a);
+        a = SharedStorage<int>{};
+        EXPECT_FALSE(weak.expired());
+        EXPECT_EQ(7, b[4]);
+    }
+    EXPECT_TRUE(weak.expired());
+}
+
+TEST(SharedStorage, VolumeCopyOnWrite) {
+    auto ram = std::make_shared<VolumeRAMPrecision<float>>(size3_t(4, 4, 4));
+    auto data = ram->getDataTyped();
+    std::iota(data, data + 64, 0.0f);
+    Volume volume(ram);
+
+    std::unique_ptr<Volume> copy(volume.clone());
+    const auto orgRAM = volume.getRepresentation<VolumeRAM>();
+    const auto copyRAM = copy->getRepresentation<VolumeRAM>();
+    EXPECT_EQ(orgRAM->getData(), copyRAM->getData());
+
+    auto editable = copy->getEditableRepresentation<VolumeRAM>();
+    editable->setFromDouble(size3_t(1, 0, 0), 100.0);
+    EXPECT_NE(orgRAM->getData(), editable->getData());
+    EXPECT_DOUBLE_EQ(1.0, orgRAM->getAsDouble(size3_t(1, 0, 0)));
+    EXPECT_DOUBLE_EQ(100.0, editable->getAsDouble(size3_t(1, 0, 0)));
+    EXPECT_DOUBLE_EQ(63.0, editable->getAsDouble(size3_t(3, 3, 3)));
+}
+
+}  // namespace inviwo
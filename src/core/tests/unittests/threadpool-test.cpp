@@ -0,0 +1,163 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/util/threadpool.h>
+
+#include <vector>
+#include <numeric>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <chrono>
+
+namespace inviwo {
+
+TEST(ThreadPool, TaskSmallBuffer) {
+    int calls = 0;
+    ThreadPool::Task task{[&calls]() { ++calls; }};
+    ThreadPool::Task moved{std::move(task)};
+    EXPECT_FALSE(static_cast<bool>(task));
+    ASSERT_TRUE(static_cast<bool>(moved));
+    moved();
+    EXPECT_EQ(1, calls);
+}
+
+TEST(ThreadPool, TaskLargeAndMoveOnly) {
+    std::array<int, 64> data;
+    std::iota(data.begin(), data.end(), 0);
+    int sum = 0;
+    auto ptr = std::make_unique<int>(2);
+    ThreadPool::Task task{[data, &sum, p = std::move(ptr)]() {
+        sum = *p * std::accumulate(data.begin(), data.end(), 0);
+    }};
+    ThreadPool::Task other;
+    other = std::move(task);
+    other();
+    EXPECT_EQ(2 * 63 * 64 / 2, sum);
+}
+
+TEST(ThreadPool, NoWorkers) {
+    ThreadPool pool(0);
+    auto res = pool.enqueue([](int a, int b) { return a + b; }, 1, 2);
+    EXPECT_EQ(3, res.get());
+}
+
+TEST(ThreadPool, Enqueue) {
+    ThreadPool pool(4);
+    std::vector<std::future<size_t>> futures;
+    for (size_t i = 0; i < 1000; ++i) {
+        futures.push_back(pool.enqueue([i]() { return i * i; }));
+    }
+    for (size_t i = 0; i < futures.size(); ++i) {
+        EXPECT_EQ(i * i, futures[i].get());
+    }
+}
+
+TEST(ThreadPool, Priority) {
+    ThreadPool pool(1);
+    // keep the only worker busy until all tasks are queued
+    std::promise<void> gate;
+    auto blocker = pool.enqueue([f = gate.get_future()]() { f.wait(); });
+
+    std::atomic<int> counter{0};
+    auto low = pool.enqueue(ThreadPool::Priority::Low, [&]() { return counter++; });
+    auto normal = pool.enqueue([&]() { return counter++; });
+    auto high = pool.enqueue(ThreadPool::Priority::High, [&]() { return counter++; });
+    gate.set_value();
+
+    EXPECT_EQ(0, high.get());
+    EXPECT_EQ(1, normal.get());
+    EXPECT_EQ(2, low.get());
+}
+
+TEST(ThreadPool, NestedTasks) {
+    // More tasks waiting for subtasks than there are workers, would dead lock without
+    // ThreadPool::wait running other tasks.
+    ThreadPool pool(2);
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 16; ++i) {
+        futures.push_back(pool.enqueue([&pool, i]() {
+            std::vector<std::future<int>> subtasks;
+            for (int j = 0; j < 8; ++j) {
+                subtasks.push_back(pool.enqueue([i, j]() { return i * j; }));
+            }
+            int sum = 0;
+            for (auto& subtask : subtasks) {
+                pool.wait(subtask);
+                sum += subtask.get();
+            }
+            return sum;
+        }));
+    }
+    for (int i = 0; i < 16; ++i) {
+        pool.wait(futures[i]);
+        EXPECT_EQ(i * 28, futures[i].get());
+    }
+}
+
+TEST(ThreadPool, Exception) {
+    ThreadPool pool(2);
+    auto res = pool.enqueue([]() -> int { throw std::runtime_error("task failed"); });
+    EXPECT_THROW(res.get(), std::runtime_error);
+}
+
+TEST(ThreadPool, WaitForFutureCompletedOutsideThePool) {
+    // The waiting worker is not woken by any pool task and has to recheck the future by itself
+    ThreadPool pool(1);
+    std::promise<int> promise;
+    std::shared_future<int> external = promise.get_future().share();
+    auto res = pool.enqueue([&pool, external]() {
+        pool.wait(external);
+        return external.get() + 1;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    promise.set_value(41);
+    EXPECT_EQ(42, res.get());
+}
+
+TEST(ThreadPool, Resize) {
+    ThreadPool pool(4);
+    std::atomic<int> counter{0};
+    for (int i = 0; i < 100; ++i) {
+        pool.enqueue([&counter]() { ++counter; });
+    }
+    pool.trySetSize(8);
+    EXPECT_EQ(8, pool.getSize());
+    while (pool.trySetSize(0) != 0) {
+    }
+    EXPECT_EQ(100, counter);
+}
+
+}  // namespace inviwo
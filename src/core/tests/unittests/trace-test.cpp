@@ -0,0 +1,169 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/util/trace.h>
+
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace inviwo {
+
+TEST(Tracer, DisabledRecordsNothing) {
+    trace::Tracer::start();
+    trace::Tracer::stop();
+    { IVW_TRACE_SCOPE("test", "Ignored"); }
+    EXPECT_TRUE(trace::Tracer::getEvents().empty());
+}
+
+TEST(Tracer, NameOnlyEvaluatedWhenEnabled) {
+    trace::Tracer::stop();
+    int calls = 0;
+    auto name = [&]() {
+        ++calls;
+        return std::string("Name");
+    };
+    { IVW_TRACE_SCOPE("test", name()); }
+    EXPECT_EQ(0, calls);
+
+    trace::Tracer::start();
+    { IVW_TRACE_SCOPE("test", name()); }
+    trace::Tracer::stop();
+    EXPECT_EQ(1, calls);
+    ASSERT_EQ(1u, trace::Tracer::getEvents().size());
+}
+
+TEST(Tracer, RecordsNestedScopesOnThreads) {
+    trace::Tracer::start();
+    {
+        IVW_TRACE_SCOPE("test", "Outer");
+        std::thread thread{[]() {
+            trace::Tracer::setThreadName("Other");
+            IVW_TRACE_SCOPE("test", "Thread");
+        }};
+        thread.join();
+        IVW_TRACE_SCOPE("test", std::string("Inner ") + std::to_string(1));
+    }
+    trace::Tracer::stop();
+
+    auto events = trace::Tracer::getEvents();
+    ASSERT_EQ(3u, events.size());
+    EXPECT_STREQ("Outer", events[0].name.data());
+    EXPECT_STREQ("Thread", events[1].name.data());
+    EXPECT_STREQ("Inner 1", events[2].name.data());
+    EXPECT_EQ(events[0].thread, events[2].thread);
+    EXPECT_NE(events[0].thread, events[1].thread);
+    EXPECT_LE(events[0].begin, events[2].begin);
+    EXPECT_GE(events[0].begin + events[0].duration, events[2].begin + events[2].duration);
+}
+
+TEST(Tracer, RingBufferKeepsNewest) {
+    trace::Tracer::start(4);
+    for (int i = 0; i < 10; ++i) {
+        IVW_TRACE_SCOPE("test", std::to_string(i));
+    }
+    trace::Tracer::stop();
+
+    auto events = trace::Tracer::getEvents();
+    ASSERT_EQ(4u, events.size());
+    for (size_t i = 0; i < events.size(); ++i) {
+        EXPECT_EQ(std::to_string(6 + i), events[i].name.data());
+    }
+}
+
+TEST(Tracer, LongNamesAreTruncated) {
+    trace::Tracer::start();
+    { IVW_TRACE_SCOPE("test", std::string(200, 'a')); }
+    trace::Tracer::stop();
+
+    auto events = trace::Tracer::getEvents();
+    ASSERT_EQ(1u, events.size());
+    EXPECT_EQ(std::string(trace::Event::maxNameLength, 'a'), events[0].name.data());
+}
+
+TEST(Tracer, TruncationKeepsUtf8Characters) {
+    // Two byte characters, the name limit falls in the middle of one
+    std::string name;
+    for (int i = 0; i < 100; ++i) name += "\xC3\xA5";
+    trace::Tracer::start();
+    { IVW_TRACE_SCOPE("test", name); }
+    trace::Tracer::stop();
+
+    auto events = trace::Tracer::getEvents();
+    ASSERT_EQ(1u, events.size());
+    EXPECT_EQ(name.substr(0, trace::Event::maxNameLength - 1), events[0].name.data());
+}
+
+TEST(Tracer, ReadWhileRecording) {
+    trace::Tracer::start(64);
+    std::atomic<bool> done{false};
+    std::thread writer{[&]() {
+        // Each event is named after its duration, a torn read would break that
+        for (std::int64_t i = 0; !done; ++i) {
+            const auto begin = trace::clock::now();
+            trace::Tracer::record("test", std::to_string(i), begin,
+                                  begin + std::chrono::nanoseconds(i));
+        }
+    }};
+    for (int i = 0; i < 200; ++i) {
+        for (const auto& event : trace::Tracer::getEvents()) {
+            EXPECT_EQ(std::to_string(event.duration), event.name.data());
+        }
+        if (i % 10 == 0) trace::Tracer::clear();
+    }
+    done = true;
+    writer.join();
+    trace::Tracer::stop();
+}
+
+TEST(Tracer, ChromeTraceJson) {
+    trace::Tracer::setThreadName("Main");
+    trace::Tracer::start();
+    { IVW_TRACE_SCOPE("test", "Quote \" and \\ backslash"); }
+    trace::Tracer::stop();
+
+    std::stringstream ss;
+    trace::Tracer::writeChromeTrace(ss);
+    const auto json = ss.str();
+    EXPECT_EQ(0u, json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+    EXPECT_NE(std::string::npos,
+              json.find("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"));
+    EXPECT_NE(std::string::npos, json.find("\"args\":{\"name\":\"Main\"}}"));
+    EXPECT_NE(std::string::npos, json.find("{\"name\":\"Quote \\\" and \\\\ backslash\","
+                                           "\"cat\":\"test\",\"ph\":\"X\""));
+    EXPECT_EQ(json.size() - 4, json.rfind("\n]}\n"));
+}
+
+}  // namespace inviwo
@@ -0,0 +1,263 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/datastructures/volume/volumebricked.h>
+#include <inviwo/core/datastructures/volume/volumebrickcache.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/datastructures/representationmemorymanager.h>
+#include <inviwo/core/util/indexmapper.h>
+#include <inviwo/core/util/raiiutils.h>
+#include <inviwo/core/util/volumesampler.h>
+
+#include <random>
+
+namespace inviwo {
+
+namespace {
+
+// A loader generating a volume where each voxel holds its own linear index
+class IndexVolumeLoader : public DiskRepresentationLoader<VolumeRepresentation>,
+                          public VolumeRegionLoader {
+public:
+    IndexVolumeLoader(size3_t dims) : dims_{dims} {}
+    virtual IndexVolumeLoader* clone() const override { return new IndexVolumeLoader(*this); }
+    virtual std::shared_ptr<VolumeRepresentation> createRepresentation() const override {
+        auto ram = std::make_shared<VolumeRAMPrecision<unsigned short>>(dims_);
+        readRegion(size3_t(0), dims_, ram->getData());
+        return ram;
+    }
+    virtual void updateRepresentation(std::shared_ptr<VolumeRepresentation> dest) const override {
+        auto ram = std::static_pointer_cast<VolumeRAM>(dest);
+        readRegion(size3_t(0), dims_, ram->getData());
+    }
+    virtual void readRegion(const size3_t& offset, const size3_t& dims,
+                            void* dest) const override {
+        ++(*reads_);
+        util::IndexMapper3D vm(dims_);
+        auto data = static_cast<unsigned short*>(dest);
+        for (size_t z = 0; z < dims.z; ++z) {
+            for (size_t y = 0; y < dims.y; ++y) {
+                for (size_t x = 0; x < dims.x; ++x) {
+                    *data++ = static_cast<unsigned short>(vm(offset + size3_t(x, y, z)));
+                }
+            }
+        }
+    }
+    size_t reads() const { return *reads_; }
+
+private:
+    size3_t dims_;
+    std::shared_ptr<size_t> reads_ = std::make_shared<size_t>(0);
+};
+
+}  // namespace
+
+TEST(VolumeBrickCache, EvictsLeastRecentlyUsed) {
+    const size3_t dims{4, 4, 4};
+    const size_t bytes = dims.x * dims.y * dims.z;
+    auto cache = VolumeBrickCache::getPtr();
+    const auto budget = cache->getBudget();
+    cache->clear();
+    cache->setBudget(2 * bytes);
+
+    const auto id = VolumeBrickCache::newVolumeId();
+    size_t loads = 0;
+    auto loader = [&]() -> std::shared_ptr<const VolumeRAM> {
+        ++loads;
+        return std::make_shared<VolumeRAMPrecision<unsigned char>>(dims);
+    };
+
+    cache->get(id, 0, loader);
+    cache->get(id, 1, loader);
+    cache->get(id, 0, loader);  // hit, brick 1 is now the least recently used
+    EXPECT_EQ(2, loads);
+    cache->get(id, 2, loader);  // evicts brick 1
+    EXPECT_EQ(3, loads);
+    EXPECT_EQ(2 * bytes, cache->getSize());
+    cache->get(id, 0, loader);
+    EXPECT_EQ(3, loads);
+    cache->get(id, 1, loader);
+    EXPECT_EQ(4, loads);
+
+    cache->clear(id);
+    EXPECT_EQ(0, cache->getSize());
+    cache->setBudget(budget);
+}
+
+TEST(VolumeBricked, BrickLayout) {
+    const size3_t dims{10, 9, 7};
+    VolumeBricked bricked(IndexVolumeLoader{dims}, dims, DataUInt16::get(), size3_t(4), 1);
+
+    EXPECT_EQ(size3_t(3, 3, 2), bricked.getBrickCount());
+    EXPECT_EQ(size3_t(1, 2, 0), bricked.getBrickIndex(size3_t(7, 8, 3)));
+    EXPECT_EQ(size3_t(0, 0, 0), bricked.getBrickDataOffset(size3_t(0, 0, 0)));
+    EXPECT_EQ(size3_t(5, 5, 5), bricked.getBrickDataDimensions(size3_t(0, 0, 0)));
+    EXPECT_EQ(size3_t(3, 3, 3), bricked.getBrickDataOffset(size3_t(1, 1, 1)));
+    EXPECT_EQ(size3_t(6, 6, 4), bricked.getBrickDataDimensions(size3_t(1, 1, 1)));
+    EXPECT_EQ(size3_t(7, 7, 0), bricked.getBrickDataOffset(size3_t(2, 2, 0)));
+    EXPECT_EQ(size3_t(3, 2, 5), bricked.getBrickDataDimensions(size3_t(2, 2, 0)));
+}
+
+TEST(VolumeBricked, DefaultGhostBorderCanBeSampled) {
+    const size3_t dims{10, 9, 7};
+    VolumeBricked bricked(IndexVolumeLoader{dims}, dims, DataUInt16::get());
+
+    EXPECT_EQ(1, bricked.getGhostBorder());
+    EXPECT_NO_THROW(detail::createVolumeSamplerKernel<1>(bricked));
+}
+
+TEST(VolumeBricked, ReadRegionAcrossBricks) {
+    const size3_t dims{10, 9, 7};
+    VolumeBricked bricked(IndexVolumeLoader{dims}, dims, DataUInt16::get(), size3_t(4), 1);
+
+    const size3_t offset{1, 2, 3};
+    const size3_t regionDims{8, 6, 4};
+    auto region = bricked.getRegion(offset, regionDims);
+    ASSERT_EQ(regionDims, region->getDimensions());
+
+    util::IndexMapper3D vm(dims);
+    util::IndexMapper3D rm(regionDims);
+    auto data = static_cast<const unsigned short*>(region->getData());
+    for (size_t z = 0; z < regionDims.z; ++z) {
+        for (size_t y = 0; y < regionDims.y; ++y) {
+            for (size_t x = 0; x < regionDims.x; ++x) {
+                EXPECT_EQ(vm(offset + size3_t(x, y, z)), data[rm(x, y, z)]);
+            }
+        }
+    }
+
+    EXPECT_THROW(bricked.getRegion(size3_t(5), size3_t(6)), Exception);
+}
+
+TEST(VolumeBricked, BricksAreCached) {
+    const size3_t dims{8, 8, 8};
+    IndexVolumeLoader loader{dims};
+    VolumeBricked bricked(loader, dims, DataUInt16::get(), size3_t(4), 0);
+
+    bricked.getRegion(size3_t(0), dims);
+    const auto reads = loader.reads();
+    EXPECT_EQ(8, reads);
+    bricked.getRegion(size3_t(2), size3_t(4));
+    EXPECT_EQ(reads, loader.reads());
+}
+
+TEST(VolumeBricked, SamplerUsesBricksOnlyOverBudget) {
+    const size3_t dims{70, 6, 5};
+    IndexVolumeLoader loader{dims};
+    const auto makeVolume = [&]() {
+        auto disk = std::make_shared<VolumeDisk>(dims, DataUInt16::get());
+        disk->setLoader(loader.clone());
+        return std::make_shared<Volume>(disk);
+    };
+    Volume reference(std::static_pointer_cast<VolumeRAM>(loader.createRepresentation()));
+    const VolumeDoubleSampler<1> referenceSampler(reference);
+
+    auto manager = RepresentationMemoryManager::getPtr();
+    const auto budget = manager->getBudget();
+    util::OnScopeExit restore([&]() { manager->setBudget(budget); });
+
+    manager->setBudget(glm::compMul(dims) * DataUInt16::get()->getSize() - 1);
+    auto bricked = makeVolume();
+    const VolumeDoubleSampler<1> sampler(bricked);
+    EXPECT_FALSE(bricked->hasRepresentation<VolumeRAM>());
+    EXPECT_TRUE(bricked->hasRepresentation<VolumeBricked>());
+
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    const auto reads = loader.reads();
+    for (size_t i = 0; i < 1000; ++i) {
+        const dvec3 pos{dist(gen), dist(gen), dist(gen)};
+        EXPECT_NEAR(referenceSampler.sample(pos), sampler.sample(pos), 1e-9) << "at " << pos;
+    }
+    EXPECT_EQ(reads + 2, loader.reads());
+    EXPECT_FALSE(bricked->hasRepresentation<VolumeRAM>());
+
+    manager->setBudget(budget);
+    auto inRAM = makeVolume();
+    const VolumeDoubleSampler<1> ramSampler(inRAM);
+    EXPECT_TRUE(inRAM->hasRepresentation<VolumeRAM>());
+    EXPECT_FALSE(inRAM->hasRepresentation<VolumeBricked>());
+}
+
+TEST(VolumeBricked, BrickedRepresentationOnlyOverBudget) {
+    const size3_t dims{8, 8, 8};
+    IndexVolumeLoader loader{dims};
+    const auto makeVolume = [&]() {
+        auto disk = std::make_shared<VolumeDisk>(dims, DataUInt16::get());
+        disk->setLoader(loader.clone());
+        return std::make_shared<Volume>(disk);
+    };
+
+    auto manager = RepresentationMemoryManager::getPtr();
+    const auto budget = manager->getBudget();
+    util::OnScopeExit restore([&]() { manager->setBudget(budget); });
+    const size_t bytes = glm::compMul(dims) * DataUInt16::get()->getSize();
+
+    manager->setBudget(bytes);
+    auto fits = makeVolume();
+    EXPECT_EQ(nullptr, util::getBrickedRepresentationOverBudget(*fits));
+    EXPECT_FALSE(fits->hasRepresentation<VolumeBricked>());
+
+    manager->setBudget(bytes - 1);
+    auto overBudget = makeVolume();
+    EXPECT_NE(nullptr, util::getBrickedRepresentationOverBudget(*overBudget));
+    EXPECT_FALSE(overBudget->hasRepresentation<VolumeRAM>());
+}
+
+TEST(VolumeBricked, BrickedSamplerMatchesRAMSampler) {
+    const size3_t dims{70, 9, 66};
+    IndexVolumeLoader loader{dims};
+    const VolumeBricked bricked(loader, dims, DataUInt16::get(), size3_t(16), 1);
+    const auto ram = std::static_pointer_cast<VolumeRAM>(loader.createRepresentation());
+
+    const auto brickedKernel = detail::createVolumeSamplerKernel<4>(bricked);
+    const auto ramKernel = detail::createVolumeSamplerKernel<4>(*ram);
+
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<double> dist(-0.05, 1.05);
+    std::vector<dvec3> positions{dvec3(0.0), dvec3(1.0), dvec3(1.0, 0.5, 0.0)};
+    for (size_t i = 0; i < 1000; ++i) positions.emplace_back(dist(gen), dist(gen), dist(gen));
+
+    std::vector<dvec4> fromBricks(positions.size());
+    std::vector<dvec4> fromRAM(positions.size());
+    brickedKernel->sample(positions.data(), positions.size(), fromBricks.data());
+    ramKernel->sample(positions.data(), positions.size(), fromRAM.data());
+    for (size_t i = 0; i < positions.size(); ++i) {
+        EXPECT_EQ(fromRAM[i], fromBricks[i]) << "at " << positions[i];
+        EXPECT_EQ(fromRAM[i], brickedKernel->sample(positions[i])) << "at " << positions[i];
+    }
+}
+
+}  // namespace inviwo
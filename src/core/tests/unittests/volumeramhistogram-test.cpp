@@ -0,0 +1,113 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumeramhistogram.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/poolutils.h>
+
+#include <vector>
+#include <random>
+
+namespace inviwo {
+
+TEST(VolumeRAMHistogram, MatchesSerialCount) {
+    const size3_t dims{128, 96, 64};
+    const size_t bins = 100;
+    std::vector<float> data(dims.x * dims.y * dims.z);
+    std::mt19937 rand(0);
+    std::uniform_real_distribution<float> dist(-0.5f, 1.5f);
+    for (auto& v : data) v = dist(rand);
+
+    std::vector<double> expected(bins, 0.0);
+    double sum = 0.0;
+    for (auto v : data) {
+        sum += v;
+        const auto bin = static_cast<double>(v) * (bins - 1);
+        if (bin > -1.0 && bin < bins) expected[static_cast<size_t>(bin)]++;
+    }
+    const double maxCount = *std::max_element(expected.begin(), expected.end());
+
+    // Without workers the volume is one range, with workers it is split into several
+    const bool stop = false;
+    const auto histograms = util::serialAndParallel([&]() {
+        return util::calculateVolumeHistogram(data.data(), dims, dvec2(0.0, 1.0), stop, bins);
+    });
+    for (const auto* result : {&histograms.first, &histograms.second}) {
+        ASSERT_EQ(1, result->size());
+        const auto& hist = (*result)[0];
+        EXPECT_TRUE(hist.isValid());
+        EXPECT_DOUBLE_EQ(*std::min_element(data.begin(), data.end()), hist.stats_.min);
+        EXPECT_DOUBLE_EQ(*std::max_element(data.begin(), data.end()), hist.stats_.max);
+        EXPECT_NEAR(sum / data.size(), hist.stats_.mean, 1e-9);
+        for (size_t i = 0; i < bins; ++i) {
+            EXPECT_DOUBLE_EQ(expected[i] / maxCount, hist[i]);
+        }
+    }
+}
+
+TEST(VolumeRAMHistogram, ProgressiveAndStop) {
+    const size3_t dims{256, 256, 16};
+    std::vector<unsigned char> data(dims.x * dims.y * dims.z);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<unsigned char>(i);
+
+    bool stop = false;
+    size_t calls = 0;
+    auto histograms = util::calculateVolumeHistogram(
+        data.data(), dims, dvec2(0.0, 255.0), stop, 256, size3_t(1),
+        [&](const HistogramContainer& coarse) {
+            ++calls;
+            EXPECT_TRUE(coarse.isValid());
+            stop = true;
+        });
+    EXPECT_EQ(1, calls);
+    EXPECT_TRUE(histograms.empty());
+}
+
+TEST(VolumeRAMHistogram, StoppedCalculationIsNotStored) {
+    const size3_t dims{256, 256, 16};
+    auto ram = std::make_shared<VolumeRAMPrecision<unsigned char>>(dims);
+    Volume volume(ram);
+
+    bool stop = false;
+    ram->calculateHistograms(256, size3_t(1), stop,
+                             [&](const HistogramContainer&) { stop = true; });
+    EXPECT_FALSE(ram->hasHistograms());
+
+    stop = false;
+    ram->calculateHistograms(256, size3_t(1), stop);
+    EXPECT_TRUE(ram->hasHistograms());
+}
+
+}  // namespace inviwo
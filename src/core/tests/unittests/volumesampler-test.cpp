@@ -0,0 +1,123 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * 
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/util/volumesampler.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+
+#include <random>
+
+namespace inviwo {
+
+namespace {
+
+template <typename T>
+std::shared_ptr<VolumeRAMPrecision<T>> randomVolumeRAM(const size3_t& dims) {
+    auto ram = std::make_shared<VolumeRAMPrecision<T>>(dims);
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<int> dist(0, 100);
+    auto data = ram->getDataTyped();
+    for (size_t i = 0; i < glm::compMul(dims); ++i) {
+        data[i] = util::glm_convert<T>(dvec4(dist(gen), dist(gen), dist(gen), dist(gen)));
+    }
+    return ram;
+}
+
+std::vector<dvec3> randomPositions(size_t count) {
+    std::mt19937 gen(1);
+    // Include positions outside of the volume
+    std::uniform_real_distribution<double> dist(-0.1, 1.1);
+    std::vector<dvec3> positions{dvec3(0.0), dvec3(1.0), dvec3(1.0, 0.5, 0.0)};
+    for (size_t i = 0; i < count; ++i) positions.emplace_back(dist(gen), dist(gen), dist(gen));
+    return positions;
+}
+
+// Reference implementation reading the corners through the virtual VolumeRAM interface
+dvec4 referenceSample(const VolumeRAM& ram, const dvec3& pos) {
+    if (glm::any(glm::lessThan(pos, dvec3(0.0))) || glm::any(glm::greaterThan(pos, dvec3(1.0)))) {
+        return dvec4(0.0);
+    }
+    const auto dims = ram.getDimensions();
+    const dvec3 samplePos = pos * dvec3(dims - size3_t(1));
+    const size3_t indexPos = size3_t(samplePos);
+    const auto voxel = [&](const size3_t& offset) {
+        return ram.getAsDVec4(glm::clamp(indexPos + offset, size3_t(0), dims - size3_t(1)));
+    };
+    const dvec4 samples[8] = {voxel({0, 0, 0}), voxel({1, 0, 0}), voxel({0, 1, 0}),
+                              voxel({1, 1, 0}), voxel({0, 0, 1}), voxel({1, 0, 1}),
+                              voxel({0, 1, 1}), voxel({1, 1, 1})};
+    return Interpolation<dvec4>::trilinear(samples, samplePos - dvec3(indexPos));
+}
+
+template <typename T>
+void testVolumeDoubleSampler() {
+    auto ram = randomVolumeRAM<T>(size3_t(7, 5, 6));
+    Volume volume(ram);
+    VolumeDoubleSampler<4> sampler(volume);
+
+    const auto positions = randomPositions(500);
+    const auto batch = sampler.sample(positions);
+    ASSERT_EQ(positions.size(), batch.size());
+    for (size_t i = 0; i < positions.size(); ++i) {
+        const auto expected = referenceSample(*ram, positions[i]);
+        EXPECT_EQ(expected, sampler.sample(positions[i])) << "at " << positions[i];
+        EXPECT_EQ(expected, batch[i]) << "at " << positions[i];
+    }
+}
+
+}  // namespace
+
+TEST(VolumeSampler, TypedMatchesVolumeRAM) {
+    testVolumeDoubleSampler<unsigned char>();
+    testVolumeDoubleSampler<float>();
+    testVolumeDoubleSampler<glm::u16vec3>();
+    testVolumeDoubleSampler<dvec4>();
+}
+
+TEST(VolumeSampler, FloatPrecision) {
+    auto ram = randomVolumeRAM<glm::u8vec3>(size3_t(9, 4, 5));
+    const VolumeRAMSampler<glm::u8vec3, 3, double> doubleSampler(*ram);
+    const VolumeRAMSampler<glm::u8vec3, 3, float> floatSampler(*ram);
+
+    const auto positions = randomPositions(500);
+    std::vector<vec3> result(positions.size());
+    floatSampler.sample(positions.begin(), positions.end(), result.begin());
+    for (size_t i = 0; i < positions.size(); ++i) {
+        const auto expected = doubleSampler.sample(positions[i]);
+        EXPECT_NEAR(expected.x, result[i].x, 1e-3);
+        EXPECT_NEAR(expected.y, result[i].y, 1e-3);
+        EXPECT_NEAR(expected.z, result[i].z, 1e-3);
+    }
+}
+
+}  // namespace inviwo
@@ -63,6 +63,10 @@ CommandLineParser::CommandLineParser(int argc, char** argv)
     , workspace_("w", "workspace", "Specify workspace to open", false, "", "workspace file")
     , outputPath_("o", "output", "Specify output path", false, "", "output path")
     , logfile_("l", "logfile", "Write log messages to file.", false, "", "logfile")
+    , trace_("", "trace",
+             "Record a trace of the network evaluation and write it to file on exit. The file "
+             "uses the Chrome trace event format (chrome://tracing).",
+             false, "", "trace file")
     , logConsole_("c", "logconsole", "Write log messages to console (cout)", false)
     , noSplashScreen_("n", "nosplash", "Pass this flag if you do not want to show a splash screen.")
     , quitAfterStartup_("q", "quit", "Pass this flag if you want to close inviwo after startup.")
@@ -76,6 +80,7 @@ CommandLineParser::CommandLineParser(int argc, char** argv)
     cmdQuiet_.add(quitAfterStartup_);
     cmdQuiet_.add(noSplashScreen_);
     cmdQuiet_.add(logfile_);
+    cmdQuiet_.add(trace_);
     cmdQuiet_.add(logConsole_);
     cmdQuiet_.add(helpQuiet_);
     cmdQuiet_.add(versionQuiet_);
@@ -87,6 +92,7 @@ CommandLineParser::CommandLineParser(int argc, char** argv)
     cmd_.add(quitAfterStartup_);
     cmd_.add(noSplashScreen_);
     cmd_.add(logfile_);
+    cmd_.add(trace_);
     cmd_.add(logConsole_);
     cmd_.add(disableResourceManager_);
 
@@ -150,6 +156,13 @@ const std::string CommandLineParser::getLogToFileFileName() const {
         return "";
 }
 
+const std::string CommandLineParser::getTraceFileName() const {
+    if (trace_.isSet())
+        return (trace_.getValue());
+    else
+        return "";
+}
+
 bool CommandLineParser::getQuitApplicationAfterStartup() const {
     return quitAfterStartup_.getValue();
 }
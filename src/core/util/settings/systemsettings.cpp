@@ -39,6 +39,7 @@ SystemSettings::SystemSettings(InviwoApplication* app)
                              {"developerMode", "Developer Mode", UsageMode::Development}},
                             1)
     , poolSize_("poolSize", "Pool Size", defaultPoolSize(), 0, 32)
+    , concurrentEvaluation_("concurrentEvaluation", "Concurrent Network Evaluation", false)
     , enablePortInspectors_("enablePortInspectors", "Enable port inspectors", true)
     , portInspectorSize_("portInspectorSize", "Port inspector size", 128, 1, 1024)
 #if __APPLE__
@@ -52,10 +53,15 @@ SystemSettings::SystemSettings(InviwoApplication* app)
     , followObjectDuringRotation_("followObjectDuringRotation",
                                   "Follow Object During Camera Rotation", false)
     , runtimeModuleReloading_("runtimeModuleReloding", "Runtime Module Reloading", false)
-    , enableResourceManager_("enableResourceManager", "Enable Resource Manager", false) {
+    , enableResourceManager_("enableResourceManager", "Enable Resource Manager", false)
+    , brickCacheSize_("brickCacheSize", "Volume Brick Cache Size (MB)", 1024, 0, 65536)
+    , representationMemoryBudget_("representationMemoryBudget", "Representation Memory Budget (MB)",
+                                  8192, 0, 1048576)
+    , representationMemoryUsage_("representationMemoryUsage", "Representation Memory Usage", "") {
 
     addProperty(applicationUsageMode_);
     addProperty(poolSize_);
+    addProperty(concurrentEvaluation_);
     addProperty(enablePortInspectors_);
     addProperty(portInspectorSize_);
     addProperty(enableTouchProperty_);
@@ -65,6 +71,11 @@ SystemSettings::SystemSettings(InviwoApplication* app)
     addProperty(followObjectDuringRotation_);
     addProperty(runtimeModuleReloading_);
     addProperty(enableResourceManager_);
+    addProperty(brickCacheSize_);
+    addProperty(representationMemoryBudget_);
+    addProperty(representationMemoryUsage_);
+    representationMemoryUsage_.setReadOnly(true);
+    representationMemoryUsage_.setSerializationMode(PropertySerializationMode::None);
 
     logStackTraceProperty_.onChange(
         [this]() { LogCentral::getPtr()->setLogStacktrace(logStackTraceProperty_.get()); });
@@ -33,6 +33,7 @@
 #include <inviwo/core/util/stringconversion.h>
 #include <inviwo/core/util/assertion.h>
 #include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/datastructures/sharedstorage.h>
 #ifdef IVW_SIGAR
 #include <sigar/include/sigar.h>
 #endif
@@ -311,6 +312,12 @@ void SystemCapabilities::printInfo() {
     } else {
         LogInfoCustom("SystemInfo", "Processor Memory: Info could not be retrieved");
     }
+
+    const auto dataMemory = util::getSharedStorageMemory();
+    LogInfoCustom("SystemInfo", "Volume and Layer RAM: Logical - "
+                                    << util::formatBytesToString(dataMemory.logicalBytes)
+                                    << ", Physical - "
+                                    << util::formatBytesToString(dataMemory.physicalBytes));
 }
 
 int SystemCapabilities::numberOfCores() const {
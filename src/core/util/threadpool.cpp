@@ -30,21 +30,62 @@
 #include <inviwo/core/util/threadpool.h>
 #include <inviwo/core/util/raiiutils.h>
 #include <inviwo/core/util/stdextensions.h>
+#include <inviwo/core/util/trace.h>
 
 namespace inviwo {
 
+namespace {
+// The pool and worker of the calling thread, if it is a worker thread.
+thread_local const void* currentPool = nullptr;
+thread_local void* currentWorker = nullptr;
+
+constexpr std::array<ThreadPool::Priority, 3> priorities = {
+    {ThreadPool::Priority::High, ThreadPool::Priority::Normal, ThreadPool::Priority::Low}};
+}  // namespace
+
+void ThreadPool::Queue::push(Task&& task, Priority priority) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    tasks_[static_cast<size_t>(priority)].push_back(std::move(task));
+}
+
+bool ThreadPool::Queue::popNewest(Task& task, Priority priority) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto& tasks = tasks_[static_cast<size_t>(priority)];
+    if (tasks.empty()) return false;
+    task = std::move(tasks.back());
+    tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::Queue::popOldest(Task& task, Priority priority) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto& tasks = tasks_[static_cast<size_t>(priority)];
+    if (tasks.empty()) return false;
+    task = std::move(tasks.front());
+    tasks.pop_front();
+    return true;
+}
+
 // the constructor just launches some amount of workers
 ThreadPool::ThreadPool(size_t threads, std::function<void()> onThreadStart,
                        std::function<void()> onThreadStop)
-    : onThreadStart_{std::move(onThreadStart)}, onThreadStop_{std::move(onThreadStop)} {
-    while (workers.size() < threads) {
-        workers.push_back(util::make_unique<Worker>(*this));
-    }
+    : size_{0}
+    , pending_{0}
+    , tasks_{0}
+    , sleeping_{0}
+    , waiting_{0}
+    , onThreadStart_{std::move(onThreadStart)}
+    , onThreadStop_{std::move(onThreadStop)} {
+    trySetSize(threads);
 }
 
 size_t ThreadPool::trySetSize(size_t size) {
-    while (workers.size() < size) {
-        workers.push_back(util::make_unique<Worker>(*this));
+    {
+        std::unique_lock<std::mutex> lock(workersMutex_);
+        while (workers.size() < size) {
+            workers.push_back(util::make_unique<Worker>(*this));
+        }
+        size_ = workers.size();
     }
 
     if (workers.size() > size) {
@@ -59,21 +100,111 @@ size_t ThreadPool::trySetSize(size_t size) {
             if (active <= size) break;
         }
 
-        condition.notify_all();
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            condition.notify_all();
+        }
 
-        util::erase_remove_if(workers, [this](std::unique_ptr<Worker>& worker) {
-            return worker->state == State::Done;
-        });
+        // Move the finished workers out of the list before joining them, other workers might be
+        // waiting for the list to steal tasks.
+        std::vector<std::unique_ptr<Worker>> done;
+        {
+            std::unique_lock<std::mutex> lock(workersMutex_);
+            for (auto& worker : workers) {
+                if (worker->state == State::Done) done.push_back(std::move(worker));
+            }
+            util::erase_remove_if(workers,
+                                  [](std::unique_ptr<Worker>& worker) { return !worker; });
+            size_ = workers.size();
+        }
     }
     return workers.size();
 }
 
-size_t ThreadPool::getSize() const { return workers.size(); }
+size_t ThreadPool::getSize() const { return size_; }
+
+size_t ThreadPool::getNumberOfTasks() const { return tasks_; }
+
+bool ThreadPool::isWorkerThread() const { return currentPool == this; }
 
 ThreadPool::~ThreadPool() {
     for (auto& worker : workers) worker->state = State::Abort;
-    condition.notify_all();
-    workers.clear(); // this will join all threads.
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        condition.notify_all();
+    }
+    std::vector<std::unique_ptr<Worker>> done;
+    {
+        std::unique_lock<std::mutex> lock(workersMutex_);
+        std::swap(done, workers);
+        size_ = 0;
+    }
+    done.clear(); // this will join all threads.
+}
+
+void ThreadPool::push(Task&& task, Priority priority) {
+    if (currentPool == this) {
+        static_cast<Worker*>(currentWorker)->queue.push(std::move(task), priority);
+    } else {
+        queue_.push(std::move(task), priority);
+    }
+    ++tasks_;
+    ++pending_;
+
+    // Only take the lock if there are workers that might be waiting for tasks, the order of
+    // pending_ and sleeping_ guarantees that no wake up is lost.
+    if (sleeping_ > 0) {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        condition.notify_one();
+    }
+    notifyWaiters();
+}
+
+void ThreadPool::notifyWaiters() {
+    // Either the waiter sees the finished or queued task, or the waiter is counted here. Taking
+    // the lock ensures that a counted waiter is already waiting on the condition.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiting_ > 0) {
+        std::unique_lock<std::mutex> lock(waitMutex_);
+        waitCondition_.notify_all();
+    }
+}
+
+bool ThreadPool::pop(Worker* self, Task& task) {
+    if (pending_ == 0) return false;
+
+    for (auto priority : priorities) {
+        if ((self && self->queue.popNewest(task, priority)) ||
+            queue_.popOldest(task, priority)) {
+            --pending_;
+            return true;
+        }
+        // Try to steal the oldest task of another worker
+        std::unique_lock<std::mutex> lock(workersMutex_);
+        for (auto& worker : workers) {
+            if (worker.get() != self && worker->queue.popOldest(task, priority)) {
+                --pending_;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::runPendingTask() {
+    if (currentPool != this) return false;
+    Task task;
+    if (pop(static_cast<Worker*>(currentWorker), task)) {
+        {
+            IVW_TRACE_SCOPE("threadpool", "Task");
+            task();
+            task = Task{};
+        }
+        --tasks_;
+        notifyWaiters();
+        return true;
+    }
+    return false;
 }
 
 ThreadPool::Worker::~Worker() { thread.join(); }
@@ -81,23 +212,42 @@ ThreadPool::Worker::~Worker() { thread.join(); }
 ThreadPool::Worker::Worker(ThreadPool& pool)
     : state{ State::Free }
     , thread{ [this, &pool]() {
+        currentPool = &pool;
+        currentWorker = this;
+        trace::Tracer::setThreadName("Pool Worker");
         pool.onThreadStart_();
-        util::OnScopeExit cleanup{[&pool]() { pool.onThreadStop_(); }};
+        util::OnScopeExit cleanup{[&pool]() {
+            pool.onThreadStop_();
+            currentPool = nullptr;
+            currentWorker = nullptr;
+        }};
 
-        std::function<void()> task;
+        Task task;
         for (;;) {
-            state = State::Free;
-            {
-                std::unique_lock<std::mutex> lock(pool.queue_mutex);
-                pool.condition.wait(lock, [this, &pool] {
-                    return state == State::Abort || state == State::Stop || !pool.tasks.empty();
-                });
-                if (state == State::Abort || (state == State::Stop && pool.tasks.empty())) break;
-                task = std::move(pool.tasks.front());
-                pool.tasks.pop();
+            if (state == State::Abort) break;
+            if (pool.pop(this, task)) {
+                auto expected = State::Free;
+                state.compare_exchange_strong(expected, State::Working);
+                {
+                    IVW_TRACE_SCOPE("threadpool", "Task");
+                    task();
+                    task = Task{};
+                }
+                --pool.tasks_;
+                pool.notifyWaiters();
+                expected = State::Working;
+                state.compare_exchange_strong(expected, State::Free);
+                continue;
             }
-            state = State::Working;
-            task();
+            // Stop once there are no more tasks to do.
+            if (state == State::Stop) break;
+
+            std::unique_lock<std::mutex> lock(pool.queue_mutex);
+            ++pool.sleeping_;
+            pool.condition.wait(lock, [this, &pool] {
+                return state == State::Abort || state == State::Stop || pool.pending_ > 0;
+            });
+            --pool.sleeping_;
         }
         state = State::Done;
 
@@ -0,0 +1,292 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2018 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/util/trace.h>
+#include <inviwo/core/util/exception.h>
+#include <inviwo/core/util/filesystem.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+
+namespace inviwo {
+
+namespace trace {
+
+constexpr size_t Event::maxNameLength;
+
+std::atomic<bool> Tracer::enabled_{false};
+
+namespace {
+
+std::int64_t toNanoseconds(clock::duration d) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+}
+
+/**
+ * Ring buffer of one thread. Only the owning thread writes to it, and flags each write in writing
+ * such that readers can wait for it to finish, see PauseWriters.
+ */
+struct ThreadBuffer {
+    ThreadBuffer(std::uint32_t id, std::string name, size_t size)
+        : id{id}, name{std::move(name)}, events(std::max(size, size_t{1})) {}
+
+    const std::uint32_t id;
+    std::string name;  //< Guarded by the registry mutex
+    std::vector<Event> events;
+    std::atomic<size_t> head{0};
+    std::atomic<bool> writing{false};
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::atomic<size_t> generation{0};
+    std::atomic<bool> paused{false};
+    size_t eventsPerThread = 0;
+    std::int64_t startTime = 0;
+};
+
+Registry& registry() {
+    static Registry registry;
+    return registry;
+}
+
+std::atomic<std::uint32_t> threadCounter{0};
+
+struct ThreadState {
+    std::uint32_t id = threadCounter++;
+    std::string name;
+    std::shared_ptr<ThreadBuffer> buffer;
+    size_t generation = 0;
+};
+thread_local ThreadState threadState;
+
+ThreadBuffer& localBuffer() {
+    auto& reg = registry();
+    if (!threadState.buffer || threadState.generation != reg.generation) {
+        std::unique_lock<std::mutex> lock(reg.mutex);
+        threadState.buffer = std::make_shared<ThreadBuffer>(threadState.id, threadState.name,
+                                                            reg.eventsPerThread);
+        threadState.generation = reg.generation;
+        reg.buffers.push_back(threadState.buffer);
+    }
+    return *threadState.buffer;
+}
+
+/**
+ * Keeps the writers out of the buffers while they are read or cleared, has to be used while
+ * holding the registry mutex. A writer sets its writing flag before checking paused, and the
+ * reader sets paused before checking the writing flags. Hence, either the writer sees paused and
+ * drops its event, or the reader waits for the write to finish.
+ */
+class PauseWriters {
+public:
+    PauseWriters(Registry& reg) : reg_{reg} {
+        reg_.paused = true;
+        for (auto& buffer : reg_.buffers) {
+            while (buffer->writing) std::this_thread::yield();
+        }
+    }
+    PauseWriters(const PauseWriters&) = delete;
+    PauseWriters& operator=(const PauseWriters&) = delete;
+    ~PauseWriters() { reg_.paused = false; }
+
+private:
+    Registry& reg_;
+};
+
+void writeJsonString(std::ostream& os, const char* str) {
+    os << '"';
+    for (auto c = str; *c != '\0'; ++c) {
+        switch (*c) {
+            case '"':
+                os << "\\\"";
+                break;
+            case '\\':
+                os << "\\\\";
+                break;
+            case '\n':
+                os << "\\n";
+                break;
+            case '\t':
+                os << "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(*c) < 0x20) {
+                    os << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                       << static_cast<int>(*c) << std::dec << std::setfill(' ');
+                } else {
+                    os << *c;
+                }
+        }
+    }
+    os << '"';
+}
+
+}  // namespace
+
+void Tracer::start(size_t eventsPerThread) {
+    auto& reg = registry();
+    std::unique_lock<std::mutex> lock(reg.mutex);
+    reg.buffers.clear();
+    reg.eventsPerThread = eventsPerThread;
+    reg.startTime = toNanoseconds(clock::now().time_since_epoch());
+    ++reg.generation;
+    enabled_ = true;
+}
+
+void Tracer::stop() { enabled_ = false; }
+
+void Tracer::clear() {
+    auto& reg = registry();
+    std::unique_lock<std::mutex> lock(reg.mutex);
+    PauseWriters pause(reg);
+    for (auto& buffer : reg.buffers) buffer->head = 0;
+    reg.startTime = toNanoseconds(clock::now().time_since_epoch());
+}
+
+void Tracer::record(const char* category, const char* name, clock::time_point begin,
+                    clock::time_point end) {
+    if (!isEnabled()) return;
+    auto& buffer = localBuffer();
+    buffer.writing = true;
+    if (registry().paused) {
+        buffer.writing.store(false, std::memory_order_release);
+        return;
+    }
+    const auto head = buffer.head.load(std::memory_order_relaxed);
+    auto& event = buffer.events[head % buffer.events.size()];
+    event.category = category;
+    auto length = std::min(std::strlen(name), Event::maxNameLength);
+    // Do not split a multi-byte UTF-8 character, back off to the start of a character
+    while (length > 0 && (static_cast<unsigned char>(name[length]) & 0xC0) == 0x80) --length;
+    std::memcpy(event.name.data(), name, length);
+    event.name[length] = '\0';
+    event.begin = toNanoseconds(begin.time_since_epoch());
+    event.duration = toNanoseconds(end - begin);
+    event.thread = buffer.id;
+    buffer.head.store(head + 1, std::memory_order_relaxed);
+    buffer.writing.store(false, std::memory_order_release);
+}
+
+void Tracer::record(const char* category, const std::string& name, clock::time_point begin,
+                    clock::time_point end) {
+    record(category, name.c_str(), begin, end);
+}
+
+void Tracer::setThreadName(const std::string& name) {
+    threadState.name = name;
+    if (threadState.buffer) {
+        std::unique_lock<std::mutex> lock(registry().mutex);
+        threadState.buffer->name = name;
+    }
+}
+
+std::vector<Event> Tracer::getEvents() {
+    auto& reg = registry();
+    std::vector<Event> events;
+    {
+        std::unique_lock<std::mutex> lock(reg.mutex);
+        PauseWriters pause(reg);
+        for (auto& buffer : reg.buffers) {
+            const auto head = buffer->head.load(std::memory_order_relaxed);
+            const auto size = buffer->events.size();
+            for (auto i = head - std::min(head, size); i < head; ++i) {
+                events.push_back(buffer->events[i % size]);
+                events.back().begin -= reg.startTime;
+            }
+        }
+    }
+    std::stable_sort(events.begin(), events.end(),
+                     [](const Event& a, const Event& b) { return a.begin < b.begin; });
+    return events;
+}
+
+void Tracer::writeChromeTrace(std::ostream& os) {
+    std::vector<std::pair<std::uint32_t, std::string>> threads;
+    {
+        auto& reg = registry();
+        std::unique_lock<std::mutex> lock(reg.mutex);
+        for (auto& buffer : reg.buffers) {
+            if (!buffer->name.empty()) threads.emplace_back(buffer->id, buffer->name);
+        }
+    }
+    const auto events = getEvents();
+
+    const auto flags = os.flags();
+    const auto precision = os.precision();
+    os << std::fixed << std::setprecision(3);
+
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    auto separator = [&]() {
+        if (!first) os << ",";
+        os << "\n";
+        first = false;
+    };
+    for (auto& thread : threads) {
+        separator();
+        os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread.first
+           << ",\"args\":{\"name\":";
+        writeJsonString(os, thread.second.c_str());
+        os << "}}";
+    }
+    for (auto& event : events) {
+        separator();
+        os << "{\"name\":";
+        writeJsonString(os, event.name.data());
+        os << ",\"cat\":";
+        writeJsonString(os, event.category);
+        os << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread
+           << ",\"ts\":" << static_cast<double>(event.begin) / 1000.0
+           << ",\"dur\":" << static_cast<double>(event.duration) / 1000.0 << "}";
+    }
+    os << "\n]}\n";
+
+    os.flags(flags);
+    os.precision(precision);
+}
+
+void Tracer::writeChromeTrace(const std::string& filename) {
+    auto file = filesystem::ofstream(filename);
+    if (!file) {
+        throw FileException("Could not open file \"" + filename + "\" for writing",
+                            IvwContextCustom("Tracer"));
+    }
+    writeChromeTrace(file);
+}
+
+}  // namespace trace
+
+}  // namespace inviwo
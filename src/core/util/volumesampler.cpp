@@ -28,31 +28,151 @@
  *********************************************************************************/
 
 #include <inviwo/core/util/volumesampler.h>
+#include <inviwo/core/util/formatdispatching.h>
+
+#include <limits>
 
 namespace inviwo {
 
-template <>
-Vector<1, double> VolumeDoubleSampler<1>::getVoxel(const size3_t &pos) const {
-    auto p = glm::clamp(pos, size3_t(0), dims_ - size3_t(1));
-    return ram_->getAsDouble(p);
+namespace detail {
+
+namespace {
+
+struct BrickData {
+    const VolumeRAM *ram;
+    size3_t offset;
+};
+
+/**
+ * Get the brick of bricked containing the voxel pos. The last brick used is remembered per
+ * thread, such that consecutive samples within the same brick do not have to lock the
+ * VolumeBrickCache. The returned data is valid until the next call from the same thread.
+ */
+BrickData getBrick(const VolumeBricked &bricked, const size3_t &pos) {
+    struct LastBrick {
+        size_t cacheId = std::numeric_limits<size_t>::max();
+        size3_t index{0};
+        size3_t offset{0};
+        std::shared_ptr<const VolumeRAM> ram;
+    };
+    thread_local LastBrick last;
+
+    const auto index = bricked.getBrickIndex(pos);
+    if (!last.ram || last.cacheId != bricked.getCacheId() || last.index != index) {
+        last.ram = bricked.getBrick(index);
+        last.cacheId = bricked.getCacheId();
+        last.index = index;
+        last.offset = bricked.getBrickDataOffset(index);
+    }
+    return {last.ram.get(), last.offset};
 }
 
-template <>
-Vector<2, double> VolumeDoubleSampler<2>::getVoxel(const size3_t &pos) const {
-    auto p = glm::clamp(pos, size3_t(0), dims_ - size3_t(1));
-    return ram_->getAsDVec2(p);
+template <typename T, unsigned int DataDims>
+class BrickedVolumeSamplerKernel : public VolumeSamplerKernel<DataDims> {
+public:
+    using Result = Vector<DataDims, double>;
+
+    BrickedVolumeSamplerKernel(const VolumeBricked &bricked)
+        : bricked_(bricked), dims_(bricked.getDimensions()) {}
+
+    virtual Result sample(const dvec3 &pos) const override {
+        if (glm::any(glm::lessThan(pos, dvec3(0.0))) ||
+            glm::any(glm::greaterThan(pos, dvec3(1.0)))) {
+            return Result(0.0);
+        }
+
+        const dvec3 samplePos = pos * dvec3(dims_ - size3_t(1));
+        const size3_t lower = glm::min(size3_t(samplePos), dims_ - size3_t(1));
+        const size3_t upper = glm::min(lower + size3_t(1), dims_ - size3_t(1));
+        const dvec3 interpolants = samplePos - dvec3(lower);
+
+        // The ghost border makes the brick containing lower also contain upper
+        const auto brick = getBrick(bricked_, lower);
+        const auto data = static_cast<const T *>(brick.ram->getData());
+        const auto brickDims = brick.ram->getDimensions();
+        const size3_t l = lower - brick.offset;
+        const size3_t u = upper - brick.offset;
+
+        const size_t x0 = l.x;
+        const size_t x1 = u.x;
+        const size_t y0 = l.y * brickDims.x;
+        const size_t y1 = u.y * brickDims.x;
+        const size_t z0 = l.z * brickDims.x * brickDims.y;
+        const size_t z1 = u.z * brickDims.x * brickDims.y;
+
+        const auto voxel = [&](size_t index) { return util::glm_convert<Result>(data[index]); };
+        const Result samples[8] = {voxel(x0 + y0 + z0), voxel(x1 + y0 + z0), voxel(x0 + y1 + z0),
+                                   voxel(x1 + y1 + z0), voxel(x0 + y0 + z1), voxel(x1 + y0 + z1),
+                                   voxel(x0 + y1 + z1), voxel(x1 + y1 + z1)};
+        return Interpolation<Result>::trilinear(samples, interpolants);
+    }
+
+    virtual void sample(const dvec3 *pos, size_t count, Result *result) const override {
+        for (size_t i = 0; i < count; ++i) result[i] = sample(pos[i]);
+    }
+
+private:
+    VolumeBricked bricked_;
+    size3_t dims_;
+};
+
+template <unsigned int DataDims>
+struct BrickedKernelCreator {
+    template <typename Result, typename Format>
+    Result operator()(const VolumeBricked &bricked) {
+        return std::make_shared<BrickedVolumeSamplerKernel<typename Format::type, DataDims>>(
+            bricked);
+    }
+};
+
+}  // namespace
+
+template <unsigned int DataDims>
+std::shared_ptr<const VolumeSamplerKernel<DataDims>> createVolumeSamplerKernel(
+    const VolumeRAM &ram) {
+    return ram.dispatch<std::shared_ptr<const VolumeSamplerKernel<DataDims>>>(
+        [](auto vrprecision) -> std::shared_ptr<const VolumeSamplerKernel<DataDims>> {
+            using ValueType = util::PrecsionValueType<decltype(vrprecision)>;
+            return std::make_shared<TypedVolumeSamplerKernel<ValueType, DataDims>>(*vrprecision);
+        });
 }
 
-template <>
-Vector<3, double> VolumeDoubleSampler<3>::getVoxel(const size3_t &pos) const {
-    auto p = glm::clamp(pos, size3_t(0), dims_ - size3_t(1));
-    return ram_->getAsDVec3(p);
+template IVW_CORE_API std::shared_ptr<const VolumeSamplerKernel<1>> createVolumeSamplerKernel<1>(
+    const VolumeRAM &ram);
+template IVW_CORE_API std::shared_ptr<const VolumeSamplerKernel<2>> createVolumeSamplerKernel<2>(
+    const VolumeRAM &ram);
+template IVW_CORE_API std::shared_ptr<const VolumeSamplerKernel<3>> createVolumeSamplerKernel<3>(
+    const VolumeRAM &ram);
+template IVW_CORE_API std::shared_ptr<const VolumeSamplerKernel<4>> createVolumeSamplerKernel<4>(
+    const VolumeRAM &ram);
+
+template <unsigned int DataDims>
+std::shared_ptr<const VolumeSamplerKernel<DataDims>> createVolumeSamplerKernel(
+    const VolumeBricked &bricked) {
+    if (bricked.getGhostBorder() < 1) {
+        throw Exception("Sampling bricks requires a ghost border",
+                        IvwContextCustom("VolumeSampler"));
+    }
+    return dispatching::dispatch<std::shared_ptr<const VolumeSamplerKernel<DataDims>>,
+                                 dispatching::filter::All>(
+        bricked.getDataFormat()->getId(), BrickedKernelCreator<DataDims>{}, bricked);
 }
 
-template <>
-Vector<4, double> VolumeDoubleSampler<4>::getVoxel(const size3_t &pos) const {
-    auto p = glm::clamp(pos, size3_t(0), dims_ - size3_t(1));
-    return ram_->getAsDVec4(p);
+template IVW_CORE_API std::shared_ptr<const VolumeSamplerKernel<1>> createVolumeSamplerKernel<1>(
+    const VolumeBricked &bricked);
+template IVW_CORE_API std::shared_ptr<const VolumeSamplerKernel<2>> createVolumeSamplerKernel<2>(
+    const VolumeBricked &bricked);
+template IVW_CORE_API std::shared_ptr<const VolumeSamplerKernel<3>> createVolumeSamplerKernel<3>(
+    const VolumeBricked &bricked);
+template IVW_CORE_API std::shared_ptr<const VolumeSamplerKernel<4>> createVolumeSamplerKernel<4>(
+    const VolumeBricked &bricked);
+
+const VolumeBricked *getSamplingBricks(const Volume &vol) {
+    // The ghost border is needed to find all corners of a cell in the same brick
+    const auto bricked = util::getBrickedRepresentationOverBudget(vol);
+    return bricked && bricked->getGhostBorder() >= 1 ? bricked : nullptr;
 }
 
+}  // namespace detail
+
 }  // namespace inviwo
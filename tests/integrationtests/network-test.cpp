@@ -31,6 +31,14 @@
 #include <modules/base/processors/volumesource.h>
 #include <modules/base/processors/cubeproxygeometryprocessor.h>
 #include <modules/base/processors/volumeslice.h>
+#include <inviwo/core/properties/minmaxproperty.h>
+#include <inviwo/core/network/processornetworkevaluator.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/ports/volumeport.h>
+#include <inviwo/core/util/raiiutils.h>
+#include <modules/opengl/volume/volumegl.h>
+
+#include <thread>
 
 #include <warn/push>
 #include <warn/ignore/all>
@@ -131,4 +139,117 @@ TEST_F(NetworkTest, ProcessorGetProperty) {
     ASSERT_TRUE(prop != nullptr);
 }
 
-}
\ No newline at end of file
+TEST_F(NetworkTest, LinkChainUpdatesIncrementally) {
+    Processor* p = network.getProcessorByIdentifier("cubeProxyGeometry");
+    ASSERT_TRUE(p != nullptr);
+    auto x = dynamic_cast<IntMinMaxProperty*>(p->getPropertyByIdentifier("clipX"));
+    auto y = dynamic_cast<IntMinMaxProperty*>(p->getPropertyByIdentifier("clipY"));
+    auto z = dynamic_cast<IntMinMaxProperty*>(p->getPropertyByIdentifier("clipZ"));
+    ASSERT_TRUE(x != nullptr && y != nullptr && z != nullptr);
+
+    network.addLink(x, y);
+    network.addLink(y, z);
+    ASSERT_EQ(2, network.getPropertiesLinkedTo(x).size());
+
+    x->set(ivec2(10, 20));
+    EXPECT_EQ(ivec2(10, 20), y->get());
+    EXPECT_EQ(ivec2(10, 20), z->get());
+
+    network.removeLink(y, z);
+    ASSERT_EQ(1, network.getPropertiesLinkedTo(x).size());
+
+    x->set(ivec2(30, 40));
+    EXPECT_EQ(ivec2(30, 40), y->get());
+    EXPECT_EQ(ivec2(10, 20), z->get());
+
+    network.addLink(z, x);
+    ASSERT_EQ(2, network.getPropertiesLinkedTo(z).size());
+    z->set(ivec2(50, 60));
+    EXPECT_EQ(ivec2(50, 60), x->get());
+    EXPECT_EQ(ivec2(50, 60), y->get());
+}
+
+namespace {
+
+// Outputs a volume that only has an OpenGL representation
+class GLVolumeSource : public Processor {
+public:
+    GLVolumeSource() : Processor(), outport_("volume") { addPort(outport_); }
+    virtual const ProcessorInfo getProcessorInfo() const override {
+        return ProcessorInfo{"org.inviwo.test.GLVolumeSource", "GL Volume Source", "Test",
+                             CodeState::Stable, Tags::GL};
+    }
+    virtual void process() override {
+        auto ram = std::make_shared<VolumeRAMPrecision<float>>(size3_t(8));
+        auto data = ram->getDataTyped();
+        for (size_t i = 0; i < 8 * 8 * 8; ++i) data[i] = 1.0f;
+        auto volume = std::make_shared<Volume>(ram);
+        volume->removeOtherRepresentations(volume->getRepresentation<VolumeGL>());
+        outport_.setData(volume);
+    }
+
+    VolumeOutport outport_;
+};
+
+// Reads the RAM representation of its input from the thread pool
+class ConcurrentVolumeReader : public Processor {
+public:
+    ConcurrentVolumeReader() : Processor(), inport_("volume") { addPort(inport_); }
+    virtual const ProcessorInfo getProcessorInfo() const override {
+        return ProcessorInfo{"org.inviwo.test.ConcurrentVolumeReader", "Concurrent Volume Reader",
+                             "Test", CodeState::Stable, Tags::CPU | Tags::Concurrent};
+    }
+    virtual void process() override {
+        const auto volume = inport_.getData();
+        hadRAM = volume->hasRepresentation<VolumeRAM>();
+        thread = std::this_thread::get_id();
+        auto ram = static_cast<const VolumeRAMPrecision<float>*>(
+            volume->getRepresentation<VolumeRAM>());
+        sum = 0.0;
+        for (size_t i = 0; i < glm::compMul(ram->getDimensions()); ++i) {
+            sum += ram->getDataTyped()[i];
+        }
+    }
+
+    VolumeInport inport_;
+    bool hadRAM = false;
+    std::thread::id thread;
+    double sum = 0.0;
+};
+
+}  // namespace
+
+TEST(ConcurrentNetworkTest, InputsAreInRAMBeforeProcessingOnThePool) {
+    auto app = InviwoApplication::getPtr();
+    const auto poolSize = app->getPoolSize();
+    app->resizePool(3);
+    util::OnScopeExit resetPool([&]() { app->resizePool(poolSize); });
+
+    ProcessorNetwork network(app);
+    ProcessorNetworkEvaluator evaluator(&network);
+    evaluator.setConcurrentEvaluation(true);
+
+    auto source = new GLVolumeSource();
+    source->setIdentifier("source");
+    network.addProcessor(source);
+    std::vector<ConcurrentVolumeReader*> readers;
+    for (auto id : {"reader1", "reader2"}) {
+        auto reader = new ConcurrentVolumeReader();
+        reader->setIdentifier(id);
+        network.addProcessor(reader);
+        network.addConnection(&source->outport_, &reader->inport_);
+        readers.push_back(reader);
+    }
+
+    source->invalidate(InvalidationLevel::InvalidOutput);
+
+    for (auto reader : readers) {
+        EXPECT_TRUE(reader->isValid());
+        EXPECT_TRUE(reader->hadRAM);
+        EXPECT_NE(std::this_thread::get_id(), reader->thread);
+        EXPECT_DOUBLE_EQ(8.0 * 8.0 * 8.0, reader->sum);
+    }
+    network.clear();
+}
+
+}  // namespace inviwo